@@ -29,6 +29,7 @@ set(DOCUMENT_FILES
 )
 
 set(EXPORTERS_FILES
+    ${LOMSE_SRC_DIR}/exporters/lomse_binary_exporter.cpp
     ${LOMSE_SRC_DIR}/exporters/lomse_ldp_exporter.cpp
     ${LOMSE_SRC_DIR}/exporters/lomse_lmd_exporter.cpp
     ${LOMSE_SRC_DIR}/exporters/lomse_mnx_exporter.cpp
@@ -57,6 +58,7 @@ set(GRAPHIC_MODEL_FILES
     ${LOMSE_SRC_DIR}/graphic_model/lomse_handler.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_measure_highlight.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_overlays_generator.cpp
+    ${LOMSE_SRC_DIR}/graphic_model/lomse_playback_timeline.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_selections.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_shape_barline.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_shape_base.cpp
@@ -73,6 +75,7 @@ set(GRAPHIC_MODEL_FILES
     ${LOMSE_SRC_DIR}/graphic_model/lomse_shape_volta_bracket.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_shape_wedge.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_shapes.cpp
+    ${LOMSE_SRC_DIR}/graphic_model/lomse_shapes_grid.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_sizers.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_tempo_line.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_time_grid.cpp
@@ -144,6 +147,7 @@ set(INTERNAL_MODEL_FILES
     ${LOMSE_SRC_DIR}/internal_model/lomse_im_figured_bass.cpp
     ${LOMSE_SRC_DIR}/internal_model/lomse_im_measures_table.cpp
     ${LOMSE_SRC_DIR}/internal_model/lomse_im_note.cpp
+    ${LOMSE_SRC_DIR}/internal_model/lomse_im_serializer.cpp
     ${LOMSE_SRC_DIR}/internal_model/lomse_internal_model.cpp
     ${LOMSE_SRC_DIR}/internal_model/lomse_model_builder.cpp
     ${LOMSE_SRC_DIR}/internal_model/lomse_relobj_cloner.cpp
@@ -154,6 +158,7 @@ set(INTERNAL_MODEL_FILES
 )
 
 set(MODULE_FILES
+    ${LOMSE_SRC_DIR}/module/lomse_batch_renderer.cpp
     ${LOMSE_SRC_DIR}/module/lomse_doorway.cpp
     ${LOMSE_SRC_DIR}/module/lomse_events.cpp
     ${LOMSE_SRC_DIR}/module/lomse_events_dispatcher.cpp
@@ -162,6 +167,7 @@ set(MODULE_FILES
     ${LOMSE_SRC_DIR}/module/lomse_interval.cpp
     ${LOMSE_SRC_DIR}/module/lomse_logger.cpp
     ${LOMSE_SRC_DIR}/module/lomse_pitch.cpp
+    ${LOMSE_SRC_DIR}/module/lomse_profiler.cpp
     ${LOMSE_SRC_DIR}/module/lomse_time.cpp
 )
 
@@ -186,6 +192,8 @@ set(PARSER_FILES
     ${LOMSE_SRC_DIR}/parser/lomse_tokenizer.cpp
     ${LOMSE_SRC_DIR}/parser/lomse_xml_parser.cpp
 
+    ${LOMSE_SRC_DIR}/parser/binary/lomse_binary_compiler.cpp
+
     ${LOMSE_SRC_DIR}/parser/ldp/lomse_ldp_analyser.cpp
     ${LOMSE_SRC_DIR}/parser/ldp/lomse_ldp_compiler.cpp
     ${LOMSE_SRC_DIR}/parser/ldp/lomse_ldp_parser.cpp
@@ -211,6 +219,7 @@ set(RENDER_FILES
 )
 
 set(SOUND_FILES
+    ${LOMSE_SRC_DIR}/sound/lomse_midi_file_writer.cpp
     ${LOMSE_SRC_DIR}/sound/lomse_midi_table.cpp
 )
 
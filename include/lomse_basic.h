@@ -265,8 +265,16 @@ struct Rectangle
     }
 
 
-//    // return true if the rectangles have a non empty intersection
-//    bool intersects(const Rectangle& rect) const;
+    // return true if the rectangles intersect or touch. Degenerated rectangles
+    // (e.g. horizontal or vertical lines) are also considered
+    bool intersects(const Rectangle& rect) const
+    {
+        return !( (rect.right() < x)
+                  || (rect.x > right())
+                  || (rect.bottom() < y)
+                  || (rect.y > bottom())
+                );
+    }
 };
 
 //---------------------------------------------------------------------------------------
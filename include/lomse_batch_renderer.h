@@ -0,0 +1,101 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_BATCH_RENDERER_H__        //to avoid nested includes
+#define __LOMSE_BATCH_RENDERER_H__
+
+#include "lomse_basic.h"
+#include "lomse_graphic_view.h"     //for EViewType
+
+#include <string>
+#include <vector>
+
+///@cond INTERNAL
+namespace lomse
+{
+///@endcond
+
+//forward declarations
+class LomseDoorway;
+class BatchWorkQueues;
+
+
+//---------------------------------------------------------------------------------------
+/** Output to generate for a BatchRenderJob.
+*/
+enum EBatchOutput
+{
+    k_batch_output_svg = 0,     ///< SVG code for the page, in BatchRenderJob::svg
+    k_batch_output_bitmap,      ///< Bitmap with the page, in BatchRenderJob::bitmap
+};
+
+//---------------------------------------------------------------------------------------
+/** %BatchRenderJob describes one document to render with LomseDoorway::render_batch()
+    and, after rendering, contains the result.
+
+    For bitmap output, the page is scaled to fit in a bitmap of size
+    @e width x @e height pixels, using the pixel format specified when initializing
+    the library. Lomse does not encode the bitmap in any image format (e.g., PNG):
+    this is left to your application.
+
+    @see LomseDoorway::render_batch()
+*/
+struct BatchRenderJob
+{
+    //input
+    std::string source;         ///< The document content or, if from_file, its path
+    bool from_file = false;     ///< %true when @e source is the path to a file
+    int format = 0;             ///< A Document::k_format_xxx value. Not used when from_file
+    int view_type = k_view_vertical_book;   ///< The View type to use for the layout
+    int output = k_batch_output_svg;        ///< A value from enum EBatchOutput
+    int page = 0;               ///< The page to render (0..num_pages - 1)
+    Pixels width = 0;           ///< Bitmap width, in pixels. Only for bitmap output
+    Pixels height = 0;          ///< Bitmap height, in pixels. Only for bitmap output
+
+    //result
+    bool ok = false;            ///< %true when the page has been rendered
+    std::string errors;         ///< Messages reported when creating the document
+    std::string svg;            ///< The SVG code, for SVG output
+    std::vector<unsigned char> bitmap;      ///< The pixels, for bitmap output
+
+    BatchRenderJob() {}
+};
+
+
+///@cond INTERNAL
+//---------------------------------------------------------------------------------------
+// BatchRenderer: renders a set of documents in parallel, on a pool of threads that
+// take the jobs from per-thread queues and steal jobs from other threads queues when
+// their queue is empty. Each job is fully processed (import, layout and rendering) by
+// a single thread and writes only on its own BatchRenderJob. Therefore, the result of
+// each job does not depend on the number of threads nor on the order of execution.
+class BatchRenderer
+{
+protected:
+    LomseDoorway& m_doorway;
+    std::vector<BatchRenderJob>& m_jobs;
+
+public:
+    BatchRenderer(LomseDoorway& doorway, std::vector<BatchRenderJob>& jobs);
+    ~BatchRenderer() {}
+
+    void render(int numThreads=0);
+
+protected:
+    void prepare_shared_resources();
+    void worker_main(BatchWorkQueues& queues, int iWorker);
+    void render_job(BatchRenderJob& job);
+
+};
+///@endcond
+
+
+}   //namespace lomse
+
+#endif      //__LOMSE_BATCH_RENDERER_H__
@@ -0,0 +1,54 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_BINARY_COMPILER_H__
+#define __LOMSE_BINARY_COMPILER_H__
+
+#include "lomse_compiler.h"
+
+#include <ostream>
+
+namespace lomse
+{
+
+//forward declarations
+class ImoDocument;
+class Document;
+
+
+//---------------------------------------------------------------------------------------
+// BinaryCompiler: restores the internal model from a binary snapshot, as created by
+// BinaryExporter. There is nothing to parse or analyse: the objects are created and
+// the ColStaffObjs and ImMeasuresTable tables are rebuilt.
+class BinaryCompiler : public Compiler
+{
+protected:
+    std::ostream& m_reporter;
+    int m_numErrors;
+
+public:
+    BinaryCompiler(ModelBuilder* mb, Document* pDoc);
+    ~BinaryCompiler();
+
+    //compilation
+    ImoDocument* compile_file(const std::string& filename) override;
+    ImoDocument* compile_string(const std::string& source) override;
+
+    //info
+    int get_num_errors() const override { return m_numErrors; }
+
+protected:
+    ImoDocument* compile_buffer(const char* data, size_t size);
+
+};
+
+
+}   //namespace lomse
+
+#endif      //__LOMSE_BINARY_COMPILER_H__
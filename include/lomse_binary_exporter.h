@@ -0,0 +1,78 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_BINARY_EXPORTER_H__        //to avoid nested includes
+#define __LOMSE_BINARY_EXPORTER_H__
+
+#include "lomse_basic.h"
+
+#include <string>
+
+///@cond INTERNALS
+namespace lomse
+{
+///@endcond
+
+//forward declarations
+class ImoDocument;
+
+
+//----------------------------------------------------------------------------------
+/** %BinaryExporter saves the internal model of a document in a compact binary format
+    (a snapshot). Loading a snapshot, with Document::from_file() and format
+    Document::k_format_binary, is much faster than importing the document from its
+    source file, as there is nothing to parse or analyse. Example:
+
+    @code
+        BinaryExporter exporter;
+        if (!exporter.save_to_file(doc.get_im_root(), "score.lmb"))
+            cout << exporter.get_error() << endl;
+        ...
+        Document doc2(libraryScope);
+        doc2.from_file("score.lmb", Document::k_format_binary);
+    @endcode
+
+    A snapshot is a cache, not an interchange format: it can only be loaded by the
+    same lomse version on machines with the same byte order. Documents containing
+    controls, images or other objects created by the application can not be saved.
+*/
+class BinaryExporter
+{
+protected:
+    std::string m_error;
+
+public:
+    /** Constructor */
+    BinaryExporter() {}
+    /** Destructor */
+    virtual ~BinaryExporter() {}
+
+    /** Returns the snapshot for the document, or an empty string if the document can
+        not be saved. See get_error().
+        @param pImoDoc  The document to save.
+    */
+    std::string get_source(ImoDocument* pImoDoc);
+
+    /** Saves the snapshot for the document in a file. Returns @FALSE if the document
+        can not be saved or in case of file error. See get_error().
+        @param pImoDoc  The document to save.
+        @param filename  The file to create.
+    */
+    bool save_to_file(ImoDocument* pImoDoc, const std::string& filename);
+
+    /** Returns the reason of the last failure.
+    */
+    inline const std::string& get_error() const { return m_error; }
+
+};
+
+
+}   //namespace lomse
+
+#endif    // __LOMSE_BINARY_EXPORTER_H__
@@ -42,17 +42,25 @@ class ContentLayouter : public Layouter
 {
 protected:
     ImoContent* m_pContent;
+    TreeNode<ImoObj>::children_iterator m_itChild;     //child being laid out
 
 public:
     ContentLayouter(ImoContentObj* pItem, Layouter* pParent,
                     GraphicModel* pGModel, LibraryScope& libraryScope,
                     ImoStyles* pStyles, bool fAddShapesToModel=true);
-    virtual ~ContentLayouter() {}
+    virtual ~ContentLayouter();
 
     //implementation of Layouter virtual methods
     void layout_in_box() override;
     void create_main_box(GmoBox* pParentBox, UPoint pos, LUnits width, LUnits height) override;
 
+    //lazy layout
+    bool must_pause_layout() override { return m_pParentLayouter->must_pause_layout(); }
+    void resume_layout_in_box() override;
+
+protected:
+    int layout_children(int result);
+
 };
 
 //----------------------------------------------------------------------------------
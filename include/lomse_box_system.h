@@ -224,6 +224,7 @@ public:
     GmoBoxSliceStaff* get_first_slice_staff_for(int iInstr, int iStaff);
     void reposition_slices(USize shift);
     void remove_free_space_at_bottom_and_adjust_slices();
+    void restore_free_space_at_bottom(LUnits space);
 
     //grid table: xPositions/timepos
     inline void set_time_grid_table(TimeGridTable* pGridTable) { m_pGridTable = pGridTable; }
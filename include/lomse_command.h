@@ -20,6 +20,7 @@
 
 #include <sstream>
 #include <list>
+#include <map>
 
 ///@cond INTERNALS
 namespace lomse
@@ -66,17 +67,26 @@ protected:
     std::string m_error;
     uint_least16_t m_flags;
 
+    //measures modified by the command, for incremental layout
+    ImoId m_dirtyScoreId;
+    int m_firstDirtyMeasure;
+    int m_lastDirtyMeasure;
+
     enum {
         k_reversible                    = 0x0001,
         k_recordable                    = 0x0002,
         k_target_set_in_constructor     = 0x0004,
         k_included_in_composite_cmd     = 0x0008,
+        k_unknown_dirty_measures        = 0x0010,
     };
 
     DocCommand(const std::string& name)
         : m_name(name)
         , m_idRefresh(k_no_imoid)
         , m_flags(0)
+        , m_dirtyScoreId(k_no_imoid)
+        , m_firstDirtyMeasure(-1)
+        , m_lastDirtyMeasure(-1)
     {
     }
 
@@ -169,6 +179,13 @@ public:
     inline void set_final_cursor_pos(ImoId id) { m_idRefresh = id; }
     inline ImoId get_final_cursor_pos() { return m_idRefresh; }
 
+    /** Returns @true if, after executing the command, it is known that all changes
+        affect only to measures [first, last] of one score. This allows to update the
+        graphic model without engraving again the whole score. Commands not
+        supporting this information always return @false.
+    */
+    bool get_dirty_measures(ImoId* pScoreId, int* pFirst, int* pLast);
+
     //settings
     inline void mark_as_included_in_composite_cmd() { m_flags |= k_included_in_composite_cmd; }
 
@@ -184,6 +201,11 @@ protected:
     int validate_source(const std::string& source);
     virtual void log_command(ostream &logger);
 
+    //info about modified measures
+    void reset_dirty_measures();
+    void add_dirty_measures_for(ImoStaffObj* pSO);
+    void add_dirty_measure(ImoStaffObj* pSO);
+
 };
 
 //---------------------------------------------------------------------------------------
@@ -288,6 +310,14 @@ typedef UndoableStack< UndoElement* >   UndoStack;
 //---------------------------------------------------------------------------------------
 /** %DocCommandExecuter class is responsible of maintaining the stack of executed
     commands and performing undo/redo.
+
+    Most commands are undone by restoring a saved copy of the document and
+    re-executing all previous commands in the undo stack. To avoid that undo time
+    grows with the length of the edition session, a copy of the document
+    (a checkpoint) is saved every few commands, so that undo only has to replay the
+    commands executed after the nearest checkpoint. The number of commands between
+    checkpoints and the maximum memory used by checkpoints can be customized by
+    methods set_checkpoint_interval() and set_checkpoints_memory_limit().
 */
 class DocCommandExecuter
 {
@@ -297,6 +327,12 @@ private:
     UndoStack   m_stack;                    //stack of executed commands
     std::string m_error;
 
+    //checkpoints: document state after executing the first n commands in the stack
+    std::map<size_t, DocModel*> m_checkpoints;
+    int         m_checkpointInterval = 25;      //commands between checkpoints. 0: none
+    size_t      m_checkpointsLimit = 500000;    //max ImoObjs in saved checkpoints
+    size_t      m_checkpointsSize = 0;          //ImoObjs in saved checkpoints
+
 public:
     /// Constructor
     DocCommandExecuter(Document* target);
@@ -334,6 +370,35 @@ public:
     /// Returns the number of undo/redo elements in the undo/redo stack.
     virtual size_t undo_stack_size() { return m_stack.size(); }
 
+    //undo checkpoints
+    /** Set the number of executed commands between two consecutive undo checkpoints.
+        A lower value speeds up undo operations at the cost of more memory and a
+        slower execution of some commands. Value 0 disables checkpoints, so that undo
+        replays all the commands executed since the start of the edition session.
+        Default value is 25 commands.    */
+    void set_checkpoint_interval(int numCommands);
+
+    /** Returns the number of executed commands between two consecutive undo
+        checkpoints.    */
+    inline int get_checkpoint_interval() { return m_checkpointInterval; }
+
+    /** Set the maximum size of all saved undo checkpoints, measured as the total
+        number of internal model objects they contain. When this limit is exceeded,
+        the checkpoint that less contributes to reduce replay time is removed.
+        Default value is 500000 objects.    */
+    void set_checkpoints_memory_limit(size_t maxObjects);
+
+    /** Returns the maximum size of all saved undo checkpoints, measured as the total
+        number of internal model objects they contain.    */
+    inline size_t get_checkpoints_memory_limit() { return m_checkpointsLimit; }
+
+    /// Returns the number of undo checkpoints currently saved.
+    inline size_t num_checkpoints() { return m_checkpoints.size(); }
+
+    /** Returns the size of all saved undo checkpoints, measured as the total
+        number of internal model objects they contain.    */
+    inline size_t checkpoints_size() { return m_checkpointsSize; }
+
 protected:
     friend class DocCmdComposite;
     void update_cursor(DocCursor* pCursor, DocCommand* pCmd);
@@ -342,6 +407,12 @@ protected:
     void replay_until(UndoElement* pUE, DocCursor* pCursor, SelectionSet* pSelection);
     void replay_command(UndoElement* pUE, DocCursor* pCursor, SelectionSet* pSelection);
 
+    void save_checkpoint();
+    void remove_checkpoints_after(size_t numCommands);
+    void remove_checkpoint(std::map<size_t, DocModel*>::iterator it);
+    void enforce_checkpoints_limit();
+    void delete_checkpoints();
+
 };
 
 //---------------------------------------------------------------------------------------
@@ -519,6 +590,7 @@ protected:
     void get_data_about_noterest_to_insert();
     void find_and_classify_overlapped_noterests();
     void determine_insertion_point();
+    void save_modified_measures();
     void add_new_note_to_existing_beam_if_necessary();
     void reduce_duration_of_overlapped_at_end();
     void remove_fully_overlapped();
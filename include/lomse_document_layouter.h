@@ -28,6 +28,7 @@ class Layouter;
 class GraphicModel;
 class GmoBox;
 class GmoBoxDocPage;
+class PhaseProfiler;
 class ScoreLayouter;
 
 //---------------------------------------------------------------------------------------
@@ -41,6 +42,17 @@ protected:
     //for unit tests: need to access ScoreLayouter.
     Layouter* m_pScoreLayouter;
 
+    //graphic model for previous version of the document. Not owned
+    GraphicModel* m_pPrevGModel;
+
+    //profiler set in the document, if any. Not owned
+    PhaseProfiler* m_pProfiler;
+
+    //lazy layout
+    bool m_fLazyLayout;
+    bool m_fLayoutPaused;
+    int m_pagesLimit;       //pause layout when this number of pages is reached. 0: no limit
+
 public:
     DocLayouter(Document* pDoc, LibraryScope& libraryScope, int constrains=0,
                 LUnits width=0.0f);
@@ -49,6 +61,29 @@ public:
     void layout_document();
     void layout_empty_document();
 
+    /** When the graphic model for the previous version of the document is provided,
+        the score layouters will reuse the systems not affected by the changes. */
+    inline void set_previous_graphic_model(GraphicModel* pGModel) {
+        m_pPrevGModel = pGModel;
+    }
+    GraphicModel* get_previous_graphic_model() override { return m_pPrevGModel; }
+
+    /** Lazy layout. When enabled, layout_document() only lays out the first
+        @c numPages pages and pauses. The remaining pages are laid out, on demand,
+        by invoking layout_more_pages(). The graphic model is not finished until the
+        layout is finished (see GraphicModel::is_layout_finished()) and this
+        DocLayouter must exist while the layout is not finished. Score layouters
+        could choose different line breaks than when laying out the whole score. */
+    void enable_lazy_layout(int numPages=1);
+    /** Continue a paused layout, for laying out @c numPages more pages (0 for all
+        remaining pages). Returns @true if there are still pages pending.
+        AWARE: If the page content scale has to be changed, the layout is started
+        again in a new graphic model. The previous graphic model is not deleted. */
+    bool layout_more_pages(int numPages=1);
+    inline bool is_layout_finished() { return !m_fLayoutPaused; }
+    bool is_lazy_layout() override { return m_fLazyLayout; }
+    bool must_pause_layout() override;
+
     //implementation of virtual methods in Layouter base class
     void layout_in_box() override {}
     void create_main_box(GmoBox* UNUSED(pParentBox), UPoint UNUSED(pos),
@@ -63,6 +98,7 @@ protected:
     int layout_content();
     void fix_document_size();
     void delete_last_trial();
+    void update_layout_state();
 
     GmoBoxDocPage* create_document_page();
     void assign_paper_size_to(GmoBox* pBox);
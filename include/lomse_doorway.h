@@ -17,6 +17,7 @@
 #include <string>
 #include <iostream>
 #include <memory>   //shared_ptr
+#include <vector>
 
 ///@cond INTERNAL
 namespace lomse
@@ -43,6 +44,7 @@ typedef std::shared_ptr<EventInfo>  SpEventInfo;
 class Request;
 class LdpReader;
 class Drawer;
+struct BatchRenderJob;
 
 
 typedef void (*pt2NotifyFunction)(void*, SpEventInfo);
@@ -395,6 +397,44 @@ public:
 
 
 
+     /** @name Batch rendering  */
+    //@{
+
+	/** Render a set of documents, using several threads for processing them in
+        parallel. For each job, the document is created, the layout is computed and
+        the requested page is rendered as SVG code or as a bitmap, and the result is
+        saved in the job. Documents are deleted after rendering them.
+
+        @param jobs The documents to render. See BatchRenderJob.
+        @param numThreads The number of threads to use. Value 0 means as many threads
+            as the number of processors. The calling thread is also used for rendering
+            and this method returns when all jobs are finished.
+
+        The result of each job does not depend on the number of threads used. The
+        callbacks set with set_notify_callback() and set_request_callback() can be
+        invoked from any of the threads.
+
+        Example:
+
+        @code
+        std::vector<BatchRenderJob> jobs(filenames.size());
+        for (size_t i=0; i < filenames.size(); ++i)
+        {
+            jobs[i].source = filenames[i];
+            jobs[i].from_file = true;
+            jobs[i].output = k_batch_output_bitmap;
+            jobs[i].width = 1240;
+            jobs[i].height = 1754;
+        }
+        m_lomse.render_batch(jobs);
+        @endcode
+	*/
+    void render_batch(std::vector<BatchRenderJob>& jobs, int numThreads=0);
+
+    //@}    //Batch rendering
+
+
+
      /** @name Playback related methods  */
     //@{
 
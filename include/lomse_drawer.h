@@ -63,6 +63,8 @@ enum ERenderOptions
 
     //for user application needs
     k_option_display_voices_in_colours,     ///< Display each music voice in a different color
+    k_option_disable_viewport_culling,      ///< Draw all objects in the visible pages,
+                                            ///< not only those in the visible area
 };
 
 ///@cond INTERNALS
@@ -113,6 +115,16 @@ struct RenderOptions
     bool read_only_mode;
     int highlighted_voice;          //0 for none
 
+    //viewport culling: when enabled, only the boxes and shapes intersecting the
+    //clip rectangle are drawn
+    bool culling_flag;
+    URect clip_rect;                //visible area, in page coordinates
+
+    //statistics, for performance measurements
+    int num_shapes_drawn;
+    int num_shapes_culled;
+    int num_boxes_culled;
+
 
     RenderOptions()
         : draw_anchor_objects(false)
@@ -138,6 +150,10 @@ struct RenderOptions
         , draw_voices_coloured(false)
         , read_only_mode(true)
         , highlighted_voice(0)                  //0=none, 1..n= voice 1..n
+        , culling_flag(false)
+        , num_shapes_drawn(0)
+        , num_shapes_culled(0)
+        , num_boxes_culled(0)
     {
         boxes.reset();
 
@@ -158,6 +174,19 @@ struct RenderOptions
         boxes.reset();
     }
 
+    void reset_render_counters()
+    {
+        num_shapes_drawn = 0;
+        num_shapes_culled = 0;
+        num_boxes_culled = 0;
+    }
+
+    //returns true if rectangle is visible (or if culling is not enabled)
+    bool is_visible(const URect& rect) const
+    {
+        return !culling_flag || clip_rect.intersects(rect);
+    }
+
     void draw_box_for(int type)
     {
         boxes[type] = true;
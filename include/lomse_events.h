@@ -1117,6 +1117,15 @@ public:
         m_items.push_back( make_pair(k_move_tempo_line, -1) );
         m_timepos = timepos;
     }
+
+    //for reusing the event object
+    void reset(WpInteractor wpInteractor, ImoId nScoreID)
+    {
+        m_wpInteractor = wpInteractor;
+        m_nID = nScoreID;
+        m_items.clear();
+        m_timepos = 0.0;
+    }
 ///@endcond
 };
 
@@ -187,6 +187,35 @@ public:
 };
 
 
+//-------------------------------------------------------------------------------------
+// MappedFile: a file in the local file system mapped in memory.
+// The mapping is private (copy on write): the content can be modified, e.g. by a
+// parser working in place, without changing the file. If the file can not be mapped
+// (e.g. it does not exist or it is empty) is_open() returns false.
+class MappedFile
+{
+private:
+    char* m_pData;
+    size_t m_size;
+#if (LOMSE_PLATFORM_WIN32 == 1)
+    void* m_hFile;
+    void* m_hMapping;
+#endif
+
+public:
+    MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    inline bool is_open() const { return m_pData != nullptr; }
+    inline char* data() { return m_pData; }
+    inline size_t size() const { return m_size; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator= (const MappedFile&);
+};
+
+
 }   //namespace lomse
 
 
@@ -26,6 +26,14 @@
 #include <string.h>
 #include "agg_array.h"
 
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
 
 using namespace agg;
 
@@ -81,14 +89,17 @@ struct glyph_cache
 
 
 //---------------------------------------------------------------------------------------
-// font_cache: storage for the latest 256 used glyphs
+// font_cache: storage for the glyphs of a font.
+// It is shared by all threads: glyphs are found without locks, and a mutex is only
+// used for adding new glyphs. Glyphs are never modified nor removed once published.
 
     class font_cache
     {
     private:
         block_allocator m_allocator;
-        glyph_cache**   m_glyphs[256];
+        std::atomic<std::atomic<glyph_cache*>*> m_glyphs[256];
         char*           m_font_signature;
+        std::mutex      m_mutex;        //for adding glyphs
 
     public:
         enum block_size_e { block_size = 16384-16 };
@@ -98,6 +109,8 @@ struct glyph_cache
             : m_allocator(block_size)
             , m_font_signature(nullptr)
         {
+            for (int i=0; i < 256; ++i)
+                m_glyphs[i].store(nullptr, std::memory_order_relaxed);
         }
 
         //--------------------------------------------------------------------
@@ -106,7 +119,6 @@ struct glyph_cache
             int len = int( strlen(font_signature) + 1 );
             m_font_signature = (char*)m_allocator.allocate(len);
             strncpy(m_font_signature, font_signature, len);
-            memset(m_glyphs, 0, sizeof(m_glyphs));
         }
 
         //--------------------------------------------------------------------
@@ -119,46 +131,52 @@ struct glyph_cache
         const glyph_cache* find_glyph(unsigned glyph_code) const
         {
             unsigned msb = (glyph_code >> 8) & 0xFF;
-            if(m_glyphs[msb])
+            std::atomic<glyph_cache*>* table = m_glyphs[msb].load(std::memory_order_acquire);
+            if(table)
             {
-                return m_glyphs[msb][glyph_code & 0xFF];
+                return table[glyph_code & 0xFF].load(std::memory_order_acquire);
             }
             return nullptr;
         }
 
         //--------------------------------------------------------------------
-        glyph_cache* cache_glyph(unsigned        glyph_code,
-                                 unsigned        glyph_index,
-                                 unsigned        data_size,
-                                 glyph_data_type data_type,
-                                 const rect_i&   bounds,
-                                 double          advance_x,
-                                 double          advance_y)
+        //Adds the glyph prepared in the font engine. If other thread has added
+        //the glyph in the meantime, returns the existing one.
+        template<class FontEngine>
+        const glyph_cache* cache_glyph(unsigned glyph_code, FontEngine& engine)
         {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
             unsigned msb = (glyph_code >> 8) & 0xFF;
-            if(m_glyphs[msb] == nullptr)
+            std::atomic<glyph_cache*>* table = m_glyphs[msb].load(std::memory_order_relaxed);
+            if(table == nullptr)
             {
-                m_glyphs[msb] =
-                    (glyph_cache**)m_allocator.allocate(sizeof(glyph_cache*) * 256,
-                                                        sizeof(glyph_cache*));
-                memset(m_glyphs[msb], 0, sizeof(glyph_cache*) * 256);
+                table = (std::atomic<glyph_cache*>*)
+                    m_allocator.allocate(sizeof(std::atomic<glyph_cache*>) * 256,
+                                         sizeof(std::atomic<glyph_cache*>));
+                for (int i=0; i < 256; ++i)
+                    new (table + i) std::atomic<glyph_cache*>(nullptr);
+                m_glyphs[msb].store(table, std::memory_order_release);
             }
 
             unsigned lsb = glyph_code & 0xFF;
-            if(m_glyphs[msb][lsb]) return nullptr; // Already exists, do not overwrite
-
-            glyph_cache* glyph =
-                (glyph_cache*)m_allocator.allocate(sizeof(glyph_cache),
-                                                   sizeof(double));
-
-            glyph->glyph_index        = glyph_index;
-            glyph->data               = m_allocator.allocate(data_size);
-            glyph->data_size          = data_size;
-            glyph->data_type          = data_type;
-            glyph->bounds             = bounds;
-            glyph->advance_x          = advance_x;
-            glyph->advance_y          = advance_y;
-            return m_glyphs[msb][lsb] = glyph;
+            glyph_cache* glyph = table[lsb].load(std::memory_order_relaxed);
+            if(glyph) return glyph;     // Already exists, do not overwrite
+
+            glyph = (glyph_cache*)m_allocator.allocate(sizeof(glyph_cache),
+                                                       sizeof(double));
+
+            glyph->glyph_index        = engine.glyph_index();
+            glyph->data_size          = engine.data_size();
+            glyph->data               = m_allocator.allocate(glyph->data_size);
+            glyph->data_type          = engine.data_type();
+            glyph->bounds             = engine.bounds();
+            glyph->advance_x          = engine.advance_x();
+            glyph->advance_y          = engine.advance_y();
+            engine.write_glyph_to(glyph->data);
+
+            table[lsb].store(glyph, std::memory_order_release);
+            return glyph;
         }
     };
 
@@ -168,113 +186,200 @@ struct glyph_cache
 
 
 //---------------------------------------------------------------------------------------
-// font_cache_pool: fonts?
+// font_cache_pool: the glyphs caches for all fonts, keyed by font signature (font
+// file, size, resolution, transform, etc.). There is a process-wide instance, shared
+// by all documents, views and threads, so that glyphs are rasterized only once.
+// When the maximum number of fonts is reached the least recently used font is
+// removed. The font caches are shared pointers, so that a removed font remains valid
+// while a font_cache_manager is still using it.
 
 class font_cache_pool
 {
-private:
-    font_cache** m_fonts;
-    unsigned     m_max_fonts;
-    unsigned     m_num_fonts;
-    font_cache*  m_cur_font;
-
 public:
     //--------------------------------------------------------------------
-    ~font_cache_pool()
+    // Hits and misses of one font_cache_manager. Each manager counts its own
+    // lookups, so that render threads do not write shared memory for each glyph.
+    // The pool adds them up when the statistics are requested.
+    class counters
     {
-        unsigned i;
-        for(i = 0; i < m_num_fonts; ++i)
+    public:
+        counters(font_cache_pool& pool)
+            : m_pool(pool), m_hits(0), m_misses(0), m_base_hits(0), m_base_misses(0)
         {
-            obj_allocator<font_cache>::deallocate(m_fonts[i]);
+            m_pool.attach(this);
         }
-        pod_allocator<font_cache*>::deallocate(m_fonts, m_max_fonts);
-    }
+        ~counters() { m_pool.detach(this); }
 
+        counters(const counters&) = delete;
+        counters& operator=(const counters&) = delete;
+
+        //only the owner thread writes: a read-modify-write is not needed
+        inline void count_hit() {
+            m_hits.store(m_hits.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+        }
+        inline void count_miss() {
+            m_misses.store(m_misses.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+        }
+
+    private:
+        friend class font_cache_pool;
+
+        font_cache_pool& m_pool;
+        std::atomic<unsigned long long> m_hits;
+        std::atomic<unsigned long long> m_misses;
+        unsigned long long m_base_hits;         //values at last reset. Protected
+        unsigned long long m_base_misses;       //by the pool mutex
+    };
+
+private:
+    struct entry
+    {
+        std::shared_ptr<font_cache> font;
+        unsigned long long last_use;
+    };
+
+    std::mutex  m_mutex;
+    std::map<std::string, entry> m_fonts;
+    unsigned    m_max_fonts;
+    unsigned long long  m_clock;
+
+    std::vector<counters*> m_counters;          //counters of existing managers
+    unsigned long long  m_hits;                 //hits and misses of deleted managers
+    unsigned long long  m_misses;
+    std::atomic<unsigned long long> m_evictions;
+
+public:
     //--------------------------------------------------------------------
-    font_cache_pool(unsigned max_fonts=32) :
-        m_fonts(pod_allocator<font_cache*>::allocate(max_fonts)),
-        m_max_fonts(max_fonts),
-        m_num_fonts(0),
-        m_cur_font(nullptr)
+    font_cache_pool(unsigned max_fonts=128)
+        : m_max_fonts(max_fonts)
+        , m_clock(0)
+        , m_hits(0)
+        , m_misses(0)
+        , m_evictions(0)
     {}
 
+    //--------------------------------------------------------------------
+    ~font_cache_pool() {}
+
+    //--------------------------------------------------------------------
+    static font_cache_pool& instance();
 
     //--------------------------------------------------------------------
-    void font(const char* font_signature, bool reset_cache = false)
+    std::shared_ptr<font_cache> font(const char* font_signature,
+                                     bool reset_cache = false)
     {
-        int idx = find_font(font_signature);
-        if(idx >= 0)
-        {
-            if(reset_cache)
-            {
-                obj_allocator<font_cache>::deallocate(m_fonts[idx]);
-                m_fonts[idx] = obj_allocator<font_cache>::allocate();
-                m_fonts[idx]->signature(font_signature);
-            }
-            m_cur_font = m_fonts[idx];
-        }
-        else
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_fonts.find(font_signature);
+        if(it != m_fonts.end() && !reset_cache)
         {
-            if(m_num_fonts >= m_max_fonts)
-            {
-                obj_allocator<font_cache>::deallocate(m_fonts[0]);
-                memmove(m_fonts,
-                        m_fonts + 1,
-                        (m_max_fonts - 1) * sizeof(font_cache*));
-                m_num_fonts = m_max_fonts - 1;
-            }
-            m_fonts[m_num_fonts] = obj_allocator<font_cache>::allocate();
-            m_fonts[m_num_fonts]->signature(font_signature);
-            m_cur_font = m_fonts[m_num_fonts];
-            ++m_num_fonts;
+            it->second.last_use = ++m_clock;
+            return it->second.font;
         }
+
+        if(it == m_fonts.end() && m_fonts.size() >= m_max_fonts)
+            remove_least_recently_used();
+
+        std::shared_ptr<font_cache> font = std::make_shared<font_cache>();
+        font->signature(font_signature);
+        entry& e = m_fonts[font_signature];
+        e.font = font;
+        e.last_use = ++m_clock;
+        return font;
     }
 
     //--------------------------------------------------------------------
-    const font_cache* font() const
+    void clear()
     {
-        return m_cur_font;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fonts.clear();
     }
 
     //--------------------------------------------------------------------
-    const glyph_cache* find_glyph(unsigned glyph_code) const
+    void max_fonts(unsigned max_fonts)
     {
-        if(m_cur_font) return m_cur_font->find_glyph(glyph_code);
-        return nullptr;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_max_fonts = (max_fonts > 0 ? max_fonts : 1);
+        while (m_fonts.size() > m_max_fonts)
+            remove_least_recently_used();
     }
 
     //--------------------------------------------------------------------
-    glyph_cache* cache_glyph(unsigned        glyph_code,
-                                unsigned        glyph_index,
-                                unsigned        data_size,
-                                glyph_data_type data_type,
-                                const rect_i&   bounds,
-                                double          advance_x,
-                                double          advance_y)
+    unsigned num_fonts()
     {
-        if(m_cur_font)
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return unsigned(m_fonts.size());
+    }
+
+    //--------------------------------------------------------------------
+    //statistics
+    unsigned long long hits()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        unsigned long long total = m_hits;
+        for (counters* c : m_counters)
+            total += c->m_hits.load(std::memory_order_relaxed) - c->m_base_hits;
+        return total;
+    }
+
+    unsigned long long misses()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        unsigned long long total = m_misses;
+        for (counters* c : m_counters)
+            total += c->m_misses.load(std::memory_order_relaxed) - c->m_base_misses;
+        return total;
+    }
+
+    unsigned long long evictions() const { return m_evictions.load(); }
+
+    void reset_counters()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_hits = 0;
+        m_misses = 0;
+        for (counters* c : m_counters)
         {
-            return m_cur_font->cache_glyph(glyph_code,
-                                            glyph_index,
-                                            data_size,
-                                            data_type,
-                                            bounds,
-                                            advance_x,
-                                            advance_y);
+            c->m_base_hits = c->m_hits.load(std::memory_order_relaxed);
+            c->m_base_misses = c->m_misses.load(std::memory_order_relaxed);
         }
-        return nullptr;
+        m_evictions.store(0);
+    }
+
+private:
+    //--------------------------------------------------------------------
+    void attach(counters* c)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_counters.push_back(c);
     }
 
+    //--------------------------------------------------------------------
+    void detach(counters* c)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_hits += c->m_hits.load(std::memory_order_relaxed) - c->m_base_hits;
+        m_misses += c->m_misses.load(std::memory_order_relaxed) - c->m_base_misses;
+        m_counters.erase(std::remove(m_counters.begin(), m_counters.end(), c),
+                         m_counters.end());
+    }
 
     //--------------------------------------------------------------------
-    int find_font(const char* font_signature)
+    void remove_least_recently_used()
     {
-        unsigned i;
-        for(i = 0; i < m_num_fonts; i++)
+        auto lru = m_fonts.begin();
+        for (auto it = m_fonts.begin(); it != m_fonts.end(); ++it)
         {
-            if(m_fonts[i]->font_is(font_signature)) return int(i);
+            if (it->second.last_use < lru->second.last_use)
+                lru = it;
+        }
+        if (lru != m_fonts.end())
+        {
+            m_fonts.erase(lru);
+            m_evictions.fetch_add(1, std::memory_order_relaxed);
         }
-        return -1;
     }
 
 };
@@ -296,6 +401,7 @@ public:
 
 //---------------------------------------------------------------------------------------
 // font_cache_manager: orchestrates font usage? (just one font: selected one)
+// Glyphs are taken from a font_cache_pool, by default the process-wide one.
 
 template<class FontEngine> class font_cache_manager
 {
@@ -309,7 +415,9 @@ public:
     typedef typename mono_adaptor_type::embedded_scanline  mono_scanline_type;
 
 private:
-    font_cache_pool     m_fonts;
+    font_cache_pool&    m_fonts;
+    font_cache_pool::counters m_counters;
+    std::shared_ptr<font_cache> m_cur_font;
     font_engine_type&   m_engine;
     int                 m_change_stamp;
     double              m_dx;
@@ -324,8 +432,10 @@ private:
 
 public:
     //--------------------------------------------------------------------
-    font_cache_manager(font_engine_type& engine, unsigned max_fonts=32) :
-        m_fonts(max_fonts),
+    font_cache_manager(font_engine_type& engine,
+                       font_cache_pool& pool = font_cache_pool::instance()) :
+        m_fonts(pool),
+        m_counters(pool),
         m_engine(engine),
         m_change_stamp(-1),
         m_dx(0.0),
@@ -344,26 +454,22 @@ public:
     const glyph_cache* glyph(unsigned glyph_code)
     {
         synchronize();
-        const glyph_cache* gl = m_fonts.find_glyph(glyph_code);
+        if(!m_cur_font) return nullptr;
+
+        const glyph_cache* gl = m_cur_font->find_glyph(glyph_code);
         if(gl)
         {
+            m_counters.count_hit();
             m_prev_glyph = m_last_glyph;
             return m_last_glyph = gl;
         }
         else
         {
+            m_counters.count_miss();
             if(m_engine.prepare_glyph(glyph_code))
             {
                 m_prev_glyph = m_last_glyph;
-                m_last_glyph = m_fonts.cache_glyph(glyph_code,
-                                                    m_engine.glyph_index(),
-                                                    m_engine.data_size(),
-                                                    m_engine.data_type(),
-                                                    m_engine.bounds(),
-                                                    m_engine.advance_x(),
-                                                    m_engine.advance_y());
-                m_engine.write_glyph_to(m_last_glyph->data);
-                return m_last_glyph;
+                return m_last_glyph = m_cur_font->cache_glyph(glyph_code, m_engine);
             }
         }
         return nullptr;
@@ -427,7 +533,7 @@ public:
     //--------------------------------------------------------------------
     void reset_cache()
     {
-        m_fonts.font(m_engine.font_signature(), true);
+        m_cur_font = m_fonts.font(m_engine.font_signature(), true);
         m_change_stamp = m_engine.change_stamp();
         m_prev_glyph = m_last_glyph = 0;
     }
@@ -442,7 +548,10 @@ private:
     {
         if(m_change_stamp != m_engine.change_stamp())
         {
-            m_fonts.font(m_engine.font_signature());
+            //the stamp also changes when setting again the same transform. Do
+            //not search the pool when the font is the same
+            if(!m_cur_font || !m_cur_font->font_is(m_engine.font_signature()))
+                m_cur_font = m_fonts.font(m_engine.font_signature());
             m_change_stamp = m_engine.change_stamp();
             m_prev_glyph = m_last_glyph = 0;
         }
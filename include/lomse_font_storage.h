@@ -29,6 +29,7 @@
 //std
 #include <string>
 #include <map>
+#include <mutex>
 using namespace std;
 
 using namespace agg;
@@ -129,6 +130,7 @@ class FontSelector
 protected:
     LibraryScope* m_pLibScope;
     std::map<string, string> m_cache;
+    std::mutex m_mutex;         //FontSelector is shared by all threads
 
 public:
     FontSelector(LibraryScope* pLibScope) : m_pLibScope(pLibScope) {}
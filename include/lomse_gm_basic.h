@@ -49,6 +49,8 @@ class Control;
 class ScoreStub;
 class GraphicModel;
 class GmMeasuresTable;
+class PlaybackTimeline;
+class ShapesGrid;
 
 
 ///@cond INTERNALS
@@ -65,16 +67,45 @@ class GmMeasuresTable;
 */
 class ScoreStub
 {
+public:
+    /** Information about one system, saved when the system is added to a page. It is
+        used for deciding if the system can be reused in an incremental layout of the
+        score, after an edition command.
+    */
+    struct SystemLayoutInfo
+    {
+        GmoBoxSystem* pBox;         //the system box, or nullptr if moved to other model
+        ImoId firstId;              //id of first staffobj in the system
+        TimeUnits startTime;        //timepos of first staffobj in the system
+        int firstMeasure;           //measure containing the first staffobj
+        int numColumns;             //number of columns in the system
+        bool fCleanStart;           //no pending relations/lyrics from previous systems
+        bool fHasPrevSystem;        //placed after other system in the same page
+        LUnits prevFreeSpace;       //free space at bottom of previous system
+        LUnits removedSpace;        //free space at bottom removed for fitting the page
+
+        SystemLayoutInfo()
+            : pBox(nullptr), firstId(k_no_imoid), startTime(0.0), firstMeasure(0)
+            , numColumns(0), fCleanStart(false), fHasPrevSystem(false)
+            , prevFreeSpace(0.0f), removedSpace(0.0f)
+        {
+        }
+    };
+
 protected:
     ImoId m_scoreId;
     std::vector<GmoBoxScorePage*> m_pages;
     GmMeasuresTable* m_measures;
+    PlaybackTimeline* m_pTimeline;
+    std::vector<SystemLayoutInfo> m_systems;
+    int m_firstDirtyMeasure;
+    int m_lastDirtyMeasure;
 
 public:
     ScoreStub(ImoScore* pScore);
     ~ScoreStub();
 
-    inline void add_page(GmoBoxScorePage* pPage) { m_pages.push_back(pPage); }
+    void add_page(GmoBoxScorePage* pPage);
     inline std::vector<GmoBoxScorePage*>& get_pages() { return m_pages; }
 
     /** Returns the GmoBoxScorePage containing timepos @c time. If @c time is not in
@@ -90,6 +121,25 @@ public:
     /** Returns the table of measures for this score */
     inline GmMeasuresTable* get_measures_table() { return m_measures; }
 
+    /** Returns the PlaybackTimeline for this score. It is created the first time it
+        is requested and discarded when a page or a system is added.
+    */
+    PlaybackTimeline* get_playback_timeline();
+    void invalidate_playback_timeline();
+
+    //info about systems, for incremental layout
+    inline void add_system_info(const SystemLayoutInfo& info) { m_systems.push_back(info); }
+    inline std::vector<SystemLayoutInfo>& get_systems_info() { return m_systems; }
+
+    /** Records that the content of measures [first, last] (0 based) has been modified
+        and that, in next layout, the systems containing them must be engraved again.
+        Successive calls accumulate the range.
+    */
+    void mark_measures_as_dirty(int first, int last);
+    inline bool has_dirty_measures() { return m_firstDirtyMeasure >= 0; }
+    inline int get_first_dirty_measure() { return m_firstDirtyMeasure; }
+    inline int get_last_dirty_measure() { return m_lastDirtyMeasure; }
+
 };
 ///@endcond
 
@@ -494,6 +544,8 @@ class GmoBox : public GmoObj
 protected:
     std::vector<GmoBox*> m_childBoxes;
 	std::list<GmoShape*> m_shapes;		    //contained shapes
+    URect m_subtreeBounds;                  //union of bounds of this box, its shapes
+                                            //and all its descendants
 
     // All boxes have four margins (top, bottom, left and right) around the
     // box area (bounds rectangle). The margins define a smaller rectangle
@@ -515,6 +567,7 @@ public:
     //child boxes
     inline int get_num_boxes() { return static_cast<int>( m_childBoxes.size() ); }
     void add_child_box(GmoBox* child);
+    void remove_child_box(GmoBox* child);
     GmoBox* get_child_box(int i);  //i = 0..n-1
     inline std::vector<GmoBox*>& get_child_boxes() { return m_childBoxes; }
 
@@ -565,6 +618,11 @@ public:
     //drawing
     virtual void on_draw(Drawer* pDrawer, RenderOptions& opt);
 
+    //viewport culling. Subtree bounds are only valid after invoking
+    //compute_subtree_bounds()
+    URect compute_subtree_bounds();
+    inline URect get_subtree_bounds() { return m_subtreeBounds; }
+
     //hit testing
     GmoBox* find_inner_box_at(LUnits x, LUnits y);
 
@@ -671,12 +729,15 @@ class GmoBoxDocPage : public GmoBox
 protected:
     int m_numPage;      //1..n
     std::list<GmoShape*> m_allShapes;		//contained shapes, ordered by layer and creation order
+    ShapesGrid* m_pShapesGrid;      //spatial index for m_allShapes
+    bool m_fShapesGridValid;
+    bool m_fSubtreeBoundsValid;     //boxes subtree bounds, for viewport culling
 
 public:
     ///@cond INTERNALS
     //excluded from public API. Only for internal use.
     GmoBoxDocPage(ImoObj* pCreatorImo);
-    ~GmoBoxDocPage() override {}
+    ~GmoBoxDocPage() override;
 
 
     //page number
@@ -691,6 +752,16 @@ public:
     GmoShape* get_first_shape_for_layer(int order);
     GmoShape* find_shape_for_object(ImoStaffObj* pSO);
     void store_in_map_imo_shape(GmoShape* pShape);
+    inline std::list<GmoShape*>& get_all_shapes() { return m_allShapes; }
+
+    //spatial index for shapes. It is automatically rebuilt when needed
+    void build_shapes_grid();
+    inline bool is_shapes_grid_valid() { return m_fShapesGridValid; }
+
+    //bounds of all boxes, for viewport culling. They are automatically
+    //recomputed when needed
+    void update_subtree_bounds();
+    inline bool are_subtree_bounds_valid() { return m_fSubtreeBoundsValid; }
 
     //hit testing
     GmoObj* hit_test(LUnits x, LUnits y);
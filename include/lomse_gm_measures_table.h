@@ -43,6 +43,11 @@ public:
     //invoked when a non-middle barline is found
     void finish_measure(int iInstr, GmoShapeBarline* pBarlineShape);
 
+    /** Replaces the barlines for the measures in system @c pBox by those saved in
+        table @c pSrc. Invoked when a system box from a previous layout is reused.
+    */
+    void copy_barlines_from(GmMeasuresTable* pSrc, GmoBoxSystem* pBox);
+
     //info
     int get_num_measures(int iInstr);
     inline int get_num_instruments() { return int(m_instrument.size()); }
@@ -164,6 +164,7 @@ protected:
     VSize  m_viewportSize;
     std::mutex m_viewportMutex;
     bool m_fUpdateGModel = false;
+    bool m_fViewportCulling = true;     //draw only objects in the visible area
 
     //caret and other visual effects
     Caret*              m_pCaret;
@@ -350,6 +351,7 @@ public:
     //graphical model
     GraphicModel* get_graphic_model();
     virtual bool graphic_model_must_be_updated() { return false; }
+    virtual bool supports_lazy_layout() { return false; }
 
     //handlers
     Handler* handlers_hit_test(LUnits x, LUnits y);
@@ -466,7 +468,8 @@ protected:
     void draw_time_grid();
     void generate_paths();
     virtual void collect_page_bounds() = 0;
-    void draw_visible_pages(int minPage, int maxPage);
+    virtual bool viewport_needs_more_pages() { return false; }
+    void draw_visible_pages(list<PageRectangle*>& visibleAreas);
     URect get_page_bounds(int iPage);
     int find_page_at_point(LUnits x, LUnits y);
     bool shift_right_x_to_be_on_page(double* xLeft);
@@ -478,7 +481,6 @@ protected:
     void trimmed_rectangle_to_page_rectangles(list<PageRectangle*>* rectangles,
                                               double xLeft, double yTop,
                                               double xRight, double yBottom);
-    void determine_visible_pages(int* minPage, int* maxPage);
     bool is_valid_viewport();
     void delete_rectangles(list<PageRectangle*>& rectangles);
     void layout_caret();
@@ -574,11 +576,13 @@ public:
     void get_view_size(Pixels* xWidth, Pixels* yHeight) override;
     int get_layout_constrains() override { return k_use_paper_width | k_use_paper_height; }
     bool is_valid_for_this_view(Document* UNUSED(pDoc)) override { return true; }
+    bool supports_lazy_layout() override { return true; }
 
 ///@endcond
 
 protected:
     void collect_page_bounds() override;
+    bool viewport_needs_more_pages() override;
 
 };
 
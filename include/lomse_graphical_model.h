@@ -49,6 +49,7 @@ class SelectionSet;
 class Control;
 class ScoreStub;
 class GmMeasuresTable;
+class PlaybackTimeline;
 
 
 //---------------------------------------------------------------------------------------
@@ -171,6 +172,8 @@ protected:
     map<GmoRef, GmoObj*> m_ctrolToPtr;
     map<ImoId, ScoreStub*> m_scores;
     AreaInfo m_areaInfo;
+    bool m_fLayoutFinished;
+    int m_estimatedPages;
 
 public:
 
@@ -192,6 +195,18 @@ public:
     */
     int get_num_pages();
 
+    /** Returns @false when the document is being laid out page by page (lazy layout)
+        and there are still pages pending to be laid out. In this case, get_num_pages()
+        returns the number of pages already laid out.
+    */
+    inline bool is_layout_finished() { return m_fLayoutFinished; }
+
+    /** Returns the expected number of pages of the rendered document. When the layout
+        is finished it is the number of pages. Otherwise, it is an estimation based
+        on the part of the document already laid out.
+    */
+    int get_estimated_num_pages();
+
     /** Returns the number of systems in the rendered score.
         @param scoreId The Id of the score to which the request is referring.
     */
@@ -210,6 +225,13 @@ public:
     */
     GmMeasuresTable* get_measures_table(ImoId scoreId);
 
+    /** Returns the PlaybackTimeline for the given score. It is a table, sorted by time,
+        with the relation timepos --> page, system and x position, used for visual
+        tracking during playback. It is built the first time it is requested.
+        @param scoreId The Id of the score to which the request is referring.
+    */
+    PlaybackTimeline* get_playback_timeline(ImoId scoreId);
+
     //@}    //information
 
 
@@ -360,10 +382,12 @@ public:
     void store_in_map_imo_shape(ImoObj* pImo, GmoShape* pShape);
     void add_to_map_imo_to_box(GmoBox* child);
     void add_to_map_ref_to_box(GmoBox* pBox);
-    void build_main_boxes_table();
+    void build_main_boxes_table(int iFirstPage=0);
+    void set_layout_state(bool fFinished, int estimatedPages);
 
     //access to objects/information
     GmoObj* get_box_for_control(GmoRef gref);
+    ScoreStub* get_stub_for(ImoId scoreId);
 
     //tests
     void dump_page(int iPage, ostream& outStream);
@@ -371,10 +395,6 @@ public:
 
 	///@endcond
 
-
-protected:
-    ScoreStub* get_stub_for(ImoId scoreId);
-
 };
 
 
@@ -15,6 +15,7 @@
 #include <map>
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 namespace lomse
 {
@@ -35,9 +36,11 @@ protected:
     std::unordered_map<ImoId, Control*> m_idToControl;
     std::unordered_map<ImoId, std::string> m_idToXmlId;
     std::map<std::string, ImoId> m_xmlIdToId;
+    std::vector<ImoId> m_removedIds;    //ids from other IdAssigner, pending to remove
+    ImoId m_lastReservedId;             //end of reserved range, or k_no_imoid if no range
 
 public:
-    IdAssigner() : m_idCounter(k_no_imoid) {}
+    IdAssigner() : m_idCounter(k_no_imoid), m_lastReservedId(k_no_imoid) {}
 
     void reset();
 
@@ -65,7 +68,17 @@ protected:
     void add_control_id(ImoId id, Control* pControl);
     void copy_strings_from(IdAssigner* pIdAssigner);
     void set_counter(ImoId value) { m_idCounter = value; }
+    void set_reserved_range(ImoId lastUsed, ImoId lastReserved) {
+        m_idCounter = lastUsed;
+        m_lastReservedId = lastReserved;
+    }
+    inline bool has_overflowed() const {
+        return m_lastReservedId != k_no_imoid && m_idCounter > m_lastReservedId;
+    }
+    ImoId renumber_ids_out_of_range(ImoId lastUsed);
     void set_control_id(ImoId id, Control* pControl);
+    void remove_id(ImoId id);
+    void move_ids_to(IdAssigner* assigner);
 
 };
 
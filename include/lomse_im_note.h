@@ -68,6 +68,8 @@ protected:
     TimeUnits   m_eventDuration = k_duration_quarter;   //event duration: real duration for playback
     TimeUnits   m_playTime = 0.0;                       //playback time: on-set time for playback
 
+    friend class ImSerializer;
+
 public:
     ImoNoteRest(int objtype) : ImoStaffObj(objtype) { m_nVoice = 1; }
 
@@ -161,6 +163,7 @@ protected:
     bool m_fFullMeasureRest = false;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoRest() : ImoNoteRest(k_imo_rest) {}
 
     friend class GoBackFwdAnalyser;
@@ -217,6 +220,7 @@ protected:
     int     m_computedStem;         //value from ENoteStem
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoNote(int type);
     ImoNote(int step, int octave, int noteType, EAccidentals accidentals=k_no_accidentals,
             int dots=0, int staff=0, int voice=0, int stem=k_stem_default);
@@ -385,6 +389,7 @@ protected:
     TimeUnits m_alignTime;  //to simplify spacing algorithm a pseudo-timepos is assigned
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoGraceNote() : ImoNote(k_imo_note_grace), m_alignTime(0.0) {}
 
 public:
@@ -0,0 +1,61 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_IM_SERIALIZER_H__        //to avoid nested includes
+#define __LOMSE_IM_SERIALIZER_H__
+
+#include "lomse_basic.h"
+
+#include <string>
+
+
+namespace lomse
+{
+
+//forward declarations
+class DocModel;
+class ImoDocument;
+
+
+//---------------------------------------------------------------------------------------
+// ImSerializer: saves the internal model in a compact binary format (a snapshot) and
+// restores it. The snapshot contains all ImoObj objects, with their ids, attributes and
+// relations, so that restoring the model is just creating the objects and copying
+// their members. The ColStaffObjs and ImMeasuresTable tables are not saved: they must
+// be rebuilt after loading, as it is done when the model is cloned.
+//
+// The snapshot is not intended for interchange: it is written in the machine byte order
+// and it is only valid for the lomse version that created it (see k_version).
+class ImSerializer
+{
+protected:
+    std::string m_error;
+
+public:
+    ImSerializer() {}
+
+    ///Snapshot format version. Must be incremented when the saved content changes.
+    enum { k_version = 1 };
+
+    bool save(ImoDocument* pImoDoc, std::string& data);
+    ImoDocument* load(const char* data, size_t size, DocModel* pDocModel);
+
+    inline const std::string& get_error() const { return m_error; }
+    static bool is_snapshot(const char* data, size_t size);
+
+protected:
+    class Writer;
+    class Reader;
+    struct Fields;
+};
+
+
+}   //namespace lomse
+
+#endif    // __LOMSE_IM_SERIALIZER_H__
@@ -60,9 +60,21 @@ namespace lomse
 		<td>When %true, if an score part has pitched notes but the clef is missing,
             the importer will assume a G or an F4 clef, depending on notes pitch
             range.</td></tr>
+	<tr><td>skip_layout</td>		<td>false</td>
+		<td>When %true, the importer ignores the elements that only contain layout
+            hints (\<page-layout\>, \<system-layout\> and \<staff-layout\>)
+            and Lomse default values are used. This saves time when importing big
+            files.</td></tr>
+	<tr><td>analysis_threads</td>		<td>1</td>
+		<td>Number of threads for analysing the \<part\> elements. When greater than
+            one, parts are analysed concurrently and the results are merged in
+            document order, so the document does not depend on the number of threads
+            (but objects ids and the numbers of ties and slurs are not the same
+            than when parts are analysed one by one). Zero means one thread per
+            processor core.</td></tr>
 	</table>
 
-	@see fix_beams(), use_default_clefs()
+	@see fix_beams(), use_default_clefs(), skip_layout(), analysis_threads()
 */
 class MusicXmlOptions
 {
@@ -76,11 +88,15 @@ private:
             MusicXmlOptionsSettings()
                 : m_fFixBeams(true)
                 , m_fDefaultClef(true)
+                , m_fSkipLayout(false)
+                , m_analysisThreads(1)
             {
             }
 
             bool m_fFixBeams;
             bool m_fDefaultClef;
+            bool m_fSkipLayout;
+            int m_analysisThreads;
 
     };
 
@@ -100,6 +116,12 @@ public:
 	/** Returns current setting for the 'use_default_clefs' option.    */
     inline bool use_default_clefs() { return m_settings.m_fDefaultClef; }
 
+	/** Returns current setting for the 'skip_layout' option.    */
+    inline bool skip_layout() { return m_settings.m_fSkipLayout; }
+
+	/** Returns current setting for the 'analysis_threads' option.    */
+    inline int analysis_threads() { return m_settings.m_analysisThreads; }
+
     //setters (only for options that can be changed without rebuilding the object)
     /** Sets the value for 'fix_beams' option. When %true, if beam information is not
         congruent with note type, the importer will fix the beam.    */
@@ -110,6 +132,17 @@ public:
         an F4 clef, depending on notes pitch range.    */
     inline void use_default_clefs(bool value) { m_settings.m_fDefaultClef = value; }
 
+    /** Sets the value for 'skip_layout' option. When %true, the importer ignores
+        the elements that only contain layout hints, such as \<page-layout\> or
+        \<system-layout\>, and Lomse default values are used.    */
+    inline void skip_layout(bool value) { m_settings.m_fSkipLayout = value; }
+
+    /** Sets the value for 'analysis_threads' option: the number of threads for
+        analysing the \<part\> elements concurrently. Value 1 disables concurrent
+        analysis and 0 means one thread per processor core. It has no effect when
+        Lomse is built without threads support.    */
+    inline void analysis_threads(int value) { m_settings.m_analysisThreads = value; }
+
 };
 
 
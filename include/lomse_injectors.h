@@ -18,6 +18,9 @@
 
 
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
 
 namespace lomse
 {
@@ -34,6 +37,7 @@ class MxlCompiler;
 class CompressedMxlCompiler;
 class MnxAnalyser;
 class MnxCompiler;
+class BinaryCompiler;
 class ModelBuilder;
 class Document;
 class LdpFactory;
@@ -82,7 +86,9 @@ protected:
     LomseDoorway* m_pDoorway;
     LomseDoorway* m_pNullDoorway;
     LdpFactory* m_pLdpFactory;
-    FontStorage* m_pFontStorage;
+    std::map<std::thread::id, FontStorage*> m_fontStorages;     //one for each thread
+    std::mutex m_fontStoragesMutex;
+    long m_scopeRef;                //unique number, to validate thread local caches
     FontSelector* m_pFontSelector;
     Metronome* m_pGlobalMetronome;
     EventsDispatcher* m_pDispatcher;
@@ -115,6 +121,7 @@ protected:
     float m_spacingDmin;
     Tenths m_spacingSmin;
     int m_renderSpacingOpts;        //options for spacing and lines breaker algorithm
+    int m_breakerMaxColumns;        //max columns per system in LinesBreakerOptimal
 
 public:
     LibraryScope(ostream& reporter=std::cout, LomseDoorway* pDoorway=nullptr);
@@ -123,7 +130,10 @@ public:
     inline ostream& default_reporter() { return m_reporter; }
     inline LomseDoorway* platform_interface() { return m_pDoorway; }
     LdpFactory* ldp_factory();
+    //FontStorage is not thread safe. Each thread gets its own FontStorage object
     FontStorage* font_storage();
+    void release_thread_font_storage();
+    inline size_t get_num_font_storages() { return m_fontStorages.size(); }  //for tests
     inline std::string& fonts_path() { return m_sFontsPath; }
     EventsDispatcher* get_events_dispatcher();
     FontSelector* get_font_selector();
@@ -192,6 +202,12 @@ public:
         m_renderSpacingOpts = opts;
         m_fUseDbgValues = true;
     }
+    //bounded lookahead for the lines breaker: systems with more than numColumns
+    //columns are not considered. Value 0 (the default) means no limit
+    inline void set_lines_breaker_max_columns(int numColumns) {
+        m_breakerMaxColumns = numColumns;
+    }
+    inline int get_lines_breaker_max_columns() { return m_breakerMaxColumns; }
 
     //global options, for debug and tests
     inline void set_justify_systems(bool value) { m_fJustifySystems = value; }
@@ -262,6 +278,9 @@ public:
                                            XmlParser* pParser);
     static MnxCompiler* inject_MnxCompiler(LibraryScope& libraryScope, Document* pDoc);
 
+    //binary snapshot format
+    static BinaryCompiler* inject_BinaryCompiler(LibraryScope& libraryScope, Document* pDoc);
+
 
     static ModelBuilder* inject_ModelBuilder(DocumentScope& documentScope);
     static Document* inject_Document(LibraryScope& libraryScope,
@@ -85,6 +85,7 @@ public:
     //staves position
     void set_staves_horizontal_position(int iInstr, LUnits x, LUnits width, LUnits indent);
     void set_position_and_width_for_staves(LUnits indent, UPoint org, GmoBoxSystem* pBox);
+    void move_staves_to_origin();
     void set_staves_width(LUnits width);
     void reposition_staves_in_engravers(const vector<LUnits>& yShifts);
 
@@ -35,10 +35,12 @@ class CaretPositioner;
 class DocCommandExecuter;
 class DocCommand;
 class DocCursor;
+class DocLayouter;
 class FragmentMark;
 class GmoObj;
 class GmoBox;
 class GraphicModel;
+class GraphicView;
 class Handler;
 class ImoScore;
 class ImoStaffObj;
@@ -175,6 +177,15 @@ protected:
     //to avoid problems during playback
     bool        m_fViewUpdatesEnabled;
 
+    //incremental layout after executing edition commands
+    bool            m_fIncrementalLayout;       //enabled
+    bool            m_fReuseGraphicModel;       //executing a command that allows it
+    GraphicModel*   m_pPrevGraphicModel;        //previous model, for reusing systems
+
+    //lazy layout: pages are laid out on demand
+    bool            m_fLazyLayout;              //enabled
+    DocLayouter*    m_pLazyLayouter;            //layouter for pending pages, if any
+
     Handler*    m_pCurHandler;  //current handler being dragged, if any
     ImoId       m_idControlledImo;
 
@@ -211,6 +222,20 @@ public:
        k_timing_visual_effects_draw_time, k_timing_total_render_time,
        k_timing_repaint_time, k_timing_max_value, };
 
+    /** Method Interactor#get_render_counters() returns a vector of counters with
+        information about the last rendering of the graphic model. This enum is used as
+        index on that vector for identifying the meaning of each vector element:
+        - <b>k_counter_shapes_drawn = 0</b> - number of shapes drawn.
+        - <b>k_counter_shapes_culled = 1</b> - number of shapes in the visible pages
+            that were not drawn because they are out of the visible area.
+        - <b>k_counter_boxes_culled = 2</b> - number of boxes in the visible pages that
+            were not explored because they are out of the visible area.
+        - <b>k_counter_max_value</b> - Not used as index. This value is for knowing how
+            many items you should expect in the returned vector, for allocating space.
+    */
+    enum ERenderCounter { k_counter_shapes_drawn=0, k_counter_shapes_culled,
+       k_counter_boxes_culled, k_counter_max_value, };
+
 
         //operating modes and related
         /** @name Modes of operation and related    */
@@ -344,6 +369,32 @@ public:
     /** Returns the graphic model object associated to the View of this %Interactor.   */
     GraphicModel* get_graphic_model();
 
+    /** Enables or disables the lazy layout of the document (disabled by default).
+        When enabled, the View is a VerticalBookView and the %Interactor is in
+        read only mode, only the first page is laid out when the graphic model is
+        created, so that it can be displayed sooner. The remaining pages are laid out
+        when the viewport approaches them, when they are requested (e.g. for printing)
+        or when your application invokes layout_more_pages(), e.g. when idle.
+
+        While the layout is not finished, get_num_pages() returns an estimation of
+        the number of pages and the line breaks could differ slightly from those
+        obtained when the whole document is laid out at once.
+
+        @see layout_more_pages(), finish_layout()
+    */
+    inline void enable_lazy_layout(bool value) { m_fLazyLayout = value; }
+
+    /** Lazy layout. Lays out @c numPages more pages, or all the pending pages when
+        @c numPages is 0. Returns @true if there are still pages pending.
+        @see enable_lazy_layout()
+    */
+    bool layout_more_pages(int numPages=1);
+
+    /** Lazy layout. Lays out all the pending pages.
+        @see enable_lazy_layout()
+    */
+    inline void finish_layout() { layout_more_pages(0); }
+
 
     /** Returns the View associated to this %Interactor.    */
     inline View* get_view() { return m_pView; }
@@ -1495,6 +1546,20 @@ public:
     */
     void exec_redo();
 
+    /** Enables or disables the incremental layout of scores after executing an
+        edition command. When enabled (the default), and the command informs about the
+        modified measures, only the systems containing them are engraved again, and
+        the other systems are moved from the previous graphic model. Shapes and
+        spacing are not computed for the columns of the reused systems. When the
+        result would be different from a full layout (e.g. lines breaks or page
+        breaks change), the score is laid out again from scratch.
+
+        See @ref edit-overview
+
+        @see exec_command()
+    */
+    inline void enable_incremental_layout(bool value) { m_fIncrementalLayout = value; }
+
     //edition related info
     /** Returns @true if there are commands in the undo queue.
 
@@ -1674,6 +1739,16 @@ public:
     */
     inline double* get_elapsed_times() { return &m_elapsedTimes[0]; }
 
+    /** Returns a vector of counters with information about the last rendering of the
+        graphic model: the number of shapes drawn and the number of shapes and boxes
+        skipped because they are out of the visible area of the view. As with
+        get_elapsed_times(), the counters are reset when a new rendering starts.
+
+        Enum Interactor::ERenderCounter is used as index on the returned vector
+        for identifying the meaning of each vector element.
+    */
+    inline int* get_render_counters() { return &m_renderCounters[0]; }
+
     //@}    //for performance measurements
 
 
@@ -1753,6 +1828,7 @@ public:
     void timing_graphic_model_render_end();
     void timing_visual_effects_start();
     void timing_renderization_end();
+    void set_render_counters(int shapesDrawn, int shapesCulled, int boxesCulled);
 
     //interface to SelectionSet
     virtual void select_object(GmoObj* pGmo, bool fClearSelection=true);
@@ -1792,6 +1868,7 @@ protected:
 
     //for performance measurements
     double m_elapsedTimes[k_timing_max_value];
+    int m_renderCounters[k_counter_max_value];
     ptime m_renderStartTime;
     ptime m_visualEffectsStartTime;
     ptime m_repaintStartTime;
@@ -1799,6 +1876,11 @@ protected:
 
     void create_graphic_model();
     void delete_graphic_model();
+    void save_graphic_model_for_reuse();
+    void detach_graphic_model();
+    void delete_lazy_layouter();
+    bool must_use_lazy_layout(GraphicView* pView, Document* pDoc);
+    void layout_pages_up_to(int page);
     bool graphic_model_must_be_updated();
     void request_window_update();
     VRect get_damaged_rectangle();
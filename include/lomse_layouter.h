@@ -62,11 +62,16 @@ public:
         k_layout_not_finished = 0,
         k_layout_success,
         k_layout_failed_auto_scale,        //auto-scaling applied. Need to re-layout
+        k_layout_paused,                   //lazy layout: pages limit reached
+        k_layout_failed_reuse,             //incremental layout not possible. Need to
+                                           //re-layout without the previous model
     };
 
     virtual void layout_in_box() = 0;
     virtual void prepare_to_start_layout() { m_result = k_layout_not_finished; }
-    virtual bool is_item_layouted() { return m_result != k_layout_not_finished; }
+    virtual bool is_item_layouted() {
+        return m_result != k_layout_not_finished && m_result != k_layout_paused;
+    }
     virtual void set_layout_result(int value) { m_result = value; }
     virtual int get_layout_result() { return m_result; }
     virtual void create_main_box(GmoBox* pParentBox, UPoint pos, LUnits width,
@@ -74,6 +79,19 @@ public:
     virtual void save_score_layouter(Layouter* pLayouter) {
         m_pParentLayouter->save_score_layouter(pLayouter);
     }
+    virtual GraphicModel* get_previous_graphic_model() {
+        return (m_pParentLayouter ? m_pParentLayouter->get_previous_graphic_model()
+                                  : nullptr);
+    }
+    virtual bool is_lazy_layout() {
+        return (m_pParentLayouter ? m_pParentLayouter->is_lazy_layout() : false);
+    }
+
+    //lazy layout. Only layouters able to continue a paused layout (by overriding
+    //resume_layout_in_box()) should forward must_pause_layout() to its parent.
+    virtual bool must_pause_layout() { return false; }
+    virtual void resume_layout_in_box() {}
+
     inline void set_constrains(int constrains) { m_constrains = constrains; }
 
     inline GraphicModel* get_graphic_model() { return m_pGModel; }
@@ -91,6 +109,8 @@ protected:
 
     Layouter* create_layouter(ImoContentObj* pItem, int constrains=0);
     int layout_item(ImoContentObj* pItem, GmoBox* pParentBox, int constrains);
+    int layout_current_item();
+    int resume_item_layout();
 
     void set_cursor_and_available_space();
 
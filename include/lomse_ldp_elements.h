@@ -10,8 +10,10 @@
 #ifndef __LOMSE_LDP_ELEMENTS_H__        //to avoid nested includes
 #define __LOMSE_LDP_ELEMENTS_H__
 
-#include <vector>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <vector>
 
 #include "lomse_build_options.h"
 #include "lomse_tree.h"
@@ -259,6 +261,33 @@ class LdpElement;
 class ImoObj;
 typedef std::shared_ptr<LdpElement>    SpLdpElement;
 
+//---------------------------------------------------------------------------------------
+// LdpArena: a monotonic memory pool for the LdpElements created by the LdpParser.
+//
+// Memory is taken from big blocks and it is never reused. The arena is reference
+// counted: its creator holds a reference and each element allocated in the arena
+// holds another one. The blocks are freed when the last reference is released, so
+// trees are deleted as always, by deleting its root element.
+//---------------------------------------------------------------------------------------
+class LdpArena
+{
+protected:
+    std::vector<char*> m_blocks;
+    char* m_pFree;              //next free byte in current block
+    size_t m_available;         //free bytes in current block
+    std::atomic<int> m_numRefs;
+
+public:
+    LdpArena();
+
+    void* allocate(size_t size);
+    inline void add_ref() { ++m_numRefs; }
+    void release();
+
+protected:
+    ~LdpArena();
+};
+
 //---------------------------------------------------------------------------------------
 // A generic LDP element representation.
 //
@@ -276,7 +305,7 @@ class LdpElement : public Visitable,
 {
 protected:
 	ELdpElement m_type;     // the element type
-	std::string	m_name;     // for composite: element name
+	const std::string* m_pName;     // for composite: element name, owned by LdpFactory
 	std::string m_value;    // for simple: the element value
     bool m_fSimple;         // true for simple elements
     int m_numLine;          // file line in whicht the elemnt starts or 0
@@ -288,6 +317,12 @@ protected:
 public:
     ~LdpElement() override;
 
+    //memory management: elements are allocated either in the heap or in an LdpArena
+    static void* operator new(size_t size);
+    static void* operator new(size_t size, LdpArena* pArena);
+    static void operator delete(void* p);
+    static void operator delete(void* p, LdpArena* pArena);
+
     //overrides to Visitable class members
 	virtual void accept_visitor(BaseVisitor& v) override;
 
@@ -295,8 +330,8 @@ public:
 	inline void set_value(const std::string& value) { m_value = value; }
     inline const std::string& get_value() { return m_value; }
     float get_value_as_float();
-    inline void set_name(const std::string& name) { m_name = name; }
-	inline const std::string& get_name() { return m_name; }
+    inline void set_name(const std::string* pName) { m_pName = pName; }
+	inline const std::string& get_name() { return *m_pName; }
 	inline ELdpElement get_type() { return m_type; }
     inline void set_num_line(int numLine) { m_numLine = numLine; }
     inline int get_line_number() { return m_numLine; }
@@ -340,8 +375,13 @@ class LdpObject : public LdpElement
 
 	public:
         //! static constructor to be used by Factory
-		static LdpElement* new_ldp_object()
-			{ LdpObject<type>* o = LOMSE_NEW LdpObject<type>; assert(o!=nullptr); return o; }
+		static LdpElement* new_ldp_object(LdpArena* pArena=nullptr)
+        {
+            LdpObject<type>* o = (pArena ? new (pArena) LdpObject<type>
+                                         : LOMSE_NEW LdpObject<type>);
+            assert(o!=nullptr);
+            return o;
+        }
 
         //! implementation of Visitable interface
         void accept_visitor(BaseVisitor& v) override {
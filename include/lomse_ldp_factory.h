@@ -12,6 +12,8 @@
 
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 #include "lomse_build_options.h"
 #include "lomse_functor.h"
@@ -29,17 +31,26 @@ class LdpFunctor;
 class LOMSE_EXPORT LdpFactory
 {
 protected:
-	std::map<std::string, LdpFunctor*> m_NameToFunctor;
+    typedef std::unordered_map<std::string, LdpFunctor*> NameToFunctorMap;
+
+	NameToFunctorMap m_NameToFunctor;
 	std::map<ELdpElement, std::string>	m_TypeToName;
 
+    //for each element type, its entry in m_NameToFunctor or nullptr if not valid.
+    //The names in m_NameToFunctor are shared by all the created elements
+    std::vector<const NameToFunctorMap::value_type*> m_TypeToEntry;
+
 public:
     LdpFactory();
 	virtual ~LdpFactory();
 
-	LdpElement* create(const std::string& name, int numLine=0) const;
-	LdpElement* create(ELdpElement type, int numLine=0) const;
+    //elements are created in the heap or, when an arena is provided, in the arena
+	LdpElement* create(const std::string& name, int numLine=0,
+                       LdpArena* pArena=nullptr) const;
+	LdpElement* create(ELdpElement type, int numLine=0, LdpArena* pArena=nullptr) const;
 
     const std::string& get_name(ELdpElement type) const;
+    ELdpElement get_type(const std::string& name) const;
 
     //utility methods
     LdpElement* new_element(ELdpElement type, LdpElement* value, int UNUSED(numLine) =0)
@@ -49,24 +60,28 @@ public:
 	    return elm;
     }
 
-    LdpElement* new_value(ELdpElement type, const std::string& value, int numLine=0)
+    LdpElement* new_value(ELdpElement type, const std::string& value, int numLine=0,
+                          LdpArena* pArena=nullptr)
     {
-	    LdpElement* elm = create(type, numLine);
+	    LdpElement* elm = create(type, numLine, pArena);
         elm->set_simple();
 	    elm->set_value(value);
 	    return elm;
     }
 
-    LdpElement* new_label(const std::string& value, int numLine=0) {
-        return new_value(k_label, value, numLine);
+    LdpElement* new_label(const std::string& value, int numLine=0,
+                          LdpArena* pArena=nullptr) {
+        return new_value(k_label, value, numLine, pArena);
     }
 
-    LdpElement* new_string(const std::string& value, int numLine=0) {
-        return new_value(k_string, value, numLine);
+    LdpElement* new_string(const std::string& value, int numLine=0,
+                           LdpArena* pArena=nullptr) {
+        return new_value(k_string, value, numLine, pArena);
     }
 
-    LdpElement* new_number(const std::string& value, int numLine=0) {
-        return new_value(k_number, value, numLine);
+    LdpElement* new_number(const std::string& value, int numLine=0,
+                           LdpArena* pArena=nullptr) {
+        return new_value(k_number, value, numLine, pArena);
     }
 
 };
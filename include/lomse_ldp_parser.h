@@ -87,6 +87,7 @@ protected:
     EParsingState   m_state;            // current automata state
     std::stack<pair<EParsingState, LdpElement*> >  m_stack;    // To save current automata state and node
     LdpElement*     m_curNode;             //node in process
+    LdpArena*       m_pArena;              //memory for the nodes of the tree in process
 
     // parsing control, options and error variables
 //    bool            m_fDebugMode;
@@ -292,11 +292,7 @@ public:
         if (node->type() == pugi::node_pcdata)
             return k_string;
 
-        string name = node->name();
-        LdpElement* elm = m_pLdpFactory->create(name, 0);
-        ELdpElement type = elm->get_type();
-        delete elm;
-        return type;
+        return m_pLdpFactory->get_type( node->name() );
     }
 
     //-----------------------------------------------------------------------------------
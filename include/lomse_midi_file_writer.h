@@ -0,0 +1,99 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_MIDI_FILE_WRITER_H__        //to avoid nested includes
+#define __LOMSE_MIDI_FILE_WRITER_H__
+
+#include "lomse_basic.h"
+
+#include <string>
+#include <vector>
+
+///@cond INTERNALS
+namespace lomse
+{
+///@endcond
+
+//forward declarations
+class ImoScore;
+class SoundEventsTable;
+
+
+//----------------------------------------------------------------------------------
+/** %MidiFileWriter renders a score as a Standard MIDI File (SMF), type 1. The file
+    is generated from the score SoundEventsTable, without playing it, so rendering
+    takes only the time needed for traversing the table. Example:
+
+    @code
+        MidiFileWriter writer;
+        writer.set_tempo(90.0);
+        if (!writer.save_to_file(pScore, "score.mid"))
+            cout << writer.get_error() << endl;
+    @endcode
+
+    Events are rendered in playback order, as ScorePlayer does: repetitions, volta
+    brackets and other jumps are executed, and transposed instruments sound at the
+    transposed pitch. The file contains a first track with the tempo map and the
+    time signatures, followed by a track for each instrument. Time resolution is
+    64 ticks per quarter note, the lomse duration of a quarter note, so that no
+    rounding is needed.
+
+    The initial tempo is the one set by set_tempo() and it is replaced by the tempo
+    changes found in the score (e.g. MusicXML @c \<sound tempo="..."/>).
+*/
+class MidiFileWriter
+{
+protected:
+    double m_bpm;           //initial tempo, quarter notes per minute
+    std::string m_error;
+    std::vector<std::string> m_tracks;
+    std::vector<long> m_lastTime;       //for each track, time of last event (ticks)
+    long m_timeSignatureTime;           //time of last time signature (ticks)
+    std::string m_timeSignature;        //last time signature meta event
+
+public:
+    /** Constructor */
+    MidiFileWriter();
+    /** Destructor */
+    virtual ~MidiFileWriter() {}
+
+    /** Set the initial tempo, in quarter notes per minute. Default value is 60.
+    */
+    inline void set_tempo(double bpm) { m_bpm = (bpm > 0.0 ? bpm : 60.0); }
+
+    /** Returns the content of the MIDI file for the score, or an empty string if
+        the score can not be rendered. See get_error().
+        @param pScore  The score to render.
+    */
+    std::string get_source(ImoScore* pScore);
+
+    /** Saves the MIDI file for the score. Returns @FALSE if the score can not be
+        rendered or in case of file error. See get_error().
+        @param pScore  The score to render.
+        @param filename  The file to create.
+    */
+    bool save_to_file(ImoScore* pScore, const std::string& filename);
+
+    /** Returns the reason of the last failure.
+    */
+    inline const std::string& get_error() const { return m_error; }
+
+protected:
+    bool render_events(ImoScore* pScore, SoundEventsTable* pTable);
+    void add_event(int iTrack, long time, const unsigned char* data, size_t size);
+    void add_tempo(long time, int tempo);
+    void add_time_signature(long time, int topNumber, int beatDuration, int numPulses);
+    std::string assemble_file();
+
+};
+
+
+}   //namespace lomse
+
+#endif    // __LOMSE_MIDI_FILE_WRITER_H__
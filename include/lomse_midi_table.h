@@ -150,6 +150,8 @@ public:
         k_visual_off,           //remove visual highlight. No effect on sound
         k_rhythm_change,        //change in rhythm (time signature)
         k_jump,                 //jump in playback (repetition mark, volta bracket,...)
+        k_tempo_change,         //new tempo. After k_jump, so that it is not applied
+                                //when jumping back from the end of previous measure
         k_note_on,              //sound on
         k_visual_on,            //add visual highlight. No effect on sound
         k_end_of_score,         //end of table
@@ -162,6 +164,7 @@ public:
         int     NotePitch;      //k_note_xxx: MIDI pitch
         int     Instrument;     //k_prog_instr: MIDI instrument
         int     TopNumber;      //k_rhythm_change: top number of TS
+        int     Tempo;          //k_tempo_change: microseconds per quarter note
     };
     union {
         int     NoteStep;       //k_note_xxx: Note step 0..6 : 0-Do, ... 6-Si
@@ -241,6 +244,7 @@ protected:
     int find_measure_for_label(const string& label);
     void add_noterest_events(StaffObjsCursor& cursor, int measure);
     void add_rythm_change(int measure, ImoTimeSignature* pTS);
+    void add_tempo_change(StaffObjsCursor& cursor, int measure, float bpm);
     void add_jump(StaffObjsCursor& cursor, int measure, JumpEntry* pJump);
     void delete_events_table();
     void delete_jumps_table();
@@ -48,10 +48,21 @@ public:
 
     ImoDocument* build_model(ImoDocument* pImoDoc);
     void structurize(ImoObj* pImo);
+    void structurize_changes(ImoScore* pScore);
 
     ImoDocument* fix_cloned_model(ImoDocument* pImoDoc);
     void fix_model(ImoObj* pImo);
 
+    //consistency check, for tests: structurizes the whole score and compares the
+    //result with the current structures. Differences are reported.
+    bool check_structure(ImoScore* pScore, std::ostream& reporter);
+
+    void clear_modified_flags(ImoScore* pScore);
+
+protected:
+    bool find_modified_instruments(ImoScore* pScore, std::vector<bool>* pInstrs);
+    std::string dump_structure(ImoScore* pScore);
+
 };
 
 //---------------------------------------------------------------------------------------
@@ -68,7 +79,7 @@ public:
     PitchAssigner() {}
     virtual ~PitchAssigner() {}
 
-    void assign_pitch(ImoScore* pScore);
+    void assign_pitch(ImoScore* pScore, const std::vector<bool>* pInstrs=nullptr);
 
 protected:
     void reset_accidentals(ImoKeySignature* pKey, int idx);
@@ -147,7 +158,7 @@ public:
     MeasuresTableBuilder() {}
     virtual ~MeasuresTableBuilder() {}
 
-	void build(ImoScore* pScore);
+	void build(ImoScore* pScore, const std::vector<bool>* pInstrs=nullptr);
 
 protected:
 
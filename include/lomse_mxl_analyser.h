@@ -11,6 +11,7 @@
 #define __LOMSE_MXL_ANALYSER_H__
 
 #include <list>
+#include <set>
 #include "lomse_xml_parser.h"
 #include "lomse_analyser.h"
 #include "lomse_ldp_elements.h"
@@ -330,6 +331,8 @@ protected:
     //analysis input
     XmlNode* m_pTree;
     std::string m_fileLocator;
+    bool m_fSkipLayout = false;     //ignore elements with only layout hints
+    ImoId m_dbgIdsPerPart = 0;      //for unit tests: ids range for each part, if not 0
 
     // information maintained in MxlAnalyser
     ImoScore*       m_pCurScore;        //the score under construction
@@ -370,12 +373,18 @@ protected:
 //    int m_nShowTupletBracket;
 //    int m_nShowTupletNumber;
 
-    //conversion from xml element name to int
-    std::map<std::string, int> m_NameToEnum;
+    //pool of element analysers for reuse, one list per tag
+    std::vector< std::vector<MxlElementAnalyser*> > m_analysers;
+
+    //concurrent analysis of <part> elements
+    MxlAnalyser* m_pParent = nullptr;   //score analyser, when this one analyses a part
+    std::vector< std::pair<ImoInstrument*, LUnits> > m_pendingLyricsSpace;  //for next instrument
+    std::set<ImoInstrument*> m_marginReplaced;  //instruments with first staff margin replaced
 
 public:
     MxlAnalyser(ostream& reporter, LibraryScope& libraryScope, Document* pDoc,
                 XmlParser* parser);
+    MxlAnalyser(MxlAnalyser* pParent, ostream& reporter);
     virtual ~MxlAnalyser();
 
     //access to results
@@ -395,10 +404,14 @@ public:
     }
     void add_all_instruments(ImoScore* pScore) { m_partList.add_all_instruments(pScore); }
     bool mark_part_as_added(const std::string& id) {
-        return m_partList.mark_part_as_added(id);
+        return (m_pParent ? false : m_partList.mark_part_as_added(id));
     }
     void check_if_missing_parts() { m_partList.check_if_missing_parts(m_reporter); }
 
+    //concurrent analysis of <part> elements
+    bool analyse_parts_concurrently(std::vector<XmlNode>& parts, ImoScore* pScore);
+    void add_pending_space_for_lyrics();
+
     //part-group
     ImoInstrGroup* start_part_group(int number);
     void terminate_part_group(int number);
@@ -408,7 +421,9 @@ public:
     //global info: setters, getters and checkers
     int set_musicxml_version(const std::string& version);
     inline int get_musicxml_version() { return m_musicxmlVersion; }
-    ImoInstrument* get_instrument(const std::string& id) { return m_partList.get_instrument(id); }
+    ImoInstrument* get_instrument(const std::string& id) {
+        return (m_pParent ? m_pParent->get_instrument(id) : m_partList.get_instrument(id));
+    }
 
     //timepos management
     void increment_time(int voice, int staff, long amount) { m_timeKeeper.increment_time(voice, staff, amount); }
@@ -489,6 +504,9 @@ public:
     void save_staff_distance(int iStaff, LUnits distance);
     LUnits get_staff_distance(int iStaff);
     bool staff_distance_is_imported(int iStaff);
+    inline void first_staff_margin_replaced(ImoInstrument* pInstr) {
+        m_marginReplaced.insert(pInstr);
+    }
     void clear_staff_distances();
 
 
@@ -582,15 +600,24 @@ public:
 
 
     int name_to_enum(const std::string& name) const;
+    int name_to_enum(const char* name) const;
     bool to_integer(const std::string& text, int* pResult);
 
     //debug, for unit tests
     void dbg_do_not_reset_voice_times() { m_timeKeeper.dbg_do_not_reset_voice_times(); }
+    void dbg_ids_per_part(ImoId numIds) { m_dbgIdsPerPart = numIds; }
 
 protected:
-    MxlElementAnalyser* new_analyser(const std::string& name, ImoObj* pAnchor=nullptr);
+    MxlElementAnalyser* new_analyser(int tag, const char* name, ImoObj* pAnchor,
+                                     void* pMem=nullptr);
+    template <class T> MxlElementAnalyser* create_analyser(void* pMem, ImoObj* pAnchor);
+    MxlElementAnalyser* get_analyser(int tag, const char* name, ImoObj* pAnchor);
+    void release_analyser(int tag, MxlElementAnalyser* a);
+    void delete_analysers();
+    void create_relation_builders();
     void delete_relation_builders();
     void add_marging_space_for_lyrics(ImoNote* pNote, ImoLyric* pLyric);
+    void reserve_space_for_lyrics_in_next_instrument(ImoInstrument* pInstr, LUnits space);
     void add_pending_staffobjs(int voice);
 };
 
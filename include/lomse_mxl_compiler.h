@@ -45,6 +45,7 @@ public:
     ImoDocument* compile_file(const std::string& filename) override;
     ImoDocument* compile_string(const std::string& source) override;
     ImoDocument* compile_buffer(const void* buffer, size_t size);
+    ImoDocument* compile_buffer(std::vector<unsigned char>&& buffer);
 
 protected:
     ImoDocument* compile_parsed_tree(XmlNode* root);
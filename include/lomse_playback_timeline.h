@@ -0,0 +1,116 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_PLAYBACK_TIMELINE_H__
+#define __LOMSE_PLAYBACK_TIMELINE_H__
+
+#include "lomse_basic.h"
+#include "lomse_timegrid_table.h"
+
+#include <vector>
+
+namespace lomse
+{
+
+//forward declarations
+class GmoBoxScorePage;
+class GmoBoxSystem;
+
+//---------------------------------------------------------------------------------------
+/** %PlaybackTimeline is a flat table, sorted by time, with the relation
+    timepos --> page, system, x position and vertical range of the system, for all
+    the systems of a score.
+
+    It is built from the TimeGridTable of each system the first time it is needed,
+    and it is used during playback for placing the tempo line and for deciding when
+    to scroll. All lookups are done by binary search. For timepos between two
+    entries, the x position is interpolated.
+
+    The timeline is owned by the ScoreStub and it is discarded when a page or a
+    system is added to the score graphic model.
+*/
+class PlaybackTimeline
+{
+public:
+    /** Information about one system in the timeline */
+    struct SystemEntry
+    {
+        GmoBoxSystem* pSystem;
+        int iPage;              //score page (0..n-1) containing the system
+        LUnits yTop;            //system vertical range
+        LUnits yBottom;
+        TimeUnits startTime;
+        TimeUnits endTime;
+        int iFirst;             //system entries in the table: [iFirst, iEnd)
+        int iEnd;
+    };
+
+    /** Result of locating a timepos */
+    struct Position
+    {
+        GmoBoxSystem* pSystem;
+        int iPage;
+        LUnits x;
+        LUnits yTop;
+        LUnits yBottom;
+
+        Position()
+            : pSystem(nullptr), iPage(0), x(0.0f), yTop(0.0f), yBottom(0.0f)
+        {
+        }
+    };
+
+protected:
+    std::vector<TimeGridTableEntry> m_entries;   //entries for all systems, in time order
+    std::vector<SystemEntry> m_systems;
+
+public:
+    PlaybackTimeline(std::vector<GmoBoxScorePage*>& pages);
+    ~PlaybackTimeline() {}
+
+    //info
+    inline int get_num_systems() { return int(m_systems.size()); }
+    inline int get_num_entries() { return int(m_entries.size()); }
+    inline SystemEntry& get_system_entry(int i) { return m_systems[i]; }
+
+    /** Returns the index of the SystemEntry for the system containing the
+        specified timepos, or -1 if no system contains it. As
+        GraphicModel::get_system_for(), this method gives preference to the system
+        containing a note/rest at the given timepos instead of non-timed staff objects.
+        @param timepos The time position (absolute time units).
+    */
+    int find_system(TimeUnits timepos);
+
+    /** Returns pointer to the GmoBoxSystem containing the specified timepos, or
+        @nullptr if no system contains it.
+        @param timepos The time position (absolute time units).
+    */
+    GmoBoxSystem* get_system_for(TimeUnits timepos);
+
+    /** Returns the x position for the notes/rests at the given timepos, in the system
+        with index @c iSystem. See TimeGridTable::get_x_for_note_rest_at_time().
+    */
+    LUnits get_x_for_note_rest_at_time(int iSystem, TimeUnits timepos);
+
+    /** Locates the system, page, x position and system vertical range for the given
+        timepos. Returns @false if no system contains the timepos.
+        @param timepos The time position (absolute time units).
+        @param pPos The structure to receive the data.
+    */
+    bool locate(TimeUnits timepos, Position* pPos);
+
+protected:
+    void add_system(GmoBoxSystem* pSystem);
+
+};
+
+
+}   //namespace lomse
+
+#endif      //__LOMSE_PLAYBACK_TIMELINE_H__
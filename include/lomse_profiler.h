@@ -0,0 +1,122 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_PROFILER_H__
+#define __LOMSE_PROFILER_H__
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace lomse
+{
+
+//---------------------------------------------------------------------------------------
+// ProfilerPhase: the timing for one execution of a phase. Times are in microseconds,
+// measured from the moment the profiler was created or cleared.
+struct ProfilerPhase
+{
+    std::string name;
+    int thread;         //0 for the first thread that recorded a phase, 1 next, ...
+    int depth;          //nesting level: 0 for outer phases
+    double start;
+    double duration;
+};
+
+//---------------------------------------------------------------------------------------
+// PhaseProfiler: collects the timings of the phases of an operation, such as opening
+// a document (parsing, analysis, model building, ...) or doing the layout.
+//
+// Phases are measured by ProfilerScope objects, that only record the time when a
+// profiler has been activated in the current thread (see ProfilerActivation).
+// Therefore, there is no overhead, other than checking for an active profiler, when
+// not profiling. The profiler can be shared by several threads.
+class PhaseProfiler
+{
+protected:
+    mutable std::mutex m_mutex;
+    std::chrono::steady_clock::time_point m_start;
+    std::vector<ProfilerPhase> m_phases;
+    std::vector<std::thread::id> m_threads;
+
+public:
+    PhaseProfiler();
+
+    void clear();
+    void add_phase(const char* name, int depth,
+                   std::chrono::steady_clock::time_point start,
+                   std::chrono::steady_clock::time_point end);
+
+    //access to results
+    std::vector<ProfilerPhase> get_phases() const;
+    double get_total_time(const std::string& name) const;  //in milliseconds
+    int get_count(const std::string& name) const;
+
+    //export
+    std::string to_json() const;
+    std::string to_chrome_trace() const;
+
+    //the profiler active in current thread or nullptr if none
+    static PhaseProfiler* current();
+
+protected:
+    friend class ProfilerActivation;
+    friend class ProfilerScope;
+    int get_thread_index();
+    static void set_current(PhaseProfiler* pProfiler);
+    static int enter_scope();
+    static void exit_scope();
+};
+
+//---------------------------------------------------------------------------------------
+// ProfilerActivation: activates a profiler in current thread while the object exists.
+// Passing nullptr leaves the current profiler, if any, active.
+class ProfilerActivation
+{
+protected:
+    PhaseProfiler* m_pPrevious;
+    bool m_fActivated;
+
+public:
+    explicit ProfilerActivation(PhaseProfiler* pProfiler);
+    ~ProfilerActivation();
+
+private:
+    ProfilerActivation(const ProfilerActivation&);
+    ProfilerActivation& operator=(const ProfilerActivation&);
+};
+
+//---------------------------------------------------------------------------------------
+// ProfilerScope: measures a phase, from its creation to its destruction, and adds it
+// to the profiler active in current thread. The name must be a literal or a string
+// that lives longer than the scope.
+class ProfilerScope
+{
+protected:
+    PhaseProfiler* m_pProfiler;
+    const char* m_name;
+    int m_depth;
+    std::chrono::steady_clock::time_point m_start;
+
+public:
+    explicit ProfilerScope(const char* name);
+    ~ProfilerScope();
+
+private:
+    ProfilerScope(const ProfilerScope&);
+    ProfilerScope& operator=(const ProfilerScope&);
+};
+
+
+}   //namespace lomse
+
+#endif      //__LOMSE_PROFILER_H__
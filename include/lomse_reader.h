@@ -28,6 +28,17 @@ class InputStream;
 // LdpReader: Base class for any provider of LDP source code to be parsed
 class LdpReader
 {
+protected:
+    //When all the source code is in memory, derived classes store it in a contiguous
+    //buffer. Then, the tokenizer reads the chars using the inline buffer_xxx()
+    //methods, instead of invoking a virtual method for each char.
+    const char* m_pBuffer = nullptr;
+    size_t m_bufferSize = 0;
+    size_t m_pos = 0;               //next char to return
+    int m_numLine = 0;              //line for the last returned char
+    bool m_fCountLines = false;
+    bool m_fRepeatingLastChar = false;
+
 public:
     LdpReader() {}
     virtual ~LdpReader() {}
@@ -45,6 +56,29 @@ public:
     // Returns the file locator associated to this reader
     virtual string get_locator() = 0;
 
+    //buffered access. Only valid when is_buffered() is true
+    inline bool is_buffered() const { return m_pBuffer != nullptr; }
+    inline char buffer_get_next_char()
+    {
+        char ch = (m_pos < m_bufferSize ? m_pBuffer[m_pos] : char(EOF));
+        ++m_pos;
+        if (m_fCountLines && !m_fRepeatingLastChar && ch == 0x0a)
+            m_numLine++;
+        m_fRepeatingLastChar = false;
+        return ch;
+    }
+    inline void buffer_repeat_last_char()
+    {
+        if (m_pos > 0)
+            --m_pos;
+        m_fRepeatingLastChar = true;
+    }
+    inline bool buffer_end_of_data() const { return m_pos >= m_bufferSize; }
+    inline int buffer_line_number() const { return m_numLine; }
+
+protected:
+    void set_buffer(const std::string& source, bool fCountLines);
+
 };
 
 
@@ -53,20 +87,19 @@ public:
 class LdpFileReader : public LdpReader
 {
 private:
-    InputStream* m_file;
     const std::string m_locator;
-    int m_numLine;
-    bool m_repeating_last_char;
+    std::string m_source;       //the whole file content
+    bool m_fOpen;
 
 public:
     LdpFileReader(const std::string& locator);
-    ~LdpFileReader() override;
+    ~LdpFileReader() override {}
 
-    char get_next_char() override;
-    void repeat_last_char() override;
-    bool is_ready() override;
-    bool end_of_data() override;
-    int get_line_number() override { return m_numLine; }
+    char get_next_char() override { return buffer_get_next_char(); }
+    void repeat_last_char() override { buffer_repeat_last_char(); }
+    bool is_ready() override { return m_fOpen; }
+    bool end_of_data() override { return buffer_end_of_data(); }
+    int get_line_number() override { return buffer_line_number(); }
     string get_locator() override { return m_locator; }
 
 };
@@ -80,15 +113,15 @@ public:
     LdpTextReader(const std::string& sourceText);
     ~LdpTextReader() override {}
 
-    char get_next_char() override;
-    void repeat_last_char() override;
-    bool is_ready() override;
-    bool end_of_data() override;
+    char get_next_char() override { return buffer_get_next_char(); }
+    void repeat_last_char() override { buffer_repeat_last_char(); }
+    bool is_ready() override { return true; }
+    bool end_of_data() override { return buffer_end_of_data(); }
     int get_line_number() override { return 0; }
     string get_locator() override { return "string:"; }
 
 private:
-    stringstream   m_stream;
+    std::string m_source;
 
 };
 
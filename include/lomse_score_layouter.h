@@ -18,6 +18,7 @@
 #include "lomse_engraver.h"
 #include "lomse_engravers_map.h"
 #include "lomse_spacing_algorithm.h"
+#include "lomse_gm_basic.h"
 
 #include <vector>
 using namespace std;
@@ -180,6 +181,30 @@ protected:
     GmoBoxSystem*       m_pCurBoxSystem;
     GmoBoxSystem*       m_pPrevBoxSystem = nullptr;
 
+    //support for incremental layout: reuse systems from previous graphic model
+    ScoreStub*          m_pPrevStub = nullptr;  //stub for this score in previous model
+    std::vector<bool>   m_reusable;             //for each system, true if can be reused
+    ScoreStub::SystemLayoutInfo m_curSysInfo;   //info about current system
+
+    //a range of columns, in systems expected to be reused, whose shapes are not created
+    struct ReusedColumns
+    {
+        ImoId firstId;          //first staffobj in the first system of the range
+        TimeUnits startTime;    //and its timepos
+        int firstMeasure;       //and its measure
+        int numEngraved;        //first columns, engraved as context for other columns
+        int numReused;          //next columns, not engraved
+    };
+    std::vector<ReusedColumns> m_reusedRanges;  //expected ranges, in score order
+    std::vector<bool>   m_reusedColumns;        //for each column, true if not engraved
+    int                 m_iNextRange = 0;       //next range to find while creating columns
+    int                 m_numToEngrave = 0;     //columns pending in current range
+    int                 m_numToReuse = 0;
+
+    //support for lazy layout: columns are created and spaced in chunks
+    bool                m_fLazyLayout;
+    bool                m_fMoreColumns;     //content pending to split in columns
+
     //support for debug and unit test
     int                 m_iColumnToTrace;
     int                 m_nTraceLevel;
@@ -198,6 +223,7 @@ public:
     SystemLayouter* get_system_layouter(int iSys) { return m_sysLayouters[iSys]; }
     virtual TypeMeasureInfo* get_measure_info_for_column(int iCol);
     virtual GmoShapeBarline* get_start_barline_shape_for_column(int iCol);
+    float get_layout_progress();
 
     //support for helper classes
     virtual LUnits get_target_size_for_system(int iSystem);
@@ -208,6 +234,11 @@ public:
         //invoked when a non-middle barline is found
     void finish_measure(int iInstr, GmoShapeBarline* pBarlineShape);
 
+    //incremental layout: column whose shapes were not created, as it will be reused
+    inline bool is_reused_column(int iCol) {
+        return iCol < int(m_reusedColumns.size()) && m_reusedColumns[iCol];
+    }
+
     //support for debugging and unit tests
     void dump_column_data(int iCol, ostream& outStream=glogger.get_stream());
     void delete_not_used_objects();
@@ -241,7 +272,9 @@ protected:
     bool enough_space_for_empty_system();
     void create_system();
     void add_system_to_page();
-    void decide_line_breaks();
+    bool decide_line_breaks();
+    void decide_more_line_breaks();
+    void delete_not_laid_out_objects();
     void page_initializations(GmoBox* pContainerBox);
     void decide_line_sizes();
     void final_touches();
@@ -273,9 +306,24 @@ protected:
 
     void reposition_system_if_page_has_changed();
     void move_paper_cursor_to_bottom_of_added_system();
+    UPoint determine_system_origin(int iSystem);
+    LUnits determine_system_width(int iSystem);
     LUnits get_first_system_staves_size();
     LUnits get_other_systems_staves_size();
 
+    //---------------------------------------------------------------
+    //incremental layout
+    void find_previous_layout();
+    bool find_dirty_systems(int* iFirstDirty, int* iLastDirty);
+    void decide_columns_to_reuse();
+    void add_reused_columns_range(int iFirstSystem, int iEndSystem);
+    bool decide_if_column_is_reused(ColStaffObjsEntry* pFirstEntry);
+    bool has_reused_columns(int iSystem);
+    bool decide_line_breaks_incrementally();
+    bool can_reuse_system(int iSystem);
+    void reuse_system();
+    void save_current_system_info();
+
     //---------------------------------------------------------------
     LUnits determine_system_top_margin();
     LUnits determine_top_space(int nInstr, bool fFirstSystemInScore=false,
@@ -447,6 +495,11 @@ public:
 
     void decide_line_breaks() override;
 
+    /** Restricts the algorithm to columns [iFirstCol, iEndCol), that will be
+        distributed in systems starting at system @c iFirstSystem. Breaks are
+        appended to the breaks vector. By default, all the score columns are used. */
+    void set_columns_range(int iFirstCol, int iEndCol, int iFirstSystem);
+
     //support for debug and tests
     void dump_entries(ostream& outStream=glogger.get_stream());
 
@@ -460,6 +513,10 @@ protected:
     std::vector<Entry> m_entries;
     int m_numCols;
     bool m_fJustifyLastLine;
+    int m_iFirstCol;            //first column to distribute
+    int m_iEndCol;              //column after last one to distribute, or -1 for all
+    int m_iFirstSystem;         //system number for the first system
+    int m_maxColumns;           //max columns per system, or 0 for no limit
 
     void initialize_entries_table();
     void compute_optimal_break_sequence();
@@ -17,7 +17,10 @@
 
 
 #include <vector>
+#include <deque>
 #include <thread>
+#include <mutex>
+#include <chrono>
 #include <condition_variable>
 
 ///@cond INTERNALS
@@ -34,6 +37,10 @@ class Interactor;
 class LibraryScope;
 class PlayerGui;
 class Metronome;
+class EventVisualTracking;
+
+typedef std::weak_ptr<Interactor>     WpInteractor;
+typedef std::shared_ptr<EventVisualTracking>  SpEventVisualTracking;
 
 //some constants for greater code legibility
 #define k_no_visual_tracking    false
@@ -47,6 +54,38 @@ class Metronome;
 typedef std::thread SoundThread;
 typedef std::condition_variable SoundFlag;
 
+/** Clock used by ScorePlayer for scheduling sound events. It is a monotonic clock,
+    not affected by changes in the system wall clock.
+*/
+typedef std::chrono::steady_clock PlaybackClock;
+
+/** A point in time, in PlaybackClock, at which a sound event has to take place. */
+typedef PlaybackClock::time_point PlaybackTime;
+
+
+//---------------------------------------------------------------------------------------
+/** Timing statistics for the last (or current) playback, as collected by ScorePlayer.
+    The player schedules each event at an absolute deadline. When the playback thread
+    wakes up, the difference between the actual time and the deadline is the
+    lateness for that event. When a lookahead is set (see
+    ScorePlayer::set_lookahead()), events delivered in advance have no lateness.
+    All values are in microseconds.
+*/
+struct PlaybackTimingStats
+{
+    long numEvents;         ///< Number of scheduled wake-ups measured
+    double meanLateness;    ///< Average lateness
+    double maxLateness;     ///< Worst lateness
+    double jitter;          ///< Standard deviation of lateness
+    double drift;           ///< Lateness of the last wake-up. As deadlines are
+                            ///< absolute, this value does not grow with playback time
+
+    PlaybackTimingStats()
+        : numEvents(0L), meanLateness(0.0), maxLateness(0.0), jitter(0.0), drift(0.0)
+    {
+    }
+};
+
 
 //---------------------------------------------------------------------------------------
 /** Class %MidiServerBase is a base class defining the interface for any class
@@ -62,6 +101,15 @@ typedef std::condition_variable SoundFlag;
     implementation is only responsible for generating or stopping sounds when requested,
     and no time computations are needed.
 
+    Note on and note off requests are delivered through the timestamped methods
+    ``note_on_at()`` and ``note_off_at()``. By default these methods just invoke
+    ``note_on()`` and ``note_off()``. If your midi server is able to schedule
+    events (e.g. by using a MIDI API with timestamped output), you can override the
+    timestamped methods and request to ScorePlayer to deliver events in advance, by
+    invoking ScorePlayer::set_lookahead(). In this case your midi server becomes
+    responsible for sending the events at the given time, and ``all_sounds_off()``
+    must also discard any pending event.
+
     Lomse does not impose any restriction about how to generate sounds other than
     low latency. Perhaps, the simpler method to generate sounds is to rely on the MIDI
     synthesizer of the PC sound card.
@@ -111,6 +159,24 @@ public:
     */
     virtual void note_off(int UNUSED(channel), int UNUSED(pitch), int UNUSED(volume)) {}
 
+    /** %Request to generate a 'note on' MIDI message at time @c when. If no
+        lookahead has been set in ScorePlayer, this method is invoked at time @c when.
+        Otherwise it is invoked in advance, up to the lookahead time.
+        Default implementation just invokes note_on().
+    */
+    virtual void note_on_at(PlaybackTime UNUSED(when), int channel, int pitch, int volume)
+    {
+        note_on(channel, pitch, volume);
+    }
+
+    /** %Request to generate a 'note off' MIDI message at time @c when. See
+        note_on_at(). Default implementation just invokes note_off().
+    */
+    virtual void note_off_at(PlaybackTime UNUSED(when), int channel, int pitch, int volume)
+    {
+        note_off(channel, pitch, volume);
+    }
+
     /** %Request to generate an 'All Sound Off' MIDI message for muting all sounding
         notes or to perform an equivalent action if sound is generated by other
         methods.
@@ -164,6 +230,24 @@ protected:
     ImoScore*           m_pScore;       //score to play
     SoundEventsTable*   m_pTable;
     SoundFlag           m_canPlay;      //playback is not paused
+    std::chrono::microseconds m_lookahead;  //time in advance for delivering events
+
+    //timing statistics
+    std::mutex          m_statsMutex;
+    long                m_numWakeUps;
+    double              m_sumLateness;      //microseconds
+    double              m_sumSqLateness;
+    double              m_maxLateness;
+    double              m_lastLateness;
+
+    //pool of visual tracking events, for not allocating a new event in each flush.
+    //Only accessed from the playback thread
+    std::vector<SpEventVisualTracking> m_trackingPool;
+
+    //visual tracking events pending to send, and their deadlines. When sound events
+    //are delivered in advance, visual events wait here for their real time, without
+    //delaying the sound events. Only accessed from the playback thread
+    std::deque< std::pair<PlaybackTime, SpEventVisualTracking> > m_pendingTracking;
 
     //metronome: MIDI parameters
     int m_MtrChannel;
@@ -317,6 +401,28 @@ public:
     */
     inline bool is_playing() { return m_fPlaying; }
 
+    /** Set the time in advance, in microseconds, with which note on and note off
+        events will be delivered to the MidiServerBase. Default value is zero, that
+        is, events are delivered at the time at which they must sound. Setting a
+        lookahead requires a midi server that overrides MidiServerBase::note_on_at()
+        and MidiServerBase::note_off_at() for scheduling the events. The new value
+        is used for the next playback.
+    */
+    inline void set_lookahead(long microseconds) {
+        m_lookahead = std::chrono::microseconds( std::max(0L, microseconds) );
+    }
+
+    /** Returns the time in advance, in microseconds, with which note on and note off
+        events are delivered to the MidiServerBase. See set_lookahead().
+    */
+    inline long get_lookahead() { return long(m_lookahead.count()); }
+
+    /** Returns the timing statistics for the current playback or, if not playing,
+        for the last playback. See PlaybackTimingStats. It can be invoked from any
+        thread.
+    */
+    PlaybackTimingStats get_timing_stats();
+
 
 ///@cond INTERNALS
 //excluded from public API. Only for internal use.
@@ -336,6 +442,13 @@ protected:
                      Interactor* pInteractor);
     void end_of_playback_housekeeping(bool fVisualTracking, Interactor* pInteractor);
     void set_new_beat_information(SoundEvent* pEvent);
+    void reset_timing_stats();
+    void wait_until(PlaybackTime deadline, Interactor* pInteractor);
+    SpEventVisualTracking new_tracking_event(WpInteractor wpInteractor);
+    void schedule_tracking_event(SpEventVisualTracking pEvent, PlaybackTime deadline,
+                                 Interactor* pInteractor);
+    void send_pending_tracking_events(Interactor* pInteractor);
+    void send_tracking_event(SpEventVisualTracking pEvent, Interactor* pInteractor);
 
     //helper, for do_play()
     //-----------------------------------------------------------------------------------
@@ -344,7 +457,7 @@ protected:
     long m_prevGuiBpm;      //last known value of metronome setting in GUI, for detecting
                             // user changes in metronome setting during playback
     long m_nMtrPulseDuration;       //a beat duration, in Time Units
-    float m_conversionFactor;       //to convert TimeUnits (delta time) to millisecs
+    double m_conversionFactor;      //to convert TimeUnits (delta time) to microseconds
 
     //current time signature (TS) info
     long m_nCurMeasureDuration;     //current TS: measure duration, in TU
@@ -358,9 +471,9 @@ protected:
     long m_nPrevMtrIntval;          //previous TS: metronome click interval, in milliseconds
 
 
-    //helper, to conver TimeUnits to milliseconds. Depends on current metronome setting
-    inline long time_units_to_milliseconds(long deltaTime) {
-        return long( float(deltaTime) * m_conversionFactor );
+    //helper, to conver TimeUnits to microseconds. Depends on current metronome setting
+    inline long long time_units_to_microseconds(double deltaTime) {
+        return (long long)( deltaTime * m_conversionFactor );
     }
 
 
@@ -0,0 +1,81 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_SHAPES_GRID_H__
+#define __LOMSE_SHAPES_GRID_H__
+
+#include "lomse_basic.h"
+
+#include <list>
+#include <map>
+#include <vector>
+
+
+namespace lomse
+{
+
+//forward declarations
+class GmoShape;
+class ImoObj;
+
+
+//---------------------------------------------------------------------------------------
+/** %ShapesGrid is a spatial index for the shapes in a GmoBoxDocPage. It is used for
+    speeding up hit testing and rectangle selection in pages with many shapes.
+
+    The page area is divided in a uniform grid of cells and each cell keeps the list
+    of shapes whose bounds intersect the cell. Shapes are identified by their rank
+    in the page list of shapes (ordered by layer and creation order) so that, when
+    several shapes are candidates, the topmost one can be determined without
+    sorting.
+
+    The grid is a snapshot: it must be rebuilt when shapes are added to the page or
+    when their position changes.
+*/
+class ShapesGrid
+{
+protected:
+    std::vector<GmoShape*> m_shapes;        //all shapes, ordered by rank
+    std::vector< std::vector<int> > m_cells; //for each cell, ranks in ascending order
+    std::map<ImoObj*, GmoShape*> m_creators; //creator imo -> first shape in rank order
+    LUnits m_xOrg;
+    LUnits m_yOrg;
+    LUnits m_cellWidth;
+    LUnits m_cellHeight;
+    int m_numCols;
+    int m_numRows;
+
+public:
+    ShapesGrid();
+    virtual ~ShapesGrid() {}
+
+    //creation
+    void build(std::list<GmoShape*>& shapes);
+    void clear();
+
+    //queries
+    GmoShape* find_shape_at(LUnits x, LUnits y);
+    void find_shapes_contained_in(const URect& rect, std::vector<GmoShape*>& found);
+    GmoShape* find_shape_for_object(ImoObj* pImo);
+
+    //info
+    inline int get_num_shapes() const { return int(m_shapes.size()); }
+    inline int get_num_cols() const { return m_numCols; }
+    inline int get_num_rows() const { return m_numRows; }
+
+protected:
+    int col_for(LUnits x) const;
+    int row_for(LUnits y) const;
+
+};
+
+
+}   //namespace lomse
+
+#endif      //__LOMSE_SHAPES_GRID_H__
@@ -99,11 +99,29 @@ public:
     /// spacing algorithm for determining the minimum size for each column.
     virtual void do_spacing_algorithm() = 0;
 
+    ///Optional. Used, instead of previous methods, for laying out the score in chunks
+    ///(lazy layout). Your implementation must split, at least, @c numColumns more
+    ///columns, apply the spacing algorithm to them and return @true if there is more
+    ///content to split. Only the columns reported by get_num_spaced_columns() can be
+    ///used for deciding line breaks. Default implementation splits all the content.
+    virtual bool split_more_content_in_columns(int UNUSED(numColumns)) {
+        split_content_in_columns();
+        do_spacing_algorithm();
+        return false;
+    }
+
     ///Methods for line break will then be invoked
     virtual float determine_penalty_for_line(int iSystem, int i, int j) = 0;
     virtual bool is_better_option(float prevPenalty, float newPenalty, float nextPenalty,
                                   int i, int j) = 0;
 
+    ///Optional. Return @true if line {ci, ..., cj} does not fit in the system even
+    ///at its minimum width. As adding more columns never makes the line fit, the lines
+    ///breaker will not try longer lines starting at column i.
+    virtual bool line_overflows(int UNUSED(iSystem), int UNUSED(i), int UNUSED(j)) {
+        return false;
+    }
+
     ///Finally, if justification is required this method will be invoked
     virtual void justify_system(int iFirstCol, int iLastCol, LUnits uSpaceIncrement) = 0;
 
@@ -112,6 +130,8 @@ public:
 
     ///Return the number of columns in which the content has been split
     virtual int get_num_columns() = 0;
+    ///Return the number of columns [0, n-1] for which spacing is already computed
+    virtual int get_num_spaced_columns() { return get_num_columns(); }
 
     virtual LUnits get_staves_height() = 0;
 
@@ -171,6 +191,8 @@ protected:
                                         //does not starts in this column or it is the
                                         //first measure.
 
+    ColStaffObjsEntry* m_pFirstEntry;   //first staffobj included in this column
+
     int m_nTraceLevel;                  //for debugging
 
     std::vector<GmoBoxSliceInstr*> m_sliceInstrBoxes;   //instr.boxes for this column
@@ -197,6 +219,8 @@ public:
     inline ColStaffObjsEntry* get_prolog_clef(ShapeId idx) { return m_prologClefs[idx]; }
     inline ColStaffObjsEntry* get_prolog_key(ShapeId idx) { return m_prologKeys[idx]; }
     inline ColStaffObjsEntry* get_prolog_time(ShapeId idx) { return m_prologTimes[idx]; }
+    inline void set_first_entry(ColStaffObjsEntry* pEntry) { m_pFirstEntry = pEntry; }
+    inline ColStaffObjsEntry* get_first_entry() { return m_pFirstEntry; }
 
     //boxes and shapes
     void add_shapes_to_boxes(int iCol);
@@ -256,6 +280,7 @@ public:
 
     //collect content
     void split_content_in_columns() override;
+    bool split_more_content_in_columns(int numColumns) override;
     //spacing algorithm
     void do_spacing_algorithm() override;
     //boxes and shapes
@@ -321,6 +346,10 @@ public:
     //spacing algorithm main actions
     ///apply spacing algorithm to all columns
     virtual void do_spacing(int iColumnToTrace) = 0;
+    ///apply spacing algorithm to the columns created since last invocation. When
+    ///@c fAllCreated is @false, columns whose spacing depends on not yet created
+    ///columns must be left pending
+    virtual void do_more_spacing(int iColumnToTrace, bool fAllCreated) = 0;
 
     //auxiliary: shapes and boxes
     ///add shapes for staff objects to graphical model
@@ -407,6 +436,8 @@ public:
 
     void create_columns();
     void do_spacing_algorithm();
+    bool create_more_columns(int numColumns);
+    void do_more_spacing(bool fAllCreated);
     inline LUnits get_staves_height()
     {
         return m_stavesHeight;
@@ -427,8 +458,12 @@ public:
 protected:
     void determine_staves_vertical_position();
 
+    void start_columns_creation();
+    void create_next_column();
     void prepare_for_new_column();
     void collect_content_for_this_column();
+    void include_object_without_shape(ImoStaffObj* pSO, TimeUnits rTime, int iInstr,
+                                      int iStaff);
 
     GmoBoxSlice* create_slice_box();
     void find_and_save_context_info_for_this_column();
@@ -85,6 +85,17 @@ protected:
     float  m_dmin;      //min note duration for which fixed spacing will be used
     float  m_Fopt;      //Optimum force (user defined and dependent on personal taste)
 
+    //accumulated columns data, for computing lines penalties in constant time.
+    //Element i is the sum for columns [0, i)
+    std::vector<double> m_accSlope;
+    std::vector<double> m_accFixed;
+    std::vector<double> m_accMinWidth;
+
+    //spacing by chunks, for lazy layout: columns [0, n-1] already processed
+    bool m_fSpacingStarted;
+    int m_numColsWithRods;
+    int m_numSpacedCols;
+
 public:
     SpAlgGourlay(LibraryScope& libraryScope, ScoreMeter* pScoreMeter,
                  ScoreLayouter* pScoreLyt, ImoScore* pScore,
@@ -95,12 +106,15 @@ public:
 
     //spacing algorithm main actions
     void do_spacing(int iColumnToTrace) override;
+    void do_more_spacing(int iColumnToTrace, bool fAllCreated) override;
+    int get_num_spaced_columns() override { return m_numSpacedCols; }
     void justify_system(int iFirstCol, int iLastCol, LUnits uSpaceIncrement) override;
 
     //for lines break algorithm
     float determine_penalty_for_line(int iSystem, int i, int j) override;
     bool is_better_option(float prevPenalty, float newPenalty, float nextPenalty,
                           int i, int j) override;
+    bool line_overflows(int iSystem, int i, int j) override;
 
     //information about a column
     bool is_empty_column(int iCol) override;
@@ -134,10 +148,12 @@ protected:
     void new_slice(ColStaffObjsEntry* pEntry, int entryType, int iColumn, int iShape);
     void finish_slice(ColStaffObjsEntry* pLastEntry, int numEntries);
     void finish_sequences();
-    void compute_rods_ds_and_di();
-    void fix_neighborhood_spacing_problems(int iColumnToTrace);
-    void compute_springs();
+    void compute_rods_ds_and_di(int iEndCol);
+    void fix_neighborhood_spacing_problems(int iColumnToTrace, int iEndCol);
+    void compute_springs(int iEndCol);
     void determine_spacing_parameters();
+    void accumulate_columns_data(int iEndCol);
+    LUnits determine_line_width(int iSystem);
     bool accept_for_prolog_slice(ColStaffObjsEntry* pEntry);
     int determine_required_slice_type(ImoStaffObj* pSO, bool fInProlog);
     ShapeData* save_info_for_shape(GmoShape* pShape, int iInstr, int iStaff);
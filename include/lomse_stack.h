@@ -127,6 +127,11 @@ public:
         return (it != m_list.end() ? *it : nullptr);
     }
 
+    //sequential access to stack items, from bottom (first pushed) to top
+    typedef typename std::list<T>::iterator iterator;
+    iterator begin() { return m_list.begin(); }
+    iterator end() { return m_list.end(); }
+
 protected:
     void remove_history() {
         typename std::list<T>::iterator it;
@@ -17,6 +17,7 @@
 #include <vector>
 #include <ostream>
 #include <map>
+#include <unordered_map>
 
 namespace lomse
 {
@@ -47,6 +48,8 @@ protected:
     int                 m_instr;
     int                 m_line;
     int                 m_staff;
+    int                 m_pos;      //position in the collection. Only valid while the
+                                    //navigation index is valid
     ImoStaffObj*        m_pImo;
 
     ColStaffObjsEntry*  m_pNext;    //next entry in the collection
@@ -58,6 +61,7 @@ public:
         , m_instr(instr)
         , m_line(line)
         , m_staff(staff)
+        , m_pos(0)
         , m_pImo(pImo)
         , m_pNext(nullptr)
         , m_pPrev(nullptr)
@@ -112,6 +116,18 @@ protected:
 
     ColStaffObjsEntry* m_pFirst;
     ColStaffObjsEntry* m_pLast;
+    ColStaffObjsEntry* m_pLastInserted;     //where to start searching insertion point
+    std::unordered_map<ImoStaffObj*, ColStaffObjsEntry*> m_index;   //staffobj -> entry
+    std::vector< std::vector<ColStaffObjsEntry*> > m_instrEntries;  //entries for each
+                                                //instrument, in creation order
+    std::vector<int> m_firstLine;               //first line for each instrument
+
+    //navigation index: built on first use and discarded when the table is modified
+    bool m_fNavIndexValid;
+    std::vector<ColStaffObjsEntry*> m_entries;              //all entries, in table order
+    std::vector< std::vector<int> > m_instrPositions;       //per instrument, positions
+    std::vector< std::vector<int> > m_barlinePositions;     //of its entries, barlines
+    std::vector< std::vector<int> > m_timeSignaturePositions;   //and time signatures
 
 public:
     ColStaffObjs();
@@ -120,6 +136,7 @@ public:
     //table info
     inline int num_entries() const { return m_numEntries; }
     inline int num_lines() const { return m_numLines; }
+    inline int num_instruments() const { return int(m_firstLine.size()); }
     inline bool is_anacrusis_start() const { return is_greater_time(m_rMissingTime, 0.0); }
     inline TimeUnits anacrusis_missing_time() const { return m_rMissingTime; }
     inline TimeUnits anacrusis_extra_time() const { return m_rAnacrusisExtraTime; }
@@ -204,6 +221,17 @@ public:
     inline ColStaffObjsEntry* front() { return m_pFirst; }
     inline iterator find(ImoStaffObj* pSO) { return iterator(find_entry_for(pSO)); }
 
+    //fast navigation, in O(log n). All methods search entries for instrument iInstr
+    //and return nullptr when not found.
+        //first entry, not before pStart, whose time is not lower than 'time'
+    ColStaffObjsEntry* find_entry_at_time(int iInstr, TimeUnits time,
+                                          ColStaffObjsEntry* pStart=nullptr);
+        //first barline in measure 'measure'
+    ColStaffObjsEntry* find_barline_in_measure(int iInstr, int measure);
+        //last barline / time signature before pEntry (nullptr: before end of table)
+    ColStaffObjsEntry* find_prev_barline(int iInstr, ColStaffObjsEntry* pEntry);
+    ColStaffObjsEntry* find_prev_time_signature(int iInstr, ColStaffObjsEntry* pEntry);
+
     //debug
     std::string dump(bool fWithIds=true);
 
@@ -222,10 +250,23 @@ protected:
     inline void set_min_note(TimeUnits duration) { m_minNoteDuration = duration; }
     void count_noterest(ImoNoteRest* pNR);
     inline void set_divisions(int div) { m_divisions = div; }
+    void reset_noterest_counters();
+
+    //for updating the entries of some instruments
+    void set_first_line(int iInstr, int line);
+    inline int first_line(int iInstr) const { return m_firstLine[iInstr]; }
+    void unlink_entries_from_instrument(int iInstr);
+    void delete_entries_for_instrument(int iInstr);
+    void relink_entries_for_instrument(int iInstr);
 
     void add_entry_to_list(ColStaffObjsEntry* pEntry);
+    ColStaffObjsEntry* find_insertion_search_start(TimeUnits time);
     ColStaffObjsEntry* find_entry_for(ImoStaffObj* pSO);
 
+    void build_nav_index();
+    ColStaffObjsEntry* find_prev_entry_in(const std::vector<int>& positions,
+                                          ColStaffObjsEntry* pEntry);
+
 };
 
 typedef  ColStaffObjs::iterator      ColStaffObjsIterator;
@@ -251,6 +292,7 @@ public:
 
     int get_line_assigned_to(int nVoice, int nStaff);
     void new_instrument();
+    void start_instrument_at_line(int line);
     inline int get_number_of_lines() { return m_lastDefinedLine; }
 
 private:
@@ -273,6 +315,7 @@ public:
     virtual ~ColStaffObjsBuilder() {}
 
     ColStaffObjs* build(ImoScore* pScore);
+    bool update(ImoScore* pScore, const std::vector<bool>& instruments);
 
 protected:
     ColStaffObjsBuilderEngine* create_builder_engine(ImoScore* pScore);
@@ -309,6 +352,7 @@ public:
     ColStaffObjsBuilderEngine& operator= (ColStaffObjsBuilderEngine&&) = delete;
 
     ColStaffObjs* do_build();
+    bool do_update(ColStaffObjs* pColStaffObjs, const std::vector<bool>& instruments);
 
     //debug
     std::string dump_divisions_data() const;
@@ -318,10 +362,12 @@ protected:
     virtual void determine_timepos(ImoStaffObj* pSO)=0;
     virtual void create_entries_for_instrument(int nInstr)=0;
     virtual void prepare_for_next_instrument()=0;
+    virtual void update_min_note_duration(ImoNoteRest* pNR)=0;
 
     void create_table();
     void collect_anacrusis_info();
     void collect_note_rest_info(ImoNoteRest* pNR);
+    void collect_note_rests_info();
     int get_line_for(int nVoice, int nStaff);
     void set_num_lines();
     void add_entries_for_key_or_time_signature(ImoObj* pImo, int nInstr);
@@ -372,6 +418,7 @@ private:
     void determine_timepos(ImoStaffObj* pSO) override;
     void create_entries_for_instrument(int nInstr) override;
     void prepare_for_next_instrument() override;
+    void update_min_note_duration(ImoNoteRest* pNR) override;
 
     //specific
     void reset_counters();
@@ -414,6 +461,7 @@ private:
     void determine_timepos(ImoStaffObj* pSO) override;
     void create_entries_for_instrument(int nInstr) override;
     void prepare_for_next_instrument() override;
+    void update_min_note_duration(ImoNoteRest* pNR) override;
 
     //specific
     void reset_counters();
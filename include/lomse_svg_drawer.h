@@ -40,6 +40,7 @@ private:
     bool                m_fIsSimple = true;     //it is a simple notation
     bool                m_fPathOpen = false;    //open path pending to be closed
     std::unordered_map<std::string, int> m_ids;     //for detecting duplicated id
+    int                 m_idsCounter = 0;   //for creating new ids for duplicated ones
 
 public:
     SvgDrawer(LibraryScope& libraryScope, std::ostream& svgstream, const SvgOptions& opt);
@@ -135,6 +135,8 @@ public:
     GmoBoxSystem* create_system_box(LUnits left, LUnits top, LUnits width, LUnits height);
     void engrave_system(LUnits indent, int iFirstCol, int iLastCol, UPoint pos,
                         GmoBoxSystem* pPrevBoxSystem);
+    GmoBoxSystem* reuse_system_box(GmoBoxSystem* pBox, int iSystem, int iFirstCol,
+                                   int iLastCol);
     void on_origin_shift(LUnits yShift);
     inline void set_constrains(int constrains) { m_constrains = constrains; }
 
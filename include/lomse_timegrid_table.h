@@ -99,6 +99,18 @@ public:
     */
     LUnits get_x_for_barline_at_time(TimeUnits timepos);
 
+    /** Algorithms used by get_x_for_note_rest_at_time() and
+        get_x_for_barline_at_time(), for a range [pFirst, pEnd) of entries sorted by
+        timepos. The entry is located by binary search. They are also used by
+        PlaybackTimeline, that stores the entries of all systems in a single table.
+    */
+    static LUnits find_x_for_note_rest_at_time(const TimeGridTableEntry* pFirst,
+                                               const TimeGridTableEntry* pEnd,
+                                               TimeUnits timepos);
+    static LUnits find_x_for_barline_at_time(const TimeGridTableEntry* pFirst,
+                                             const TimeGridTableEntry* pEnd,
+                                             TimeUnits timepos);
+
     //debug
     std::string dump();
 
@@ -46,7 +46,7 @@ enum ETokenType {
 
     public:
         LdpToken(ETokenType type, std::string value, int numLine)
-            : m_type(type), m_value(value), m_numLine(numLine) {}
+            : m_type(type), m_value(std::move(value)), m_numLine(numLine) {}
         LdpToken(ETokenType type, char value, int numLine)
             : m_type(type), m_value(""), m_numLine(numLine) { m_value += value; }
 
@@ -75,6 +75,8 @@ enum ETokenType {
     private:
         LdpToken* parse_new_token();
         char get_next_char();
+        void repeat_last_char();
+        bool end_of_data();
         static bool is_number(char ch);
         static bool is_letter(char ch);
 
@@ -88,6 +90,9 @@ enum ETokenType {
         bool        m_expectingValuePart;
         bool        m_expectingNamePart;
         LdpToken*   m_pTokenNamePart;
+
+        //the reader has all the source in a buffer
+        bool        m_fBuffered;
     };
 
 
@@ -13,7 +13,9 @@
 #include "lomse_parser.h"
 #include "lomse_internal_model.h"
 
+#include <memory>
 #include <string>
+#include <vector>
 using namespace std;
 
 #include "pugixml/pugiconfig.hpp"
@@ -25,6 +27,7 @@ namespace lomse
 {
 
 //forward declarations and definitions
+class MappedFile;
 typedef pugi::xml_document          XmlDocument;
 typedef pugi::xml_attribute         XmlAttribute;
 
@@ -43,6 +46,7 @@ public:
     XmlNode(const XmlNode* node) : m_node(node->m_node) {}
 
     string name() { return string(m_node.name()); }
+    inline const char* name_cstr() { return m_node.name(); }
     string value();
     XmlAttribute attribute(const string& name) {
         return m_node.attribute(name.c_str());
@@ -101,6 +105,9 @@ private:
     vector<ptrdiff_t> m_offsetData;     // offset -> line mapping
     bool m_fOffsetDataReady;
     string m_filename;
+    std::unique_ptr<MappedFile> m_pMappedFile;  //parsed file, when parsed in place
+    std::vector<unsigned char> m_buffer;        //parsed buffer, when parsed in place
+    bool m_fEmbedPcdata;
 
 public:
     XmlParser(ostream& reporter=cout);
@@ -110,13 +117,25 @@ public:
     void parse_text(const std::string& sourceText) override;
     void parse_cstring(char* sourceText);
     void parse_buffer(const void* buffer, size_t size);
+    void parse_buffer_inplace(std::vector<unsigned char>&& buffer);
 
     inline const string& get_error() { return m_errorMsg; }
     inline const string& get_encoding() { return m_encoding; }
     inline XmlNode* get_tree_root() { return &m_root; }
     int get_line_number(XmlNode* node);
 
+    //free the memory used by the parsed tree
+    void clear();
+
+    //When true, the text of elements containing only text is stored in the
+    //element node instead of in a child pcdata node. This saves a lot of memory
+    //but the tree structure changes: the element has no children.
+    //XmlNode::value() returns the text in both cases. Therefore, code using a tree
+    //parsed with this option must not walk or count the pcdata child nodes.
+    inline void embed_pcdata(bool value) { m_fEmbedPcdata = value; }
+
 protected:
+    unsigned int get_parse_options();
     void parse_char_string(char* string);
     void find_root();
     bool build_offset_data(const char* file);
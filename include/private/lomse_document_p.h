@@ -53,6 +53,7 @@ class DocCommandExecuter;
 class Compiler;
 class IdAssigner;
 class Interactor;
+class PhaseProfiler;
 class ImoDocument;
 class ImoMusicData;
 class ImoScore;
@@ -140,6 +141,16 @@ public:
     void reset_id_assigner();
     void on_removed_from_model(ImoObj* pImo);
 
+    //id management when parts of the model are built concurrently. Each thread uses
+    //its own IdAssigner, with a reserved range of ids, and it is merged into the
+    //model IdAssigner when the thread finishes. Ranges are sized from the estimated
+    //number of ids each thread will use. When a thread exceeds its range, the excess
+    //ids are renumbered when merging
+    void reserve_thread_ids(std::vector<IdAssigner*>& assigners,
+                            const std::vector<ImoId>& numIds);
+    void use_thread_id_assigner(IdAssigner* pAssigner);
+    void merge_thread_ids(std::vector<IdAssigner*>& assigners);
+
     //dirty flag
     inline bool is_dirty() { return (m_flags & k_dirty) != 0; }
     inline void set_dirty() { m_flags |= k_dirty; }
@@ -153,6 +164,7 @@ public:
 
 protected:
     DocModel& clone(const DocModel& a);
+    IdAssigner* thread_id_assigner() const;
 
 
 };
@@ -200,6 +212,7 @@ protected:
     DocumentScope   m_docScope;
     int             m_modified = 0;         //modified since last 'save to file' operation
     DocModel*       m_pModel = nullptr;     //the document content
+    PhaseProfiler*  m_pProfiler = nullptr;  //not owned
 
 public:
     /// Constructor
@@ -214,6 +227,7 @@ public:
         k_format_mxl_compressed, ///< Compressed MusicXML format
         k_format_mnx,       ///< W3C MNX format
         k_format_unknown,
+        k_format_binary,    ///< Lomse binary snapshot of the internal model
     };
 
 
@@ -617,6 +631,21 @@ public:
     */
     void notify_if_document_modified();
 
+    /** Set the PhaseProfiler object that will collect the timings of the phases for
+        creating this %Document (parsing, analysis, model building, ...) and for doing
+        its layout. The profiler is not owned by the %Document and must exist while
+        it is set. Pass nullptr to stop profiling.
+
+        <b>Remarks</b>
+        - The profiler must be set before invoking from_file() or from_string().
+        - The results can be exported with PhaseProfiler::to_json() or
+            PhaseProfiler::to_chrome_trace().
+    */
+    inline void set_profiler(PhaseProfiler* pProfiler) { m_pProfiler = pProfiler; }
+
+    /** Returns the PhaseProfiler set for this %Document or nullptr if not profiling. */
+    inline PhaseProfiler* get_profiler() const { return m_pProfiler; }
+
     //@}    //Miscellaneous methods
 
 
@@ -682,7 +711,7 @@ protected:
     friend class Interactor;
     friend class DocCommandExecuter;
     inline void set_dirty() { if(m_pModel) m_pModel->set_dirty(); }
-    inline void clear_dirty() { if(m_pModel) m_pModel->clear_dirty(); }
+    void clear_dirty();
 
     //There is a design bug: ImoControl constructor needs to access ImoDocument for
     //setting the language. But when the control is created (in LdpAnalyser or
@@ -1486,6 +1486,7 @@ protected:
     ImoObj(int objtype, ImoId id=k_no_imoid);
 
     friend class ImFactory;
+    friend class ImSerializer;
     void set_owner_model(DocModel* pDocModel);
     virtual void initialize_object() {}
 
@@ -1948,6 +1949,7 @@ protected:
     };
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoStyle() : ImoSimpleObj(k_imo_style), m_name(), m_idParent(k_no_imoid) {}
 
 public:
@@ -2188,6 +2190,8 @@ protected:
     ImoContentObj(int objtype);
     ImoContentObj(ImoId id, int objtype);
 
+    friend class ImSerializer;
+
 public:
     //the five special
     ~ImoContentObj() override {}
@@ -2296,6 +2300,7 @@ protected:
     std::list<ImoRelObj*> m_relations;
 
     friend class ImFactory;
+    friend class ImSerializer;
     friend class ImoContentObj;
     ImoRelations() : ImoSimpleObj(k_imo_relations) {}
 
@@ -2458,6 +2463,7 @@ protected:
     ImoBoxInline(int objtype, LUnits width, LUnits height) : ImoInlineLevelObj(objtype)
                                                            , m_size(width, height) {}
 
+    friend class ImSerializer;
 
 public:
     //the five special
@@ -2502,6 +2508,7 @@ class ImoInlineWrapper : public ImoBoxInline
 {
 protected:
     friend class ImFactory;
+    friend class ImSerializer;
     ImoInlineWrapper() : ImoBoxInline(k_imo_inline_wrapper) {}
 
 public:
@@ -2522,6 +2529,7 @@ private:
     std::string m_language;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoLink() : ImoBoxInline(k_imo_link) {}
 
 public:
@@ -2550,6 +2558,8 @@ protected:
     ImoScoreObj(ImoId id, int objtype) : ImoContentObj(id, objtype), m_color(0,0,0) {}
     ImoScoreObj(int objtype) : ImoContentObj(objtype), m_color(0,0,0) {}
 
+    friend class ImSerializer;
+
 public:
     //the five special
     ~ImoScoreObj() override {}
@@ -2586,6 +2596,8 @@ protected:
     ImoStaffObj(int objtype) : ImoScoreObj(objtype) {}
     ImoStaffObj(ImoId id, int objtype) : ImoScoreObj(id, objtype) {}
 
+    friend class ImSerializer;
+
 public:
     //the five special
     ~ImoStaffObj() override;
@@ -2686,6 +2698,7 @@ protected:
     {
     }
 
+    friend class ImSerializer;
 
 public:
 
@@ -2748,6 +2761,8 @@ private:
     std::list< pair<ImoStaffObj*, ImoRelDataObj*> > m_relatedObjects;
 #endif
 
+    friend class ImSerializer;
+
 protected:
     ImoRelObj(int objtype) : ImoScoreObj(objtype) {}
 
@@ -2791,6 +2806,7 @@ class ImoAttachments : public ImoCollection
 {
 protected:
     friend class ImFactory;
+    friend class ImSerializer;
     friend class ImoContentObj;
     ImoAttachments() : ImoCollection(k_imo_attachments) {}
 
@@ -2823,6 +2839,7 @@ protected:
     bool m_repeat[6];
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoBeamData(ImoBeamDto* pDto);
     ImoBeamData();
 
@@ -2921,6 +2938,7 @@ protected:
     TPoint m_tPoints[4];   //start, end, ctrol1, ctrol2
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoBezierInfo() : ImoSimpleObj(k_imo_bezier_info) {}
 
 public:
@@ -3000,6 +3018,7 @@ protected:
     inline void set_stem_direction(int value) { m_stemDirection = value; }
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoChord()
         : ImoRelObj(k_imo_chord)
         , m_fCrossStaff(false)
@@ -3047,6 +3066,7 @@ protected:
     ImoId m_id;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoCursorInfo() : ImoSimpleObj(k_imo_cursor_info)
         , m_instrument(0), m_staff(0), m_time(0.0), m_id(k_no_imoid) {}
 
@@ -3096,6 +3116,7 @@ protected:
     TypeLineStyle m_style;
 
     friend class ImFactory;
+    friend class ImSerializer;
     friend class ImoTextBox;
     friend class ImoLine;
     friend class ImoScoreLine;
@@ -3173,6 +3194,7 @@ protected:
     };
 
     friend class ImFactory;
+    friend class ImSerializer;
     friend class ImoInstrument;
     ImoMidiInfo() : ImoSimpleObj(k_imo_midi_info) {}
 
@@ -3267,6 +3289,8 @@ protected:
     Tenths        m_borderWidth;
     ELineStyle    m_borderStyle;
 
+    friend class ImSerializer;
+
 public:
     ImoTextBlockInfo()
         : ImoSimpleObj(k_imo_textblock_info)
@@ -3362,6 +3386,7 @@ protected:
 
 
     friend class ImFactory;
+    friend class ImSerializer;
     friend class ImoInstrument;
     ImoSoundInfo();
     void initialize_object() override;
@@ -3434,6 +3459,7 @@ protected:
     };
 
     friend class ImFactory;
+    friend class ImSerializer;
     friend class ImoDocument;
     friend class ImoScore;
     ImoPageInfo();
@@ -3513,6 +3539,7 @@ protected:
     friend class ImoBlocksContainer;
     friend class Document;
     friend class ImFactory;
+    friend class ImSerializer;
     ImoAnonymousBlock() : ImoInlinesContainer(k_imo_anonymous_block) {}
 
 public:
@@ -3552,6 +3579,7 @@ protected:
                                         //nullptr when middle barline
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoBarline()
         : ImoStaffObj(k_imo_barline)
         , m_barlineType(k_barline_simple)
@@ -3614,6 +3642,7 @@ protected:
     void set_stems_direction(vector<int>* pStemsDir);
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoBeam() : ImoRelObj(k_imo_beam), m_pStemsDir(nullptr) {}
 
 public:
@@ -3645,6 +3674,8 @@ protected:
     ImoBlock(int objtype) : ImoAuxObj(objtype) {}
     ImoBlock(int objtype, ImoTextBlockInfo& box) : ImoAuxObj(objtype), m_box(box) {}
 
+    friend class ImSerializer;
+
 public:
     //the five special
     ~ImoBlock() override {}
@@ -3665,6 +3696,7 @@ protected:
     //TPoint m_anchorJoinPoint;     //point on the box rectangle
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoTextBox() : ImoBlock(k_imo_text_box), m_fHasAnchorLine(false) {}
     ImoTextBox(ImoTextBlockInfo& box) : ImoBlock(k_imo_text_box, box), m_fHasAnchorLine(false) {}
 
@@ -3696,6 +3728,7 @@ protected:
     std::shared_ptr<Control> m_ctrol;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoControl(Control* ctrol);
     ImoControl(int type) : ImoInlineLevelObj(type), m_ctrol(nullptr) {}
 
@@ -3733,6 +3766,7 @@ protected:
     bool m_fEnabled;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoButton();
 
 public:
@@ -3778,6 +3812,7 @@ protected:
     int m_symbolSize = k_size_default;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoClef() : ImoStaffObj(k_imo_clef) {}
 
 public:
@@ -3841,6 +3876,7 @@ class ImoContent : public ImoBlocksContainer
 {
 protected:
     friend class ImFactory;
+    friend class ImSerializer;
     ImoContent() : ImoBlocksContainer(k_imo_content) {}
     ImoContent(int objtype) : ImoBlocksContainer(objtype) {}
 
@@ -3885,6 +3921,7 @@ protected:
 
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoDirection() : ImoStaffObj(k_imo_direction) {}
 
 public:
@@ -3926,6 +3963,7 @@ protected:
     int m_symbol = ImoSymbolRepetitionMark::k_undefined;       //a value from enum ESymbolRepetitionMark
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoSymbolRepetitionMark() : ImoAuxObj(k_imo_symbol_repetition_mark) {}
 
 public:
@@ -3956,6 +3994,7 @@ protected:
     std::string m_classid;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoDynamic() : ImoContent(k_imo_dynamic), m_classid("") {}
 
 public:
@@ -3984,6 +4023,7 @@ class ImoSystemBreak : public ImoStaffObj
 {
 protected:
     friend class ImFactory;
+    friend class ImSerializer;
     ImoSystemBreak() : ImoStaffObj(k_imo_system_break) {}
 
 public:
@@ -4031,6 +4071,7 @@ protected:
     std::list<ImoStyle*> m_privateStyles;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoDocument(const std::string& version="");
     void initialize_object() override;
 
@@ -4094,6 +4135,7 @@ protected:
     EArpeggio m_type;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoArpeggio()
         : ImoRelObj(k_imo_arpeggio)
         , m_type(k_arpeggio_standard)
@@ -4151,6 +4193,7 @@ protected:
     int m_symbol;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoFermata()
         : ImoAuxObj(k_imo_fermata)
         , m_placement(k_placement_default)
@@ -4206,6 +4249,8 @@ protected:
     {
     }
 
+    friend class ImSerializer;
+
 public:
     //the five special
     ~ImoArticulation() override {}
@@ -4244,6 +4289,7 @@ protected:
     int m_symbol;   //symbol to use when alternatives. For now only for breath_mark
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoArticulationSymbol()
         : ImoArticulation(k_imo_articulation_symbol)
         , m_fUp(true)
@@ -4320,6 +4366,7 @@ protected:
     Tenths m_dashSpace;     //only for dashed lines
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoArticulationLine()
         : ImoArticulation(k_imo_articulation_line)
         , m_lineShape(k_line_shape_straight)
@@ -4387,6 +4434,7 @@ protected:
 //    %enclosure;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoDynamicsMark() : ImoAuxObj(k_imo_dynamics_mark) {}
 
 public:
@@ -4423,6 +4471,7 @@ protected:
 //    %enclosure;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoOrnament()
         : ImoAuxObj(k_imo_ornament)
         , m_ornamentType(k_ornament_unknown)
@@ -4475,6 +4524,7 @@ protected:
     int m_placement;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoTechnical()
         : ImoAuxObj(k_imo_technical)
         , m_technicalType(k_technical_unknown)
@@ -4515,6 +4565,7 @@ protected:
     int m_string = 1;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoFretString() : ImoTechnical(k_imo_fret_string)
     {
         m_technicalType = k_technical_fret_string;
@@ -4604,6 +4655,7 @@ protected:
     std::list<FingerData> m_fingerings;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoFingering() : ImoTechnical(k_imo_fingering)
     {
         m_technicalType = k_technical_fingering;
@@ -4636,6 +4688,7 @@ protected:
     static constexpr TimeUnits k_shift_start_end = 100000000.0;     //any too big value
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoGoBackFwd() : ImoStaffObj(k_imo_go_back_fwd), m_fFwd(true), m_rTimeShift(0.0) {}
 
 public:
@@ -4674,6 +4727,7 @@ protected:
     TimeUnits   m_makeTime;         //duration to assign
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoGraceRelObj()
         : ImoRelObj(k_imo_grace_relobj)
         , m_graceType(k_grace_steal_previous)
@@ -4725,6 +4779,7 @@ protected:
     TypeTextInfo m_text;
 
     friend class ImFactory;
+    friend class ImSerializer;
     friend class ImoInstrument;
     friend class ImoInstrGroup;
     ImoScoreText() : ImoAuxObj(k_imo_score_text), m_text() {}
@@ -4757,6 +4812,7 @@ protected:
     int m_hAlign;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoScoreTitle() : ImoScoreText(k_imo_score_title), m_hAlign(k_halign_center) {}
 
 public:
@@ -4785,6 +4841,7 @@ class ImoSoundChange : public ImoStaffObj
 protected:
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoSoundChange()
         : ImoStaffObj(k_imo_sound_change)
     {
@@ -4826,6 +4883,7 @@ protected:
     bool m_doubled;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoTranspose()
         : ImoStaffObj(k_imo_transpose)
     {
@@ -4865,6 +4923,7 @@ protected:
     int m_repeatType;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoTextRepetitionMark()
         : ImoScoreText(k_imo_text_repetition_mark)
         , m_repeatType(0)
@@ -4900,6 +4959,7 @@ protected:
     SpImage m_image;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoImage() : ImoInlineLevelObj(k_imo_image), m_image( LOMSE_NEW Image() ) {}
     ImoImage(unsigned char* imgbuf, VSize bmpSize, EPixelFormat format, USize imgSize)
         : ImoInlineLevelObj(k_imo_image)
@@ -4967,6 +5027,7 @@ protected:
     ImoId m_abbrevStyle = k_no_imoid;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoInstrGroup();
 
 public:
@@ -5049,6 +5110,7 @@ protected:
                                             //has no metric. Otherwise it will be nullptr.
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoInstrument();
     void initialize_object() override;
 
@@ -5181,6 +5243,7 @@ class ImoInstruments : public ImoCollection
 {
 protected:
     friend class ImFactory;
+    friend class ImSerializer;
     ImoInstruments() : ImoCollection(k_imo_instruments) {}
 
 public:
@@ -5198,6 +5261,7 @@ class ImoInstrGroups : public ImoCollection
 {
 protected:
     friend class ImFactory;
+    friend class ImSerializer;
     ImoInstrGroups() : ImoCollection(k_imo_instrument_groups) {}
 
 public:
@@ -5215,6 +5279,7 @@ class ImoScoreTitles : public ImoCollection
 {
 protected:
     friend class ImFactory;
+    friend class ImSerializer;
     ImoScoreTitles() : ImoCollection(k_imo_score_titles) {}
 
 public:
@@ -5231,6 +5296,7 @@ class ImoParameters : public ImoCollection
 {
 protected:
     friend class ImFactory;
+    friend class ImSerializer;
     ImoParameters() : ImoCollection(k_imo_parameters) {}
 
 public:
@@ -5247,6 +5313,7 @@ class ImoSounds : public ImoCollection
 {
 protected:
     friend class ImFactory;
+    friend class ImSerializer;
     ImoSounds() : ImoCollection(k_imo_sounds) {}
 
 public:
@@ -5330,6 +5397,7 @@ protected:
 
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoKeySignature() : ImoStaffObj(k_imo_key_signature) {}
 
 
@@ -5378,6 +5446,7 @@ protected:
     TypeLineStyle m_style;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoLine() : ImoAuxObj(k_imo_line) {}
 
 public:
@@ -5394,6 +5463,7 @@ class ImoListItem : public ImoBlocksContainer
 protected:
     friend class Document;
     friend class ImFactory;
+    friend class ImSerializer;
     ImoListItem();
     void initialize_object() override;
 
@@ -5414,6 +5484,7 @@ protected:
     int m_listType;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoList();
     void initialize_object() override;
 
@@ -5454,6 +5525,7 @@ protected:
     bool    m_fParenthesis;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoMetronomeMark()
         : ImoAuxObj(k_imo_metronome_mark), m_markType(k_value)
         , m_ticksPerMinute(60), m_leftNoteType(0), m_leftDots(0)
@@ -5538,6 +5610,7 @@ protected:
     std::vector<float> m_widths;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoMultiColumn();
     void initialize_object() override;
 
@@ -5570,6 +5643,7 @@ class ImoMusicData : public ImoCollection
 {
 protected:
     friend class ImFactory;
+    friend class ImSerializer;
     ImoMusicData() : ImoCollection(k_imo_music_data) {}
 
 public:
@@ -5595,6 +5669,7 @@ protected:
     float       m_rValue = 0.0f;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoOptionInfo() : ImoSimpleObj(k_imo_option) {}
 
 public:
@@ -5681,6 +5756,7 @@ class ImoOptions : public ImoCollection
 {
 protected:
     friend class ImFactory;
+    friend class ImSerializer;
     ImoOptions() : ImoCollection(k_imo_options) {}
 
 public:
@@ -5700,6 +5776,7 @@ protected:
     friend class ImoBlocksContainer;
     friend class Document;
     friend class ImFactory;
+    friend class ImSerializer;
     ImoParagraph() : ImoInlinesContainer(k_imo_para) { set_edit_terminal(true); }
 
 public:
@@ -5722,6 +5799,7 @@ protected:
     std::string m_value;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoParamInfo() : ImoSimpleObj(k_imo_param_info), m_name(), m_value() {}
 
 public:
@@ -5750,6 +5828,7 @@ protected:
     int m_level = 1;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoHeading() : ImoInlinesContainer(k_imo_heading) { set_edit_terminal(true); }
 
 public:
@@ -5803,6 +5882,7 @@ protected:
     TypeLineStyle m_style;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoScoreLine()
         : ImoAuxObj(k_imo_score_line)
         , m_startPoint(0.0f, 0.0f)
@@ -5869,6 +5949,7 @@ protected:
     std::string m_stopLabel;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoScorePlayer();
 
     friend class ScorePlayerAnalyser;
@@ -5940,6 +6021,7 @@ protected:
     };
 
     friend class ImFactory;
+    friend class ImSerializer;
     friend class ImoScore;
     ImoSystemInfo() : ImoSimpleObj(k_imo_system_info) {}
 
@@ -6003,6 +6085,7 @@ protected:
     };
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoScore();
     void initialize_object() override;
 
@@ -6115,6 +6198,11 @@ public:
         that will invoke this method on all scores. */
     void end_of_changes();
 
+    /** Same as end_of_changes() but faster, as only the instruments containing
+        objects marked as dirty are processed. It can only be used when all
+        modified objects have been marked as dirty, as edition commands do. */
+    void end_of_marked_changes();
+
 
 protected:
     ImoScore& clone(const ImoScore& a);
@@ -6143,6 +6231,7 @@ protected:
     int     m_orientation = k_orientation_default;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoSlur() : ImoRelObj(k_imo_slur) {}
     ImoSlur(int num) : ImoRelObj(k_imo_slur), m_slurNum(num) {}
 
@@ -6185,7 +6274,15 @@ protected:
     int     m_orientation;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoSlurData(ImoSlurDto* pDto);
+    ImoSlurData()
+        : ImoRelDataObj(k_imo_slur_data)
+        , m_fStart(false)
+        , m_slurNum(0)
+        , m_orientation(k_orientation_default)
+    {
+    }
 
 public:
     //the five special
@@ -6328,6 +6425,7 @@ protected:
     };
 
     friend class ImFactory;
+    friend class ImSerializer;
     friend class ImoInstrument;
     ImoStaffInfo(int numStaff=0, int lines=5, int type=k_staff_regular,
                  LUnits spacing=LOMSE_STAFF_LINE_SPACING,
@@ -6409,6 +6507,7 @@ protected:
     std::map<std::string, ImoStyle*> m_nameToStyle;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoStyles();
     void initialize_object() override;
 
@@ -6452,6 +6551,7 @@ protected:
     std::list<ImoId> m_colStyles;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoTable() : ImoBlocksContainer(k_imo_table) {}
 
 public:
@@ -6486,6 +6586,7 @@ protected:
 
     friend class Document;
     friend class ImFactory;
+    friend class ImSerializer;
     ImoTableCell();
     void initialize_object() override;
 
@@ -6511,6 +6612,7 @@ class ImoTableRow : public ImoBlocksContainer
 protected:
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoTableRow();
     void initialize_object() override;
 
@@ -6565,6 +6667,7 @@ class ImoTableBody : public ImoTableSection
 {
 protected:
     friend class ImFactory;
+    friend class ImSerializer;
     friend class ImoContentObj;
     ImoTableBody() : ImoTableSection(k_imo_table_body) {}
 
@@ -6582,6 +6685,7 @@ class ImoTableHead : public ImoTableSection
 {
 protected:
     friend class ImFactory;
+    friend class ImSerializer;
     friend class ImoContentObj;
     ImoTableHead() : ImoTableSection(k_imo_table_head) {}
 
@@ -6603,6 +6707,7 @@ private:
 
 protected:
     friend class ImFactory;
+    friend class ImSerializer;
     friend class TextItemAnalyser;
     friend class TextItemLmdAnalyser;
 
@@ -6642,6 +6747,7 @@ protected:
     int     m_orientation;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoTieData(ImoTieDto* pDto);
     ImoTieData();
 
@@ -6671,6 +6777,7 @@ protected:
     int     m_orientation = k_orientation_default;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoTie() : ImoRelObj(k_imo_tie) {}
     ImoTie(int num) : ImoRelObj(k_imo_tie), m_tieNum(num) {}
 
@@ -6833,6 +6940,7 @@ protected:
     int     m_type;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoTimeSignature()
         : ImoStaffObj(k_imo_time_signature)
         , m_top(2)
@@ -7045,6 +7153,7 @@ protected:
     int m_nPlacement = k_placement_default;     //a value from enum EPlacement
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoTuplet() : ImoRelObj(k_imo_tuplet) {}
     ImoTuplet(ImoTupletDto* dto);
 
@@ -7098,6 +7207,7 @@ protected:
     // ImoLyricsTextInfo[]
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoLyric()
         : ImoAuxRelObj(k_imo_lyric)
         , m_number(0)
@@ -7175,6 +7285,7 @@ protected:
 //    Color m_elisionColor;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoLyricsTextInfo() : ImoSimpleObj(k_imo_lyrics_text_info) {}
 
 
@@ -7216,6 +7327,7 @@ protected:
     int     m_octaveShiftNum;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoOctaveShift(int num=0)
         : ImoRelObj(k_imo_octave_shift)
         , m_steps(0)
@@ -7303,6 +7415,7 @@ protected:
     bool m_fAbbreviated = false;
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoPedalMark() : ImoAuxObj(k_imo_pedal_mark) {}
 
 public:
@@ -7337,6 +7450,7 @@ class ImoPedalLine : public ImoRelObj
 
 protected:
     friend class ImFactory;
+    friend class ImSerializer;
     ImoPedalLine() : ImoRelObj(k_imo_pedal_line) {}
 
 public:
@@ -7456,6 +7570,7 @@ protected:
     int m_numVoltas;                //number of voltas in the set
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoVoltaBracket()
         : ImoRelObj(k_imo_volta_bracket)
         , m_fStopJog(true)
@@ -7667,6 +7782,7 @@ protected:
     };
 
     friend class ImFactory;
+    friend class ImSerializer;
     ImoWedge(int num=0) : ImoRelObj(k_imo_wedge), m_wedgeNum(num) {}
 
 public:
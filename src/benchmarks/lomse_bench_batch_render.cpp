@@ -0,0 +1,80 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_batch_renderer.h"
+#include "lomse_build_options.h"
+#include "lomse_doorway.h"
+#include "lomse_document.h"
+
+#include <sstream>
+#if (LOMSE_ENABLE_THREADS == 1)
+    #include <thread>
+#endif
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+static vector<BatchRenderJob> create_jobs(int numDocs)
+{
+    vector<BatchRenderJob> jobs(numDocs);
+    for (int i=0; i < numDocs; ++i)
+    {
+        jobs[i].source = ldp_piano_score(1 + i % 3, 20 + 5 * (i % 4));
+        jobs[i].format = Document::k_format_ldp;
+        jobs[i].output = k_batch_output_bitmap;
+        jobs[i].width = 800;
+        jobs[i].height = 1100;
+    }
+    return jobs;
+}
+
+//---------------------------------------------------------------------------------------
+static double time_batch(LomseDoorway& doorway, vector<BatchRenderJob>& jobs,
+                         int numThreads)
+{
+    BenchmarkTimer timer;
+    doorway.render_batch(jobs, numThreads);
+    return timer.elapsed_ms();
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(BatchRender, throughput)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+
+    const int numDocs = 24;
+    int numThreads = 1;
+#if (LOMSE_ENABLE_THREADS == 1)
+    numThreads = max(1, int(std::thread::hardware_concurrency()));
+#endif
+
+    vector<BatchRenderJob> sequential = create_jobs(numDocs);
+    double ms1 = time_batch(doorway, sequential, 1);
+
+    vector<BatchRenderJob> parallel = create_jobs(numDocs);
+    double msN = time_batch(doorway, parallel, numThreads);
+
+    bool fIdentical = true;
+    for (int i=0; i < numDocs; ++i)
+        fIdentical &= (sequential[i].ok && sequential[i].bitmap == parallel[i].bitmap);
+
+    stringstream ss;
+    ss << numDocs << " documents, " << numThreads << " threads";
+    report("1 thread", numDocs / (max(ms1, 0.001) / 1000.0), "docs/s");
+    report(ss.str(), numDocs / (max(msN, 0.001) / 1000.0), "docs/s");
+    report("speedup", ms1 / max(msN, 0.001), "x");
+    report("identical output", fIdentical ? 1.0 : 0.0, "bool");
+}
@@ -0,0 +1,108 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_binary_exporter.h"
+#include "lomse_build_options.h"
+#include "lomse_document.h"
+#include "lomse_doorway.h"
+#include "lomse_injectors.h"
+#include "lomse_internal_model.h"
+#include "lomse_mxl_exporter.h"
+
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+static string read_file(const string& filename)
+{
+    ifstream file(filename.c_str(), ios::in | ios::binary);
+    stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+//---------------------------------------------------------------------------------------
+static double time_load(LibraryScope& libScope, const string& source, int format,
+                        int repetitions)
+{
+    BenchmarkTimer timer;
+    for (int i=0; i < repetitions; ++i)
+    {
+        stringstream errormsg;
+        Document doc(libScope, errormsg);
+        doc.from_string(source, format);
+    }
+    return timer.elapsed_ms() / repetitions;
+}
+
+//---------------------------------------------------------------------------------------
+static void compare_load(LibraryScope& libScope, const string& source, int format,
+                         const string& title, int repetitions)
+{
+    //the document is imported from its source and saved as a binary snapshot. Then
+    //the load time for both is compared
+
+    stringstream errormsg;
+    Document doc(libScope, errormsg);
+    doc.from_string(source, format);
+    BinaryExporter exporter;
+    string snapshot = exporter.get_source(doc.get_im_root());
+    if (snapshot.empty())
+    {
+        report(title + ", snapshot not created: " + exporter.get_error(), 0.0, "");
+        return;
+    }
+
+    double timeSource = time_load(libScope, source, format, repetitions);
+    double timeBinary = time_load(libScope, snapshot, Document::k_format_binary,
+                                  repetitions);
+
+    report(title + ", source size", double(source.size()) / 1024.0, "KB");
+    report(title + ", snapshot size", double(snapshot.size()) / 1024.0, "KB");
+    report(title + ", import from source", timeSource, "ms");
+    report(title + ", load snapshot", timeBinary, "ms");
+    report(title + ", speedup", timeSource / max(timeBinary, 0.001), "x");
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(BinarySnapshot, load_vs_import)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    string path = TESTLIB_SCORES_PATH;
+    compare_load(libScope, read_file(path + "02092-chant.lms"), Document::k_format_ldp,
+                 "LDP 02092-chant", 20);
+    compare_load(libScope, read_file(path + "00205-multimetric.lmd"),
+                 Document::k_format_lmd, "LMD 00205-multimetric", 20);
+    compare_load(libScope, read_file(path + "unit-tests/other/03-BeetAnGeSample.xml"),
+                 Document::k_format_mxl, "MusicXML 03-BeetAnGeSample", 20);
+
+    //the same large score in LDP and MusicXML formats
+    string ldp = ldp_piano_score(4, 1000);
+    compare_load(libScope, ldp, Document::k_format_ldp, "LDP 4 pianos, 1000 measures", 3);
+
+    stringstream errormsg;
+    Document doc(libScope, errormsg);
+    doc.from_string(ldp, Document::k_format_ldp);
+    MxlExporter exporter(libScope);
+    exporter.set_remove_newlines(true);
+    string mxl = exporter.get_source(doc.get_im_root()->get_content_item(0));
+    compare_load(libScope, mxl, Document::k_format_mxl,
+                 "MusicXML 4 pianos, 1000 measures", 3);
+}
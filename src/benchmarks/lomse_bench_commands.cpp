@@ -0,0 +1,69 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_doorway.h"
+#include "lomse_document.h"
+#include "lomse_document_cursor.h"
+#include "lomse_command.h"
+#include "lomse_selections.h"
+
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+static double time_undo(LibraryScope& libScope, int numCommands, int interval)
+{
+    //executes numCommands in a score and returns the time for undoing the last one
+
+    Document doc(libScope, cout);
+    doc.from_string(ldp_piano_score(2, 20), Document::k_format_ldp);
+    DocCursor cursor(&doc);
+    SelectionSet sel(&doc);
+    DocCommandExecuter executer(&doc);
+    executer.set_checkpoint_interval(interval);
+    cursor.enter_element();
+
+    for (int i=0; i < numCommands; ++i)
+    {
+        executer.execute(&cursor, LOMSE_NEW CmdAddNoteRest("(n c4 e v1)",
+                                                           k_edit_mode_replace), &sel);
+    }
+
+    BenchmarkTimer timer;
+    executer.undo(&cursor, &sel);
+    return timer.elapsed_ms();
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(DocCommandExecuter, undo)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    const int commands[] = { 50, 200, 500 };
+    for (int numCommands : commands)
+    {
+        stringstream title;
+        title << "undo after " << numCommands << " commands";
+        report(title.str() + ", replay from start", time_undo(libScope, numCommands, 0),
+               "ms");
+        report(title.str() + ", checkpoints", time_undo(libScope, numCommands, 25),
+               "ms");
+    }
+}
@@ -0,0 +1,76 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_doorway.h"
+#include "lomse_document.h"
+#include "lomse_font_cache_manager.h"
+#include "lomse_graphic_view.h"
+#include "lomse_interactor.h"
+#include "lomse_presenter.h"
+
+#include <vector>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+//time for creating a new library instance and rendering the first page of a score
+static double time_first_render(const string& source, bool fClearCache)
+{
+    if (fClearCache)
+        font_cache_pool::instance().clear();
+
+    BenchmarkTimer timer;
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+
+    Presenter* pPresenter = doorway.new_document(k_view_vertical_book, source,
+                                                 Document::k_format_ldp);
+    Interactor* pIntor = pPresenter->get_interactor_raw_ptr(0);
+    const unsigned width = 900;
+    const unsigned height = 1200;
+    std::vector<unsigned char> buffer(width * height * 4);
+    pIntor->set_rendering_buffer(&buffer[0], width, height);
+    pIntor->redraw_bitmap();
+    double ms = timer.elapsed_ms();
+
+    delete pPresenter;
+    return ms;
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(GlyphCache, new_interactor)
+{
+    string source = ldp_piano_score(2, 30);
+    font_cache_pool& pool = font_cache_pool::instance();
+    const int numRepetitions = 5;
+
+    double timeCold = 0.0;
+    for (int i=0; i < numRepetitions; ++i)
+        timeCold += time_first_render(source, true);
+
+    time_first_render(source, true);
+    pool.reset_counters();
+    double timeWarm = 0.0;
+    for (int i=0; i < numRepetitions; ++i)
+        timeWarm += time_first_render(source, false);
+
+    double lookups = double(pool.hits() + pool.misses());
+    report("first render, glyphs not cached", timeCold / numRepetitions, "ms");
+    report("first render, shared glyph cache", timeWarm / numRepetitions, "ms");
+    report("speedup", timeCold / max(timeWarm, 0.001), "x");
+    report("glyph cache hit rate", 100.0 * pool.hits() / max(lookups, 1.0), "%");
+    report("cached fonts", double(pool.num_fonts()), "fonts");
+}
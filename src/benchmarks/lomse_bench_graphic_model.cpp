@@ -0,0 +1,130 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_doorway.h"
+#include "lomse_document.h"
+#include "lomse_gm_basic.h"
+#include "lomse_graphic_view.h"
+#include "lomse_graphical_model.h"
+#include "lomse_interactor.h"
+#include "lomse_presenter.h"
+#include "lomse_selections.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+//helper: the hit testing algorithm used before the spatial index was introduced
+static GmoShape* find_shape_at_by_list_scan(GmoBoxDocPage* pPage, LUnits x, LUnits y)
+{
+    std::list<GmoShape*>& shapes = pPage->get_all_shapes();
+    std::list<GmoShape*>::reverse_iterator it;
+    for (it = shapes.rbegin(); it != shapes.rend(); ++it)
+    {
+        if ((*it)->hit_test(x, y))
+            return *it;
+    }
+    return nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(GraphicModel, page_hit_testing)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+
+    //single page view: all shapes are in one dense page
+    int numInstruments = 8;
+    int numMeasures = 100;
+    Presenter* pPresenter = doorway.new_document(k_view_single_page,
+        ldp_piano_score(numInstruments, numMeasures), Document::k_format_ldp);
+    Interactor* pIntor = pPresenter->get_interactor_raw_ptr(0);
+
+    BenchmarkTimer timer;
+    GraphicModel* pGModel = pIntor->get_graphic_model();
+    report("layout, including shapes index", timer.elapsed_ms(), "ms");
+
+    GmoBoxDocPage* pPage = pGModel->get_page(0);
+    report("shapes in page", double(pPage->get_all_shapes().size()), "shapes");
+
+    //random points inside the page
+    const int numPoints = 2000;
+    std::vector<UPoint> points;
+    srand(1);
+    for (int i=0; i < numPoints; ++i)
+    {
+        LUnits x = pPage->get_width() * LUnits(rand()) / LUnits(RAND_MAX);
+        LUnits y = pPage->get_height() * LUnits(rand()) / LUnits(RAND_MAX);
+        points.push_back(UPoint(x, y));
+    }
+
+    timer.start();
+    int numFoundScan = 0;
+    std::vector<GmoShape*> foundScan;
+    for (const UPoint& pt : points)
+    {
+        GmoShape* pShape = find_shape_at_by_list_scan(pPage, pt.x, pt.y);
+        foundScan.push_back(pShape);
+        numFoundScan += (pShape ? 1 : 0);
+    }
+    double timeScan = timer.elapsed_ms();
+
+    timer.start();
+    pPage->build_shapes_grid();
+    double timeBuild = timer.elapsed_ms();
+
+    timer.start();
+    int numFoundGrid = 0;
+    int numDifferent = 0;
+    for (int i=0; i < numPoints; ++i)
+    {
+        GmoShape* pShape = pGModel->find_shape_at(0, points[i].x, points[i].y);
+        numFoundGrid += (pShape ? 1 : 0);
+        numDifferent += (pShape != foundScan[i] ? 1 : 0);
+    }
+    double timeGrid = timer.elapsed_ms();
+
+    report("shapes index build", timeBuild, "ms");
+    report("hit test, list scan (per point)", 1000.0 * timeScan / numPoints, "us");
+    report("hit test, shapes index (per point)", 1000.0 * timeGrid / numPoints, "us");
+    report("speedup", timeScan / max(timeGrid, 0.001), "x");
+    report("points hitting a shape, list scan", double(numFoundScan), "");
+    report("points hitting a shape, shapes index", double(numFoundGrid), "");
+    report("results mismatch", double(numDifferent), "");
+
+    //rectangle selection, with a rectangle of 1/10 of page size
+    LUnits width = pPage->get_width() / 10.0f;
+    LUnits height = pPage->get_height() / 10.0f;
+    const int numRects = 500;
+    SelectionSet selection(nullptr);
+    timer.start();
+    size_t numSelected = 0;
+    for (int i=0; i < numRects; ++i)
+    {
+        URect rect(points[i].x, points[i].y, width, height);
+        pGModel->select_objects_in_rectangle(0, &selection, rect);
+        numSelected += size_t(selection.num_selected());
+    }
+    double timeSelect = timer.elapsed_ms();
+    report("rectangle selection, shapes index (per rect)", 1000.0 * timeSelect / numRects,
+           "us");
+    report("average shapes selected", double(numSelected) / numRects, "");
+
+    delete pPresenter;
+}
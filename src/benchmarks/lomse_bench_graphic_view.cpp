@@ -0,0 +1,72 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_doorway.h"
+#include "lomse_document.h"
+#include "lomse_drawer.h"
+#include "lomse_graphic_view.h"
+#include "lomse_interactor.h"
+#include "lomse_presenter.h"
+
+#include <vector>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(GraphicView, zoomed_repaint)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+
+    Presenter* pPresenter = doorway.new_document(k_view_vertical_book,
+        ldp_piano_score(4, 60), Document::k_format_ldp);
+    Interactor* pIntor = pPresenter->get_interactor_raw_ptr(0);
+
+    const unsigned width = 1200;
+    const unsigned height = 900;
+    std::vector<unsigned char> buffer(width * height * 4);
+    pIntor->set_rendering_buffer(&buffer[0], width, height);
+    pIntor->set_scale(4.0, 0, 0, false);
+    pIntor->redraw_bitmap();        //build the graphic model
+
+    const int numRepaints = 20;
+    int* pCounters = pIntor->get_render_counters();
+    BenchmarkTimer timer;
+    for (int i=0; i < numRepaints; ++i)
+        pIntor->redraw_bitmap();
+    double timeCulling = timer.elapsed_ms();
+    int drawnCulling = *(pCounters + Interactor::k_counter_shapes_drawn);
+    int shapesCulled = *(pCounters + Interactor::k_counter_shapes_culled);
+    int boxesCulled = *(pCounters + Interactor::k_counter_boxes_culled);
+
+    pIntor->set_rendering_option(k_option_disable_viewport_culling, true);
+    timer.start();
+    for (int i=0; i < numRepaints; ++i)
+        pIntor->redraw_bitmap();
+    double timeAll = timer.elapsed_ms();
+    int drawnAll = *(pCounters + Interactor::k_counter_shapes_drawn);
+
+    report("repaint at 400%, whole page (per repaint)", timeAll / numRepaints, "ms");
+    report("repaint at 400%, viewport culling (per repaint)",
+           timeCulling / numRepaints, "ms");
+    report("speedup", timeAll / max(timeCulling, 0.001), "x");
+    report("shapes drawn, whole page", double(drawnAll), "shapes");
+    report("shapes drawn, viewport culling", double(drawnCulling), "shapes");
+    report("shapes culled", double(shapesCulled), "shapes");
+    report("boxes culled", double(boxesCulled), "boxes");
+
+    delete pPresenter;
+}
@@ -0,0 +1,98 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_command.h"
+#include "lomse_doorway.h"
+#include "lomse_document.h"
+#include "lomse_document_cursor.h"
+#include "lomse_graphic_view.h"
+#include "lomse_internal_model.h"
+#include "lomse_interactor.h"
+#include "lomse_presenter.h"
+#include "lomse_staffobjs_table.h"
+
+#include <sstream>
+#include <vector>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+static ImoId find_first_note_in_measure(Document* pDoc, int iMeasure)
+{
+    ImoScore* pScore = dynamic_cast<ImoScore*>( pDoc->get_im_root()->get_content_item(0) );
+    ColStaffObjs* pTable = pScore->get_staffobjs_table();
+    ColStaffObjs::iterator it;
+    for (it = pTable->begin(); it != pTable->end(); ++it)
+    {
+        if ((*it)->measure() == iMeasure && (*it)->imo_object()->is_note())
+            return (*it)->element_id();
+    }
+    return k_no_imoid;
+}
+
+//---------------------------------------------------------------------------------------
+static double time_edits(LomseDoorway& doorway, int numMeasures, bool fIncremental)
+{
+    //replaces a note in the middle of the score and measures the time for executing
+    //the command and repainting the view. Returns the mean time per edition.
+
+    Presenter* pPresenter = doorway.new_document(k_view_vertical_book,
+        ldp_piano_score(2, numMeasures), Document::k_format_ldp);
+    Interactor* pIntor = pPresenter->get_interactor_raw_ptr(0);
+    Document* pDoc = pPresenter->get_document_raw_ptr();
+
+    const unsigned width = 1200;
+    const unsigned height = 900;
+    std::vector<unsigned char> buffer(width * height * 4);
+    pIntor->set_rendering_buffer(&buffer[0], width, height);
+    pIntor->enable_incremental_layout(fIncremental);
+    pIntor->redraw_bitmap();        //build the graphic model
+
+    const int numEdits = 10;
+    static const char* notes[] = { "(n d4 e v1 p1)", "(n e4 e v1 p1)" };
+    BenchmarkTimer timer;
+    for (int i=0; i < numEdits; ++i)
+    {
+        ImoId id = find_first_note_in_measure(pDoc, numMeasures * 3 / 5);
+        pIntor->get_cursor()->reset_and_point_to(id);
+        pIntor->exec_command(LOMSE_NEW CmdAddNoteRest(notes[i % 2],
+                                                      k_edit_mode_replace));
+        pIntor->redraw_bitmap();
+    }
+    double time = timer.elapsed_ms() / numEdits;
+
+    delete pPresenter;
+    return time;
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(IncrementalLayout, edit_to_repaint)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+
+    const int measures[] = { 100, 500 };
+    for (int numMeasures : measures)
+    {
+        stringstream title;
+        title << "2 pianos, " << numMeasures << " measures, edit-to-repaint";
+        double timeFull = time_edits(doorway, numMeasures, false);
+        double timeIncremental = time_edits(doorway, numMeasures, true);
+        report(title.str() + ", full layout", timeFull, "ms");
+        report(title.str() + ", incremental layout", timeIncremental, "ms");
+        report(title.str() + ", speedup", timeFull / max(timeIncremental, 0.001), "x");
+    }
+}
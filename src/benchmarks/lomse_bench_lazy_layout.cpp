@@ -0,0 +1,66 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_document.h"
+#include "lomse_document_layouter.h"
+#include "lomse_doorway.h"
+#include "lomse_graphical_model.h"
+#include "lomse_injectors.h"
+
+#include <sstream>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(LazyLayout, time_to_first_page)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    //four pianos, 500 measures
+    Document doc(libScope, cout);
+    doc.from_string(ldp_piano_score(4, 500), Document::k_format_ldp);
+
+    //eager layout: the first page is available when all pages are laid out
+    int numPages = 0;
+    {
+        BenchmarkTimer timer;
+        DocLayouter layouter(&doc, libScope);
+        layouter.layout_document();
+        report("eager, all pages", timer.elapsed_ms(), "ms");
+        numPages = layouter.get_graphic_model()->get_num_pages();
+        delete layouter.get_graphic_model();
+    }
+    report("pages", numPages, "");
+
+    //lazy layout: first page, then the remaining pages
+    {
+        BenchmarkTimer timer;
+        DocLayouter layouter(&doc, libScope);
+        layouter.enable_lazy_layout(1);
+        layouter.layout_document();
+        report("lazy, first page", timer.elapsed_ms(), "ms");
+        report("lazy, estimated pages",
+               layouter.get_graphic_model()->get_estimated_num_pages(), "");
+
+        BenchmarkTimer timerRest;
+        while (layouter.layout_more_pages(1));
+        report("lazy, remaining pages", timerRest.elapsed_ms(), "ms");
+        report("lazy, all pages", timer.elapsed_ms(), "ms");
+        delete layouter.get_graphic_model();
+    }
+}
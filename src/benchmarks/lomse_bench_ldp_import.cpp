@@ -0,0 +1,196 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_document.h"
+#include "lomse_doorway.h"
+#include "lomse_injectors.h"
+#include "lomse_ldp_parser.h"
+#include "lomse_reader.h"
+#include "lomse_tokenizer.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+// Global operator new is replaced for counting the number of memory allocations
+static std::atomic<long> m_numAllocations(0);
+
+void* operator new(size_t size)
+{
+    ++m_numAllocations;
+    void* p = malloc(size == 0 ? 1 : size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    free(p);
+}
+
+
+//---------------------------------------------------------------------------------------
+static double mb_per_second(size_t bytes, int repetitions, double ms)
+{
+    return (double(bytes) * repetitions / (1024.0 * 1024.0)) / (max(ms, 0.001) / 1000.0);
+}
+
+//---------------------------------------------------------------------------------------
+static int tokenize(LdpReader& reader)
+{
+    LdpTokenizer tokenizer(reader, cout);
+    int numTokens = 0;
+    for (LdpToken* token = tokenizer.read_token();
+         token->get_type() != tkEndOfFile;
+         token = tokenizer.read_token())
+    {
+        ++numTokens;
+    }
+    return numTokens;
+}
+
+//---------------------------------------------------------------------------------------
+static string read_file(const string& filename)
+{
+    ifstream file(filename.c_str(), ios::in | ios::binary);
+    stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+//---------------------------------------------------------------------------------------
+static void time_parse(LibraryScope& libScope, const string& source,
+                       const string& title, int repetitions)
+{
+    //parsing (building the tree of LdpElements) is measured in isolation and also
+    //the full import (parsing, analysis and building the internal model)
+
+    long numAllocations = 0;
+    BenchmarkTimer timer;
+    for (int i=0; i < repetitions; ++i)
+    {
+        stringstream errormsg;
+        LdpParser parser(errormsg, libScope.ldp_factory());
+        long startAllocations = m_numAllocations;
+        parser.parse_text(source);
+        numAllocations = m_numAllocations - startAllocations;
+        delete parser.get_ldp_tree()->get_root();
+    }
+    double timeParse = timer.elapsed_ms();
+
+    timer.start();
+    for (int i=0; i < repetitions; ++i)
+    {
+        stringstream errormsg;
+        Document doc(libScope, errormsg);
+        doc.from_string(source, Document::k_format_ldp);
+    }
+    double timeImport = timer.elapsed_ms();
+
+    stringstream ss;
+    ss << title << " (" << source.size() / 1024 << " KB)";
+    report(ss.str() + ", parse", timeParse / repetitions, "ms");
+    report(ss.str() + ", parse", double(numAllocations), "allocations");
+    report(ss.str() + ", full import", timeImport / repetitions, "ms");
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(LdpImport, parse_tree)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    string path = TESTLIB_SCORES_PATH;
+    time_parse(libScope, read_file(path + "09003-ebook-three-pages.lms"),
+               "09003-ebook-three-pages", 20);
+    time_parse(libScope, read_file(path + "02092-chant.lms"), "02092-chant", 20);
+    time_parse(libScope, read_file(path + "01026-beamed-chords.lms"),
+               "01026-beamed-chords", 20);
+    time_parse(libScope, ldp_piano_score(4, 1000), "4 pianos, 1000 measures", 3);
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(LdpImport, tokenizer_throughput)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    //four pianos, 1000 measures, one element per line
+    string source = ldp_piano_score(4, 1000);
+    for (size_t i = source.find(")("); i != string::npos; i = source.find(")(", i))
+        source.replace(i, 2, ")\n(");
+    const string filename = "lomse-bench-ldp-import.lms";
+    {
+        ofstream file(filename.c_str(), ios::out | ios::binary);
+        file << source;
+    }
+    report("source size", double(source.size()) / 1024.0, "KB");
+
+    const int repetitions = 5;
+    int numTokens = 0;
+    BenchmarkTimer timer;
+    for (int i=0; i < repetitions; ++i)
+    {
+        LdpTextReader reader(source);
+        numTokens = tokenize(reader);
+    }
+    double ms = timer.elapsed_ms();
+    report("tokens", double(numTokens), "tokens");
+    report("tokenizer, from string", mb_per_second(source.size(), repetitions, ms),
+           "MB/s");
+
+    timer.start();
+    for (int i=0; i < repetitions; ++i)
+    {
+        LdpFileReader reader(filename);
+        numTokens = tokenize(reader);
+    }
+    ms = timer.elapsed_ms();
+    report("tokenizer, from file", mb_per_second(source.size(), repetitions, ms), "MB/s");
+
+    timer.start();
+    for (int i=0; i < repetitions; ++i)
+    {
+        stringstream errormsg;
+        LdpParser parser(errormsg, libScope.ldp_factory());
+        parser.parse_file(filename);
+    }
+    ms = timer.elapsed_ms();
+    report("parser (tree of LdpElements), from file",
+           mb_per_second(source.size(), repetitions, ms), "MB/s");
+
+    remove(filename.c_str());
+}
@@ -0,0 +1,92 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_doorway.h"
+#include "lomse_document.h"
+#include "lomse_graphical_model.h"
+#include "lomse_internal_model.h"
+#include "lomse_score_layouter.h"
+
+#include <sstream>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+//helper, to access protected members
+class BenchScoreLayouter : public ScoreLayouter
+{
+public:
+    BenchScoreLayouter(ImoContentObj* pImo, GraphicModel* pGModel,
+                       LibraryScope& libraryScope)
+        : ScoreLayouter(pImo, nullptr, pGModel, libraryScope)
+    {
+    }
+
+    double time_line_breaks(GmoBox* pPageBox)
+    {
+        page_initializations(pPageBox);
+        move_cursor_to_top_left_corner();
+
+        BenchmarkTimer timer;
+        decide_line_breaks();
+        return timer.elapsed_ms();
+    }
+
+    int get_num_systems() { return int(m_breaks.size()); }
+    void delete_all() { delete_not_used_objects(); }
+};
+
+//---------------------------------------------------------------------------------------
+static void time_breaker(LibraryScope& libScope, int numMeasures, const string& title)
+{
+    Document doc(libScope, cout);
+    doc.from_string(ldp_piano_score(1, numMeasures), Document::k_format_ldp);
+    ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+    GraphicModel gmodel( doc.get_im_root() );
+
+    BenchScoreLayouter scoreLyt(pScore, &gmodel, libScope);
+    scoreLyt.prepare_to_start_layout();
+    GmoBoxScorePage pageBox(pScore);
+    pageBox.set_origin(1500.0f, 2000.0f);
+    pageBox.set_width(19000.0f);
+    pageBox.set_height(25700.0f);
+
+    double time = scoreLyt.time_line_breaks(&pageBox);
+
+    stringstream ss;
+    ss << title << ", " << numMeasures << " measures (" << scoreLyt.get_num_columns()
+       << " columns, " << scoreLyt.get_num_systems() << " systems)";
+    report(ss.str(), time, "ms");
+
+    scoreLyt.delete_all();
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(LinesBreaker, optimal_breaks)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    const int measures[] = { 100, 500, 1000, 2000 };
+    for (int numMeasures : measures)
+        time_breaker(libScope, numMeasures, "pruned");
+
+    libScope.set_lines_breaker_max_columns(16);
+    for (int numMeasures : measures)
+        time_breaker(libScope, numMeasures, "lookahead 16 columns");
+    libScope.set_lines_breaker_max_columns(0);
+}
@@ -0,0 +1,70 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_doorway.h"
+#include "lomse_document.h"
+#include "lomse_internal_model.h"
+#include "lomse_midi_file_writer.h"
+#include "lomse_midi_table.h"
+
+#include <memory>
+#include <sstream>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(MidiFileWriter, catalogue_batch)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    //a catalogue of 40 scores, from one to four pianos and 50 to 140 measures
+    int numScores = 40;
+    vector< unique_ptr<Document> > docs;
+    for (int i=0; i < numScores; ++i)
+    {
+        Document* pDoc = LOMSE_NEW Document(libScope, cout);
+        pDoc->from_string(ldp_piano_score(1 + i % 4, 50 + 10 * (i % 10)),
+                          Document::k_format_ldp);
+        docs.push_back( unique_ptr<Document>(pDoc) );
+    }
+
+    //render all scores, including the creation of the events tables
+    MidiFileWriter writer;
+    size_t totalBytes = 0;
+    BenchmarkTimer timer;
+    for (unique_ptr<Document>& doc : docs)
+    {
+        ImoScore* pScore = static_cast<ImoScore*>( doc->get_im_root()->get_content_item(0) );
+        totalBytes += writer.get_source(pScore).size();
+    }
+    double timeRender = timer.elapsed_ms();
+
+    //playback time, at the default tempo of 60 quarter notes per minute
+    double playbackTime = 0.0;
+    for (unique_ptr<Document>& doc : docs)
+    {
+        ImoScore* pScore = static_cast<ImoScore*>( doc->get_im_root()->get_content_item(0) );
+        vector<SoundEvent*>& events = pScore->get_midi_table()->get_events();
+        playbackTime += double(events.back()->DeltaTime) / double(k_duration_quarter);
+    }
+
+    report("scores", numScores, "");
+    report("SMF data", double(totalBytes) / 1024.0, "KB");
+    report("render, all scores", timeRender, "ms");
+    report("scores per second", 1000.0 * numScores / timeRender, "");
+    report("real-time playback, all scores", playbackTime / 60.0, "min");
+}
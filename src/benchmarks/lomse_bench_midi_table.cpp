@@ -0,0 +1,138 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_doorway.h"
+#include "lomse_document.h"
+#include "lomse_internal_model.h"
+#include "lomse_midi_table.h"
+
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+//helper, to access protected members
+class BenchSoundEventsTable : public SoundEventsTable
+{
+public:
+    BenchSoundEventsTable(ImoScore* pScore) : SoundEventsTable(pScore) {}
+
+    void create_unsorted_events()
+    {
+        program_sounds_for_instruments();
+        create_events();
+    }
+
+    //the sort algorithm used before replacing it by a stable sort
+    void bubble_sort_by_time()
+    {
+        int nNumElements = int(m_events.size());
+        for (int i = 0; i < nNumElements; i++)
+        {
+            bool fChanges = false;
+            int j = nNumElements - 1;
+            while ( j != i )
+            {
+                int k = j - 1;
+                if ((m_events[j]->DeltaTime < m_events[k]->DeltaTime) ||
+                    ((m_events[j]->DeltaTime == m_events[k]->DeltaTime) &&
+                     ((m_events[j]->Measure < m_events[k]->Measure) ||
+                      (m_events[j]->EventType < m_events[k]->EventType))))
+                {
+                    SoundEvent* pEvAux = m_events[j];
+                    m_events[j] = m_events[k];
+                    m_events[k] = pEvAux;
+                    fChanges = true;
+                }
+                j = k;
+            }
+            if (!fChanges) break;
+        }
+    }
+
+    void my_sort_by_time() { sort_by_time(); }
+};
+
+//---------------------------------------------------------------------------------------
+static void time_create_table(Document& doc, const string& title,
+                              bool fCompareWithBubble)
+{
+    ImoDocument* pImoDoc = doc.get_im_root();
+    ImoScore* pScore = (pImoDoc ? dynamic_cast<ImoScore*>(pImoDoc->get_content_item(0))
+                                : nullptr);
+    if (!pScore)
+    {
+        report(title + ": score not loaded", 0.0, "");
+        return;
+    }
+
+    BenchmarkTimer timer;
+    SoundEventsTable table(pScore);
+    table.create_table();
+    double timeCreate = timer.elapsed_ms();
+
+    report(title + ": events", double(table.num_events()), "");
+    report(title + ": create_table()", timeCreate, "ms");
+
+    BenchSoundEventsTable sorted(pScore);
+    sorted.create_unsorted_events();
+    timer.start();
+    sorted.my_sort_by_time();
+    report(title + ": sort events, stable sort", timer.elapsed_ms(), "ms");
+
+    if (fCompareWithBubble)
+    {
+        BenchSoundEventsTable bubble(pScore);
+        bubble.create_unsorted_events();
+        timer.start();
+        bubble.bubble_sort_by_time();
+        report(title + ": sort events, bubble sort", timer.elapsed_ms(), "ms");
+    }
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(MidiTable, create_table)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    string path = TESTLIB_SCORES_PATH;
+    {
+        Document doc(libScope, cout);
+        doc.from_file(path + "50047-cross-staff-beamed-group-more-space.xml",
+                      Document::k_format_mxl);
+        time_create_table(doc, "50047-cross-staff", true);
+    }
+    {
+        Document doc(libScope, cout);
+        doc.from_file(path + "unit-tests/other/03-BeetAnGeSample.xml",
+                      Document::k_format_mxl);
+        time_create_table(doc, "03-BeetAnGeSample", true);
+    }
+
+    //synthetic scores: 8 pianos. The bubble sort is O(n^2), only used on small ones
+    const int measures[] = { 50, 200, 500 };
+    for (int numMeasures : measures)
+    {
+        stringstream title;
+        title << "8 pianos, " << numMeasures << " measures";
+        Document doc(libScope, cout);
+        doc.from_string(ldp_piano_score(8, numMeasures), Document::k_format_ldp);
+        time_create_table(doc, title.str(), numMeasures <= 50);
+    }
+}
@@ -0,0 +1,505 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_doorway.h"
+#include "lomse_document.h"
+#include "lomse_import_options.h"
+#include "lomse_injectors.h"
+#include "lomse_internal_model.h"
+#include "lomse_mxl_analyser.h"
+#include "lomse_xml_parser.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#if defined(__GLIBC__)
+    #include <malloc.h>
+#endif
+#if (LOMSE_ENABLE_THREADS == 1)
+    #include <thread>
+#endif
+#if (LOMSE_ENABLE_COMPRESSION == 1)
+    #include "lomse_zip_stream.h"
+    #include <zlib.h>
+#endif
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+//generates a MusicXML piano score with numMeasures measures. Each measure contains
+//beamed eighth notes with a slur in the right hand, a chord and a dynamics mark in
+//the left hand, and a barline. When fLayout is true, the score also includes the
+//layout hints that exporters usually generate: page and system layout in <defaults>,
+//and a <print> element in each measure. The score has numParts identical pianos.
+static string mxl_piano_score(int numMeasures, bool fLayout=false, int numParts=1)
+{
+    static const char* steps[] = { "C", "D", "E", "F", "G", "A", "B" };
+
+    stringstream ss;
+    ss << "<?xml version='1.0' encoding='UTF-8' standalone='no'?>"
+       << "<score-partwise version='3.1'>";
+    if (fLayout)
+    {
+        ss << "<defaults><scaling><millimeters>7</millimeters><tenths>40</tenths>"
+           << "</scaling><page-layout><page-height>1697</page-height>"
+           << "<page-width>1200</page-width><page-margins type='both'>"
+           << "<left-margin>70</left-margin><right-margin>70</right-margin>"
+           << "<top-margin>88</top-margin><bottom-margin>88</bottom-margin>"
+           << "</page-margins></page-layout><system-layout><system-margins>"
+           << "<left-margin>0</left-margin><right-margin>0</right-margin>"
+           << "</system-margins><system-distance>121</system-distance>"
+           << "</system-layout><staff-layout><staff-distance>65</staff-distance>"
+           << "</staff-layout></defaults>";
+    }
+
+    //all parts have the same content
+    stringstream measures;
+    for (int m=1; m <= numMeasures; ++m)
+    {
+        measures << "<measure number='" << m << "'>";
+        if (fLayout)
+        {
+            measures << "<print new-system='" << (m % 4 == 1 ? "yes" : "no") << "'>"
+                     << "<system-layout><system-margins><left-margin>0</left-margin>"
+                     << "<right-margin>0</right-margin></system-margins>"
+                     << "<system-distance>121</system-distance></system-layout>"
+                     << "<staff-layout number='2'><staff-distance>65</staff-distance>"
+                     << "</staff-layout></print>";
+        }
+        if (m == 1)
+        {
+            measures << "<attributes><divisions>2</divisions>"
+                     << "<key><fifths>0</fifths></key>"
+                     << "<time><beats>4</beats><beat-type>4</beat-type></time><staves>2</staves>"
+                     << "<clef number='1'><sign>G</sign><line>2</line></clef>"
+                     << "<clef number='2'><sign>F</sign><line>4</line></clef></attributes>";
+        }
+        for (int i=0; i < 8; ++i)
+        {
+            measures << "<note><pitch><step>" << steps[(m + i) % 7] << "</step>"
+                     << "<octave>4</octave></pitch><duration>1</duration><voice>1</voice>"
+                     << "<type>eighth</type><stem>up</stem><staff>1</staff>"
+                     << "<beam number='1'>" << (i % 2 == 0 ? "begin" : "end")
+                     << "</beam>";
+            if (i == 0 || i == 7)
+            {
+                measures << "<notations><slur number='1' type='"
+                         << (i == 0 ? "start" : "stop") << "'/></notations>";
+            }
+            measures << "</note>";
+        }
+        measures << "<backup><duration>8</duration></backup>"
+                 << "<direction placement='below'><direction-type>"
+                 << "<dynamics><mf/></dynamics></direction-type><staff>2</staff></direction>";
+        for (int i=0; i < 2; ++i)
+        {
+            measures << "<note>" << (i > 0 ? "<chord/>" : "")
+                     << "<pitch><step>" << steps[(m + 2*i) % 7] << "</step>"
+                     << "<octave>3</octave></pitch><duration>8</duration><voice>2</voice>"
+                     << "<type>whole</type><staff>2</staff></note>";
+        }
+        measures << "<barline location='right'><bar-style>regular</bar-style></barline>"
+                 << "</measure>";
+    }
+
+    ss << "<part-list>";
+    for (int p=1; p <= numParts; ++p)
+        ss << "<score-part id='P" << p << "'><part-name>Piano</part-name></score-part>";
+    ss << "</part-list>";
+    for (int p=1; p <= numParts; ++p)
+        ss << "<part id='P" << p << "'>" << measures.str() << "</part>";
+    ss << "</score-partwise>";
+    return ss.str();
+}
+
+//---------------------------------------------------------------------------------------
+static string read_file(const string& filename)
+{
+    ifstream file(filename.c_str(), ios::in | ios::binary);
+    stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+//---------------------------------------------------------------------------------------
+static double mb_per_second(size_t bytes, int repetitions, double ms)
+{
+    return (double(bytes) * repetitions / (1024.0 * 1024.0)) / (max(ms, 0.001) / 1000.0);
+}
+
+//---------------------------------------------------------------------------------------
+static void time_import(LibraryScope& libScope, const string& source,
+                        const string& title, int repetitions)
+{
+    //parsing and analysis are measured in isolation and also the full import
+    //(parsing, analysis and building the internal model)
+
+    double timeParse = 0.0;
+    double timeAnalyse = 0.0;
+    for (int i=0; i < repetitions; ++i)
+    {
+        stringstream errormsg;
+        Document doc(libScope, errormsg);
+        XmlParser parser(errormsg);
+
+        BenchmarkTimer timer;
+        parser.parse_text(source);
+        timeParse += timer.elapsed_ms();
+
+        MxlAnalyser a(errormsg, libScope, &doc, &parser);
+        timer.start();
+        ImoObj* pRoot = a.analyse_tree(parser.get_tree_root(), "string:");
+        timeAnalyse += timer.elapsed_ms();
+        delete pRoot;
+    }
+
+    BenchmarkTimer timer;
+    for (int i=0; i < repetitions; ++i)
+    {
+        stringstream errormsg;
+        Document doc(libScope, errormsg);
+        doc.from_string(source, Document::k_format_mxl);
+    }
+    double timeImport = timer.elapsed_ms();
+
+    stringstream ss;
+    ss << title << " (" << source.size() / 1024 << " KB)";
+    report(ss.str() + ", parse", mb_per_second(source.size(), repetitions, timeParse),
+           "MB/s");
+    report(ss.str() + ", analyse", mb_per_second(source.size(), repetitions, timeAnalyse),
+           "MB/s");
+    report(ss.str() + ", full import", mb_per_second(source.size(), repetitions, timeImport),
+           "MB/s");
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(MxlImport, throughput)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    string path = TESTLIB_SCORES_PATH;
+    time_import(libScope, read_file(path + "50047-cross-staff-beamed-group-more-space.xml"),
+                "50047-cross-staff", 10);
+    time_import(libScope, read_file(path + "unit-tests/other/03-BeetAnGeSample.xml"),
+                "03-BeetAnGeSample", 10);
+
+    const int measures[] = { 100, 1000 };
+    for (int numMeasures : measures)
+    {
+        stringstream title;
+        title << "piano, " << numMeasures << " measures";
+        time_import(libScope, mxl_piano_score(numMeasures), title.str(), 5);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+//Peak memory is measured by using the Linux counters in /proc/self/status. The peak
+//counter (VmHWM) is reset by writing in /proc/self/clear_refs. Before each
+//measurement, free memory retained by malloc is returned to the system.
+static long memory_kb(const string& field)
+{
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line))
+    {
+        if (line.compare(0, field.size(), field) == 0)
+            return atol(line.c_str() + field.size() + 1);
+    }
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------
+static void measure_file_import(const string& title, std::function<void()> import)
+{
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+    ofstream("/proc/self/clear_refs") << "5";
+    long startKB = memory_kb("VmRSS");
+
+    BenchmarkTimer timer;
+    import();
+    double ms = timer.elapsed_ms();
+
+    report(title, ms, "ms");
+    report(title + ", peak memory", double(memory_kb("VmHWM") - startKB) / 1024.0, "MB");
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(MxlImport, large_file)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+    Document warmup(libScope);
+    warmup.from_string(mxl_piano_score(2, true), Document::k_format_mxl);
+
+    //piano score, with layout hints in each measure
+    const string filename = "lomse-bench-mxl-import.xml";
+    {
+        string source = mxl_piano_score(8000, true);
+        ofstream file(filename.c_str(), ios::out | ios::binary);
+        file << source;
+        report("file size", double(source.size()) / (1024.0 * 1024.0), "MB");
+    }
+
+    measure_file_import("parse, file copied into a buffer", [&]() {
+        pugi::xml_document doc;
+        doc.load_file(filename.c_str(), pugi::parse_default | pugi::parse_declaration);
+    });
+
+    measure_file_import("parse, file mapped and parsed in place", [&]() {
+        XmlParser parser;
+        parser.parse_file(filename);
+    });
+
+    measure_file_import("parse, in place, embedded text", [&]() {
+        XmlParser parser;
+        parser.embed_pcdata(true);
+        parser.parse_file(filename);
+    });
+
+    measure_file_import("full import", [&]() {
+        stringstream errormsg;
+        Document doc(libScope, errormsg);
+        doc.from_file(filename, Document::k_format_mxl);
+    });
+
+    MusicXmlOptions* opt = libScope.get_musicxml_options();
+    opt->skip_layout(true);
+    measure_file_import("full import, skipping layout", [&]() {
+        stringstream errormsg;
+        Document doc(libScope, errormsg);
+        doc.from_file(filename, Document::k_format_mxl);
+    });
+    opt->skip_layout(false);
+
+    remove(filename.c_str());
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(MxlImport, concurrent_parts)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    //eight pianos, 500 measures. Analysis time, with the parts analysed by one
+    //or several threads
+    string source = mxl_piano_score(500, false, 8);
+    report("source size", double(source.size()) / 1024.0, "KB");
+#if (LOMSE_ENABLE_THREADS == 1)
+    report("hardware threads", double(std::thread::hardware_concurrency()), "threads");
+#endif
+
+    MusicXmlOptions* opt = libScope.get_musicxml_options();
+    const int threads[] = { 1, 2, 4, 8 };
+    for (int numThreads : threads)
+    {
+        opt->analysis_threads(numThreads);
+        const int repetitions = 3;
+        double timeAnalyse = 0.0;
+        for (int i=0; i < repetitions; ++i)
+        {
+            stringstream errormsg;
+            Document doc(libScope, errormsg);
+            XmlParser parser(errormsg);
+            parser.parse_text(source);
+
+            MxlAnalyser a(errormsg, libScope, &doc, &parser);
+            BenchmarkTimer timer;
+            ImoObj* pRoot = a.analyse_tree(parser.get_tree_root(), "string:");
+            timeAnalyse += timer.elapsed_ms();
+            delete pRoot;
+        }
+        stringstream title;
+        title << "analyse, " << numThreads << " thread" << (numThreads > 1 ? "s" : "");
+        report(title.str(), timeAnalyse / repetitions, "ms");
+    }
+    opt->analysis_threads(1);
+}
+
+#if (LOMSE_ENABLE_COMPRESSION == 1)
+//---------------------------------------------------------------------------------------
+//Minimal zip writer for creating compressed MusicXML files (.mxl). Lomse only includes
+//the minizip code for reading zip files.
+class ZipWriter
+{
+protected:
+    struct Entry
+    {
+        string name;
+        unsigned long crc;
+        unsigned long compressedSize;
+        unsigned long size;
+        unsigned long offset;
+    };
+
+    ofstream m_file;
+    vector<Entry> m_entries;
+
+public:
+    ZipWriter(const string& filename) : m_file(filename.c_str(), ios::out | ios::binary) {}
+
+    void add_entry(const string& name, const string& data)
+    {
+        z_stream zs = z_stream();
+        deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                     Z_DEFAULT_STRATEGY);
+        vector<unsigned char> buffer(deflateBound(&zs, uLong(data.size())));
+        zs.next_in = (Bytef*)(data.data());
+        zs.avail_in = uInt(data.size());
+        zs.next_out = buffer.data();
+        zs.avail_out = uInt(buffer.size());
+        deflate(&zs, Z_FINISH);
+        deflateEnd(&zs);
+
+        Entry entry;
+        entry.name = name;
+        entry.crc = crc32(0L, (const Bytef*)(data.data()), uInt(data.size()));
+        entry.compressedSize = zs.total_out;
+        entry.size = (unsigned long)(data.size());
+        entry.offset = (unsigned long)(m_file.tellp());
+        m_entries.push_back(entry);
+
+        write_32(0x04034b50);       //local file header
+        write_entry_fields(entry);
+        write_16(0);                //extra field length
+        m_file << name;
+        m_file.write((const char*)buffer.data(), entry.compressedSize);
+    }
+
+    void close()
+    {
+        unsigned long start = (unsigned long)(m_file.tellp());
+        for (const Entry& entry : m_entries)
+        {
+            write_32(0x02014b50);   //central directory file header
+            write_16(20);           //version made by
+            write_entry_fields(entry);
+            write_16(0);            //extra field length
+            write_16(0);            //comment length
+            write_16(0);            //disk number
+            write_16(0);            //internal attributes
+            write_32(0);            //external attributes
+            write_32(entry.offset);
+            m_file << entry.name;
+        }
+        unsigned long end = (unsigned long)(m_file.tellp());
+        write_32(0x06054b50);       //end of central directory
+        write_16(0);
+        write_16(0);
+        write_16((unsigned long)(m_entries.size()));
+        write_16((unsigned long)(m_entries.size()));
+        write_32(end - start);
+        write_32(start);
+        write_16(0);
+        m_file.close();
+    }
+
+protected:
+    void write_entry_fields(const Entry& entry)
+    {
+        write_16(20);               //version needed
+        write_16(0);                //flags
+        write_16(Z_DEFLATED);       //compression method
+        write_16(0);                //time
+        write_16(0x21);             //date: 1980-01-01
+        write_32(entry.crc);
+        write_32(entry.compressedSize);
+        write_32(entry.size);
+        write_16((unsigned long)(entry.name.size()));
+    }
+
+    void write_16(unsigned long value)
+    {
+        m_file.put(char(value & 0xFF));
+        m_file.put(char((value >> 8) & 0xFF));
+    }
+
+    void write_32(unsigned long value)
+    {
+        write_16(value & 0xFFFF);
+        write_16((value >> 16) & 0xFFFF);
+    }
+};
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(MxlImport, compressed_file)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+    Document warmup(libScope);
+    warmup.from_string(mxl_piano_score(2, true), Document::k_format_mxl);
+
+    //piano score, with layout hints in each measure, compressed
+    const string filename = "lomse-bench-mxl-import.mxl";
+    {
+        string source = mxl_piano_score(8000, true);
+        ZipWriter zip(filename);
+        zip.add_entry("META-INF/container.xml",
+            "<?xml version='1.0' encoding='UTF-8'?><container><rootfiles>"
+            "<rootfile full-path='score.xml'/></rootfiles></container>");
+        zip.add_entry("score.xml", source);
+        zip.close();
+        report("uncompressed size", double(source.size()) / (1024.0 * 1024.0), "MB");
+        ifstream file(filename.c_str(), ios::in | ios::binary | ios::ate);
+        report("file size", double(file.tellg()) / (1024.0 * 1024.0), "MB");
+    }
+
+    measure_file_import("inflate", [&]() {
+        ZipInputStream zip(filename);
+        zip.move_to_entry("score.xml");
+        zip.open_current_entry();
+        std::vector<unsigned char> buffer = zip.get_as_vector();
+    });
+
+    measure_file_import("inflate and parse, buffer copied by the parser", [&]() {
+        ZipInputStream zip(filename);
+        zip.move_to_entry("score.xml");
+        zip.open_current_entry();
+        std::vector<unsigned char> buffer = zip.get_as_vector();
+        XmlParser parser;
+        parser.embed_pcdata(true);
+        parser.parse_buffer(buffer.data(), buffer.size());
+    });
+
+    measure_file_import("inflate and parse in place", [&]() {
+        ZipInputStream zip(filename);
+        zip.move_to_entry("score.xml");
+        zip.open_current_entry();
+        XmlParser parser;
+        parser.embed_pcdata(true);
+        parser.parse_buffer_inplace( zip.get_as_vector() );
+    });
+
+    measure_file_import("full import", [&]() {
+        stringstream errormsg;
+        Document doc(libScope, errormsg);
+        doc.from_file(filename, Document::k_format_mxl_compressed);
+    });
+
+    remove(filename.c_str());
+}
+#endif
@@ -0,0 +1,122 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_box_system.h"
+#include "lomse_build_options.h"
+#include "lomse_document.h"
+#include "lomse_document_layouter.h"
+#include "lomse_doorway.h"
+#include "lomse_graphical_model.h"
+#include "lomse_injectors.h"
+#include "lomse_internal_model.h"
+#include "lomse_playback_timeline.h"
+#include "lomse_time.h"
+
+#include <sstream>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+//helper: the algorithm for finding the system used before the timeline was introduced
+static GmoBoxSystem* find_system_by_pages_scan(GraphicModel* pGModel, ImoId scoreId,
+                                               TimeUnits timepos)
+{
+    ScoreStub* pStub = pGModel->get_stub_for(scoreId);
+    GmoBoxScorePage* pPage = pStub->get_page_for(timepos);
+    if (!pPage)
+        return nullptr;
+
+    int i = pPage->get_num_first_system();
+    int maxSystem = pPage->get_num_systems() + i;
+    for (; i < maxSystem; ++i)
+    {
+        GmoBoxSystem* pSystem = pPage->get_system(i);
+        if (is_lower_time(timepos, pSystem->end_time()))
+            return pSystem;
+        else if (is_equal_time(timepos, pSystem->end_time()))
+        {
+            GmoBoxSystem* pNextSystem = pPage->get_system(i + 1);
+            if (pNextSystem && is_equal_time(timepos, pNextSystem->start_time()))
+                return pNextSystem;
+            return pSystem;
+        }
+    }
+    return nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(PlaybackTimeline, visual_tracking_lookups)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    //four pianos, 500 measures
+    int numMeasures = 500;
+    Document doc(libScope, cout);
+    doc.from_string(ldp_piano_score(4, numMeasures), Document::k_format_ldp);
+    ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+    ImoId scoreId = pScore->get_id();
+
+    DocLayouter layouter(&doc, libScope);
+    layouter.layout_document();
+    GraphicModel* pGModel = layouter.get_graphic_model();
+    report("pages", pGModel->get_num_pages(), "");
+    report("systems", pGModel->get_num_systems(scoreId), "");
+
+    BenchmarkTimer timer;
+    PlaybackTimeline* pTimeline = pGModel->get_playback_timeline(scoreId);
+    report("timeline build", timer.elapsed_ms(), "ms");
+    report("timeline entries", pTimeline->get_num_entries(), "");
+
+    //a tempo line event for each eighth note and one between events, as when
+    //playing at a fast tempo
+    int numEvents = 0;
+    LUnits total = 0.0f;
+    timer.start();
+    for (TimeUnits timepos = 0.0; timepos < numMeasures * 256.0; timepos += 16.0)
+    {
+        GmoBoxSystem* pSystem = find_system_by_pages_scan(pGModel, scoreId, timepos);
+        if (pSystem)
+            total += pSystem->get_x_for_note_rest_at_time(timepos);
+        ++numEvents;
+    }
+    double timeSystem = timer.elapsed_ms();
+
+    timer.start();
+    PlaybackTimeline::Position pos;
+    for (TimeUnits timepos = 0.0; timepos < numMeasures * 256.0; timepos += 16.0)
+    {
+        if (pTimeline->locate(timepos, &pos))
+            total -= pos.x;
+    }
+    double timeTimeline = timer.elapsed_ms();
+
+    int numDifferent = 0;
+    for (TimeUnits timepos = 0.0; timepos < numMeasures * 256.0; timepos += 16.0)
+    {
+        GmoBoxSystem* pSystem = find_system_by_pages_scan(pGModel, scoreId, timepos);
+        numDifferent += (pSystem != pTimeline->get_system_for(timepos) ? 1 : 0);
+    }
+
+    report("tempo line lookups", numEvents, "");
+    report("pages scan (per lookup)", 1000.0 * timeSystem / numEvents, "us");
+    report("timeline (per lookup)", 1000.0 * timeTimeline / numEvents, "us");
+    report("results mismatch", numDifferent, "");
+    if (total == 0.0f)
+        report("(checksum)", total, "");
+
+    delete pGModel;
+}
@@ -0,0 +1,84 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_document.h"
+#include "lomse_document_layouter.h"
+#include "lomse_doorway.h"
+#include "lomse_graphical_model.h"
+#include "lomse_injectors.h"
+#include "lomse_profiler.h"
+
+#include <sstream>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+static double time_open(LibraryScope& libScope, const string& source,
+                        PhaseProfiler* pProfiler, int repetitions)
+{
+    BenchmarkTimer timer;
+    for (int i=0; i < repetitions; ++i)
+    {
+        Document doc(libScope, cout);
+        doc.set_profiler(pProfiler);
+        doc.from_string(source, Document::k_format_ldp);
+    }
+    return timer.elapsed_ms() / repetitions;
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(Profiler, open_phases)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    //four pianos, 500 measures
+    string source = ldp_piano_score(4, 500);
+
+    //profiler overhead
+    PhaseProfiler profiler;
+    report("open, not profiling", time_open(libScope, source, nullptr, 3), "ms");
+    report("open, profiling", time_open(libScope, source, &profiler, 3), "ms");
+
+    //timings per phase, for opening the document and for its layout
+    profiler.clear();
+    Document doc(libScope, cout);
+    doc.set_profiler(&profiler);
+    doc.from_string(source, Document::k_format_ldp);
+    DocLayouter layouter(&doc, libScope);
+    layouter.layout_document();
+    delete layouter.get_graphic_model();
+
+    const char* phases[] = {
+        "Document::from_string",
+        "LdpParser::parse",
+        "LdpAnalyser::analyse_tree",
+        "ModelBuilder::build_model",
+        "ColStaffObjsBuilder::build",
+        "MeasuresTableBuilder::build",
+        "MidiAssigner::assign_midi_data",
+        "PitchAssigner::assign_pitch",
+        "DocLayouter::layout_document",
+        "ColumnsBuilder::create_columns",
+        "ColumnsBuilder::do_spacing_algorithm",
+        "ScoreLayouter::decide_line_breaks",
+        "SystemLayouter::engrave_system",
+        "SystemLayouter::engrave_system_details",
+    };
+    for (const char* name : phases)
+        report(name, profiler.get_total_time(name), "ms");
+}
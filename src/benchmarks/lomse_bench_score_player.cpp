@@ -0,0 +1,136 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#include "lomse_config.h"
+#if (LOMSE_ENABLE_THREADS == 1)
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_document.h"
+#include "lomse_doorway.h"
+#include "lomse_injectors.h"
+#include "lomse_internal_model.h"
+#include "lomse_player_gui.h"
+#include "lomse_score_player.h"
+
+#include <sstream>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+//helper, for accessing protected members
+class BenchScorePlayer : public ScorePlayer
+{
+public:
+    BenchScorePlayer(LibraryScope& libScope, MidiServerBase* pMidi)
+        : ScorePlayer(libScope, pMidi)
+    {
+    }
+
+    void wait_for_termination()
+    {
+        while (m_fPlaying)
+            std::this_thread::sleep_for( std::chrono::milliseconds(10) );
+        if (m_pThread && m_pThread->joinable())
+            m_pThread->join();
+        m_pThread.reset();
+    }
+};
+
+//---------------------------------------------------------------------------------------
+//helper, midi server saving the time at which each note on is sent
+class BenchMidiServer : public MidiServerBase
+{
+public:
+    std::vector<PlaybackTime> m_noteOn;
+
+    void note_on_at(PlaybackTime UNUSED(when), int UNUSED(channel), int UNUSED(pitch),
+                    int UNUSED(volume)) override
+    {
+        m_noteOn.push_back(PlaybackClock::now());
+    }
+};
+
+//---------------------------------------------------------------------------------------
+//helper: the scheduling used before absolute deadlines were introduced: metronome
+//interval truncated to milliseconds and relative waits in whole milliseconds.
+//Returns the drift, in milliseconds, between first and last event
+static double play_with_relative_waits(int numNotes, long nDuration, long bpm)
+{
+    long nMtrIntval = 60000L / bpm;
+    float conversionFactor = float(nMtrIntval) / 64.0f;
+
+    PlaybackTime start = PlaybackClock::now();
+    long curTime = 0L;
+    for (int i=1; i < numNotes; ++i)
+    {
+        long nEvTime = long( float(i * nDuration) * conversionFactor );
+        long waitT = nEvTime - curTime;
+        if (waitT > 0L)
+            std::this_thread::sleep_for( std::chrono::milliseconds(waitT) );
+        curTime = nEvTime;
+    }
+    double elapsed = double( std::chrono::duration_cast<std::chrono::microseconds>(
+                                PlaybackClock::now() - start).count() ) / 1000.0;
+    double expected = double((numNotes - 1) * nDuration) * 60000.0 / (64.0 * double(bpm));
+    return elapsed - expected;
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(ScorePlayer, scheduling_drift)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    //160 sixteenth notes at 960 BPM: 15.625 ms per note
+    int numNotes = 160;
+    long bpm = 960L;
+    stringstream ss;
+    ss << "(score (vers 2.0)(instrument (musicData (clef G)";
+    for (int i=0; i < numNotes; ++i)
+        ss << "(n c4 s)";
+    ss << ")))";
+    Document doc(libScope, cout);
+    doc.from_string(ss.str(), Document::k_format_ldp);
+    ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+
+    report("relative waits: drift", play_with_relative_waits(numNotes, 16L, bpm), "ms");
+
+    BenchMidiServer midi;
+    BenchScorePlayer player(libScope, &midi);
+    PlayerNoGui playGui;
+    player.load_score(pScore, &playGui);
+    player.play(k_no_visual_tracking, bpm, nullptr);
+    player.wait_for_termination();
+
+    double drift = 0.0;
+    if (!midi.m_noteOn.empty())
+    {
+        double elapsed = double( std::chrono::duration_cast<std::chrono::microseconds>(
+                            midi.m_noteOn.back() - midi.m_noteOn.front()).count() ) / 1000.0;
+        double expected = double((midi.m_noteOn.size() - 1) * 16) * 60000.0
+                          / (64.0 * double(bpm));
+        drift = elapsed - expected;
+    }
+    report("absolute deadlines: drift", drift, "ms");
+
+    PlaybackTimingStats stats = player.get_timing_stats();
+    report("absolute deadlines: wake-ups", stats.numEvents, "");
+    report("absolute deadlines: mean lateness", stats.meanLateness, "us");
+    report("absolute deadlines: jitter", stats.jitter, "us");
+    report("absolute deadlines: max lateness", stats.maxLateness, "us");
+}
+
+#endif  //LOMSE_ENABLE_THREADS == 1
@@ -0,0 +1,151 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_doorway.h"
+#include "lomse_document.h"
+#include "lomse_document_cursor.h"
+#include "lomse_command.h"
+#include "lomse_internal_model.h"
+#include "lomse_selections.h"
+#include "lomse_staffobjs_table.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+//a two instruments piano score with about 100k entries in the staffobjs table
+static void load_big_score(Document& doc)
+{
+    doc.from_string(ldp_piano_score(2, 3850), Document::k_format_ldp);
+}
+
+//---------------------------------------------------------------------------------------
+static vector<ImoStaffObj*> sample_staffobjs(ColStaffObjs* pTable, int numSamples)
+{
+    //staffobjs evenly distributed along the table
+    vector<ImoStaffObj*> samples;
+    int step = max(1, pTable->num_entries() / numSamples);
+    int i = 0;
+    for (ColStaffObjsIterator it = pTable->begin(); it != pTable->end(); ++it, ++i)
+    {
+        if (i % step == 0)
+            samples.push_back( (*it)->imo_object() );
+    }
+    return samples;
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(ColStaffObjs, find_and_edit)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    Document doc(libScope, cout);
+    load_big_score(doc);
+    ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+    ColStaffObjs* pTable = pScore->get_staffobjs_table();
+    report("table size", double(pTable->num_entries()), "entries");
+
+    //find entries
+    vector<ImoStaffObj*> samples = sample_staffobjs(pTable, 2000);
+    BenchmarkTimer timer;
+    int found = 0;
+    for (ImoStaffObj* pSO : samples)
+        found += (pTable->find(pSO) != pTable->end() ? 1 : 0);
+    double ms = timer.elapsed_ms();
+    report("find entry (per find)", 1000.0 * ms / samples.size(), "us");
+    report("entries found", double(found), "entries");
+
+    //cursor moves
+    ScoreCursor cursor(&doc, pScore);
+    timer.start();
+    for (ImoStaffObj* pSO : samples)
+        cursor.point_to(pSO->get_id());
+    ms = timer.elapsed_ms();
+    report("cursor point_to (per move)", 1000.0 * ms / samples.size(), "us");
+
+    //note insertion, at the middle of the score
+    DocCursor docCursor(&doc);
+    SelectionSet sel(&doc);
+    DocCommandExecuter executer(&doc);
+    docCursor.point_to(samples[samples.size() / 2]->get_id());
+    const int numInsertions = 5;
+    timer.start();
+    for (int i=0; i < numInsertions; ++i)
+    {
+        executer.execute(&docCursor, LOMSE_NEW CmdAddNoteRest("(n c4 e v1)",
+                                                              k_edit_mode_ripple), &sel);
+    }
+    ms = timer.elapsed_ms();
+    report("insert note (per insertion)", ms / numInsertions, "ms");
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(ColStaffObjs, random_cursor_moves)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    Document doc(libScope, cout);
+    load_big_score(doc);
+    ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+    ColStaffObjs* pTable = pScore->get_staffobjs_table();
+    report("table size", double(pTable->num_entries()), "entries");
+
+    //random targets, as when jumping around the score (go to measure, click on
+    //a note, playback follow)
+    const int numMoves = 2000;
+    const int numMeasures = 3850;
+    std::mt19937 rnd(1234);
+    vector<int> measures;
+    vector<int> instruments;
+    for (int i=0; i < numMoves; ++i)
+    {
+        measures.push_back( int(rnd() % numMeasures) + 1 );
+        instruments.push_back( int(rnd() % 2) );
+    }
+    vector<ImoStaffObj*> samples = sample_staffobjs(pTable, numMoves);
+    std::shuffle(samples.begin(), samples.end(), rnd);
+
+    ScoreCursor cursor(&doc, pScore);
+    BenchmarkTimer timer;
+    cursor.to_measure(1, 0, 0);     //the first move builds the navigation index
+    report("first move", timer.elapsed_ms(), "ms");
+
+    timer.start();
+    for (int i=0; i < numMoves; ++i)
+        cursor.to_measure(measures[i], instruments[i], 0);
+    double ms = timer.elapsed_ms();
+    report("to_measure (per move)", 1000.0 * ms / numMoves, "us");
+
+    timer.start();
+    for (int i=0; i < numMoves; ++i)
+        cursor.to_time(instruments[i], 0, (measures[i] - 1) * k_duration_whole);
+    ms = timer.elapsed_ms();
+    report("to_time (per move)", 1000.0 * ms / numMoves, "us");
+
+    timer.start();
+    for (ImoStaffObj* pSO : samples)
+        cursor.point_to(pSO->get_id());
+    ms = timer.elapsed_ms();
+    report("point_to (per move)", 1000.0 * ms / samples.size(), "us");
+}
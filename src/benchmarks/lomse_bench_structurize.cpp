@@ -0,0 +1,114 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_doorway.h"
+#include "lomse_document.h"
+#include "lomse_document_cursor.h"
+#include "lomse_command.h"
+#include "lomse_internal_model.h"
+#include "lomse_im_note.h"
+#include "lomse_model_builder.h"
+#include "lomse_selections.h"
+#include "lomse_staffobjs_table.h"
+
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+// BenchDocument:  Helper class to use Document protected members
+class BenchDocument : public Document
+{
+public:
+    BenchDocument(LibraryScope& libraryScope, ostream& reporter)
+        : Document(libraryScope, reporter) {}
+   ~BenchDocument() override {}
+
+    void my_clear_dirty() { clear_dirty(); }
+};
+
+//---------------------------------------------------------------------------------------
+static ImoNote* first_note_in_instrument(ImoScore* pScore, int iInstr)
+{
+    ColStaffObjs* pTable = pScore->get_staffobjs_table();
+    for (ColStaffObjsIterator it = pTable->begin(); it != pTable->end(); ++it)
+    {
+        if ((*it)->num_instrument() == iInstr && (*it)->imo_object()->is_note())
+            return static_cast<ImoNote*>( (*it)->imo_object() );
+    }
+    return nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(Structurize, per_edit_latency)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    //four pianos, 1000 measures
+    BenchDocument doc(libScope, cout);
+    doc.from_string(ldp_piano_score(4, 1000), Document::k_format_ldp);
+    doc.my_clear_dirty();
+    ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+    report("table size", double(pScore->get_staffobjs_table()->num_entries()), "entries");
+
+    const int numEdits = 10;
+
+    //full structurize, as done before for every edit
+    ModelBuilder builder;
+    BenchmarkTimer timer;
+    for (int i=0; i < numEdits; ++i)
+        builder.structurize(pScore);
+    report("full structurize (per edit)", timer.elapsed_ms() / numEdits, "ms");
+
+    //incremental structurize, after modifying a note in one instrument. Modifying
+    //the last instrument only requires re-inserting its entries, modifying the first
+    //one requires re-inserting the entries for all instruments. The document dirty
+    //flag is cleared after each edit, as it is done when the graphic model is rebuilt
+    for (int iInstr = 3; iInstr >= 0; iInstr -= 3)
+    {
+        ImoNote* pNote = first_note_in_instrument(pScore, iInstr);
+        timer.start();
+        for (int i=0; i < numEdits; ++i)
+        {
+            pNote->set_dirty(true);
+            pScore->end_of_marked_changes();
+            doc.my_clear_dirty();
+        }
+        stringstream ss;
+        ss << "incremental structurize, instrument " << iInstr + 1 << " (per edit)";
+        report(ss.str(), timer.elapsed_ms() / numEdits, "ms");
+    }
+
+    //full edition command, in the last instrument
+    DocCursor cursor(&doc);
+    SelectionSet sel(&doc);
+    DocCommandExecuter executer(&doc);
+    ImoId noteId = first_note_in_instrument(pScore, 3)->get_id();
+    cursor.point_to(noteId);
+    sel.add(noteId);
+    timer.start();
+    for (int i=0; i < numEdits; ++i)
+    {
+        executer.execute(&cursor, LOMSE_NEW CmdChangeDots(1), &sel);
+        doc.my_clear_dirty();
+        executer.execute(&cursor, LOMSE_NEW CmdChangeDots(0), &sel);
+        doc.my_clear_dirty();
+    }
+    report("change dots command (per command)", timer.elapsed_ms() / (2 * numEdits), "ms");
+}
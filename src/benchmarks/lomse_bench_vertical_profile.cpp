@@ -0,0 +1,126 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_document.h"
+#include "lomse_document_layouter.h"
+#include "lomse_doorway.h"
+#include "lomse_graphical_model.h"
+#include "lomse_injectors.h"
+#include "lomse_shapes.h"
+#include "lomse_vertical_profile.h"
+
+#include <sstream>
+
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+//helper: a dense keyboard score. Each measure has sixteen chords of sixteenths with
+//accidentals in the right hand and eight chords of eighths in the left hand
+static string ldp_dense_keyboard_score(int numInstruments, int numMeasures)
+{
+    static const char* high[] = { "+c5", "d5", "-e5", "f5", "+f5", "g5", "-a5", "b5" };
+    static const char* low[] = { "c3", "-e3", "g3", "+g3" };
+
+    stringstream ss;
+    ss << "(score (vers 2.0)";
+    for (int iInstr=0; iInstr < numInstruments; ++iInstr)
+    {
+        ss << "(instrument (staves 2)(musicData (clef G p1)(clef F4 p2)(key C)(time 4 4)";
+        for (int iMeasure=0; iMeasure < numMeasures; ++iMeasure)
+        {
+            for (int i=0; i < 16; ++i)
+            {
+                int k = (i + iMeasure) % 8;
+                ss << "(chord (n " << high[k] << " s v1 p1)(n " << high[(k + 2) % 8]
+                   << " s v1 p1)(n " << high[(k + 4) % 8] << " s v1 p1))";
+            }
+            ss << "(goBack w)";
+            for (int i=0; i < 8; ++i)
+            {
+                ss << "(chord (n " << low[i % 4] << " e v2 p2)(n "
+                   << low[(i + 1) % 4] << " e v2 p2))";
+            }
+            ss << "(barline simple)";
+        }
+        ss << "))";
+    }
+    ss << ")";
+    return ss.str();
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(VerticalProfile, update_and_query)
+{
+    //a wide system with many narrow shapes, as in a dense system of a keyboard score
+    int numShapes = 20000;
+    LUnits xStart = 0.0f;
+    LUnits xEnd = numShapes * 200.0f;
+    vector<GmoShapeRectangle*> shapes;
+    shapes.reserve(numShapes);
+    for (int i=0; i < numShapes; ++i)
+    {
+        GmoShapeRectangle* pShape = LOMSE_NEW GmoShapeRectangle(nullptr);
+        pShape->set_origin(i * 200.0f + (i % 3) * 50.0f, 1000.0f + (i * 37 % 23) * 100.0f);
+        pShape->set_width(180.0f + (i % 5) * 60.0f);
+        pShape->set_height(300.0f + (i * 13 % 7) * 150.0f);
+        shapes.push_back(pShape);
+    }
+
+    VerticalProfile vp(xStart, xEnd, 1);
+    vp.initialize(0, 2000.0f, 2400.0f);
+    {
+        BenchmarkTimer timer;
+        for (GmoShapeRectangle* pShape : shapes)
+            vp.update(pShape, 0);
+        report("update, 20000 shapes", timer.elapsed_ms(), "ms");
+    }
+
+    {
+        BenchmarkTimer timer;
+        LUnits total = 0.0f;
+        for (int i=0; i < numShapes; ++i)
+        {
+            LUnits x = i * 200.0f;
+            total += vp.get_max_for(x, x + 600.0f, 0).first;
+            total -= vp.get_min_for(x, x + 600.0f, 0).first;
+        }
+        report("get_max_for/get_min_for, 20000 queries", timer.elapsed_ms(), "ms");
+        if (total == 0.0f)
+            report("(checksum)", total, "");
+    }
+
+    for (GmoShapeRectangle* pShape : shapes)
+        delete pShape;
+}
+
+//---------------------------------------------------------------------------------------
+BENCHMARK(VerticalProfile, dense_keyboard_layout)
+{
+    LomseDoorway doorway;
+    doorway.init_library(k_pix_format_rgba32, 96);
+    doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    LibraryScope& libScope = *doorway.get_library_scope();
+
+    //two pianos, 100 measures of dense chords
+    Document doc(libScope, cout);
+    doc.from_string(ldp_dense_keyboard_score(2, 100), Document::k_format_ldp);
+
+    BenchmarkTimer timer;
+    DocLayouter layouter(&doc, libScope);
+    layouter.layout_document();
+    report("layout", timer.elapsed_ms(), "ms");
+    report("pages", layouter.get_graphic_model()->get_num_pages(), "");
+    delete layouter.get_graphic_model();
+}
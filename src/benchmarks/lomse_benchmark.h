@@ -0,0 +1,83 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_BENCHMARK_H__
+#define __LOMSE_BENCHMARK_H__
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+
+namespace lomse
+{
+
+//---------------------------------------------------------------------------------------
+// Benchmark: base class for all benchmarks. Benchmarks register themselves in a
+// global list when created, and the runner program executes them.
+// Use macro BENCHMARK(Suite, Name) for defining a benchmark.
+class Benchmark
+{
+public:
+    const char* m_suite;
+    const char* m_name;
+
+    Benchmark(const char* suite, const char* name);
+    virtual ~Benchmark() {}
+
+    virtual void run() = 0;
+
+    static std::vector<Benchmark*>& get_list();
+};
+
+//---------------------------------------------------------------------------------------
+// BenchmarkTimer: wall time measurements
+class BenchmarkTimer
+{
+protected:
+    std::chrono::steady_clock::time_point m_start;
+
+public:
+    BenchmarkTimer() { start(); }
+
+    inline void start() { m_start = std::chrono::steady_clock::now(); }
+    inline double elapsed_ms() const
+    {
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - m_start;
+        return elapsed.count();
+    }
+};
+
+//---------------------------------------------------------------------------------------
+// helpers
+
+//print a measurement, i.e.: report("hit test, list scan", 12.3, "ms")
+void report(const std::string& what, double value, const std::string& units);
+
+//synthetic LDP score, for benchmarks on big scores. Each instrument is a piano
+//(two staves) and each measure contains eight notes, a chord and a rest.
+std::string ldp_piano_score(int numInstruments, int numMeasures);
+
+
+}   //namespace lomse
+
+
+//---------------------------------------------------------------------------------------
+#define BENCHMARK(Suite, Name) \
+    class Benchmark##Suite##Name : public lomse::Benchmark \
+    { \
+    public: \
+        Benchmark##Suite##Name() : lomse::Benchmark(#Suite, #Name) {} \
+        void run() override; \
+    } benchmark##Suite##Name##Instance; \
+    void Benchmark##Suite##Name::run()
+
+
+#endif      //__LOMSE_BENCHMARK_H__
@@ -0,0 +1,117 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#include "lomse_benchmark.h"
+
+#include "lomse_build_options.h"
+#include "lomse_injectors.h"
+
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string.h>
+
+using namespace std;
+using namespace lomse;
+
+
+namespace lomse
+{
+
+//=======================================================================================
+// Benchmark implementation
+//=======================================================================================
+Benchmark::Benchmark(const char* suite, const char* name)
+    : m_suite(suite)
+    , m_name(name)
+{
+    get_list().push_back(this);
+}
+
+//---------------------------------------------------------------------------------------
+std::vector<Benchmark*>& Benchmark::get_list()
+{
+    static std::vector<Benchmark*> benchmarks;
+    return benchmarks;
+}
+
+//---------------------------------------------------------------------------------------
+void report(const std::string& what, double value, const std::string& units)
+{
+    printf("    %-50s %12.3f %s\n", what.c_str(), value, units.c_str());
+}
+
+//---------------------------------------------------------------------------------------
+std::string ldp_piano_score(int numInstruments, int numMeasures)
+{
+    static const char* pitches[] = { "c4", "d4", "e4", "f4", "g4", "a4", "b4", "c5" };
+
+    stringstream ss;
+    ss << "(score (vers 2.0)";
+    for (int iInstr=0; iInstr < numInstruments; ++iInstr)
+    {
+        ss << "(instrument (staves 2)(musicData (clef G p1)(clef F4 p2)(key C)(time 4 4)";
+        for (int iMeasure=0; iMeasure < numMeasures; ++iMeasure)
+        {
+            for (int i=0; i < 8; ++i)
+                ss << "(n " << pitches[(i + iMeasure) % 8] << " e v1 p1)";
+            ss << "(goBack w)"
+               << "(chord (n c3 h v2 p2)(n e3 h v2 p2)(n g3 h v2 p2))"
+               << "(r h v2 p2)"
+               << "(barline simple)";
+        }
+        ss << "))";
+    }
+    ss << ")";
+    return ss.str();
+}
+
+
+}   //namespace lomse
+
+
+//---------------------------------------------------------------------------------------
+static bool matches(Benchmark* pBench, const string& name)
+{
+    return name == pBench->m_suite || name == pBench->m_name;
+}
+
+//---------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    //invoke without arguments to run all benchmarks:
+    //  benchmarks
+    //
+    //invoke with arguments to run only the matching suites or benchmarks:
+    //  benchmarks MySuite MyBenchmarkName
+
+    cout << "Lomse version " << LibraryScope::get_version_long_string()
+         << ". Benchmarks runner." << endl << endl;
+
+    std::vector<Benchmark*>& benchmarks = Benchmark::get_list();
+    int numRun = 0;
+    BenchmarkTimer timer;
+    for (Benchmark* pBench : benchmarks)
+    {
+        bool fRun = (argc == 1);
+        for (int i=1; i < argc && !fRun; ++i)
+            fRun = matches(pBench, argv[i]);
+
+        if (fRun)
+        {
+            cout << pBench->m_suite << " / " << pBench->m_name << endl;
+            pBench->run();
+            ++numRun;
+        }
+    }
+
+    printf("\n%d benchmarks run. Total time: %.2f seconds.\n", numRun,
+           timer.elapsed_ms() / 1000.0);
+    return 0;
+}
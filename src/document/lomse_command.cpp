@@ -27,6 +27,7 @@
 #include "lomse_score_algorithms.h"
 #include "lomse_score_utilities.h"
 
+#include <algorithm>
 #include <sstream>
 using namespace std;
 
@@ -124,6 +125,96 @@ int DocCommand::validate_source(const string& source)
     return k_success;
 }
 
+//---------------------------------------------------------------------------------------
+bool DocCommand::get_dirty_measures(ImoId* pScoreId, int* pFirst, int* pLast)
+{
+    if ((m_flags & k_unknown_dirty_measures) || m_dirtyScoreId == k_no_imoid)
+        return false;
+
+    *pScoreId = m_dirtyScoreId;
+    *pFirst = m_firstDirtyMeasure;
+    *pLast = m_lastDirtyMeasure;
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void DocCommand::reset_dirty_measures()
+{
+    m_flags &= ~k_unknown_dirty_measures;
+    m_dirtyScoreId = k_no_imoid;
+    m_firstDirtyMeasure = -1;
+    m_lastDirtyMeasure = -1;
+}
+
+//---------------------------------------------------------------------------------------
+void DocCommand::add_dirty_measures_for(ImoStaffObj* pSO)
+{
+    //the measure containing the staffobj is modified. Also the measures for related
+    //objects, as their shapes could be affected (e.g. beams, ties, lyrics hyphenation)
+
+    add_dirty_measure(pSO);
+
+    if (pSO->get_num_relations() > 0)
+    {
+        list<ImoRelObj*>& relobjs = pSO->get_relations()->get_relobjs();
+        list<ImoRelObj*>::iterator it;
+        for (it = relobjs.begin(); it != relobjs.end(); ++it)
+        {
+            if ((*it)->get_num_objects() > 0)
+            {
+                add_dirty_measure( (*it)->get_start_object() );
+                add_dirty_measure( (*it)->get_end_object() );
+            }
+        }
+    }
+
+    if (pSO->get_num_attachments() > 0)
+    {
+        ImoAttachments* pAuxObjs = pSO->get_attachments();
+        TreeNode<ImoObj>::children_iterator it;
+        for (it = pAuxObjs->begin(); it != pAuxObjs->end(); ++it)
+        {
+            if ((*it)->is_lyric())
+            {
+                ImoLyric* pLyric = static_cast<ImoLyric*>(*it);
+                ImoLyric* pPrev = pLyric->get_prev_lyric();
+                if (pPrev)
+                    add_dirty_measure( pPrev->get_parent_staffobj() );
+                ImoLyric* pNext = pLyric->get_next_lyric();
+                if (pNext)
+                    add_dirty_measure( pNext->get_parent_staffobj() );
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void DocCommand::add_dirty_measure(ImoStaffObj* pSO)
+{
+    ImoScore* pScore = (pSO ? pSO->get_score() : nullptr);
+    ColStaffObjsEntry* pEntry = (pSO ? pSO->get_colstaffobjs_entry() : nullptr);
+    if (!pScore || !pEntry || pEntry->imo_object() != pSO
+        || (m_dirtyScoreId != k_no_imoid && m_dirtyScoreId != pScore->get_id()))
+    {
+        //measure cannot be determined or changes in several scores
+        m_flags |= k_unknown_dirty_measures;
+        return;
+    }
+
+    int iMeasure = pEntry->measure();
+    m_dirtyScoreId = pScore->get_id();
+    if (m_firstDirtyMeasure == -1)
+    {
+        m_firstDirtyMeasure = iMeasure;
+        m_lastDirtyMeasure = iMeasure;
+    }
+    else
+    {
+        m_firstDirtyMeasure = min(m_firstDirtyMeasure, iMeasure);
+        m_lastDirtyMeasure = max(m_lastDirtyMeasure, iMeasure);
+    }
+}
+
 
 //=======================================================================================
 // DocCmdComposite
@@ -231,6 +322,7 @@ DocCommandExecuter::DocCommandExecuter(Document* target)
 DocCommandExecuter::~DocCommandExecuter()
 {
     delete m_pModelStart;
+    delete_checkpoints();
 }
 
 //---------------------------------------------------------------------------------------
@@ -262,10 +354,18 @@ int DocCommandExecuter::execute(DocCursor* pCursor, DocCommand* pCmd,
         {
             //by design, all commands that modify the document are reversible and must
             //support undo/redo
+            //push() clears redo history, so checkpoints for it are no longer valid
+            remove_checkpoints_after(m_stack.size());
             m_stack.push( pUE );
             update_cursor(pCursor, pCmd);
             update_selection(pSelection, pCmd);
             m_pDoc->set_modified();
+
+            if (m_checkpointInterval > 0
+                && m_stack.size() % size_t(m_checkpointInterval) == 0)
+            {
+                save_checkpoint();
+            }
         }
         else if (pCmd->is_reversible())
             delete pUE;     //cmd ownership transferred to UE; this deletes cmd
@@ -391,18 +491,27 @@ void DocCommandExecuter::undo(DocCursor* pCursor, SelectionSet* pSelection)
 void DocCommandExecuter::replay_until(UndoElement* pUE, DocCursor* pCursor,
                                       SelectionSet* pSelection)
 {
-    //restore initial model
-    m_pDoc->replace_model(m_pModelStart);
-    m_pModelStart = LOMSE_NEW DocModel(*m_pModelStart);
-
-    //re-play all commands until the desired one
-    for (size_t i=0; i < m_stack.size(); ++i)
+    //pUE is already removed from the stack. Find nearest checkpoint to the state
+    //after executing all remaining commands, and restore it
+    size_t numCommands = m_stack.size();
+    size_t start = 0;
+    DocModel* pModel = m_pModelStart;
+    map<size_t, DocModel*>::iterator itCP = m_checkpoints.upper_bound(numCommands);
+    if (itCP != m_checkpoints.begin())
     {
-        UndoElement* pUEi = m_stack.get_item(i);
-        if (pUEi == pUE)
-            break;
+        --itCP;
+        start = itCP->first;
+        pModel = itCP->second;
+    }
+    m_pDoc->replace_model( LOMSE_NEW DocModel(*pModel) );
 
-        replay_command(pUEi, pCursor, pSelection);
+    //re-play all commands after the checkpoint
+    UndoStack::iterator it = m_stack.begin();
+    for (size_t i=0; i < start && it != m_stack.end(); ++i)
+        ++it;
+    for (; it != m_stack.end(); ++it)
+    {
+        replay_command(*it, pCursor, pSelection);
     }
 
     //restore selection and cursor state
@@ -445,6 +554,90 @@ void DocCommandExecuter::redo(DocCursor* pCursor, SelectionSet* pSelection)
     }
 }
 
+//---------------------------------------------------------------------------------------
+void DocCommandExecuter::set_checkpoint_interval(int numCommands)
+{
+    m_checkpointInterval = max(0, numCommands);
+    if (m_checkpointInterval == 0)
+        delete_checkpoints();
+}
+
+//---------------------------------------------------------------------------------------
+void DocCommandExecuter::set_checkpoints_memory_limit(size_t maxObjects)
+{
+    m_checkpointsLimit = maxObjects;
+    enforce_checkpoints_limit();
+}
+
+//---------------------------------------------------------------------------------------
+void DocCommandExecuter::save_checkpoint()
+{
+    size_t numCommands = m_stack.size();
+    if (m_checkpoints.find(numCommands) != m_checkpoints.end())
+        return;
+
+    DocModel* pModel = m_pDoc->create_model_copy();
+    m_checkpoints[numCommands] = pModel;
+    m_checkpointsSize += pModel->id_assigner_size();
+    enforce_checkpoints_limit();
+}
+
+//---------------------------------------------------------------------------------------
+void DocCommandExecuter::remove_checkpoints_after(size_t numCommands)
+{
+    while (!m_checkpoints.empty() && m_checkpoints.rbegin()->first > numCommands)
+        remove_checkpoint( --m_checkpoints.end() );
+}
+
+//---------------------------------------------------------------------------------------
+void DocCommandExecuter::remove_checkpoint(map<size_t, DocModel*>::iterator it)
+{
+    m_checkpointsSize -= it->second->id_assigner_size();
+    delete it->second;
+    m_checkpoints.erase(it);
+}
+
+//---------------------------------------------------------------------------------------
+void DocCommandExecuter::enforce_checkpoints_limit()
+{
+    //While over the limit, remove the checkpoint whose removal creates the smaller
+    //replay gap, that is, the one nearest to its neighbours. This keeps checkpoints
+    //evenly distributed, thinning the oldest part of the stack on ties. The most
+    //recent checkpoint is only removed when it is the only one and does not fit.
+
+    while (m_checkpointsSize > m_checkpointsLimit && !m_checkpoints.empty())
+    {
+        map<size_t, DocModel*>::iterator itRemove = --m_checkpoints.end();
+        size_t minGap = 0;
+        size_t prev = 0;
+        map<size_t, DocModel*>::iterator it = m_checkpoints.begin();
+        map<size_t, DocModel*>::iterator itLast = --m_checkpoints.end();
+        for (; it != itLast; ++it)
+        {
+            map<size_t, DocModel*>::iterator itNext = it;
+            ++itNext;
+            size_t gap = itNext->first - prev;
+            if (itRemove == itLast || gap < minGap)
+            {
+                minGap = gap;
+                itRemove = it;
+            }
+            prev = it->first;
+        }
+        remove_checkpoint(itRemove);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void DocCommandExecuter::delete_checkpoints()
+{
+    map<size_t, DocModel*>::iterator it;
+    for (it = m_checkpoints.begin(); it != m_checkpoints.end(); ++it)
+        delete it->second;
+    m_checkpoints.clear();
+    m_checkpointsSize = 0;
+}
+
 ////---------------------------------------------------------------------------------------
 //void DocCommandExecuter::replay(DocCursor* pCursor)
 //{
@@ -542,7 +735,7 @@ int CmdAddChordNote::perform_action(Document* pDoc, DocCursor* pCursor)
     ImoTreeAlgoritms::add_note_to_chord(pBaseNote, pNewNote, pDoc);
 
     //force to rebuild ColStaffObjs table
-    pScore->end_of_changes();
+    pScore->end_of_marked_changes();
 
     return k_success;
 }
@@ -610,11 +803,13 @@ int CmdAddNoteRest::perform_action(Document* pDoc, DocCursor* pCursor)
     m_pDoc = pDoc;
     m_pCursor = pCursor;
     m_finalSrc = m_source;
+    reset_dirty_measures();
 
     get_data_about_insertion_point();
     get_data_about_noterest_to_insert();
     find_and_classify_overlapped_noterests();
     determine_insertion_point();
+    save_modified_measures();
     if (!m_overlaps.empty())
     {
         reduce_duration_of_overlapped_at_end();
@@ -632,12 +827,29 @@ int CmdAddNoteRest::perform_action(Document* pDoc, DocCursor* pCursor)
     clear_temporary_objects();
 
     //rebuild ColStaffObjs table, as there are objects added/removed
-    m_pScore->end_of_changes();
+    m_pScore->end_of_marked_changes();
     update_cursor();
 
+    list<ImoStaffObj*>::iterator it;
+    for (it = m_insertedObjs.begin(); it != m_insertedObjs.end(); ++it)
+        add_dirty_measures_for(*it);
+
     return k_success;
 }
 
+//---------------------------------------------------------------------------------------
+void CmdAddNoteRest::save_modified_measures()
+{
+    //measures for objects that will be removed or modified
+
+    list<OverlappedNoteRest*>::const_iterator it;
+    for (it = m_overlaps.begin(); it != m_overlaps.end(); ++it)
+        add_dirty_measures_for((*it)->pNR);
+
+    if (m_pAt)
+        add_dirty_measures_for(m_pAt);
+}
+
 //---------------------------------------------------------------------------------------
 void CmdAddNoteRest::update_cursor()
 {
@@ -1182,10 +1394,12 @@ int CmdChangeAccidentals::perform_action(Document* pDoc, DocCursor* UNUSED(pCurs
 
     bool fSavePitch = (m_oldPitch.size() == 0);     //AWARE: for redo pitch is already saved
     ImoScore* pScore = nullptr;
+    reset_dirty_measures();
     list<ImoId>::iterator it;
     for (it = m_notes.begin(); it != m_notes.end(); ++it)
     {
         ImoNote* pNote = static_cast<ImoNote*>( pDoc->get_pointer_to_imo(*it) );
+        add_dirty_measures_for(pNote);
         if (fSavePitch)
             m_oldPitch.push_back( pNote->get_fpitch() );
         pNote->set_notated_accidentals(m_acc);
@@ -1386,10 +1600,12 @@ int CmdChangeDots::set_target(Document* UNUSED(pDoc), DocCursor* UNUSED(pCursor)
 //---------------------------------------------------------------------------------------
 int CmdChangeDots::perform_action(Document* pDoc, DocCursor* pCursor)
 {
+    reset_dirty_measures();
     list<ImoId>::iterator it;
     for (it = m_noteRests.begin(); it != m_noteRests.end(); ++it)
     {
         ImoNoteRest* pNR = static_cast<ImoNoteRest*>( pDoc->get_pointer_to_imo(*it) );
+        add_dirty_measures_for(pNR);
         pNR->set_dots(m_dots);
         pNR->set_dirty(true);
     }
@@ -1397,7 +1613,14 @@ int CmdChangeDots::perform_action(Document* pDoc, DocCursor* pCursor)
     //rebuild StaffObjs collection, as duration of some objects have changed and this
     //affects to timepos of objects after them
     ImoScore* pScore = static_cast<ImoScore*>( pCursor->get_parent_object() );
-    pScore->end_of_changes();
+    pScore->end_of_marked_changes();
+
+    //the modified objects could have been moved to other measures
+    for (it = m_noteRests.begin(); it != m_noteRests.end(); ++it)
+    {
+        ImoNoteRest* pNR = static_cast<ImoNoteRest*>( pDoc->get_pointer_to_imo(*it) );
+        add_dirty_measures_for(pNR);
+    }
 
     return k_success;
 }
@@ -1635,6 +1858,7 @@ int CmdDeleteBlockLevelObj::perform_action(Document* pDoc, DocCursor* pCursor)
         prepare_cursor_for_deletion(pCursor);
         if (m_name == "")
             set_command_name("Delete ", pImo);
+
         pDoc->delete_block_level_obj(pImo);
         return k_success;
     }
@@ -1773,6 +1997,7 @@ int CmdDeleteSelection::perform_action(Document* pDoc, DocCursor* pCursor)
     log_forensic_data(pDoc, pCursor);
 
     prepare_cursor_for_deletion(pCursor);
+    reset_dirty_measures();
     delete_staffobjs(pDoc);
     delete_relobjs(pDoc);
     delete_auxobjs(pDoc);
@@ -1780,7 +2005,7 @@ int CmdDeleteSelection::perform_action(Document* pDoc, DocCursor* pCursor)
 
     //rebuild StaffObjs collection
     ImoScore* pScore = static_cast<ImoScore*>( pCursor->get_parent_object() );
-    pScore->end_of_changes();
+    pScore->end_of_marked_changes();
 
     return k_success;
 }
@@ -1868,6 +2093,7 @@ void CmdDeleteSelection::delete_staffobj(ImoStaffObj* pImo)
         }
 
         //delete object
+        add_dirty_measures_for(pImo);
         ImoInstrument* pInstr = pImo->get_instrument();
         pInstr->delete_staffobj(pImo);
     }
@@ -1899,7 +2125,15 @@ void CmdDeleteSelection::delete_relobjs(Document* pDoc)
         {
             ImoRelObj* pRO = static_cast<ImoRelObj*>( pDoc->get_pointer_to_imo(*it) );
             if (pRO)
+            {
+                //the relation shapes span from start to end object
+                if (pRO->get_num_objects() > 0)
+                {
+                    add_dirty_measure( pRO->get_start_object() );
+                    add_dirty_measure( pRO->get_end_object() );
+                }
                 pDoc->delete_relation(pRO);
+            }
         }
     }
 }
@@ -1914,7 +2148,10 @@ void CmdDeleteSelection::delete_auxobjs(Document* pDoc)
         {
             ImoAuxObj* pAO = static_cast<ImoAuxObj*>( pDoc->get_pointer_to_imo(*it) );
             if (pAO)
+            {
+                add_dirty_measure( pAO->get_parent_staffobj() );
                 pDoc->delete_auxobj(pAO);
+            }
         }
     }
 }
@@ -1966,6 +2203,7 @@ int CmdDeleteStaffObj::perform_action(Document* pDoc, DocCursor* pCursor)
 {
     log_forensic_data(pDoc, pCursor);
 
+    reset_dirty_measures();
     ImoStaffObj* pImo = dynamic_cast<ImoStaffObj*>( pDoc->get_pointer_to_imo(m_id) );
     if (pImo)
     {
@@ -1990,6 +2228,7 @@ int CmdDeleteStaffObj::perform_action(Document* pDoc, DocCursor* pCursor)
         }
 
         //delete object
+        add_dirty_measures_for(pImo);
         ImoInstrument* pInstr = pImo->get_instrument();
         pInstr->delete_staffobj(pImo);
 
@@ -2007,7 +2246,7 @@ int CmdDeleteStaffObj::perform_action(Document* pDoc, DocCursor* pCursor)
 
         //rebuild StaffObjs collection
         ImoScore* pScore = static_cast<ImoScore*>( pCursor->get_parent_object() );
-        pScore->end_of_changes();
+        pScore->end_of_marked_changes();
 
         return k_success;
     }
@@ -2165,7 +2404,7 @@ int CmdInsertManyStaffObjs::perform_action(Document* pDoc, DocCursor* pCursor)
         list<ImoStaffObj*> objects = pInstr->insert_staff_objects_at(pAt, m_source, errormsg);
         if (objects.size() > 0)
         {
-            pScore->end_of_changes();        //update ColStaffObjs table
+            pScore->end_of_marked_changes();        //update ColStaffObjs table
             m_lastInsertedId = objects.back()->get_id();
             objects.clear();
             return k_success;
@@ -2239,7 +2478,7 @@ int CmdInsertStaffObj::perform_action(Document* pDoc, DocCursor* pCursor)
             }
 
             //update ColStaffObjs table
-            pScore->end_of_changes();
+            pScore->end_of_marked_changes();
 
             //assign name to this command
             if (m_name == "")
@@ -20,6 +20,7 @@
 #include "lomse_mxl_compiler.h"
 #include "lomse_compressed_mxl_compiler.h"
 #include "lomse_mnx_compiler.h"
+#include "lomse_binary_compiler.h"
 #include "lomse_injectors.h"
 #include "lomse_id_assigner.h"
 #include "lomse_ldp_exporter.h"
@@ -33,7 +34,9 @@
 #include "lomse_staffobjs_table.h"
 #include "lomse_autoclef.h"
 #include "lomse_relobj_cloner.h"
+#include "lomse_profiler.h"
 
+#include <atomic>
 #include <sstream>
 using namespace std;
 
@@ -153,6 +156,14 @@ public:
 };
 
 
+#if (LOMSE_ENABLE_THREADS == 1)
+//---------------------------------------------------------------------------------------
+//IdAssigner used by current thread while building part of a model concurrently
+static thread_local const DocModel* s_pThreadModel = nullptr;
+static thread_local IdAssigner* s_pThreadIdAssigner = nullptr;
+#endif
+
+
 //=======================================================================================
 // DocModel implementation
 //=======================================================================================
@@ -191,8 +202,10 @@ DocModel& DocModel::clone(const DocModel& a)
     //copy xml strings from old IdAssigner
     m_pIdAssigner->copy_strings_from(a.m_pIdAssigner);
 
-    //use the maximum found id to instantiate idCounter
-    m_pIdAssigner->set_counter( v.max_id() );
+    //keep the id counter of the source model. Ids for objects deleted in the source
+    //are not reused and, when undo restores a copy and replays the next commands,
+    //the created objects receive the same ids than when the commands were executed
+    m_pIdAssigner->set_counter( max(v.max_id(), a.m_pIdAssigner->m_idCounter) );
 
     //build ColStaffObjs and ImMeasureTable
     //TODO: for speed, instead of running everything, only ColStaffObjs and ImMeasureTable
@@ -211,7 +224,7 @@ DocModel& DocModel::clone(const DocModel& a)
 //---------------------------------------------------------------------------------------
 void DocModel::add_unique_model_ref()
 {
-    static long m_refsCounter = 0L;     //global counter to create unique id numbers
+    static std::atomic<long> m_refsCounter(0L);     //global counter to create unique id numbers
 
     m_imRef = ++m_refsCounter;
 }
@@ -225,34 +238,51 @@ RelObjCloner* DocModel::get_relobj_cloner()
         return m_pRelObjCloner = LOMSE_NEW RelObjCloner;
 }
 
+//---------------------------------------------------------------------------------------
+IdAssigner* DocModel::thread_id_assigner() const
+{
+#if (LOMSE_ENABLE_THREADS == 1)
+    return (s_pThreadModel == this ? s_pThreadIdAssigner : nullptr);
+#else
+    return nullptr;
+#endif
+}
+
 //---------------------------------------------------------------------------------------
 void DocModel::assign_id(ImoObj* pImo)
 {
-    m_pIdAssigner->assign_id(pImo);
+    IdAssigner* pThreadIds = thread_id_assigner();
+    (pThreadIds ? pThreadIds : m_pIdAssigner)->assign_id(pImo);
 }
 
 //---------------------------------------------------------------------------------------
 ImoId DocModel::reserve_id(ImoId id)
 {
-    return m_pIdAssigner->reserve_id(id);
+    IdAssigner* pThreadIds = thread_id_assigner();
+    return (pThreadIds ? pThreadIds : m_pIdAssigner)->reserve_id(id);
 }
 
 //---------------------------------------------------------------------------------------
 void DocModel::assign_id(Control* pControl)
 {
-    m_pIdAssigner->assign_id(pControl);
+    IdAssigner* pThreadIds = thread_id_assigner();
+    (pThreadIds ? pThreadIds : m_pIdAssigner)->assign_id(pControl);
 }
 
 //---------------------------------------------------------------------------------------
 string DocModel::get_xml_id_for(ImoId id) const
 {
+    IdAssigner* pThreadIds = thread_id_assigner();
+    if (pThreadIds && pThreadIds->get_pointer_to_imo(id))
+        return pThreadIds->get_xml_id_for(id);
     return m_pIdAssigner->get_xml_id_for(id);
 }
 
 //---------------------------------------------------------------------------------------
 void DocModel::set_xml_id_for(ImoId id, const string& value)
 {
-    m_pIdAssigner->set_xml_id_for(id, value);
+    IdAssigner* pThreadIds = thread_id_assigner();
+    (pThreadIds ? pThreadIds : m_pIdAssigner)->set_xml_id_for(id, value);
 }
 
 //---------------------------------------------------------------------------------------
@@ -270,19 +300,25 @@ string DocModel::dump_id_assigner() const
 //---------------------------------------------------------------------------------------
 ImoObj* DocModel::get_pointer_to_imo(const std::string& xmlId) const
 {
-    return m_pIdAssigner->get_pointer_to_imo(xmlId);
+    IdAssigner* pThreadIds = thread_id_assigner();
+    ImoObj* pImo = (pThreadIds ? pThreadIds->get_pointer_to_imo(xmlId) : nullptr);
+    return (pImo ? pImo : m_pIdAssigner->get_pointer_to_imo(xmlId));
 }
 
 //---------------------------------------------------------------------------------------
 ImoObj* DocModel::get_pointer_to_imo(ImoId id) const
 {
-    return m_pIdAssigner->get_pointer_to_imo(id);
+    IdAssigner* pThreadIds = thread_id_assigner();
+    ImoObj* pImo = (pThreadIds ? pThreadIds->get_pointer_to_imo(id) : nullptr);
+    return (pImo ? pImo : m_pIdAssigner->get_pointer_to_imo(id));
 }
 
 //---------------------------------------------------------------------------------------
 Control* DocModel::get_pointer_to_control(ImoId id) const
 {
-    return m_pIdAssigner->get_pointer_to_control(id);
+    IdAssigner* pThreadIds = thread_id_assigner();
+    Control* pControl = (pThreadIds ? pThreadIds->get_pointer_to_control(id) : nullptr);
+    return (pControl ? pControl : m_pIdAssigner->get_pointer_to_control(id));
 }
 
 //---------------------------------------------------------------------------------------
@@ -294,7 +330,78 @@ void DocModel::reset_id_assigner()
 //---------------------------------------------------------------------------------------
 void DocModel::on_removed_from_model(ImoObj* pImo)
 {
-    m_pIdAssigner->remove(pImo);
+    IdAssigner* pThreadIds = thread_id_assigner();
+    if (pThreadIds == nullptr || pThreadIds->get_pointer_to_imo(pImo->get_id()))
+    {
+        (pThreadIds ? pThreadIds : m_pIdAssigner)->remove(pImo);
+    }
+    else if (pImo->get_id() != k_no_imoid)
+    {
+        //the shared IdAssigner can not be modified while threads are running. The
+        //id will be removed when merging the thread ids
+        pThreadIds->m_removedIds.push_back(pImo->get_id());
+        pImo->set_id(k_no_imoid);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void DocModel::reserve_thread_ids(vector<IdAssigner*>& assigners,
+                                  const vector<ImoId>& numIds)
+{
+    //The ids not yet used are split in consecutive ranges, one for each thread,
+    //sized from the estimated number of ids each thread will use. Thus, after
+    //merging, ids are nearly as compact as when building the model in a single
+    //thread. As ranges do not depend on the threads scheduling, the ids assigned
+    //to each object are always the same.
+
+    ImoId first = max(m_pIdAssigner->m_idCounter, ImoId(0));
+    for (size_t i=0; i < assigners.size(); ++i)
+    {
+        assigners[i]->set_reserved_range(first, first + numIds[i]);
+        first += numIds[i];
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void DocModel::use_thread_id_assigner(IdAssigner* pAssigner)
+{
+    //from now on, the current thread will take new ids from pAssigner. Pass nullptr
+    //to use again the model IdAssigner
+#if (LOMSE_ENABLE_THREADS == 1)
+    s_pThreadModel = (pAssigner ? this : nullptr);
+    s_pThreadIdAssigner = pAssigner;
+#else
+    (void)pAssigner;
+#endif
+}
+
+//---------------------------------------------------------------------------------------
+void DocModel::merge_thread_ids(vector<IdAssigner*>& assigners)
+{
+    size_t size = m_pIdAssigner->size();
+    for (IdAssigner* pAssigner : assigners)
+        size += pAssigner->size();
+    m_pIdAssigner->m_idToImo.reserve(size);
+
+    //A thread that used more ids than reserved has taken ids from the range of the
+    //next threads. Its excess ids are moved to a new range, after all ids used by
+    //all threads, so that merged ranges never overlap.
+    ImoId lastUsed = m_pIdAssigner->m_idCounter;
+    for (IdAssigner* pAssigner : assigners)
+        lastUsed = max(lastUsed, max(pAssigner->m_idCounter, pAssigner->m_lastReservedId));
+
+    for (IdAssigner* pAssigner : assigners)
+    {
+        if (pAssigner->has_overflowed())
+        {
+            LOMSE_LOG_INFO("Thread ids range exceeded by %d ids. They are renumbered.",
+                           int(pAssigner->m_idCounter - pAssigner->m_lastReservedId));
+            lastUsed = pAssigner->renumber_ids_out_of_range(lastUsed);
+        }
+    }
+
+    for (IdAssigner* pAssigner : assigners)
+        pAssigner->move_ids_to(m_pIdAssigner);
 }
 
 
@@ -351,6 +458,9 @@ void Document::set_imo_doc(ImoDocument* pImoDoc)
 //---------------------------------------------------------------------------------------
 int Document::from_file(const string& filename, int format)
 {
+    ProfilerActivation profiling(m_pProfiler);
+    ProfilerScope scope("Document::from_file");
+
     initialize();
     int numErrors = 0;
     Compiler* pCompiler = get_compiler_for_format(format);
@@ -378,6 +488,9 @@ int Document::from_file(const string& filename, int format)
 //---------------------------------------------------------------------------------------
 int Document::from_string(const string& source, int format)
 {
+    ProfilerActivation profiling(m_pProfiler);
+    ProfilerScope scope("Document::from_string");
+
     initialize();
     int numErrors = 0;
     Compiler* pCompiler = get_compiler_for_format(format);
@@ -458,6 +571,7 @@ void Document::fix_malformed_musicxml()
         ImoScore* pScore = dynamic_cast<ImoScore*>( m_pModel->m_pImoDoc->get_content_item(0) );
         if (pScore)
         {
+            ProfilerScope scope("AutoClef::do_autoclef");
             AutoClef ac(pScore);
             ac.do_autoclef();
         }
@@ -508,6 +622,9 @@ Compiler* Document::get_compiler_for_format(int format)
         case k_format_mnx:
             return Injector::inject_MnxCompiler(m_libraryScope, this);
 
+        case k_format_binary:
+            return Injector::inject_BinaryCompiler(m_libraryScope, this);
+
         default:
             return nullptr;
     }
@@ -729,6 +846,30 @@ ImoStyle* Document::get_default_style()
 //    return m_pModel->m_pImoDoc->find_style(name);
 //}
 
+//---------------------------------------------------------------------------------------
+void Document::clear_dirty()
+{
+    if (!m_pModel)
+        return;
+
+    m_pModel->clear_dirty();
+
+    //scores structures are up to date. Therefore, information about modified
+    //instruments, for updating these structures, is no longer needed
+    ImoDocument* pImoDoc = m_pModel->m_pImoDoc;
+    ImoContent* pContent = (pImoDoc ? pImoDoc->get_content() : nullptr);
+    if (pContent)
+    {
+        ModelBuilder builder;
+        ImoObj::children_iterator it;
+        for (it = pContent->begin(); it != pContent->end(); ++it)
+        {
+            if ((*it)->is_score())
+                builder.clear_modified_flags( static_cast<ImoScore*>(*it) );
+        }
+    }
+}
+
 //---------------------------------------------------------------------------------------
 void Document::notify_if_document_modified()
 {
@@ -1170,11 +1170,13 @@ void ScoreCursor::to_time(int iInstr, int iStaff, TimeUnits rTargetTime)
     m_currentState.instrument(iInstr);
     m_currentState.staff(iStaff);
 
-    //optimization: avoid search from start if current time lower than target time
-    if (!p_there_is_iter_object() || is_greater_time(p_iter_object_time(), rTargetTime))
-        m_it = m_pColStaffObjs->begin();
-
-    p_forward_to_instr_with_time_not_lower_than(rTargetTime);
+    //find first entry for the instrument with time not lower than target time. Search
+    //from current position if current time is not greater than target time
+    ColStaffObjsEntry* pStart = nullptr;
+    if (p_there_is_iter_object() && !is_greater_time(p_iter_object_time(), rTargetTime))
+        pStart = *m_it;
+    m_it = ColStaffObjsIterator(
+                m_pColStaffObjs->find_entry_at_time(iInstr, rTargetTime, pStart) );
 
     //here time is greater or equal. Instr is ok or not found
     if (p_there_is_iter_object())
@@ -1225,39 +1227,22 @@ void ScoreCursor::to_measure(int measure, int instr, int staff)
         return;
     }
 
-    m_startOfBarTimepos = 0.0;
-    m_curBeatDuration = k_duration_quarter;
-
-    m_it = m_pColStaffObjs->begin();
-    while (p_there_is_iter_object())
-    {
-        if (p_iter_object_instrument() == m_currentState.instrument())
-        {
-            if (p_iter_object()->is_barline())
-            {
-                m_startOfBarTimepos = p_iter_object_time();
-                if (p_iter_object_measure() == measure - 1)
-                {
-                    m_currentState.time( p_iter_object_time() );
-                    p_update_pointed_object();
-                    to_next_staffobj(true);
-                    return;
-                }
-            }
-            if (p_iter_object()->is_time_signature())
-            {
-                ImoTimeSignature* pTS =
-                        static_cast<ImoTimeSignature*>( p_iter_object() );
-                m_curBeatDuration = pTS->get_beat_duration();
-            }
-        }
-        p_move_iterator_to_next();
-    }
+    //find the barline ending previous measure. If not found, start of measure and
+    //beat are taken from last barline and time signature
+    int iInstr = m_currentState.instrument();
+    ColStaffObjsEntry* pBarline = m_pColStaffObjs->find_barline_in_measure(iInstr,
+                                                                           measure - 1);
+    m_it = ColStaffObjsIterator(pBarline);
+    if (!pBarline)
+        pBarline = m_pColStaffObjs->find_prev_barline(iInstr, nullptr);
+    m_startOfBarTimepos = (pBarline ? pBarline->time() : 0.0);
+    p_set_beat_duration_from_time_signature_before(*m_it);
 
     if (p_there_is_iter_object())
     {
         m_currentState.time( p_iter_object_time() );
         p_update_pointed_object();
+        to_next_staffobj(true);
     }
     else
     {
@@ -1433,8 +1418,17 @@ void ScoreCursor::p_move_iterator_to(ImoId id)
         m_it = m_pColStaffObjs->end();
     else
     {
-        m_it = m_pColStaffObjs->begin();
-        for (; m_it != m_pColStaffObjs->end() && (*m_it)->element_id() != id; ++m_it);
+        //use the table index when the object is known by the document
+        ImoObj* pImo = m_pDoc->get_pointer_to_imo(id);
+        if (pImo && pImo->is_staffobj())
+            m_it = m_pColStaffObjs->find( static_cast<ImoStaffObj*>(pImo) );
+        else if (pImo)
+            m_it = m_pColStaffObjs->end();
+        else
+        {
+            m_it = m_pColStaffObjs->begin();
+            for (; m_it != m_pColStaffObjs->end() && (*m_it)->element_id() != id; ++m_it);
+        }
     }
 }
 
@@ -1817,35 +1811,35 @@ void ScoreCursor::p_determine_total_duration()
 //---------------------------------------------------------------------------------------
 void ScoreCursor::p_find_start_of_measure_and_time_signature()
 {
-    bool fBarlineFound = false;
-    bool fTimeFound = false;
+    //start of measure and beat are determined by the previous barline and time
+    //signature in current instrument. When at end of score they are not searched.
+
     m_startOfBarTimepos = 0.0;
     m_curBeatDuration = k_duration_quarter;
+    if (!p_there_is_iter_object())
+        return;
 
-    ColStaffObjsIterator itSave = m_it;
-    p_move_iterator_to_prev();
-    while (p_there_is_iter_object())
+    ColStaffObjsEntry* pBarline =
+        m_pColStaffObjs->find_prev_barline(m_currentState.instrument(), *m_it);
+    if (pBarline)
+        m_startOfBarTimepos = pBarline->time();
+
+    p_set_beat_duration_from_time_signature_before(*m_it);
+}
+
+//---------------------------------------------------------------------------------------
+void ScoreCursor::p_set_beat_duration_from_time_signature_before(ColStaffObjsEntry* pEntry)
+{
+    //AWARE: pEntry == nullptr means end of score
+
+    m_curBeatDuration = k_duration_quarter;
+    ColStaffObjsEntry* pTsEntry =
+        m_pColStaffObjs->find_prev_time_signature(m_currentState.instrument(), pEntry);
+    if (pTsEntry)
     {
-        if (p_iter_object_instrument() == m_currentState.instrument())
-        {
-            if (!fBarlineFound && p_iter_object()->is_barline())
-            {
-                m_startOfBarTimepos = p_iter_object_time();
-                fBarlineFound = true;
-            }
-            if (!fTimeFound && p_iter_object()->is_time_signature())
-            {
-                ImoTimeSignature* pTS =
-                        static_cast<ImoTimeSignature*>( p_iter_object() );
-                m_curBeatDuration = pTS->get_beat_duration();
-                fTimeFound = true;
-            }
-        }
-        if (fBarlineFound && fTimeFound)
-            break;
-        p_move_iterator_to_prev();
+        ImoTimeSignature* pTS = static_cast<ImoTimeSignature*>( pTsEntry->imo_object() );
+        m_curBeatDuration = pTS->get_beat_duration();
     }
-    m_it = itSave;
 }
 
 
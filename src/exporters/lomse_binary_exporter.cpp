@@ -0,0 +1,56 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#include "lomse_binary_exporter.h"
+
+#include "lomse_im_serializer.h"
+#include "lomse_logger.h"
+
+#include <fstream>
+
+using namespace std;
+
+namespace lomse
+{
+
+//=======================================================================================
+// BinaryExporter implementation
+//=======================================================================================
+std::string BinaryExporter::get_source(ImoDocument* pImoDoc)
+{
+    m_error.clear();
+    string data;
+    ImSerializer serializer;
+    if (!serializer.save(pImoDoc, data))
+    {
+        m_error = serializer.get_error();
+        LOMSE_LOG_ERROR(m_error);
+    }
+    return data;
+}
+
+//---------------------------------------------------------------------------------------
+bool BinaryExporter::save_to_file(ImoDocument* pImoDoc, const std::string& filename)
+{
+    string data = get_source(pImoDoc);
+    if (data.empty())
+        return false;
+
+    ofstream file(filename.c_str(), ios::out | ios::binary);
+    if (!file.good())
+    {
+        m_error = "Could not create file '" + filename + "'";
+        return false;
+    }
+    file.write(data.data(), streamsize(data.size()));
+    return file.good();
+}
+
+
+}  //namespace lomse
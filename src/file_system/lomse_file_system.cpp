@@ -14,6 +14,15 @@
 	#include "lomse_zip_stream.h"
 #endif
 
+#if (LOMSE_PLATFORM_WIN32 == 1)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -266,4 +275,78 @@ long LocalInputStream::read (unsigned char* pDestBuffer, long nBytesToRead)
 }
 
 
+//=======================================================================================
+// MappedFile implementation
+//=======================================================================================
+#if (LOMSE_PLATFORM_WIN32 == 1)
+
+MappedFile::MappedFile(const std::string& filename)
+    : m_pData(nullptr)
+    , m_size(0)
+    , m_hFile(INVALID_HANDLE_VALUE)
+    , m_hMapping(nullptr)
+{
+    m_hFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_hFile == INVALID_HANDLE_VALUE)
+        return;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_hFile, &size) || size.QuadPart == 0)
+        return;
+
+    m_hMapping = CreateFileMappingA(m_hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (m_hMapping == nullptr)
+        return;
+
+    m_pData = static_cast<char*>( MapViewOfFile(m_hMapping, FILE_MAP_COPY, 0, 0, 0) );
+    if (m_pData)
+        m_size = size_t(size.QuadPart);
+}
+
+//---------------------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+    if (m_pData)
+        UnmapViewOfFile(m_pData);
+    if (m_hMapping)
+        CloseHandle(m_hMapping);
+    if (m_hFile != INVALID_HANDLE_VALUE)
+        CloseHandle(m_hFile);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename)
+    : m_pData(nullptr)
+    , m_size(0)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        void* p = mmap(nullptr, size_t(info.st_size), PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED)
+        {
+            m_pData = static_cast<char*>(p);
+            m_size = size_t(info.st_size);
+        }
+    }
+    close(fd);      //the mapping remains valid
+}
+
+//---------------------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+    if (m_pData)
+        munmap(m_pData, m_size);
+}
+
+#endif
+
+
 }  //namespace lomse
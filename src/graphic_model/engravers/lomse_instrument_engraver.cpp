@@ -344,6 +344,27 @@ void PartsEngraver::set_position_and_width_for_staves(LUnits indent, UPoint org,
     }
 }
 
+//---------------------------------------------------------------------------------------
+void PartsEngraver::move_staves_to_origin()
+{
+    //Undo the positioning done when engraving a system, so that staffobjs can be
+    //engraved again as when starting the layout. Required for lazy layout, as
+    //columns are created after engraving some systems
+
+    std::vector<GroupEngraver*>::iterator itG;
+    for (itG = m_groupEngravers.begin(); itG != m_groupEngravers.end(); ++itG)
+    {
+        (*itG)->set_slice_instr_origin(UPoint(0.0f, 0.0f));
+    }
+
+    std::vector<InstrumentEngraver*>::iterator it;
+    for (it = m_instrEngravers.begin(); it != m_instrEngravers.end(); ++it)
+    {
+        (*it)->set_slice_instr_origin(UPoint(0.0f, 0.0f));
+        (*it)->reset_staff_position_shifts();
+    }
+}
+
 //---------------------------------------------------------------------------------------
 void PartsEngraver::set_staves_width(LUnits width)
 {
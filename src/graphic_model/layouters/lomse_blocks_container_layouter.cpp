@@ -34,6 +34,18 @@ ContentLayouter::ContentLayouter(ImoContentObj* pItem, Layouter* pParent,
 {
 }
 
+//---------------------------------------------------------------------------------------
+ContentLayouter::~ContentLayouter()
+{
+    //if the layout was paused, the layouter for current child was not deleted.
+    //AWARE: score layouters are owned by DocLayouter
+    if (m_result == k_layout_paused
+        && !static_cast<ImoContentObj*>(*m_itChild)->is_score())
+    {
+        delete m_pCurLayouter;
+    }
+}
+
 //---------------------------------------------------------------------------------------
 void ContentLayouter::layout_in_box()
 {
@@ -41,17 +53,42 @@ void ContentLayouter::layout_in_box()
 
     set_cursor_and_available_space();
 
-    TreeNode<ImoObj>::children_iterator it;
-    int result = k_layout_success;
-    for (it = m_pContent->begin(); it != m_pContent->end(); ++it)
+    m_itChild = m_pContent->begin();
+    set_layout_result( layout_children(k_layout_success) );
+}
+
+//---------------------------------------------------------------------------------------
+void ContentLayouter::resume_layout_in_box()
+{
+    //Lazy layout: continue with the child whose layout was paused and then with
+    //the remaining children
+
+    int result = resume_item_layout();
+    if (result != k_layout_paused && result != k_layout_failed_auto_scale
+        && result != k_layout_failed_reuse)
     {
-        result = layout_item(static_cast<ImoContentObj*>( *it ), m_pItemMainBox, m_constrains);
-        if (result == k_layout_failed_auto_scale)
-            break;
+        ++m_itChild;
+        result = layout_children(result);
     }
     set_layout_result(result);
 }
 
+//---------------------------------------------------------------------------------------
+int ContentLayouter::layout_children(int result)
+{
+    for (; m_itChild != m_pContent->end(); ++m_itChild)
+    {
+        result = layout_item(static_cast<ImoContentObj*>( *m_itChild ), m_pItemMainBox,
+                             m_constrains);
+        if (result == k_layout_failed_auto_scale || result == k_layout_failed_reuse
+            || result == k_layout_paused)
+        {
+            break;
+        }
+    }
+    return result;
+}
+
 //---------------------------------------------------------------------------------------
 void ContentLayouter::create_main_box(GmoBox* pParentBox, UPoint pos, LUnits width,
                                       LUnits height)
@@ -145,7 +182,8 @@ void MultiColumnLayouter::layout_in_box()
     }
 
     //loop to finish columns
-    if (layoutResult != k_layout_failed_auto_scale)
+    if (layoutResult != k_layout_failed_auto_scale
+        && layoutResult != k_layout_failed_reuse)
     {
         LUnits bottom = 0.0f;
         LUnits height = 0.0f;
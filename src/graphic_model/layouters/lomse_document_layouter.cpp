@@ -16,6 +16,10 @@
 #include "lomse_score_layouter.h"
 #include "lomse_calligrapher.h"
 #include "lomse_box_system.h"
+#include "lomse_profiler.h"
+
+#include <algorithm>
+#include <cmath>
 
 
 namespace lomse
@@ -35,6 +39,11 @@ DocLayouter::DocLayouter(Document* pDoc, LibraryScope& libraryScope, int constra
     , m_pDoc( pDoc->get_im_root() )
     , m_viewWidth(width)
     , m_pScoreLayouter(nullptr)
+    , m_pPrevGModel(nullptr)
+    , m_pProfiler( pDoc->get_profiler() )
+    , m_fLazyLayout(false)
+    , m_fLayoutPaused(false)
+    , m_pagesLimit(0)
 {
     m_pStyles = m_pDoc->get_styles();
     m_pGModel = LOMSE_NEW GraphicModel(m_pDoc);
@@ -44,6 +53,10 @@ DocLayouter::DocLayouter(Document* pDoc, LibraryScope& libraryScope, int constra
 //---------------------------------------------------------------------------------------
 DocLayouter::~DocLayouter()
 {
+    //when the layout is paused, the ContentLayouter was not deleted
+    if (m_fLayoutPaused)
+        delete m_pCurLayouter;
+
     delete m_pScoreLayouter;
 }
 
@@ -57,6 +70,9 @@ void DocLayouter::layout_empty_document()
 //---------------------------------------------------------------------------------------
 void DocLayouter::layout_document()
 {
+    ProfilerActivation profiling(m_pProfiler);
+    ProfilerScope scope("DocLayouter::layout_document");
+
     int result = k_layout_not_finished;
     int numTrials = 0;
     while(result == k_layout_not_finished && numTrials < 30)
@@ -64,7 +80,7 @@ void DocLayouter::layout_document()
         numTrials++;
         start_new_page();
         result = layout_content();
-        if (result == k_layout_failed_auto_scale)
+        if (result == k_layout_failed_auto_scale || result == k_layout_failed_reuse)
         {
             delete_last_trial();
             result = k_layout_not_finished;
@@ -72,8 +88,74 @@ void DocLayouter::layout_document()
     }
     if (result == k_layout_not_finished)
         layout_empty_document();
+    else if (result == k_layout_paused)
+        m_fLayoutPaused = true;
+    else
+        fix_document_size();
+
+    update_layout_state();
+}
+
+//---------------------------------------------------------------------------------------
+void DocLayouter::enable_lazy_layout(int numPages)
+{
+    m_fLazyLayout = (numPages > 0);
+    m_pagesLimit = max(0, numPages);
+}
+
+//---------------------------------------------------------------------------------------
+bool DocLayouter::must_pause_layout()
+{
+    return m_pagesLimit > 0 && m_pGModel->get_num_pages() >= m_pagesLimit;
+}
+
+//---------------------------------------------------------------------------------------
+bool DocLayouter::layout_more_pages(int numPages)
+{
+    if (!m_fLayoutPaused)
+        return false;
+
+    ProfilerActivation profiling(m_pProfiler);
+    ProfilerScope scope("DocLayouter::layout_more_pages");
+
+    m_pagesLimit = (numPages > 0 ? m_pGModel->get_num_pages() + numPages : 0);
+    m_fLayoutPaused = false;
+
+    int result = resume_item_layout();
+    if (result == k_layout_paused)
+        m_fLayoutPaused = true;
+    else if (result == k_layout_failed_auto_scale)
+    {
+        //start again. The graphic model is owned by the user: do not delete it
+        m_pGModel = nullptr;
+        delete_last_trial();
+        layout_document();
+        return m_fLayoutPaused;
+    }
     else
         fix_document_size();
+
+    update_layout_state();
+    return m_fLayoutPaused;
+}
+
+//---------------------------------------------------------------------------------------
+void DocLayouter::update_layout_state()
+{
+    //While the layout is paused, the number of pages is estimated from the part of
+    //the score already laid out
+
+    int numPages = m_pGModel->get_num_pages();
+    int estimated = numPages;
+    if (m_fLayoutPaused)
+    {
+        estimated = numPages + 1;
+        ScoreLayouter* pScoreLyt = get_score_layouter();
+        float progress = (pScoreLyt ? pScoreLyt->get_layout_progress() : 0.0f);
+        if (progress > 0.0f)
+            estimated = max(estimated, int(ceil(float(numPages) / progress)));
+    }
+    m_pGModel->set_layout_state(!m_fLayoutPaused, estimated);
 }
 
 //---------------------------------------------------------------------------------------
@@ -82,6 +164,9 @@ void DocLayouter::delete_last_trial()
     delete m_pScoreLayouter;
     delete m_pGModel;
 
+    //AWARE: boxes could have been moved from previous model. Do not reuse it
+    m_pPrevGModel = nullptr;
+
     m_result = k_layout_not_finished;
     m_pGModel = LOMSE_NEW GraphicModel(m_pDoc);
     m_pParentLayouter = nullptr;
@@ -85,21 +85,41 @@ int Layouter::layout_item(ImoContentObj* pItem, GmoBox* pParentBox, int constrai
     m_pCurLayouter->set_constrains(constrains);
 
     m_pCurLayouter->prepare_to_start_layout();
-    while (!m_pCurLayouter->is_item_layouted())
+    if (!m_pCurLayouter->is_item_layouted())
     {
         m_pCurLayouter->create_main_box(pParentBox, m_pageCursor,
                                         m_availableWidth, m_availableHeight);
+    }
+    return layout_current_item();
+}
+
+//---------------------------------------------------------------------------------------
+int Layouter::layout_current_item()
+{
+    //AWARE: The main box for the item is already created
+
+    while (!m_pCurLayouter->is_item_layouted())
+    {
         m_pCurLayouter->layout_in_box();
+        if (m_pCurLayouter->get_layout_result() == k_layout_paused)
+            return k_layout_paused;
+
         m_pCurLayouter->set_box_height();
 
         if (!m_pCurLayouter->is_item_layouted())
         {
-            pParentBox = start_new_page();
+            //lazy layout: do not start a new page if the pages limit is reached
+            if (must_pause_layout())
+                return k_layout_paused;
+
+            GmoBox* pParentBox = start_new_page();
+            m_pCurLayouter->create_main_box(pParentBox, m_pageCursor,
+                                            m_availableWidth, m_availableHeight);
         }
     }
 
     int result = m_pCurLayouter->get_layout_result();
-    if (result != k_layout_failed_auto_scale)
+    if (result != k_layout_failed_auto_scale && result != k_layout_failed_reuse)
     {
         m_pCurLayouter->add_end_margins();
 
@@ -111,12 +131,38 @@ int Layouter::layout_item(ImoContentObj* pItem, GmoBox* pParentBox, int constrai
             m_availableHeight -= pChildBox->get_height();
         }
 
-        if (!pItem->is_score())
+        if (!m_pCurLayouter->m_pItem->is_score())
             delete m_pCurLayouter;
     }
     return result;
 }
 
+//---------------------------------------------------------------------------------------
+int Layouter::resume_item_layout()
+{
+    //Lazy layout: continue laying out the item whose layout was paused
+
+    if (m_pCurLayouter->get_layout_result() == k_layout_paused)
+    {
+        //the pause was requested by a descendant of current item
+        m_pCurLayouter->resume_layout_in_box();
+        if (m_pCurLayouter->get_layout_result() == k_layout_paused)
+            return k_layout_paused;
+
+        m_pCurLayouter->set_box_height();
+    }
+
+    if (!m_pCurLayouter->is_item_layouted())
+    {
+        //the pause was requested when current item needed a new page
+        GmoBox* pParentBox = start_new_page();
+        m_pCurLayouter->create_main_box(pParentBox, m_pageCursor,
+                                        m_availableWidth, m_availableHeight);
+    }
+
+    return layout_current_item();
+}
+
 //---------------------------------------------------------------------------------------
 void Layouter::set_cursor_and_available_space()
 {
@@ -58,10 +58,18 @@
 #include "lomse_gm_measures_table.h"
 #include "lomse_vertical_profile.h"
 #include "lomse_fingering_engraver.h"
+#include "lomse_profiler.h"
+
+#include <algorithm>
+#include <climits>
+#include <map>
 
 namespace lomse
 {
 
+//lazy layout: number of columns to create and space in each chunk
+const int k_lazy_layout_columns = 32;
+
 //=======================================================================================
 // ScoreLayoutScope implementation
 //=======================================================================================
@@ -141,6 +149,8 @@ ScoreLayouter::ScoreLayouter(ImoContentObj* pItem, Layouter* pParent,
     , m_pStub(nullptr)
     , m_pCurBoxPage(nullptr)
     , m_pCurBoxSystem(nullptr)
+    , m_fLazyLayout(false)
+    , m_fMoreColumns(false)
     , m_iColumnToTrace(-1)
     , m_nTraceLevel(k_trace_off)
     , m_fFirstSystemInPage(true)
@@ -150,12 +160,20 @@ ScoreLayouter::ScoreLayouter(ImoContentObj* pItem, Layouter* pParent,
 //---------------------------------------------------------------------------------------
 ScoreLayouter::~ScoreLayouter()
 {
+    if ((m_fLazyLayout && m_result == k_layout_not_finished)
+        || m_result == k_layout_failed_reuse)
+    {
+        delete_not_laid_out_objects();
+    }
+
     delete_system_layouters();
 }
 
 //---------------------------------------------------------------------------------------
 void ScoreLayouter::prepare_to_start_layout()
 {
+    ProfilerScope scope("ScoreLayouter::prepare_to_start_layout");
+
     //initialize base class
     Layouter::prepare_to_start_layout();
 
@@ -172,9 +190,19 @@ void ScoreLayouter::prepare_to_start_layout()
     decide_systems_indentation();
 
     //Next the score is split in columns (small chunks, e.g. measures) and
-    //the spacing algorithm is applied
-    m_pSpAlgorithm->split_content_in_columns();
-    m_pSpAlgorithm->do_spacing_algorithm();
+    //the spacing algorithm is applied. For lazy layout, only the first chunk
+    //of columns is created. More columns will be created as systems are needed.
+    m_fLazyLayout = is_lazy_layout() && !m_pPrevStub;
+    if (m_fLazyLayout)
+    {
+        m_fMoreColumns =
+            m_pSpAlgorithm->split_more_content_in_columns(k_lazy_layout_columns);
+    }
+    else
+    {
+        m_pSpAlgorithm->split_content_in_columns();
+        m_pSpAlgorithm->do_spacing_algorithm();
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -195,10 +223,14 @@ void ScoreLayouter::layout_in_box()
 
     if (is_first_page())
     {
-        decide_line_breaks();
         //AWARE: deciding line breaks cannot be moved to the preparation phase because
         //for deciding break points it is necessary to know page size, and this
         //information is not known in the preparation phase.
+        if (!decide_line_breaks())
+        {
+            set_layout_result(k_layout_failed_reuse);
+            return;
+        }
 
         add_score_titles();
     }
@@ -209,7 +241,21 @@ void ScoreLayouter::layout_in_box()
     while(m_iCurColumn < get_num_columns() || system_created())
     {
         if (!system_created())
+        {
+            //lazy layout: the system to create must not be the provisional last one
+            while (m_fMoreColumns && m_iCurSystem + 1 >= get_num_systems() - 1)
+                decide_more_line_breaks();
+
+            //incremental layout: a system whose shapes were not created must be reused
+            if (has_reused_columns(m_iCurSystem + 1)
+                && !can_reuse_system(m_iCurSystem + 1))
+            {
+                set_layout_result(k_layout_failed_reuse);
+                return;
+            }
+
             create_system();
+        }
 
         if (enough_space_in_page_for_system())
         {
@@ -277,6 +323,7 @@ void ScoreLayouter::initialice_score_layouter()
 
     get_score_renderization_options();
     create_stub();
+    find_previous_layout();
 
     //For debugging:
     //ColStaffObjs* pCol = m_pScore->get_staffobjs_table();
@@ -290,8 +337,15 @@ void ScoreLayouter::initialice_score_layouter()
 //---------------------------------------------------------------------------------------
 void ScoreLayouter::create_system()
 {
+    if (can_reuse_system(m_iCurSystem + 1))
+    {
+        reuse_system();
+        return;
+    }
+
     create_system_layouter();
     create_system_box();
+    save_current_system_info();
     engrave_system();
 }
 
@@ -352,6 +406,8 @@ bool ScoreLayouter::enough_space_in_page_for_system()
     height -= m_pCurBoxSystem->get_free_space_at_bottom();
     if (remaining_height() >= height)
     {
+        if (m_curSysInfo.pBox == m_pCurBoxSystem)
+            m_curSysInfo.removedSpace = m_pCurBoxSystem->get_free_space_at_bottom();
         m_pCurBoxSystem->remove_free_space_at_bottom_and_adjust_slices();
         return true;
     }
@@ -363,6 +419,7 @@ void ScoreLayouter::delete_system()
 {
     delete m_pCurBoxSystem;
     m_pCurBoxSystem = nullptr;
+    m_curSysInfo.pBox = nullptr;
 }
 
 //---------------------------------------------------------------------------------------
@@ -397,34 +454,48 @@ void ScoreLayouter::create_system_box()
     m_iCurSystem++;
     m_pPrevBoxSystem = (m_fFirstSystemInPage ? nullptr : m_pPrevBoxSystem);
 
-    //get margins
     ImoSystemInfo* pInfo = (m_iCurSystem == 0 ? m_pScore->get_first_system_info()
                                               : m_pScore->get_other_system_info());
-    LUnits leftMargin = pInfo->get_left_margin();
-    LUnits rightMargin = pInfo->get_right_margin();
-
-    //determine top and left positions
-    LUnits top = m_cursor.y
-                 + distance_to_top_of_system(m_iCurSystem, m_fFirstSystemInPage);
-    LUnits left = m_cursor.x + leftMargin;
 
     //determine height
     LUnits height = determine_system_top_margin();      //top margin
     height += m_pSpAlgorithm->get_staves_height();      //staves height
     height += pInfo->get_system_distance() / 2.0f;      //bottom margin
 
-    //determine width
-    LUnits width = m_pCurBoxPage->get_width();
-    width -= (leftMargin + rightMargin);
-
     //create the box
-    m_pCurBoxSystem = m_pCurSysLyt->create_system_box(left, top, width, height);
+    UPoint org = determine_system_origin(m_iCurSystem);
+    LUnits width = determine_system_width(m_iCurSystem);
+    m_pCurBoxSystem = m_pCurSysLyt->create_system_box(org.x, org.y, width, height);
 
     //save info for repositioning system if necessary
     m_iSysPage = m_iCurPage;
     m_sysCursor = m_cursor;
 }
 
+//---------------------------------------------------------------------------------------
+UPoint ScoreLayouter::determine_system_origin(int iSystem)
+{
+    //position for system box, at current cursor position
+
+    ImoSystemInfo* pInfo = (iSystem == 0 ? m_pScore->get_first_system_info()
+                                         : m_pScore->get_other_system_info());
+
+    LUnits top = m_cursor.y + distance_to_top_of_system(iSystem, m_fFirstSystemInPage);
+    LUnits left = m_cursor.x + pInfo->get_left_margin();
+    return UPoint(left, top);
+}
+
+//---------------------------------------------------------------------------------------
+LUnits ScoreLayouter::determine_system_width(int iSystem)
+{
+    ImoSystemInfo* pInfo = (iSystem == 0 ? m_pScore->get_first_system_info()
+                                         : m_pScore->get_other_system_info());
+
+    LUnits width = m_pCurBoxPage->get_width();
+    width -= (pInfo->get_left_margin() + pInfo->get_right_margin());
+    return width;
+}
+
 //---------------------------------------------------------------------------------------
 void ScoreLayouter::add_system_to_page()
 {
@@ -432,6 +503,14 @@ void ScoreLayouter::add_system_to_page()
 
     m_pCurBoxPage->add_system(m_pCurBoxSystem, m_iCurSystem);
     m_pCurBoxSystem->add_shapes_to_tables();
+    m_pStub->invalidate_playback_timeline();
+
+    //empty systems added for filling the page are not saved
+    if (m_curSysInfo.pBox == m_pCurBoxSystem)
+    {
+        m_pStub->add_system_info(m_curSysInfo);
+        m_curSysInfo.pBox = nullptr;
+    }
 
     move_paper_cursor_to_bottom_of_added_system();
     is_first_system_in_page(false);
@@ -501,10 +580,29 @@ LUnits ScoreLayouter::get_other_systems_staves_size()
 }
 
 //---------------------------------------------------------------------------------------
-void ScoreLayouter::decide_line_breaks()
+bool ScoreLayouter::decide_line_breaks()
 {
+    //Returns false if the incremental layout failed and the systems whose shapes
+    //were not created can not be reused. In this case, a full layout is needed
+
+    ProfilerScope scope("ScoreLayouter::decide_line_breaks");
+
+    //lazy layout: line breaks are decided as systems are needed
+    if (m_fMoreColumns)
+        return true;
+
     if (get_num_columns() != 0)
     {
+        if (m_pPrevStub && decide_line_breaks_incrementally())
+            return true;
+
+        //shapes for some columns were not created
+        if (std::find(m_reusedColumns.begin(), m_reusedColumns.end(), true)
+            != m_reusedColumns.end())
+        {
+            return false;
+        }
+
         bool fUseSimple = false;
 //        if (m_libraryScope.use_debug_values())
 //            fUseSimple = (m_libraryScope.get_render_spacing_opts()
@@ -524,6 +622,453 @@ void ScoreLayouter::decide_line_breaks()
             breaker.decide_line_breaks();
         }
     }
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void ScoreLayouter::decide_more_line_breaks()
+{
+    //Lazy layout: the last system is provisional, as it could continue in the columns
+    //not yet created. Therefore, the next chunk of columns is created and the line
+    //breaks for the last system and the new columns are decided again.
+    //AWARE: the line breaks could be different from those obtained when the whole
+    //score is split at once.
+
+    ProfilerScope scope("ScoreLayouter::decide_line_breaks");
+
+    int iFirstCol = 0;
+    if (!m_breaks.empty())
+    {
+        iFirstCol = m_breaks.back();
+        m_breaks.pop_back();
+        m_fMoreColumns =
+            m_pSpAlgorithm->split_more_content_in_columns(k_lazy_layout_columns);
+    }
+
+    int iEndCol = m_pSpAlgorithm->get_num_spaced_columns();
+    if (iEndCol > iFirstCol)
+    {
+        LinesBreakerOptimal breaker(this, m_libraryScope, m_pSpAlgorithm, m_breaks);
+        breaker.set_columns_range(iFirstCol, iEndCol, get_num_systems());
+        breaker.decide_line_breaks();
+    }
+    else
+        m_breaks.push_back(iFirstCol);
+}
+
+//---------------------------------------------------------------------------------------
+float ScoreLayouter::get_layout_progress()
+{
+    //Approximate fraction of the score already laid out, based on the measure
+    //for the first column not yet added to a page. AWARE: the last created system
+    //could be pending, waiting for a new page
+
+    int iCol = (system_created() ? m_breaks[m_iCurSystem] : m_iCurColumn);
+    ColStaffObjsEntry* pLast = m_pScore->get_staffobjs_table()->back();
+    if (!pLast || iCol < 0 || iCol >= get_num_columns())
+        return 1.0f;
+
+    ColStaffObjsEntry* pEntry = get_column(iCol)->get_first_entry();
+    if (!pEntry)
+        return 1.0f;
+
+    return float(pEntry->measure()) / float(pLast->measure() + 1);
+}
+
+//---------------------------------------------------------------------------------------
+void ScoreLayouter::find_previous_layout()
+{
+    //When the document was modified by an edition command, the graphic model for
+    //the previous version of the document could be available, and the command could
+    //have informed about the modified measures. In this case, the systems not
+    //affected by the changes will not be engraved again: its boxes will be moved
+    //to the new graphic model.
+
+    m_pPrevStub = nullptr;
+    m_reusable.clear();
+    m_reusedRanges.clear();
+    m_reusedColumns.clear();
+
+    GraphicModel* pPrevGModel = get_previous_graphic_model();
+    if (pPrevGModel)
+    {
+        ScoreStub* pStub = pPrevGModel->get_stub_for(m_pScore->get_id());
+        if (pStub && pStub->has_dirty_measures() && !pStub->get_systems_info().empty())
+        {
+            m_pPrevStub = pStub;
+            decide_columns_to_reuse();
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+bool ScoreLayouter::find_dirty_systems(int* iFirstDirty, int* iLastDirty)
+{
+    //find the systems, in previous layout, containing modified measures. A measure
+    //can be split between two systems. Returns false if none found
+
+    std::vector<ScoreStub::SystemLayoutInfo>& systems = m_pPrevStub->get_systems_info();
+    int numSystems = int(systems.size());
+    int firstDirty = m_pPrevStub->get_first_dirty_measure();
+    int lastDirty = m_pPrevStub->get_last_dirty_measure();
+
+    *iFirstDirty = -1;
+    *iLastDirty = -1;
+    for (int i=0; i < numSystems; ++i)
+    {
+        int first = systems[i].firstMeasure;
+        int last = (i == numSystems - 1 ? INT_MAX : systems[i+1].firstMeasure);
+        if (first <= lastDirty && last >= firstDirty)
+        {
+            if (*iFirstDirty == -1)
+                *iFirstDirty = i;
+            *iLastDirty = i;
+        }
+    }
+    return *iFirstDirty != -1;
+}
+
+//---------------------------------------------------------------------------------------
+void ScoreLayouter::decide_columns_to_reuse()
+{
+    //Systems before and after the modified ones will probably be reused. Therefore,
+    //when creating the columns, shapes will not be created for their columns. The
+    //spacing for a column depends on the neighbour columns. Therefore, the first
+    //column of each group of reused systems (when it is not the first column of the
+    //score) and its last two columns are engraved
+
+    int iFirstDirty, iLastDirty;
+    if (!find_dirty_systems(&iFirstDirty, &iLastDirty))
+        return;
+
+    std::vector<ScoreStub::SystemLayoutInfo>& systems = m_pPrevStub->get_systems_info();
+    int numSystems = int(systems.size());
+
+    //the last system is never reused. And a system with relations or lyrics crossing
+    //its limits is not reused
+    int iStart = 0;
+    for (int i=0; i < numSystems; ++i)
+    {
+        bool fCandidate = (i < iFirstDirty || (i > iLastDirty && i < numSystems - 1))
+                          && systems[i].pBox && systems[i].fCleanStart
+                          && systems[i+1].fCleanStart;
+        if (!fCandidate)
+        {
+            add_reused_columns_range(iStart, i);
+            iStart = i + 1;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void ScoreLayouter::add_reused_columns_range(int iFirstSystem, int iEndSystem)
+{
+    std::vector<ScoreStub::SystemLayoutInfo>& systems = m_pPrevStub->get_systems_info();
+
+    int numColumns = 0;
+    for (int i=iFirstSystem; i < iEndSystem; ++i)
+        numColumns += systems[i].numColumns;
+
+    ReusedColumns range;
+    range.numEngraved = (iFirstSystem == 0 ? 0 : 1);
+    range.numReused = numColumns - range.numEngraved - 2;
+    if (range.numReused <= 0)
+        return;
+
+    range.firstId = systems[iFirstSystem].firstId;
+    range.startTime = systems[iFirstSystem].startTime;
+    range.firstMeasure = systems[iFirstSystem].firstMeasure;
+    m_reusedRanges.push_back(range);
+}
+
+//---------------------------------------------------------------------------------------
+bool ScoreLayouter::decide_if_column_is_reused(ColStaffObjsEntry* pFirstEntry)
+{
+    //Invoked by ColumnsBuilder when starting a new column. Returns true if shapes
+    //must not be created for this column, as it is in a system that will be reused.
+    //A range of reused columns starts when the column starts at the same staffobj
+    //than the first system of the range in previous layout
+
+    if (m_numToEngrave == 0 && m_numToReuse == 0 && pFirstEntry)
+    {
+        for (int i=m_iNextRange; i < int(m_reusedRanges.size()); ++i)
+        {
+            ReusedColumns& range = m_reusedRanges[i];
+            if (pFirstEntry->element_id() == range.firstId
+                && pFirstEntry->measure() == range.firstMeasure
+                && is_equal_time(pFirstEntry->time(), range.startTime))
+            {
+                m_numToEngrave = range.numEngraved;
+                m_numToReuse = range.numReused;
+                m_iNextRange = i + 1;
+                break;
+            }
+        }
+    }
+
+    bool fReused = false;
+    if (m_numToEngrave > 0)
+        --m_numToEngrave;
+    else if (m_numToReuse > 0)
+    {
+        --m_numToReuse;
+        fReused = true;
+    }
+    m_reusedColumns.push_back(fReused);
+    return fReused;
+}
+
+//---------------------------------------------------------------------------------------
+bool ScoreLayouter::has_reused_columns(int iSystem)
+{
+    if (m_reusedColumns.empty() || iSystem >= get_num_systems())
+        return false;
+
+    int iFirstCol = m_breaks[iSystem];
+    int iLastCol = (iSystem == get_num_systems() - 1 ? get_num_columns()
+                                                     : m_breaks[iSystem + 1]);
+    for (int iCol=iFirstCol; iCol < iLastCol; ++iCol)
+    {
+        if (is_reused_column(iCol))
+            return true;
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+bool ScoreLayouter::decide_line_breaks_incrementally()
+{
+    //Only the systems containing modified measures are split again in lines. Breaks
+    //for previous systems are preserved and, when possible, also breaks for next
+    //systems. Returns false if not possible and a full lines break is required.
+
+    std::vector<ScoreStub::SystemLayoutInfo>& systems = m_pPrevStub->get_systems_info();
+    int numSystems = int(systems.size());
+
+    int iFirstDirty, iLastDirty;
+    if (!find_dirty_systems(&iFirstDirty, &iLastDirty))
+        return false;
+
+    //locate the column starting each old system
+    int numCols = get_num_columns();
+    std::map<ImoId, int> columns;
+    for (int iCol=0; iCol < numCols; ++iCol)
+    {
+        ColStaffObjsEntry* pEntry = get_column(iCol)->get_first_entry();
+        if (pEntry)
+            columns[pEntry->element_id()] = iCol;
+    }
+    std::vector<int> startCol(numSystems, -1);
+    for (int i=0; i < numSystems; ++i)
+    {
+        std::map<ImoId, int>::iterator it = columns.find(systems[i].firstId);
+        if (it != columns.end())
+        {
+            ColStaffObjsEntry* pEntry = get_column(it->second)->get_first_entry();
+            if (pEntry->measure() == systems[i].firstMeasure
+                && is_equal_time(pEntry->time(), systems[i].startTime))
+            {
+                startCol[i] = it->second;
+            }
+        }
+    }
+
+    //previous systems must start at the same columns
+    int iStartCol = 0;
+    for (int i=0; i < iFirstDirty; ++i)
+    {
+        if (startCol[i] != iStartCol)
+            return false;
+        iStartCol += systems[i].numColumns;
+    }
+    if (iStartCol >= numCols)
+        return false;
+    ColStaffObjsEntry* pEntry = get_column(iStartCol)->get_first_entry();
+    if (!pEntry || pEntry->measure() != systems[iFirstDirty].firstMeasure
+        || !is_equal_time(pEntry->time(), systems[iFirstDirty].startTime))
+    {
+        return false;
+    }
+
+    //next systems are preserved only if all of them start at the same columns
+    int iEndCol = numCols;
+    int iFirstNext = iLastDirty + 1;
+    if (iFirstNext < numSystems)
+    {
+        bool fPreserve = true;
+        for (int i=iFirstNext; i < numSystems && fPreserve; ++i)
+        {
+            int iNext = (i == numSystems - 1 ? numCols : startCol[i+1]);
+            fPreserve = (startCol[i] >= 0 && startCol[i] + systems[i].numColumns == iNext);
+        }
+        if (fPreserve)
+            iEndCol = startCol[iFirstNext];
+        else
+            iFirstNext = numSystems;
+    }
+    if (iEndCol <= iStartCol)
+        return false;
+
+    //split modified systems
+    m_breaks.clear();
+    for (int i=0; i < iFirstDirty; ++i)
+        m_breaks.push_back(startCol[i]);
+
+    LinesBreakerOptimal breaker(this, m_libraryScope, m_pSpAlgorithm, m_breaks);
+    breaker.set_columns_range(iStartCol, iEndCol, iFirstDirty);
+    breaker.decide_line_breaks();
+
+    //systems numbers are used in some shapes ids. Therefore, next systems can be
+    //reused only if the number of modified systems has not changed
+    bool fSameNumber = (int(m_breaks.size()) == iLastDirty + 1);
+    for (int i=iFirstNext; i < numSystems; ++i)
+        m_breaks.push_back(startCol[i]);
+
+    m_reusable.assign(m_breaks.size(), false);
+    for (int i=0; i < iFirstDirty; ++i)
+        m_reusable[i] = true;
+    if (fSameNumber)
+    {
+        for (int i=iFirstNext; i < numSystems; ++i)
+            m_reusable[i] = true;
+    }
+
+    //last system is never reused, as it is affected by final touches
+    m_reusable.back() = false;
+
+    //systems whose shapes were not created must be reused
+    for (int i=0; i < get_num_systems(); ++i)
+    {
+        if (!m_reusable[i] && has_reused_columns(i))
+            return false;
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+bool ScoreLayouter::can_reuse_system(int iSystem)
+{
+    if (!m_pPrevStub || iSystem >= int(m_reusable.size()) || !m_reusable[iSystem])
+        return false;
+
+    std::vector<ScoreStub::SystemLayoutInfo>& systems = m_pPrevStub->get_systems_info();
+    if (iSystem + 1 >= int(systems.size()))
+        return false;
+
+    //no relations or lyrics crossing system limits
+    ScoreStub::SystemLayoutInfo& info = systems[iSystem];
+    if (!info.pBox || !info.fCleanStart || !systems[iSystem+1].fCleanStart
+        || !m_notFinishedRelObj.empty() || !m_notFinishedLyrics.empty())
+    {
+        return false;
+    }
+
+    //same columns
+    int iFirstCol = m_breaks[iSystem];
+    int iLastCol = m_breaks[iSystem + 1];
+    ColStaffObjsEntry* pEntry = get_column(iFirstCol)->get_first_entry();
+    if (!pEntry || pEntry->element_id() != info.firstId
+        || iLastCol - iFirstCol != info.numColumns)
+    {
+        return false;
+    }
+
+    //same width and same previous system, as it affects staves position
+    if (!is_equal_pos(info.pBox->get_width(), determine_system_width(iSystem)))
+        return false;
+
+    GmoBoxSystem* pPrevBoxSystem = (m_fFirstSystemInPage ? nullptr : m_pPrevBoxSystem);
+    if (info.fHasPrevSystem != (pPrevBoxSystem != nullptr))
+        return false;
+
+    return !pPrevBoxSystem
+           || is_equal_pos(pPrevBoxSystem->get_free_space_at_bottom(), info.prevFreeSpace);
+}
+
+//---------------------------------------------------------------------------------------
+void ScoreLayouter::reuse_system()
+{
+    //move the system box from the previous graphic model instead of engraving the
+    //system again
+
+    ScoreStub::SystemLayoutInfo& info = m_pPrevStub->get_systems_info()[m_iCurSystem+1];
+    GmoBoxSystem* pBox = info.pBox;
+    info.pBox = nullptr;
+
+    GmoBox* pParent = pBox->get_parent_box();
+    if (pParent)
+        pParent->remove_child_box(pBox);
+    pBox->restore_free_space_at_bottom(info.removedSpace);
+
+    create_system_layouter();
+    m_iCurSystem++;
+    m_pPrevBoxSystem = (m_fFirstSystemInPage ? nullptr : m_pPrevBoxSystem);
+
+    UPoint org = determine_system_origin(m_iCurSystem);
+    pBox->shift_origin_and_content(USize(org.x - pBox->get_left(),
+                                         org.y - pBox->get_top()) );
+
+    int iFirstCol = m_breaks[m_iCurSystem];
+    int iLastCol = m_breaks[m_iCurSystem + 1];
+    m_pCurBoxSystem = m_pCurSysLyt->reuse_system_box(pBox, m_iCurSystem, iFirstCol,
+                                                     iLastCol);
+    m_iSysPage = m_iCurPage;
+    m_sysCursor = m_cursor;
+
+    //discard the shapes and pending aux objects created for these columns
+    for (int iCol=iFirstCol; iCol < iLastCol; ++iCol)
+        m_pSpAlgorithm->delete_shapes(iCol);
+
+    std::list<AuxObjContext*>::iterator it = m_pendingAuxObjs.begin();
+    while (it != m_pendingAuxObjs.end())
+    {
+        if ((*it)->iCol >= iFirstCol && (*it)->iCol < iLastCol)
+        {
+            delete *it;
+            it = m_pendingAuxObjs.erase(it);
+        }
+        else
+            ++it;
+    }
+    m_iCurColumn = iLastCol;
+
+    //measures table must point to the barlines in the reused box
+    m_pStub->get_measures_table()->copy_barlines_from(m_pPrevStub->get_measures_table(),
+                                                      pBox);
+
+    m_curSysInfo = info;
+    m_curSysInfo.pBox = pBox;
+    m_curSysInfo.removedSpace = 0.0f;
+}
+
+//---------------------------------------------------------------------------------------
+void ScoreLayouter::save_current_system_info()
+{
+    //info for deciding, in a future layout, if this system can be reused
+
+    m_curSysInfo = ScoreStub::SystemLayoutInfo();
+    m_curSysInfo.pBox = m_pCurBoxSystem;
+    m_curSysInfo.fCleanStart = m_notFinishedRelObj.empty() && m_notFinishedLyrics.empty();
+    m_curSysInfo.fHasPrevSystem = (m_pPrevBoxSystem != nullptr);
+    if (m_pPrevBoxSystem)
+        m_curSysInfo.prevFreeSpace = m_pPrevBoxSystem->get_free_space_at_bottom();
+
+    if (get_num_columns() > 0)
+    {
+        int iFirstCol = m_breaks[m_iCurSystem];
+        int iLastCol = (is_last_system() ? get_num_columns()
+                                         : m_breaks[m_iCurSystem + 1]);
+        m_curSysInfo.numColumns = iLastCol - iFirstCol;
+
+        ColStaffObjsEntry* pEntry = get_column(iFirstCol)->get_first_entry();
+        if (pEntry)
+        {
+            m_curSysInfo.firstId = pEntry->element_id();
+            m_curSysInfo.startTime = pEntry->time();
+            m_curSysInfo.firstMeasure = pEntry->measure();
+        }
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -756,6 +1301,23 @@ void ScoreLayouter::delete_not_used_objects()
     delete_system_boxes();
 }
 
+//---------------------------------------------------------------------------------------
+void ScoreLayouter::delete_not_laid_out_objects()
+{
+    //Lazy layout not finished. Delete objects created for the columns not yet
+    //transferred to the graphic model
+
+    delete_pendig_aux_objects();
+
+    for (int iCol = max(0, m_iCurColumn); iCol < get_num_columns(); ++iCol)
+        m_pSpAlgorithm->delete_shapes(iCol);
+
+    if (system_created())
+        delete_system();
+
+    m_engravers.delete_engravers();
+}
+
 //---------------------------------------------------------------------------------------
 void ScoreLayouter::delete_pendig_aux_objects()
 {
@@ -1589,7 +2151,19 @@ LinesBreakerOptimal::LinesBreakerOptimal(ScoreLayouter* pScoreLyt,
     : LinesBreaker(pScoreLyt, libScope, pSpAlgorithm, breaks)
     , m_numCols(0)
     , m_fJustifyLastLine(false)
+    , m_iFirstCol(0)
+    , m_iEndCol(-1)
+    , m_iFirstSystem(0)
+    , m_maxColumns(libScope.get_lines_breaker_max_columns())
+{
+}
+
+//---------------------------------------------------------------------------------------
+void LinesBreakerOptimal::set_columns_range(int iFirstCol, int iEndCol, int iFirstSystem)
 {
+    m_iFirstCol = iFirstCol;
+    m_iEndCol = iEndCol;
+    m_iFirstSystem = iFirstSystem;
 }
 
 //---------------------------------------------------------------------------------------
@@ -1606,7 +2180,9 @@ void LinesBreakerOptimal::decide_line_breaks()
 //---------------------------------------------------------------------------------------
 void LinesBreakerOptimal::initialize_entries_table()
 {
-    m_numCols = m_pScoreLyt->get_num_columns();
+    //AWARE: entries are relative to first column to distribute
+    int iEndCol = (m_iEndCol < 0 ? m_pScoreLyt->get_num_columns() : m_iEndCol);
+    m_numCols = iEndCol - m_iFirstCol;
 
     m_entries.reserve(m_numCols+1);
     m_entries.assign(m_numCols+1, Entry());
@@ -1653,7 +2229,9 @@ void LinesBreakerOptimal::compute_optimal_break_sequence()
 
                 //try system formed by columns {ci,...,cj-1}
 
-                bool fSystemBreak = m_pScoreLyt->column_has_system_break(j-1);
+                int iFirstCol = m_iFirstCol + i;
+                int iLastCol = m_iFirstCol + j - 1;
+                bool fSystemBreak = m_pScoreLyt->column_has_system_break(iLastCol);
                 float newPenalty;
                 if (fSystemBreak)
                 {
@@ -1662,7 +2240,8 @@ void LinesBreakerOptimal::compute_optimal_break_sequence()
                 }
                 else
                 {
-                    newPenalty = m_pSpAlgorithm->determine_penalty_for_line(iSystem, i, j-1);
+                    newPenalty = m_pSpAlgorithm->determine_penalty_for_line(
+                                        m_iFirstSystem + iSystem, iFirstCol, iLastCol);
                     if (newPenalty < 0.0f)
                     {
                         newPenalty = 0.0f;
@@ -1679,7 +2258,8 @@ void LinesBreakerOptimal::compute_optimal_break_sequence()
                 }
 
                 if (fSystemBreak || m_pSpAlgorithm->is_better_option(prevPenalty, newPenalty,
-                                                            m_entries[j].penalty, i, j-1))
+                                                            m_entries[j].penalty,
+                                                            iFirstCol, iLastCol))
                 {
                     if (fTrace)
                     {
@@ -1697,7 +2277,15 @@ void LinesBreakerOptimal::compute_optimal_break_sequence()
                     break;
 
                 //optimization: if no space for column j do not try column j+1
-                if (newPenalty >= LOMSE_INFINITE_PENALTY)
+                if (newPenalty >= LOMSE_INFINITE_PENALTY
+                    || m_pSpAlgorithm->line_overflows(m_iFirstSystem + iSystem,
+                                                      iFirstCol, iLastCol))
+                {
+                    break;
+                }
+
+                //bounded lookahead: do not try systems with more columns than allowed
+                if (m_maxColumns > 0 && j - i >= m_maxColumns)
                     break;
             }
         }
@@ -1722,8 +2310,8 @@ void LinesBreakerOptimal::retrieve_breaks_sequence()
     if (i == 0)
     {
         //no breaks. Just one single system
-        m_breaks.push_back(0);      //AWARE: breaks size is the number of systems because
-                                    //last break is implicit: last column
+        m_breaks.push_back(m_iFirstCol);    //AWARE: breaks size is the number of systems
+                                            //because last break is implicit: last column
 
         if (fTrace)
         {
@@ -1735,12 +2323,13 @@ void LinesBreakerOptimal::retrieve_breaks_sequence()
     }
 
     int numBreaks = m_entries[i].system;
-    m_breaks.assign(numBreaks, 0);
+    size_t iStart = m_breaks.size();
+    m_breaks.resize(iStart + numBreaks, m_iFirstCol);
 
     while (m_entries[i].predecessor > 0)
     {
         i = m_entries[i].predecessor;
-        m_breaks[--numBreaks] = i;
+        m_breaks[iStart + (--numBreaks)] = m_iFirstCol + i;
     }
 
     if (fTrace)
@@ -20,6 +20,7 @@
 #include "lomse_score_layouter.h"
 #include "lomse_box_slice.h"
 #include "lomse_shape_barline.h"
+#include "lomse_profiler.h"
 
 
 namespace lomse
@@ -80,6 +81,14 @@ void SpAlgColumn::split_content_in_columns()
     m_pColsBuilder->create_columns();
 }
 
+//---------------------------------------------------------------------------------------
+bool SpAlgColumn::split_more_content_in_columns(int numColumns)
+{
+    bool fMoreContent = m_pColsBuilder->create_more_columns(numColumns);
+    m_pColsBuilder->do_more_spacing(!fMoreContent);
+    return fMoreContent;
+}
+
 //---------------------------------------------------------------------------------------
 void SpAlgColumn::do_spacing_algorithm()
 {
@@ -271,6 +280,41 @@ ColumnsBuilder::~ColumnsBuilder()
 
 //---------------------------------------------------------------------------------------
 void ColumnsBuilder::create_columns()
+{
+    //staffobjs are engraved here, while collecting the content for each column
+    ProfilerScope scope("ColumnsBuilder::create_columns");
+
+    start_columns_creation();
+    while(!m_pSysCursor->is_end())
+        create_next_column();
+
+    m_maxColumn = m_iColumn;
+}
+
+//---------------------------------------------------------------------------------------
+bool ColumnsBuilder::create_more_columns(int numColumns)
+{
+    //Lazy layout: columns are created in chunks. Returns true if there is more
+    //content pending
+
+    ProfilerScope scope("ColumnsBuilder::create_columns");
+
+    //AWARE: engraving a system moves the staves to the system position. Therefore,
+    //for creating more columns the staves must be moved back to origin
+    if (m_colsData.empty())
+        start_columns_creation();
+    else
+        m_pPartsEngraver->move_staves_to_origin();
+
+    for (int i=0; i < numColumns && !m_pSysCursor->is_end(); ++i)
+        create_next_column();
+
+    m_maxColumn = m_iColumn;
+    return !m_pSysCursor->is_end();
+}
+
+//---------------------------------------------------------------------------------------
+void ColumnsBuilder::start_columns_creation()
 {
     m_iColumn = -1;
     m_iColStartMeasure = 0;
@@ -280,28 +324,43 @@ void ColumnsBuilder::create_columns()
     m_fOther.assign(m_pScore->get_num_instruments(), false);
 
     determine_staves_vertical_position();
-    while(!m_pSysCursor->is_end())
-    {
-        m_iColumn++;
-        prepare_for_new_column();
-        m_colsData.push_back( LOMSE_NEW ColumnData(m_pScoreMeter, m_pSpAlgorithm) );
-        find_and_save_context_info_for_this_column();
-        collect_content_for_this_column();
-    }
-    m_maxColumn = m_iColumn;
+}
+
+//---------------------------------------------------------------------------------------
+void ColumnsBuilder::create_next_column()
+{
+    m_iColumn++;
+    prepare_for_new_column();
+    m_colsData.push_back( LOMSE_NEW ColumnData(m_pScoreMeter, m_pSpAlgorithm) );
+    find_and_save_context_info_for_this_column();
+    collect_content_for_this_column();
 }
 
 //---------------------------------------------------------------------------------------
 void ColumnsBuilder::do_spacing_algorithm()
 {
+    ProfilerScope scope("ColumnsBuilder::do_spacing_algorithm");
     m_pSpAlgorithm->do_spacing(m_iColumnToTrace);
 }
 
+//---------------------------------------------------------------------------------------
+void ColumnsBuilder::do_more_spacing(bool fAllCreated)
+{
+    ProfilerScope scope("ColumnsBuilder::do_spacing_algorithm");
+    m_pSpAlgorithm->do_more_spacing(m_iColumnToTrace, fAllCreated);
+}
+
 //---------------------------------------------------------------------------------------
 void ColumnsBuilder::collect_content_for_this_column()
 {
     //ask system layouter to prepare for receiving data for objects in this column
     m_pSpAlgorithm->start_column_measurements(m_iColumn);
+    if (!m_pSysCursor->is_end())
+        m_colsData[m_iColumn]->set_first_entry( m_pSysCursor->cur_entry() );
+
+    //incremental layout: shapes are not needed if the column will be reused
+    bool fReused = m_pScoreLyt->decide_if_column_is_reused(
+                                    m_colsData[m_iColumn]->get_first_entry() );
 
     //loop to process all StaffObjs until this column is completed
     ImoStaffObj* pSO = nullptr;
@@ -341,6 +400,11 @@ void ColumnsBuilder::collect_content_for_this_column()
         {
             m_pSpAlgorithm->set_system_break(m_iColumn, true);
         }
+        else if (fReused)
+        {
+            pShape = nullptr;
+            include_object_without_shape(pSO, rTime, iInstr, iStaff);
+        }
         else
         {
             if (pSO->is_clef())
@@ -452,6 +516,29 @@ void ColumnsBuilder::collect_content_for_this_column()
     m_pSpAlgorithm->finish_column_measurements(m_iColumn);
 }
 
+//---------------------------------------------------------------------------------------
+void ColumnsBuilder::include_object_without_shape(ImoStaffObj* pSO, TimeUnits rTime,
+                                                  int iInstr, int iStaff)
+{
+    //Incremental layout: the column will be reused and shapes are not created. But
+    //the information for the spacing algorithm and for the measures table is needed
+
+    bool fInProlog = false;
+    if (pSO->is_clef() || pSO->is_key_signature() || pSO->is_time_signature())
+    {
+        int idx = m_pSysCursor->staff_index();
+        fInProlog = determine_if_is_in_prolog(pSO, rTime, iInstr, idx);
+    }
+    else
+        m_fOther[iInstr] = true;
+
+    m_pSpAlgorithm->include_object(m_pSysCursor->cur_entry(), m_iColumn, iInstr, iStaff,
+                                   pSO, nullptr, fInProlog);
+
+    if (pSO->is_barline() && !static_cast<ImoBarline*>(pSO)->is_middle())
+        m_pScoreLyt->finish_measure(iInstr, nullptr);
+}
+
 //---------------------------------------------------------------------------------------
 void ColumnsBuilder::find_and_save_context_info_for_this_column()
 {
@@ -642,6 +729,7 @@ ColumnData::ColumnData(ScoreMeter* pScoreMeter, SpAlgColumn* pSpAlgorithm)
     , m_fMeasureStart(false)
     , m_pMeasureInfo(nullptr)
     , m_pShapeBarline(nullptr)
+    , m_pFirstEntry(nullptr)
     , m_nTraceLevel(k_trace_off)
 {
     reserve_space_for_prolog_clefs_keys( m_pScoreMeter->num_staves() );
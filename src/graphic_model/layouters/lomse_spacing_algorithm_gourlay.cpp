@@ -65,6 +65,9 @@ SpAlgGourlay::SpAlgGourlay(LibraryScope& libraryScope, ScoreMeter* pScoreMeter,
     , m_alpha(0.0f)
     , m_dmin(0.0f)
     , m_Fopt(0.0f)
+    , m_fSpacingStarted(false)
+    , m_numColsWithRods(0)
+    , m_numSpacedCols(0)
 {
     ColStaffObjs* pCol = pScore->get_staffobjs_table();
     m_shapes.reserve(pCol->num_entries());
@@ -473,33 +476,78 @@ void SpAlgGourlay::do_spacing(int iColumnToTrace)
     //when this method is invoked, all columns in the score have been created and the
     //information collected.
 
+    do_more_spacing(iColumnToTrace, true);
+}
+
+//---------------------------------------------------------------------------------------
+void SpAlgGourlay::do_more_spacing(int iColumnToTrace, bool fAllCreated)
+{
+    //When not all columns have been created (lazy layout) the spacing can not be
+    //computed for the last columns: a slice needs the next one for computing ds, and
+    //computing rods for a slice can modify the two previous slices. Therefore, rods
+    //are not computed for the last column, and spacing is not computed for the
+    //previous two columns.
+    //Incremental layout: the columns to be reused have no shapes. Only ds and di
+    //are computed for their slices, as these values are needed by next slices.
+
+    int numCols = int(m_columns.size());
+    int iEndRods = (fAllCreated ? numCols : max(0, numCols - 1));
+    int iEndSpaced = (fAllCreated ? numCols : max(0, iEndRods - 2));
+
     //collect information, mainly by processing slices
-    determine_spacing_parameters();
-    compute_rods_ds_and_di();
-    fix_neighborhood_spacing_problems(iColumnToTrace);
-    compute_springs();
+    if (!m_fSpacingStarted)
+    {
+        determine_spacing_parameters();
+        m_fSpacingStarted = true;
+    }
+    compute_rods_ds_and_di(iEndRods);
+    fix_neighborhood_spacing_problems(iColumnToTrace, iEndSpaced);
+    compute_springs(iEndSpaced);
 
     //all information ready. Proceed by columns
     int numInstruments = m_pScoreMeter->num_instruments();
-    int iCol = 0;
-    vector<ColumnDataGourlay*>::iterator it;
-    for (iCol=0, it=m_columns.begin(); it != m_columns.end(); ++it, ++iCol)
+    for (int iCol=m_numSpacedCols; iCol < iEndSpaced; ++iCol)
     {
-        (*it)->order_slices();
-        (*it)->collect_barlines_information(numInstruments);
-        (*it)->determine_minimum_width();
-        (*it)->apply_force(m_Fopt);     //to get an initial estimation for columns width
-        (*it)->determine_approx_sff_for(m_Fopt);
+        if (m_pScoreLyt->is_reused_column(iCol))
+            continue;
+
+        ColumnDataGourlay* pColumn = m_columns[iCol];
+        pColumn->order_slices();
+        pColumn->collect_barlines_information(numInstruments);
+        pColumn->determine_minimum_width();
+        pColumn->apply_force(m_Fopt);     //to get an initial estimation for columns width
+        pColumn->determine_approx_sff_for(m_Fopt);
 
         if ((iCol == iColumnToTrace) || m_libraryScope.dump_column_tables())
         {
             dbgLogger << " ****************************** After applying Fopt = "
                 << m_Fopt << endl;
             dbgLogger << dump_spacing_parameters();
-            (*it)->dump(glogger.get_stream());
+            pColumn->dump(glogger.get_stream());
             dbgLogger << endl;
         }
     }
+
+    accumulate_columns_data(iEndSpaced);
+    m_numSpacedCols = iEndSpaced;
+}
+
+//---------------------------------------------------------------------------------------
+void SpAlgGourlay::accumulate_columns_data(int iEndCol)
+{
+    //save the accumulated slope, fixed space and minimum width of the columns, so
+    //that the data for any line {ci, ..., cj} is just a difference
+
+    size_t numCols = size_t(iEndCol);
+    m_accSlope.resize(numCols + 1, 0.0);
+    m_accFixed.resize(numCols + 1, 0.0);
+    m_accMinWidth.resize(numCols + 1, 0.0);
+    for (size_t i=size_t(m_numSpacedCols); i < numCols; ++i)
+    {
+        m_accSlope[i+1] = m_accSlope[i] + m_columns[i]->m_slope;
+        m_accFixed[i+1] = m_accFixed[i] + m_columns[i]->m_xFixed;
+        m_accMinWidth[i+1] = m_accMinWidth[i] + m_columns[i]->get_minimum_width();
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -569,38 +617,51 @@ void SpAlgGourlay::determine_spacing_parameters()
 }
 
 //---------------------------------------------------------------------------------------
-void SpAlgGourlay::compute_rods_ds_and_di()
+void SpAlgGourlay::compute_rods_ds_and_di(int iEndCol)
 {
     TextMeter textMeter(m_libraryScope);
-    list<TimeSlice*>::iterator it;
-    for (it = m_slices.begin(); it != m_slices.end(); ++it)
+    for (int iCol=m_numColsWithRods; iCol < iEndCol; ++iCol)
     {
-        (*it)->assign_spacing_values(m_shapes, m_pScoreMeter, textMeter);
-        (*it)->compute_ds_and_di();
+        bool fReused = m_pScoreLyt->is_reused_column(iCol);
+        TimeSlice* pSlice = m_columns[iCol]->m_pFirstSlice;
+        for (int i=0; i < m_columns[iCol]->num_slices(); ++i, pSlice = pSlice->next())
+        {
+            if (!fReused)
+                pSlice->assign_spacing_values(m_shapes, m_pScoreMeter, textMeter);
+            pSlice->compute_ds_and_di();
+        }
     }
+    m_numColsWithRods = max(m_numColsWithRods, iEndCol);
 }
 
 //---------------------------------------------------------------------------------------
-void SpAlgGourlay::fix_neighborhood_spacing_problems(int iColumnToTrace)
+void SpAlgGourlay::fix_neighborhood_spacing_problems(int iColumnToTrace, int iEndCol)
 {
-    vector<ColumnDataGourlay*>::iterator it;
-    int iCol = 0;
-    for (it = m_columns.begin(); it != m_columns.end(); ++it, ++iCol)
+    for (int iCol=m_numSpacedCols; iCol < iEndCol; ++iCol)
     {
+        if (m_pScoreLyt->is_reused_column(iCol))
+            continue;
+
         bool fTrace = (iCol == iColumnToTrace) || m_libraryScope.dump_column_tables();
-        (*it)->fix_neighborhood_spacing_problems(fTrace);
+        m_columns[iCol]->fix_neighborhood_spacing_problems(fTrace);
     }
 }
 
 //---------------------------------------------------------------------------------------
-void SpAlgGourlay::compute_springs()
+void SpAlgGourlay::compute_springs(int iEndCol)
 {
     LUnits dsFixed = m_pScoreMeter->tenths_to_logical_max(
                                 m_pScoreMeter->get_spacing_value());
     bool fProportional = m_pScoreMeter->is_proportional_spacing();
-    list<TimeSlice*>::iterator it;
-    for (it = m_slices.begin(); it != m_slices.end(); ++it)
-        (*it)->compute_spring_data(m_uSmin, m_alpha, m_dmin, fProportional, dsFixed);
+    for (int iCol=m_numSpacedCols; iCol < iEndCol; ++iCol)
+    {
+        if (m_pScoreLyt->is_reused_column(iCol))
+            continue;
+
+        TimeSlice* pSlice = m_columns[iCol]->m_pFirstSlice;
+        for (int i=0; i < m_columns[iCol]->num_slices(); ++i, pSlice = pSlice->next())
+            pSlice->compute_spring_data(m_uSmin, m_alpha, m_dmin, fProportional, dsFixed);
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -897,23 +958,15 @@ float SpAlgGourlay::determine_penalty_for_line(int iSystem, int iFirstCol, int i
 //        return -1.0f;
 //    }
 
-    LUnits lineWidth = m_pScoreLyt->get_target_size_for_system(iSystem);
-    if (iSystem > 0)
-        lineWidth -= 1000.0f; //m_pScoreLyt->get_prolog_width_for_system(iSystem);
+    LUnits lineWidth = determine_line_width(iSystem);
 
     //determine composite spacing function sff[cicj]
     //                       j                          j
     //    sff[cicj] = 1 / ( SUM ( 1/Cappn ) )  = 1 / ( SUM ( slope.n ) )
     //                      n=i                        n=i
-    float sum = 0.0f;
-    LUnits fixed = 0.0f;
-    LUnits minWidth = 0.0f;
-    for (int i = iFirstCol; i <= iLastCol; ++i)
-    {
-        sum += m_columns[i]->m_slope;
-        fixed += m_columns[i]->m_xFixed;
-        minWidth += m_columns[i]->get_minimum_width();
-    }
+    float sum = float(m_accSlope[iLastCol+1] - m_accSlope[iFirstCol]);
+    LUnits fixed = LUnits(m_accFixed[iLastCol+1] - m_accFixed[iFirstCol]);
+    LUnits minWidth = LUnits(m_accMinWidth[iLastCol+1] - m_accMinWidth[iFirstCol]);
     float c = 1.0f / sum;
 
     //if minimum width is greater than required width, it is impossible to achieve
@@ -972,6 +1025,27 @@ float SpAlgGourlay::determine_penalty_for_line(int iSystem, int iFirstCol, int i
     return R;
 }
 
+//---------------------------------------------------------------------------------------
+bool SpAlgGourlay::line_overflows(int iSystem, int iFirstCol, int iLastCol)
+{
+    //minimum width only grows when adding columns. Lines with just one column are
+    //always accepted
+    if (iFirstCol == iLastCol)
+        return false;
+
+    LUnits minWidth = LUnits(m_accMinWidth[iLastCol+1] - m_accMinWidth[iFirstCol]);
+    return minWidth > determine_line_width(iSystem);
+}
+
+//---------------------------------------------------------------------------------------
+LUnits SpAlgGourlay::determine_line_width(int iSystem)
+{
+    LUnits lineWidth = m_pScoreLyt->get_target_size_for_system(iSystem);
+    if (iSystem > 0)
+        lineWidth -= 1000.0f; //m_pScoreLyt->get_prolog_width_for_system(iSystem);
+    return lineWidth;
+}
+
 //---------------------------------------------------------------------------------------
 bool SpAlgGourlay::is_better_option(float prevPenalty, float newPenalty,
                                     float nextPenalty, int UNUSED(i), int UNUSED(j))
@@ -33,6 +33,7 @@
 #include "lomse_chord_engraver.h"
 #include "lomse_aux_shapes_aligner.h"
 #include "lomse_lyric_engraver.h"
+#include "lomse_profiler.h"
 
 #include <sstream>
 #include <algorithm>
@@ -156,6 +157,8 @@ GmoBoxSystem* SystemLayouter::create_system_box(LUnits left, LUnits top, LUnits
 void SystemLayouter::engrave_system(LUnits indent, int iFirstCol, int iLastCol,
                                     UPoint pos, GmoBoxSystem* pPrevBoxSystem)
 {
+    ProfilerScope scope("SystemLayouter::engrave_system");
+
     m_iSystem = m_pScoreLyt->m_iCurSystem;
     m_iFirstCol = iFirstCol;
     m_iLastCol = iLastCol;
@@ -185,6 +188,23 @@ void SystemLayouter::engrave_system(LUnits indent, int iFirstCol, int iLastCol,
     add_initial_line_joining_all_staves_in_system();
 }
 
+//---------------------------------------------------------------------------------------
+GmoBoxSystem* SystemLayouter::reuse_system_box(GmoBoxSystem* pBox, int iSystem,
+                                               int iFirstCol, int iLastCol)
+{
+    //an already engraved system box, from a previous layout, is going to be used
+    //instead of engraving the system
+
+    m_pBoxSystem = pBox;
+    m_iSystem = iSystem;
+    m_iFirstCol = iFirstCol;
+    m_iLastCol = iLastCol;
+    m_yMin = pBox->get_top();
+    m_yMax = pBox->get_bottom();
+
+    return m_pBoxSystem;
+}
+
 //---------------------------------------------------------------------------------------
 void SystemLayouter::set_position_and_width_for_staves(LUnits indent)
 {
@@ -789,6 +809,9 @@ void SystemLayouter::increment_cross_staff_stems(GmoShapeBeam* pShapeBeam, LUnit
 //---------------------------------------------------------------------------------------
 void SystemLayouter::engrave_system_details(int iSystem)
 {
+    //AuxObjs and RelObjs are engraved here
+    ProfilerScope scope("SystemLayouter::engrave_system_details");
+
     //list of AuxObjs/RelObjs for system iSystem
     std::list<PendingPair> systemAuxObjs;
     std::bitset<k_imo_last> used;
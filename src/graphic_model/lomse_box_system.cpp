@@ -131,6 +131,26 @@ void GmoBoxSystem::remove_free_space_at_bottom_and_adjust_slices()
     }
 }
 
+//---------------------------------------------------------------------------------------
+void GmoBoxSystem::restore_free_space_at_bottom(LUnits space)
+{
+    //undo a previous remove_free_space_at_bottom_and_adjust_slices() that removed
+    //the given space. Used when the system is reused in other page
+
+    if (space == 0.0f)
+        return;
+
+    set_height( get_height() + space );
+    m_uFreeAtBottom = space;
+
+    vector<GmoBox*>::iterator it;
+    for (it=m_childBoxes.begin(); it != m_childBoxes.end(); ++it)
+    {
+        GmoBoxSlice* pSlice = static_cast<GmoBoxSlice*>(*it);
+        pSlice->reduce_last_instrument_height(-space);
+    }
+}
+
 //---------------------------------------------------------------------------------------
 GmoBoxSliceInstr* GmoBoxSystem::get_first_instr_slice(int iInstr)
 {
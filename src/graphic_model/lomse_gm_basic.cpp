@@ -19,7 +19,10 @@
 #include "lomse_box_system.h"
 #include "lomse_logger.h"
 #include "lomse_gm_measures_table.h"
+#include "lomse_playback_timeline.h"
+#include "lomse_shapes_grid.h"
 
+#include <algorithm>
 #include <cstdlib>      //abs
 #include <iomanip>
 using namespace std;
@@ -349,6 +352,20 @@ void GmoBox::add_child_box(GmoBox* child)
     child->set_owner_box(this);
 }
 
+//---------------------------------------------------------------------------------------
+void GmoBox::remove_child_box(GmoBox* child)
+{
+    //the child box is not deleted. Ownership is transferred to the caller
+
+    std::vector<GmoBox*>::iterator it = find(m_childBoxes.begin(), m_childBoxes.end(),
+                                             child);
+    if (it != m_childBoxes.end())
+    {
+        m_childBoxes.erase(it);
+        child->set_owner_box(nullptr);
+    }
+}
+
 //---------------------------------------------------------------------------------------
 GmoBox* GmoBox::get_child_box(int i)  //i = 0..n-1
 {
@@ -439,10 +456,15 @@ void GmoBox::on_draw(Drawer* pDrawer, RenderOptions& opt)
     draw_border(pDrawer, opt);
     draw_shapes(pDrawer, opt);
 
-    //draw contained boxes
+    //draw contained boxes, skipping those out of the visible area
     std::vector<GmoBox*>::iterator it;
     for (it=m_childBoxes.begin(); it != m_childBoxes.end(); ++it)
-        (*it)->on_draw(pDrawer, opt);
+    {
+        if (opt.is_visible( (*it)->get_subtree_bounds() ))
+            (*it)->on_draw(pDrawer, opt);
+        else
+            ++opt.num_boxes_culled;
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -450,7 +472,58 @@ void GmoBox::draw_shapes(Drawer* pDrawer, RenderOptions& opt)
 {
     std::list<GmoShape*>::iterator itS;
     for (itS=m_shapes.begin(); itS != m_shapes.end(); ++itS)
-        (*itS)->on_draw(pDrawer, opt);
+    {
+        if (opt.is_visible( (*itS)->get_bounds() ))
+        {
+            (*itS)->on_draw(pDrawer, opt);
+            ++opt.num_shapes_drawn;
+        }
+        else
+            ++opt.num_shapes_culled;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+//helper for GmoBox::compute_subtree_bounds(). URect::Union() is not used because it
+//ignores empty rectangles, and shapes such as horizontal lines have zero height. But
+//rectangles without size (e.g. boxes for staves in a slice, that are just containers,
+//or the shape for a key signature without accidentals) are ignored.
+static void add_to_bounds(const URect& rect, URect* pBounds, bool* pfEmpty)
+{
+    if (rect.width == 0.0f && rect.height == 0.0f)
+        return;
+
+    if (*pfEmpty)
+    {
+        *pBounds = rect;
+        *pfEmpty = false;
+        return;
+    }
+
+    LUnits xMax = max(pBounds->right(), rect.right());
+    LUnits yMax = max(pBounds->bottom(), rect.bottom());
+    pBounds->x = min(pBounds->left(), rect.left());
+    pBounds->y = min(pBounds->top(), rect.top());
+    pBounds->width = xMax - pBounds->x;
+    pBounds->height = yMax - pBounds->y;
+}
+
+//---------------------------------------------------------------------------------------
+URect GmoBox::compute_subtree_bounds()
+{
+    URect bounds(m_origin, m_size);
+    bool fEmpty = (m_size.width == 0.0f && m_size.height == 0.0f);
+
+    std::list<GmoShape*>::iterator itS;
+    for (itS=m_shapes.begin(); itS != m_shapes.end(); ++itS)
+        add_to_bounds((*itS)->get_bounds(), &bounds, &fEmpty);
+
+    std::vector<GmoBox*>::iterator itB;
+    for (itB=m_childBoxes.begin(); itB != m_childBoxes.end(); ++itB)
+        add_to_bounds((*itB)->compute_subtree_bounds(), &bounds, &fEmpty);
+
+    m_subtreeBounds = bounds;
+    return m_subtreeBounds;
 }
 
 //---------------------------------------------------------------------------------------
@@ -913,9 +986,18 @@ public:
 GmoBoxDocPage::GmoBoxDocPage(ImoObj* pCreatorImo)
     : GmoBox(GmoObj::k_box_doc_page, pCreatorImo)
     , m_numPage(1)
+    , m_pShapesGrid(nullptr)
+    , m_fShapesGridValid(false)
+    , m_fSubtreeBoundsValid(false)
 {
 }
 
+//---------------------------------------------------------------------------------------
+GmoBoxDocPage::~GmoBoxDocPage()
+{
+    delete m_pShapesGrid;
+}
+
 //---------------------------------------------------------------------------------------
 void GmoBoxDocPage::on_draw(Drawer* pDrawer, RenderOptions& opt)
 {
@@ -926,6 +1008,9 @@ void GmoBoxDocPage::on_draw(Drawer* pDrawer, RenderOptions& opt)
         pDrawer->start_simple_notation(get_notation_id(ss.str()), "background");
     }
 
+    if (opt.culling_flag && !m_fSubtreeBoundsValid)
+        update_subtree_bounds();
+
     draw_page_background(pDrawer, opt);
     GmoBox::on_draw(pDrawer, opt);
 }
@@ -960,9 +1045,28 @@ void GmoBoxDocPage::add_to_tables(GmoShape* pShape)
     else
         m_allShapes.insert(it, pShape);
 
+    m_fShapesGridValid = false;
+    m_fSubtreeBoundsValid = false;
     store_in_map_imo_shape(pShape);
 }
 
+//---------------------------------------------------------------------------------------
+void GmoBoxDocPage::build_shapes_grid()
+{
+    if (!m_pShapesGrid)
+        m_pShapesGrid = LOMSE_NEW ShapesGrid();
+
+    m_pShapesGrid->build(m_allShapes);
+    m_fShapesGridValid = true;
+}
+
+//---------------------------------------------------------------------------------------
+void GmoBoxDocPage::update_subtree_bounds()
+{
+    compute_subtree_bounds();
+    m_fSubtreeBoundsValid = true;
+}
+
 //---------------------------------------------------------------------------------------
 void GmoBoxDocPage::store_in_map_imo_shape(GmoShape* pShape)
 {
@@ -990,25 +1094,19 @@ GmoShape* GmoBoxDocPage::get_first_shape_for_layer(int layer)
 //---------------------------------------------------------------------------------------
 GmoShape* GmoBoxDocPage::find_shape_at(LUnits x, LUnits y)
 {
-    std::list<GmoShape*>::reverse_iterator it;
-    for (it = m_allShapes.rbegin(); it != m_allShapes.rend(); ++it)
-    {
-        if ((*it)->hit_test(x, y))
-            return *it;
-    }
-    return nullptr;
+    if (!m_fShapesGridValid)
+        build_shapes_grid();
+
+    return m_pShapesGrid->find_shape_at(x, y);
 }
 
 //---------------------------------------------------------------------------------------
 GmoShape* GmoBoxDocPage::find_shape_for_object(ImoStaffObj* pSO)
 {
-    std::list<GmoShape*>::iterator it;
-    for (it = m_allShapes.begin(); it != m_allShapes.end(); ++it)
-    {
-        if ((*it)->was_created_by(pSO))
-            return *it;
-    }
-    return nullptr;
+    if (!m_fShapesGridValid)
+        build_shapes_grid();
+
+    return m_pShapesGrid->find_shape_for_object(pSO);
 }
 
 //---------------------------------------------------------------------------------------
@@ -1030,17 +1128,16 @@ void GmoBoxDocPage::select_objects_in_rectangle(SelectionSet* selection,
                                                 const URect& selRect,
                                                 unsigned UNUSED(flags))
 {
-    bool fSomethingSelected = false;
-    std::list<GmoShape*>::reverse_iterator it;
-    for (it = m_allShapes.rbegin(); it != m_allShapes.rend(); ++it)
-    {
-        URect bbox = (*it)->get_bounds();
-        if (selRect.contains(bbox))
-        {
-            selection->add(*it);
-            fSomethingSelected = true;
-        }
-    }
+    if (!m_fShapesGridValid)
+        build_shapes_grid();
+
+    std::vector<GmoShape*> shapes;
+    m_pShapesGrid->find_shapes_contained_in(selRect, shapes);
+
+    std::vector<GmoShape*>::iterator it;
+    for (it = shapes.begin(); it != shapes.end(); ++it)
+        selection->add(*it);
+    bool fSomethingSelected = !shapes.empty();
 
     //if no objects in rectangle try to select clicked object
     if (!fSomethingSelected)
@@ -1171,6 +1268,9 @@ void GmoBoxLink::notify_event(SpEventInfo pEvent)
 //=======================================================================================
 ScoreStub::ScoreStub(ImoScore* pScore)
     : m_scoreId(pScore->get_id())
+    , m_pTimeline(nullptr)
+    , m_firstDirtyMeasure(-1)
+    , m_lastDirtyMeasure(-1)
 {
     m_measures = LOMSE_NEW GmMeasuresTable(pScore);
 }
@@ -1179,6 +1279,47 @@ ScoreStub::ScoreStub(ImoScore* pScore)
 ScoreStub::~ScoreStub()
 {
     delete m_measures;
+    delete m_pTimeline;
+}
+
+//---------------------------------------------------------------------------------------
+void ScoreStub::add_page(GmoBoxScorePage* pPage)
+{
+    m_pages.push_back(pPage);
+    invalidate_playback_timeline();
+}
+
+//---------------------------------------------------------------------------------------
+PlaybackTimeline* ScoreStub::get_playback_timeline()
+{
+    if (!m_pTimeline)
+        m_pTimeline = LOMSE_NEW PlaybackTimeline(m_pages);
+    return m_pTimeline;
+}
+
+//---------------------------------------------------------------------------------------
+void ScoreStub::invalidate_playback_timeline()
+{
+    delete m_pTimeline;
+    m_pTimeline = nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+void ScoreStub::mark_measures_as_dirty(int first, int last)
+{
+    if (first < 0 || last < first)
+        return;
+
+    if (m_firstDirtyMeasure < 0)
+    {
+        m_firstDirtyMeasure = first;
+        m_lastDirtyMeasure = last;
+    }
+    else
+    {
+        m_firstDirtyMeasure = min(m_firstDirtyMeasure, first);
+        m_lastDirtyMeasure = max(m_lastDirtyMeasure, last);
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -17,6 +17,7 @@
 //std
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 using namespace std;
 
 namespace lomse
@@ -89,6 +90,25 @@ void GmMeasuresTable::finish_measure(int iInstr, GmoShapeBarline* pBarlineShape)
     m_numBarlines[iInstr]++;
 }
 
+//---------------------------------------------------------------------------------------
+void GmMeasuresTable::copy_barlines_from(GmMeasuresTable* pSrc, GmoBoxSystem* pBox)
+{
+    int numInstrs = min(get_num_instruments(), pSrc->get_num_instruments());
+    for (int iInstr=0; iInstr < numInstrs; ++iInstr)
+    {
+        BarlinesVector* pBarlines = m_instrument[iInstr];
+        BarlinesVector* pSrcBarlines = pSrc->m_instrument[iInstr];
+        int iFirst = pBox->get_first_measure(iInstr);
+        if (!pBarlines || !pSrcBarlines || iFirst < 0)
+            continue;
+
+        int iEnd = iFirst + pBox->get_num_measures(iInstr);
+        iEnd = min(iEnd, int(min(pBarlines->size(), pSrcBarlines->size())));
+        for (int i=iFirst; i < iEnd; ++i)
+            pBarlines->at(i) = pSrcBarlines->at(i);
+    }
+}
+
 //---------------------------------------------------------------------------------------
 LUnits GmMeasuresTable::get_end_barline_left(int iInstr, int iMeasure,
                                              GmoBoxSystem* pBox)
@@ -24,9 +24,12 @@
 #include "lomse_box_system.h"
 #include "lomse_box_slice.h"
 #include "lomse_timegrid_table.h"
+#include "lomse_playback_timeline.h"
 #include "lomse_score_algorithms.h"
 #include "lomse_logger.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>      //abs
 #include <iomanip>
 
@@ -38,11 +41,13 @@ namespace lomse
 //=======================================================================================
 // Graphic model implementation
 //=======================================================================================
-static long m_idCounter = 0L;
+static std::atomic<long> m_idCounter(0L);
 
 //---------------------------------------------------------------------------------------
 GraphicModel::GraphicModel(ImoDocument* pCreator)
     : m_modified(true)
+    , m_fLayoutFinished(true)
+    , m_estimatedPages(0)
 {
     m_root = LOMSE_NEW GmoBoxDocument(this, pCreator);
     m_modelId = ++m_idCounter;
@@ -67,6 +72,20 @@ int GraphicModel::get_num_pages()
     return m_root->get_num_pages();
 }
 
+//---------------------------------------------------------------------------------------
+int GraphicModel::get_estimated_num_pages()
+{
+    int numPages = get_num_pages();
+    return (m_fLayoutFinished ? numPages : max(numPages, m_estimatedPages));
+}
+
+//---------------------------------------------------------------------------------------
+void GraphicModel::set_layout_state(bool fFinished, int estimatedPages)
+{
+    m_fLayoutFinished = fFinished;
+    m_estimatedPages = estimatedPages;
+}
+
 //---------------------------------------------------------------------------------------
 GmoBoxDocPage* GraphicModel::get_page(int i)
 {
@@ -244,14 +263,20 @@ GmoBox* GraphicModel::get_box_for_imo(ImoId id)
 }
 
 //---------------------------------------------------------------------------------------
-void GraphicModel::build_main_boxes_table()
+void GraphicModel::build_main_boxes_table(int iFirstPage)
 {
+    //AWARE: iFirstPage > 0 when adding the pages created by a lazy layout
+
     if (m_root)
     {
         vector<GmoBox*>& pageBoxes = m_root->get_child_boxes();
         vector<GmoBox*>::iterator itP;
-        for (itP=pageBoxes.begin(); itP != pageBoxes.end(); ++itP)
+        for (itP=pageBoxes.begin() + iFirstPage; itP < pageBoxes.end(); ++itP)
         {
+            GmoBoxDocPage* pPage = static_cast<GmoBoxDocPage*>(*itP);
+            pPage->build_shapes_grid();
+            pPage->update_subtree_bounds();
+
             vector<GmoBox*>& contentBoxes = (*itP)->get_child_boxes();
             vector<GmoBox*>::iterator itC;
             for (itC=contentBoxes.begin(); itC != contentBoxes.end(); ++itC)
@@ -284,44 +309,8 @@ GmoBoxSystem* GraphicModel::get_system_for(ImoId scoreId, TimeUnits timepos)
 {
     //if not found returns nullptr
 
-    ScoreStub* pStub = get_stub_for(scoreId);
-    GmoBoxScorePage* pPage = pStub->get_page_for(timepos);
-    if (pPage)
-    {
-        //find system in this page
-        GmoBoxSystem* pSystem = nullptr;
-        int i = pPage->get_num_first_system();
-        int maxSystem = pPage->get_num_systems() + i;
-        LOMSE_LOG_DEBUG(Logger::k_events, "get_system_for(%f), i=%d, maxSystem=%d",
-                        timepos, i, maxSystem);
-        for (; i < maxSystem; ++i)
-        {
-            pSystem = pPage->get_system(i);
-            LOMSE_LOG_DEBUG(Logger::k_events, "system %d. End time = %f",
-                            i, pSystem->end_time());
-            if (is_lower_time(timepos, pSystem->end_time()))
-                break;
-            else if(is_equal_time(timepos, pSystem->end_time()))
-            {
-                //look in next system
-                int iNext = i + 1;
-                if (iNext < maxSystem)
-                {
-                    GmoBoxSystem* pNextSystem = pPage->get_system(iNext);
-                    if (is_equal_time(timepos, pNextSystem->start_time()))
-                    {
-                        i = iNext;
-                        pSystem = pNextSystem;
-                    }
-                }
-                break;
-            }
-        }
-
-        if (i < maxSystem)
-            return pSystem;
-    }
-    return nullptr;
+    PlaybackTimeline* pTimeline = get_playback_timeline(scoreId);
+    return (pTimeline ? pTimeline->get_system_for(timepos) : nullptr);
 }
 
 //---------------------------------------------------------------------------------------
@@ -406,6 +395,13 @@ GmMeasuresTable* GraphicModel::get_measures_table(ImoId scoreId)
 	return (pStub ? pStub->get_measures_table() : nullptr);
 }
 
+//---------------------------------------------------------------------------------------
+PlaybackTimeline* GraphicModel::get_playback_timeline(ImoId scoreId)
+{
+	ScoreStub* pStub = get_stub_for(scoreId);
+	return (pStub ? pStub->get_playback_timeline() : nullptr);
+}
+
 //---------------------------------------------------------------------------------------
 int GraphicModel::get_page_number_containing(GmoObj* pGmo)
 {
@@ -0,0 +1,122 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#include "lomse_playback_timeline.h"
+
+#include "lomse_gm_basic.h"
+#include "lomse_box_system.h"
+#include "lomse_time.h"
+
+//std
+#include <algorithm>
+using namespace std;
+
+namespace lomse
+{
+
+//=======================================================================================
+// PlaybackTimeline implementation
+//=======================================================================================
+PlaybackTimeline::PlaybackTimeline(std::vector<GmoBoxScorePage*>& pages)
+{
+    for (GmoBoxScorePage* pPage : pages)
+    {
+        //AWARE: first page could be empty when the score is embedded in a text.
+        //See ScoreStub::get_page_for()
+        int iSystem = pPage->get_num_first_system();
+        int maxSystem = pPage->get_num_systems() + iSystem;
+        for (; iSystem < maxSystem; ++iSystem)
+            add_system( pPage->get_system(iSystem) );
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void PlaybackTimeline::add_system(GmoBoxSystem* pSystem)
+{
+    TimeGridTable* pTable = pSystem->get_time_grid_table();
+    if (pTable == nullptr || pTable->get_size() == 0)
+        return;     //system without timed staffobjs
+
+    SystemEntry system;
+    system.pSystem = pSystem;
+    system.iPage = pSystem->get_page_number();
+    system.yTop = pSystem->get_top();
+    system.yBottom = pSystem->get_bottom();
+    system.startTime = pTable->start_time();
+    system.endTime = pTable->end_time();
+    system.iFirst = int(m_entries.size());
+
+    vector<TimeGridTableEntry>& entries = pTable->get_entries();
+    m_entries.insert(m_entries.end(), entries.begin(), entries.end());
+
+    system.iEnd = int(m_entries.size());
+    m_systems.push_back(system);
+}
+
+//---------------------------------------------------------------------------------------
+int PlaybackTimeline::find_system(TimeUnits timepos)
+{
+    //find first system with end time greater or equal than requested time
+    vector<SystemEntry>::iterator it =
+        std::lower_bound(m_systems.begin(), m_systems.end(), timepos,
+                         [](const SystemEntry& system, TimeUnits time)
+                         { return is_lower_time(system.endTime, time); });
+    if (it == m_systems.end())
+        return -1;
+
+    int i = int(it - m_systems.begin());
+
+    //when timepos is the end of the system, look in next system
+    if (is_equal_time(timepos, (*it).endTime))
+    {
+        int iNext = i + 1;
+        if (iNext < int(m_systems.size())
+            && is_equal_time(timepos, m_systems[iNext].startTime))
+        {
+            return iNext;
+        }
+    }
+    return i;
+}
+
+//---------------------------------------------------------------------------------------
+GmoBoxSystem* PlaybackTimeline::get_system_for(TimeUnits timepos)
+{
+    int i = find_system(timepos);
+    return (i < 0 ? nullptr : m_systems[i].pSystem);
+}
+
+//---------------------------------------------------------------------------------------
+LUnits PlaybackTimeline::get_x_for_note_rest_at_time(int iSystem, TimeUnits timepos)
+{
+    const TimeGridTableEntry* pEntries = m_entries.data();
+    SystemEntry& system = m_systems[iSystem];
+    return TimeGridTable::find_x_for_note_rest_at_time(pEntries + system.iFirst,
+                                                       pEntries + system.iEnd,
+                                                       timepos);
+}
+
+//---------------------------------------------------------------------------------------
+bool PlaybackTimeline::locate(TimeUnits timepos, Position* pPos)
+{
+    int i = find_system(timepos);
+    if (i < 0)
+        return false;
+
+    SystemEntry& system = m_systems[i];
+    pPos->pSystem = system.pSystem;
+    pPos->iPage = system.iPage;
+    pPos->x = get_x_for_note_rest_at_time(i, timepos);
+    pPos->yTop = system.yTop;
+    pPos->yBottom = system.yBottom;
+    return true;
+}
+
+
+}  //namespace lomse
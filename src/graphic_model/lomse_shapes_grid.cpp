@@ -0,0 +1,201 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#include "lomse_shapes_grid.h"
+
+#include "lomse_gm_basic.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace lomse
+{
+
+//grid size: average number of shapes per cell and max number of cells per axis
+const double k_shapes_per_cell = 4.0;
+const int k_max_cells_per_axis = 128;
+
+
+//=======================================================================================
+// ShapesGrid implementation
+//=======================================================================================
+ShapesGrid::ShapesGrid()
+    : m_xOrg(0.0f)
+    , m_yOrg(0.0f)
+    , m_cellWidth(1.0f)
+    , m_cellHeight(1.0f)
+    , m_numCols(0)
+    , m_numRows(0)
+{
+}
+
+//---------------------------------------------------------------------------------------
+void ShapesGrid::clear()
+{
+    m_shapes.clear();
+    m_cells.clear();
+    m_creators.clear();
+    m_numCols = 0;
+    m_numRows = 0;
+}
+
+//---------------------------------------------------------------------------------------
+void ShapesGrid::build(std::list<GmoShape*>& shapes)
+{
+    clear();
+    if (shapes.empty())
+        return;
+
+    m_shapes.reserve(shapes.size());
+    m_shapes.assign(shapes.begin(), shapes.end());
+
+    //determine grid extent: the union of all shapes bounds
+    LUnits xMin = 0.0f, yMin = 0.0f, xMax = 0.0f, yMax = 0.0f;
+    bool fFirst = true;
+    for (GmoShape* pShape : m_shapes)
+    {
+        URect bbox = pShape->get_bounds();
+        if (fFirst)
+        {
+            xMin = bbox.left();
+            yMin = bbox.top();
+            xMax = bbox.right();
+            yMax = bbox.bottom();
+            fFirst = false;
+        }
+        else
+        {
+            xMin = std::min(xMin, bbox.left());
+            yMin = std::min(yMin, bbox.top());
+            xMax = std::max(xMax, bbox.right());
+            yMax = std::max(yMax, bbox.bottom());
+        }
+
+        ImoObj* pImo = pShape->get_creator_imo();
+        if (pImo && m_creators.find(pImo) == m_creators.end())
+            m_creators[pImo] = pShape;
+    }
+    LUnits width = std::max(xMax - xMin, 1.0f);
+    LUnits height = std::max(yMax - yMin, 1.0f);
+
+    //determine grid size, trying to keep cells nearly square
+    double numCells = std::max(1.0, double(m_shapes.size()) / k_shapes_per_cell);
+    double cols = std::sqrt(numCells * double(width) / double(height));
+    m_numCols = std::max(1, std::min(k_max_cells_per_axis, int(std::ceil(cols))));
+    int rows = int(std::ceil(numCells / m_numCols));
+    m_numRows = std::max(1, std::min(k_max_cells_per_axis, rows));
+
+    m_xOrg = xMin;
+    m_yOrg = yMin;
+    m_cellWidth = width / LUnits(m_numCols);
+    m_cellHeight = height / LUnits(m_numRows);
+
+    //distribute shapes. As they are processed by rank, each cell list is sorted
+    m_cells.resize(m_numCols * m_numRows);
+    int numShapes = int(m_shapes.size());
+    for (int rank=0; rank < numShapes; ++rank)
+    {
+        URect bbox = m_shapes[rank]->get_bounds();
+        int colStart = col_for(std::min(bbox.left(), bbox.right()));
+        int colEnd = col_for(std::max(bbox.left(), bbox.right()));
+        int rowStart = row_for(std::min(bbox.top(), bbox.bottom()));
+        int rowEnd = row_for(std::max(bbox.top(), bbox.bottom()));
+        for (int row=rowStart; row <= rowEnd; ++row)
+        {
+            for (int col=colStart; col <= colEnd; ++col)
+                m_cells[row * m_numCols + col].push_back(rank);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+int ShapesGrid::col_for(LUnits x) const
+{
+    //points outside the grid are clamped to the border cells
+    LUnits pos = (x - m_xOrg) / m_cellWidth;
+    if (!(pos > 0.0f))
+        return 0;
+    return std::min(m_numCols - 1, int(pos));
+}
+
+//---------------------------------------------------------------------------------------
+int ShapesGrid::row_for(LUnits y) const
+{
+    LUnits pos = (y - m_yOrg) / m_cellHeight;
+    if (!(pos > 0.0f))
+        return 0;
+    return std::min(m_numRows - 1, int(pos));
+}
+
+//---------------------------------------------------------------------------------------
+GmoShape* ShapesGrid::find_shape_at(LUnits x, LUnits y)
+{
+    if (m_cells.empty())
+        return nullptr;
+
+    //the topmost shape is the one with highest rank
+    std::vector<int>& cell = m_cells[row_for(y) * m_numCols + col_for(x)];
+    std::vector<int>::reverse_iterator it;
+    for (it = cell.rbegin(); it != cell.rend(); ++it)
+    {
+        GmoShape* pShape = m_shapes[*it];
+        if (pShape->hit_test(x, y))
+            return pShape;
+    }
+    return nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+void ShapesGrid::find_shapes_contained_in(const URect& rect,
+                                          std::vector<GmoShape*>& found)
+{
+    //returns the shapes whose bounds are contained in the rectangle, in reverse rank
+    //order (topmost shapes first)
+
+    if (m_cells.empty())
+        return;
+
+    int colStart = col_for(std::min(rect.left(), rect.right()));
+    int colEnd = col_for(std::max(rect.left(), rect.right()));
+    int rowStart = row_for(std::min(rect.top(), rect.bottom()));
+    int rowEnd = row_for(std::max(rect.top(), rect.bottom()));
+
+    std::vector<int> candidates;
+    for (int row=rowStart; row <= rowEnd; ++row)
+    {
+        for (int col=colStart; col <= colEnd; ++col)
+        {
+            std::vector<int>& cell = m_cells[row * m_numCols + col];
+            candidates.insert(candidates.end(), cell.begin(), cell.end());
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), std::greater<int>());
+    candidates.erase( std::unique(candidates.begin(), candidates.end()),
+                      candidates.end() );
+
+    for (int rank : candidates)
+    {
+        GmoShape* pShape = m_shapes[rank];
+        if (rect.contains(pShape->get_bounds()))
+            found.push_back(pShape);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+GmoShape* ShapesGrid::find_shape_for_object(ImoObj* pImo)
+{
+    std::map<ImoObj*, GmoShape*>::const_iterator it = m_creators.find(pImo);
+    if (it != m_creators.end())
+        return it->second;
+    return nullptr;
+}
+
+
+}  //namespace lomse
@@ -12,6 +12,7 @@
 #include "lomse_time.h"
 
 //std
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 using namespace std;
@@ -78,13 +79,13 @@ TimeUnits TimeGridTable::get_time_for_position(LUnits uxPos)
     if (uxPos <= m_PosTimes.front().uxPos)
         return 0.0;
 
-    //otherwise find in table
-    std::vector<TimeGridTableEntry>::iterator it = m_PosTimes.begin();
-    for (++it; it != m_PosTimes.end(); ++it)
-    {
-        if (uxPos <= (*it).uxPos)
-            return (*it).rTimepos;
-    }
+    //otherwise find in table. Entries are ordered by x position
+    std::vector<TimeGridTableEntry>::iterator it =
+        std::lower_bound(m_PosTimes.begin() + 1, m_PosTimes.end(), uxPos,
+                         [](const TimeGridTableEntry& entry, LUnits x)
+                         { return entry.uxPos < x; });
+    if (it != m_PosTimes.end())
+        return (*it).rTimepos;
 
     //if not found return last entry timepos
     return m_PosTimes.back().rTimepos;
@@ -92,79 +93,90 @@ TimeUnits TimeGridTable::get_time_for_position(LUnits uxPos)
 
 //---------------------------------------------------------------------------------------
 LUnits TimeGridTable::get_x_for_note_rest_at_time(TimeUnits timepos)
+{
+    const TimeGridTableEntry* pFirst = m_PosTimes.data();
+    return find_x_for_note_rest_at_time(pFirst, pFirst + m_PosTimes.size(), timepos);
+}
+
+//---------------------------------------------------------------------------------------
+LUnits TimeGridTable::get_x_for_barline_at_time(TimeUnits timepos)
+{
+    const TimeGridTableEntry* pFirst = m_PosTimes.data();
+    return find_x_for_barline_at_time(pFirst, pFirst + m_PosTimes.size(), timepos);
+}
+
+//---------------------------------------------------------------------------------------
+//helper: first entry whose timepos is not lower than timepos
+static const TimeGridTableEntry* lower_bound_for_time(const TimeGridTableEntry* pFirst,
+                                                      const TimeGridTableEntry* pEnd,
+                                                      TimeUnits timepos)
+{
+    return std::lower_bound(pFirst, pEnd, timepos,
+                            [](const TimeGridTableEntry& entry, TimeUnits time)
+                            { return is_lower_time(entry.rTimepos, time); });
+}
+
+//---------------------------------------------------------------------------------------
+//helper: interpolate the position for timepos, between pEntry and previous entry
+static LUnits interpolate_x(const TimeGridTableEntry* pFirst,
+                            const TimeGridTableEntry* pEntry, TimeUnits timepos)
+{
+    const TimeGridTableEntry* pPrev = (pEntry != pFirst ? pEntry - 1 : pEntry);
+    double dx = double(pEntry->uxPos - pPrev->uxPos)
+                / double(pEntry->rTimepos - pPrev->rTimepos);
+    return pPrev->uxPos + LUnits( double(timepos - pPrev->rTimepos) * dx );
+}
+
+//---------------------------------------------------------------------------------------
+LUnits TimeGridTable::find_x_for_note_rest_at_time(const TimeGridTableEntry* pFirst,
+                                                   const TimeGridTableEntry* pEnd,
+                                                   TimeUnits timepos)
 {
     //xPos = 0 if table is empty or timepos < first entry timepos
-    if (m_PosTimes.size() == 0 || is_lower_time(timepos, m_PosTimes.front().rTimepos))
+    if (pFirst == pEnd || is_lower_time(timepos, pFirst->rTimepos))
         return 0.0;       //<--------------------------- Test 100
 
     //otherwise find in table
-    vector<TimeGridTableEntry>::iterator it = m_PosTimes.begin();
-    TimeUnits prevTimepos = (*it).rTimepos;
-    LUnits xPrev = (*it).uxPos;
-
-    for (; it != m_PosTimes.end(); ++it)
-    {
-        if (is_lower_time(timepos, (*it).rTimepos))
-        {
-            //interpolate                  //<---------------- Test 104
-            double dx = double((*it).uxPos - xPrev) / double((*it).rTimepos - prevTimepos);
-            return xPrev + LUnits( double(timepos - prevTimepos) * dx );
-        }
-        else if (is_equal_time(timepos, (*it).rTimepos))
-        {
-            if ((*it).rDuration > 0.0)
-                return (*it).uxPos;       //<--------------------------- Test 101
-
-            //try next entry
-            vector<TimeGridTableEntry>::iterator itNext = it;
-            LUnits lastPos = (*it).uxPos;
-            ++itNext;
-            while (itNext != m_PosTimes.end()
-                   && is_equal_time(timepos, (*itNext).rTimepos))
-            {
-                lastPos = (*itNext).uxPos;
-                ++itNext;
-            }
-            return lastPos;            //<-------------- Tests 102 & T103
-        }
-
-        prevTimepos = (*it).rTimepos;
-        xPrev = (*it).uxPos;
-    }
+    const TimeGridTableEntry* pEntry = lower_bound_for_time(pFirst, pEnd, timepos);
 
     //if not found return last entry xPos. Or should return system xRight?
-    return m_PosTimes.back().uxPos;       //<--------------------------- Test 105
+    if (pEntry == pEnd)
+        return (pEnd - 1)->uxPos;       //<--------------------------- Test 105
+
+    if (is_lower_time(timepos, pEntry->rTimepos))
+        return interpolate_x(pFirst, pEntry, timepos);      //<---------------- Test 104
+
+    //equal time
+    if (pEntry->rDuration > 0.0)
+        return pEntry->uxPos;       //<--------------------------- Test 101
+
+    //try next entry
+    LUnits lastPos = pEntry->uxPos;
+    for (++pEntry; pEntry != pEnd && is_equal_time(timepos, pEntry->rTimepos); ++pEntry)
+        lastPos = pEntry->uxPos;
+    return lastPos;            //<-------------- Tests 102 & T103
 }
 
 //---------------------------------------------------------------------------------------
-LUnits TimeGridTable::get_x_for_barline_at_time(TimeUnits timepos)
+LUnits TimeGridTable::find_x_for_barline_at_time(const TimeGridTableEntry* pFirst,
+                                                 const TimeGridTableEntry* pEnd,
+                                                 TimeUnits timepos)
 {
     //xPos = 0 if table is empty or timepos < first entry timepos
-    if (m_PosTimes.size() == 0 || is_lower_time(timepos, m_PosTimes.front().rTimepos))
+    if (pFirst == pEnd || is_lower_time(timepos, pFirst->rTimepos))
         return 0.0;       //<--------------------------- Test 200
 
     //otherwise find in table
-    vector<TimeGridTableEntry>::iterator it = m_PosTimes.begin();
-    TimeUnits prevTimepos = (*it).rTimepos;
-    LUnits xPrev = (*it).uxPos;
-
-    for (; it != m_PosTimes.end(); ++it)
-    {
-        if (is_equal_time(timepos, (*it).rTimepos))//<--------------- Test 201 (case =)
-            return (*it).uxPos;
-        else if (is_lower_time(timepos, (*it).rTimepos))//<---------- Test 202 (case <)
-        {
-            //interpolate
-            double dx = double((*it).uxPos - xPrev) / double((*it).rTimepos - prevTimepos);
-            return xPrev + LUnits( double(timepos - prevTimepos) * dx );
-        }
-
-        prevTimepos = (*it).rTimepos;
-        xPrev = (*it).uxPos;
-    }
+    const TimeGridTableEntry* pEntry = lower_bound_for_time(pFirst, pEnd, timepos);
 
     //if not found return last entry xPos. Or should return system xRight?
-    return m_PosTimes.back().uxPos;       //<--------------------------- Test 203
+    if (pEntry == pEnd)
+        return (pEnd - 1)->uxPos;       //<--------------------------- Test 203
+
+    if (is_equal_time(timepos, pEntry->rTimepos))   //<--------------- Test 201 (case =)
+        return pEntry->uxPos;
+
+    return interpolate_x(pFirst, pEntry, timepos);  //<---------- Test 202 (case <)
 }
 
 //---------------------------------------------------------------------------------------
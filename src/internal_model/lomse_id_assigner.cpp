@@ -13,7 +13,7 @@
 #include "lomse_control.h"
 #include "lomse_visitor.h"
 
-#include <algorithm>        //for max, min
+#include <algorithm>        //for max, min, sort, unique
 #include <sstream>
 using namespace std;
 
@@ -30,6 +30,7 @@ void IdAssigner::reset()
     m_idToXmlId.clear();
     m_xmlIdToId.clear();
     m_idCounter = k_no_imoid;
+    m_lastReservedId = k_no_imoid;
 }
 
 //---------------------------------------------------------------------------------------
@@ -87,15 +88,21 @@ void IdAssigner::remove(ImoObj* pImo)
     ImoId id = pImo->get_id();
     if (id != k_no_imoid)
     {
-        m_idToImo.erase(id);        //this assumes that id exists; crash otherwise
-        string xmlId = get_xml_id_for(id);
-        if (!xmlId.empty())
-            m_xmlIdToId.erase(xmlId);
-        m_idToXmlId.erase(id);
+        remove_id(id);
         pImo->set_id(k_no_imoid);
     }
 }
 
+//---------------------------------------------------------------------------------------
+void IdAssigner::remove_id(ImoId id)
+{
+    m_idToImo.erase(id);        //this assumes that id exists; crash otherwise
+    string xmlId = get_xml_id_for(id);
+    if (!xmlId.empty())
+        m_xmlIdToId.erase(xmlId);
+    m_idToXmlId.erase(id);
+}
+
 //---------------------------------------------------------------------------------------
 string IdAssigner::get_xml_id_for(ImoId id)
 {
@@ -188,6 +195,78 @@ void IdAssigner::copy_ids_to(IdAssigner* assigner, ImoId idMin)
         assigner->set_xml_id_for(itS->first, itS->second);
 }
 
+//---------------------------------------------------------------------------------------
+void IdAssigner::move_ids_to(IdAssigner* assigner)
+{
+    //all ids are transferred to the target assigner, and the pending removals
+    //are applied there
+
+    copy_ids_to(assigner, k_no_imoid);
+    assigner->m_idCounter = max(assigner->m_idCounter, m_idCounter);
+
+    for (ImoId id : m_removedIds)
+        assigner->remove_id(id);
+
+    reset();
+    m_idToControl.clear();
+    m_removedIds.clear();
+}
+
+//---------------------------------------------------------------------------------------
+ImoId IdAssigner::renumber_ids_out_of_range(ImoId lastUsed)
+{
+    //the ids assigned after exhausting the reserved range are moved to a new range,
+    //starting after lastUsed, and keeping their order. Returns the last id used
+
+    vector<ImoId> ids;
+    unordered_map<ImoId, ImoObj*>::const_iterator it;
+    for (it = m_idToImo.begin(); it != m_idToImo.end(); ++it)
+    {
+        if (it->first > m_lastReservedId)
+            ids.push_back(it->first);
+    }
+    unordered_map<ImoId, Control*>::const_iterator itC;
+    for (itC = m_idToControl.begin(); itC != m_idToControl.end(); ++itC)
+    {
+        if (itC->first > m_lastReservedId)
+            ids.push_back(itC->first);
+    }
+    sort(ids.begin(), ids.end());
+    ids.erase(unique(ids.begin(), ids.end()), ids.end());
+
+    for (ImoId id : ids)
+    {
+        ImoId newId = ++lastUsed;
+
+        ImoObj* pImo = get_pointer_to_imo(id);
+        if (pImo)
+        {
+            m_idToImo.erase(id);
+            pImo->set_id(newId);
+            m_idToImo[newId] = pImo;
+        }
+
+        Control* pControl = get_pointer_to_control(id);
+        if (pControl)
+        {
+            m_idToControl.erase(id);
+            pControl->set_control_id(newId);
+            m_idToControl[newId] = pControl;
+        }
+
+        string xmlId = get_xml_id_for(id);
+        if (!xmlId.empty())
+        {
+            m_idToXmlId.erase(id);
+            set_xml_id_for(newId, xmlId);
+        }
+    }
+
+    m_idCounter = lastUsed;
+    m_lastReservedId = k_no_imoid;
+    return lastUsed;
+}
+
 //---------------------------------------------------------------------------------------
 void IdAssigner::add_id(ImoId id, ImoObj* pImo)
 {
@@ -75,6 +75,7 @@ void ImoTreeAlgoritms::change_noterest_duration(ImoNoteRest* pNR, TimeUnits dura
 {
     NoteTypeAndDots figdots = duration_to_note_type_and_dots(duration);
     pNR->set_note_type_and_dots(figdots.noteType, figdots.dots);
+    pNR->set_dirty(true);
 }
 
 //---------------------------------------------------------------------------------------
@@ -87,7 +88,7 @@ list<ImoStaffObj*> ImoTreeAlgoritms::insert_staffobjs(ImoInstrument* pInstr,
     list<ImoStaffObj*> objects
                 = pInstr->insert_staff_objects_at(pAt, ldpsource, errormsg);
     if (objects.size() > 0)
-        pScore->end_of_changes();        //update ColStaffObjs table
+        pScore->end_of_marked_changes();        //update ColStaffObjs table
 
     return objects;
 }
@@ -0,0 +1,1486 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#include "lomse_im_serializer.h"
+
+#include "lomse_internal_model.h"
+#include "lomse_im_note.h"
+#include "lomse_logger.h"
+#include "lomse_profiler.h"
+#include "private/lomse_document_p.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+namespace lomse
+{
+
+//snapshot header: magic, format version and a mark for detecting the byte order
+static const char k_magic[4] = { 'L', 'M', 'S', 'B' };
+static const uint16_t k_byte_order_mark = 0x0102;
+static const size_t k_header_size = sizeof(k_magic) + 2 * sizeof(uint16_t);
+
+//markers in the objects stream, in place of an object type
+static const int32_t k_null_object = -1;
+static const int32_t k_end_of_children = -2;
+
+//marker for a relation not yet saved, in place of its index
+static const int32_t k_new_relobj = -1;
+
+//type tags for attributes values
+enum EAttrValueType
+{
+    k_attr_int = 0,
+    k_attr_bool,
+    k_attr_float,
+    k_attr_double,
+    k_attr_string,
+    k_attr_color,
+};
+
+
+//=======================================================================================
+// ImSerializer::Fields: the members to save for each Imo class and for the auxiliary
+// data containers used in the internal model. The same code is used for saving and
+// for loading: the archive (Writer or Reader) determines the direction.
+//=======================================================================================
+struct ImSerializer::Fields
+{
+    //basic types -----------------------------------------------------------------------
+    template<class A> static void io(A& ar, bool& v) { ar.pod(v); }
+    template<class A> static void io(A& ar, int& v) { ar.pod(v); }
+    template<class A> static void io(A& ar, unsigned int& v) { ar.pod(v); }
+    template<class A> static void io(A& ar, float& v) { ar.pod(v); }
+    template<class A> static void io(A& ar, double& v) { ar.pod(v); }
+    template<class A> static void io(A& ar, Color& v) { ar.pod(v); }
+    template<class A> static void io(A& ar, TPoint& v) { ar.pod(v); }
+    template<class A> static void io(A& ar, USize& v) { ar.pod(v); }
+    template<class A> static void io(A& ar, std::string& v) { ar.text(v); }
+
+    template<class A> static void io(A& ar, long& v)
+    {
+        int64_t n = v;
+        ar.pod(n);
+        v = long(n);
+    }
+
+    template<class A, class E>
+    static typename std::enable_if<std::is_enum<E>::value>::type io(A& ar, E& v)
+    {
+        int32_t n = int32_t(v);
+        ar.pod(n);
+        v = E(n);
+    }
+
+    //containers ------------------------------------------------------------------------
+    template<class A, class T, size_t N> static void io(A& ar, T (&v)[N])
+    {
+        for (size_t i=0; i < N; ++i)
+            io(ar, v[i]);
+    }
+
+    template<class A, class T> static void io(A& ar, std::vector<T>& v)
+    {
+        uint32_t n = uint32_t(v.size());
+        ar.length(n);
+        v.resize(n);
+        for (size_t i=0; i < n; ++i)
+        {
+            T value = v[i];
+            io(ar, value);
+            v[i] = value;
+        }
+    }
+
+    template<class A, class T> static void io(A& ar, std::list<T>& v)
+    {
+        uint32_t n = uint32_t(v.size());
+        ar.length(n);
+        v.resize(n);
+        for (T& item : v)
+            io(ar, item);
+    }
+
+    template<class A, class K, class T> static void io(A& ar, std::map<K, T>& m)
+    {
+        uint32_t n = uint32_t(m.size());
+        ar.length(n);
+        if (ar.is_loading())
+        {
+            for (uint32_t i=0; i < n; ++i)
+            {
+                K key = K();
+                T value = T();
+                io(ar, key);
+                io(ar, value);
+                m[key] = value;
+            }
+        }
+        else
+        {
+            for (auto& item : m)
+            {
+                K key = item.first;
+                io(ar, key);
+                io(ar, item.second);
+            }
+        }
+    }
+
+    template<class A, class T> static void io(A& ar, std::pair<ImoId, T*>& v)
+    {
+        io(ar, v.first);
+        io(ar, v.second);
+    }
+
+    //owned ImoObj objects that are not nodes in the tree
+    template<class A, class T>
+    static typename std::enable_if<std::is_base_of<ImoObj, T>::value>::type
+    io(A& ar, T*& p)
+    {
+        ar.object(p);
+    }
+
+    //owned auxiliary data, optional
+    template<class A, class T> static void io_owned(A& ar, T*& p)
+    {
+        bool fExists = (p != nullptr);
+        ar.pod(fExists);
+        if (ar.is_loading())
+            p = (fExists ? LOMSE_NEW T() : nullptr);
+        if (p)
+            io(ar, *p);
+    }
+
+    //auxiliary data containers ---------------------------------------------------------
+    template<class A> static void io(A& ar, TypeTextInfo& v)
+    {
+        io(ar, v.text);
+        io(ar, v.language);
+    }
+
+    template<class A> static void io(A& ar, TypeLineStyle& v)
+    {
+        io(ar, v.lineStyle);
+        io(ar, v.startEdge);
+        io(ar, v.endEdge);
+        io(ar, v.startStyle);
+        io(ar, v.endStyle);
+        io(ar, v.color);
+        io(ar, v.width);
+        io(ar, v.startPoint);
+        io(ar, v.endPoint);
+    }
+
+    template<class A> static void io(A& ar, TypeMeasureInfo& v)
+    {
+        io(ar, v.index);
+        io(ar, v.count);
+        io(ar, v.number);
+        io(ar, v.fHideNumber);
+    }
+
+    template<class A> static void io(A& ar, KeyAccidental& v)
+    {
+        io(ar, v.step);
+        io(ar, v.alter);
+        io(ar, v.accidental);
+    }
+
+    //abstract Imo classes --------------------------------------------------------------
+    template<class A> static void io(A& ar, ImoObj& o)
+    {
+        io(ar, o.m_id);
+        io(ar, o.m_flags);
+        ar.attribs(o.m_attribs);
+    }
+
+    template<class A> static void io(A& ar, ImoContentObj& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_styleId);
+        io(ar, o.m_txUserLocation);
+        io(ar, o.m_tyUserLocation);
+        io(ar, o.m_txUserRefPoint);
+        io(ar, o.m_tyUserRefPoint);
+        io(ar, o.m_fVisible);
+    }
+
+    template<class A> static void io(A& ar, ImoScoreObj& o)
+    {
+        io(ar, static_cast<ImoContentObj&>(o));
+        io(ar, o.m_color);
+    }
+
+    template<class A> static void io(A& ar, ImoStaffObj& o)
+    {
+        io(ar, static_cast<ImoScoreObj&>(o));
+        io(ar, o.m_staff);
+        io(ar, o.m_nVoice);
+        io(ar, o.m_time);
+    }
+
+    template<class A> static void io(A& ar, ImoAuxRelObj& o)
+    {
+        io(ar, static_cast<ImoScoreObj&>(o));
+        io(ar, o.m_prevId);
+        io(ar, o.m_nextId);
+    }
+
+    template<class A> static void io(A& ar, ImoRelObj& o)
+    {
+        io(ar, static_cast<ImoScoreObj&>(o));
+        io(ar, o.m_relatedObjects);
+    }
+
+    template<class A> static void io(A& ar, ImoBoxInline& o)
+    {
+        io(ar, static_cast<ImoContentObj&>(o));
+        io(ar, o.m_size);
+    }
+
+    template<class A> static void io(A& ar, ImoBlock& o)
+    {
+        io(ar, static_cast<ImoScoreObj&>(o));
+        io(ar, o.m_box);
+    }
+
+    template<class A> static void io(A& ar, ImoArticulation& o)
+    {
+        io(ar, static_cast<ImoScoreObj&>(o));
+        io(ar, o.m_articulationType);
+        io(ar, o.m_placement);
+    }
+
+    template<class A> static void io(A& ar, ImoNoteRest& o)
+    {
+        io(ar, static_cast<ImoStaffObj&>(o));
+        io(ar, o.m_fUnpitched);
+        io(ar, o.m_nNoteType);
+        io(ar, o.m_step);
+        io(ar, o.m_octave);
+        io(ar, o.m_nDots);
+        io(ar, o.m_timeModifierTop);
+        io(ar, o.m_timeModifierBottom);
+        io(ar, o.m_duration);
+        io(ar, o.m_playDuration);
+        io(ar, o.m_eventDuration);
+        io(ar, o.m_playTime);
+    }
+
+    //document and styles ---------------------------------------------------------------
+    template<class A> static void io(A& ar, ImoDocument& o)
+    {
+        io(ar, static_cast<ImoContentObj&>(o));
+        io(ar, o.m_scale);
+        io(ar, o.m_version);
+        io(ar, o.m_language);
+        io(ar, o.m_privateStyles);
+    }
+
+    template<class A> static void io(A& ar, ImoStyle& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_name);
+        io(ar, o.m_idParent);
+        io(ar, o.m_lunitsProps);
+        io(ar, o.m_floatProps);
+        io(ar, o.m_stringProps);
+        io(ar, o.m_intProps);
+        io(ar, o.m_colorProps);
+        io(ar, o.m_modified);
+    }
+
+    template<class A> static void io(A& ar, ImoStyles& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_nameToStyle);
+    }
+
+    template<class A> static void io(A& ar, ImoPageInfo& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_uLeftMarginOdd);
+        io(ar, o.m_uRightMarginOdd);
+        io(ar, o.m_uTopMarginOdd);
+        io(ar, o.m_uBottomMarginOdd);
+        io(ar, o.m_uLeftMarginEven);
+        io(ar, o.m_uRightMarginEven);
+        io(ar, o.m_uTopMarginEven);
+        io(ar, o.m_uBottomMarginEven);
+        io(ar, o.m_uPageSize);
+        io(ar, o.m_fPortrait);
+        io(ar, o.m_modified);
+    }
+
+    template<class A> static void io(A& ar, ImoTextBlockInfo& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_size);
+        io(ar, o.m_topLeftPoint);
+        io(ar, o.m_bgColor);
+        io(ar, o.m_borderColor);
+        io(ar, o.m_borderWidth);
+        io(ar, o.m_borderStyle);
+    }
+
+    //score structure -------------------------------------------------------------------
+    template<class A> static void io(A& ar, ImoScore& o)
+    {
+        io(ar, static_cast<ImoContentObj&>(o));
+        io(ar, o.m_version);
+        io(ar, o.m_sourceFormat);
+        io(ar, o.m_accidentalsModel);
+        io(ar, o.m_scaling);
+        io(ar, o.m_systemInfoFirst);
+        io(ar, o.m_systemInfoOther);
+        io(ar, o.m_nameToStyle);
+        io(ar, o.m_numLyricFonts);
+        io(ar, o.m_lyricLanguages);
+        io(ar, o.m_staffDistance);
+        io(ar, o.m_modified);
+    }
+
+    template<class A> static void io(A& ar, ImoSystemInfo& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_fFirst);
+        io(ar, o.m_leftMargin);
+        io(ar, o.m_rightMargin);
+        io(ar, o.m_systemDistance);
+        io(ar, o.m_topSystemDistance);
+        io(ar, o.m_modified);
+    }
+
+    template<class A> static void io(A& ar, ImoInstrument& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_name);
+        io(ar, o.m_abbrev);
+        io(ar, o.m_nameStyle);
+        io(ar, o.m_abbrevStyle);
+        io(ar, o.m_partId);
+        io(ar, o.m_staves);
+        io(ar, o.m_barlineLayout);
+        io(ar, o.m_measuresNumbering);
+        io_owned(ar, o.m_pLastMeasureInfo);
+    }
+
+    template<class A> static void io(A& ar, ImoInstrGroup& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_joinBarlines);
+        io(ar, o.m_symbol);
+        io(ar, o.m_name);
+        io(ar, o.m_abbrev);
+        io(ar, o.m_numInstrs);
+        io(ar, o.m_iFirstInstr);
+        io(ar, o.m_nameStyle);
+        io(ar, o.m_abbrevStyle);
+    }
+
+    template<class A> static void io(A& ar, ImoStaffInfo& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_numStaff);
+        io(ar, o.m_nNumLines);
+        io(ar, o.m_staffType);
+        io(ar, o.m_uSpacing);
+        io(ar, o.m_uLineThickness);
+        io(ar, o.m_uMarging);
+        io(ar, o.m_fTablature);
+        io(ar, o.m_notationScaling);
+        io(ar, o.m_modified);
+    }
+
+    //sound and options -----------------------------------------------------------------
+    template<class A> static void io(A& ar, ImoMidiInfo& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_soundId);
+        io(ar, o.m_port);
+        io(ar, o.m_midiDeviceName);
+        io(ar, o.m_midiName);
+        io(ar, o.m_bank);
+        io(ar, o.m_channel);
+        io(ar, o.m_program);
+        io(ar, o.m_unpitched);
+        io(ar, o.m_volume);
+        io(ar, o.m_pan);
+        io(ar, o.m_elevation);
+        io(ar, o.m_modified);
+    }
+
+    template<class A> static void io(A& ar, ImoSoundInfo& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_soundId);
+        io(ar, o.m_instrName);
+        io(ar, o.m_instrAbbrev);
+        io(ar, o.m_instrSound);
+        io(ar, o.m_fSolo);
+        io(ar, o.m_fEnsemble);
+        io(ar, o.m_ensembleSize);
+        io(ar, o.m_virtualLibrary);
+        io(ar, o.m_virtualName);
+        io(ar, o.m_playTechnique);
+    }
+
+    template<class A> static void io(A& ar, ImoOptionInfo& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_type);
+        io(ar, o.m_name);
+        io(ar, o.m_sValue);
+        io(ar, o.m_fValue);
+        io(ar, o.m_nValue);
+        io(ar, o.m_rValue);
+    }
+
+    template<class A> static void io(A& ar, ImoParamInfo& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_name);
+        io(ar, o.m_value);
+    }
+
+    template<class A> static void io(A& ar, ImoCursorInfo& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_instrument);
+        io(ar, o.m_staff);
+        io(ar, o.m_time);
+        io(ar, o.m_id);
+    }
+
+    //staffobjs -------------------------------------------------------------------------
+    template<class A> static void io(A& ar, ImoBarline& o)
+    {
+        io(ar, static_cast<ImoStaffObj&>(o));
+        io(ar, o.m_barlineType);
+        io(ar, o.m_fMiddle);
+        io(ar, o.m_fTKChange);
+        io(ar, o.m_times);
+        io(ar, o.m_winged);
+        io_owned(ar, o.m_pMeasureInfo);
+    }
+
+    template<class A> static void io(A& ar, ImoClef& o)
+    {
+        io(ar, static_cast<ImoStaffObj&>(o));
+        io(ar, o.m_sign);
+        io(ar, o.m_line);
+        io(ar, o.m_octaveChange);
+        io(ar, o.m_symbolSize);
+    }
+
+    template<class A> static void io(A& ar, ImoDirection& o)
+    {
+        io(ar, static_cast<ImoStaffObj&>(o));
+        io(ar, o.m_space);
+        io(ar, o.m_placement);
+        io(ar, o.m_displayRepeat);
+        io(ar, o.m_soundRepeat);
+        io(ar, o.m_idNR);
+    }
+
+    template<class A> static void io(A& ar, ImoGoBackFwd& o)
+    {
+        io(ar, static_cast<ImoStaffObj&>(o));
+        io(ar, o.m_fFwd);
+        io(ar, o.m_rTimeShift);
+    }
+
+    template<class A> static void io(A& ar, ImoTranspose& o)
+    {
+        io(ar, static_cast<ImoStaffObj&>(o));
+        io(ar, o.m_numStaff);
+        io(ar, o.m_diatonic);
+        io(ar, o.m_chromatic);
+        io(ar, o.m_octaveChange);
+        io(ar, o.m_doubled);
+    }
+
+    template<class A> static void io(A& ar, ImoKeySignature& o)
+    {
+        io(ar, static_cast<ImoStaffObj&>(o));
+        io(ar, o.m_fStandard);
+        io(ar, o.m_fForAllStaves);
+        io(ar, o.m_fifths);
+        io(ar, o.m_keyMode);
+        io(ar, o.m_fCancel);
+        io(ar, o.m_accidentals);
+        io(ar, o.m_octave);
+    }
+
+    template<class A> static void io(A& ar, ImoTimeSignature& o)
+    {
+        io(ar, static_cast<ImoStaffObj&>(o));
+        io(ar, o.m_top);
+        io(ar, o.m_bottom);
+        io(ar, o.m_type);
+    }
+
+    template<class A> static void io(A& ar, ImoRest& o)
+    {
+        io(ar, static_cast<ImoNoteRest&>(o));
+        io(ar, o.m_fGoFwd);
+        io(ar, o.m_fFullMeasureRest);
+    }
+
+    template<class A> static void io(A& ar, ImoNote& o)
+    {
+        io(ar, static_cast<ImoNoteRest&>(o));
+        io(ar, o.m_actual_acc);
+        io(ar, o.m_notated_acc);
+        io(ar, o.m_options);
+        io(ar, o.m_stemDirection);
+        io(ar, o.m_idTieNext);
+        io(ar, o.m_idTiePrev);
+        io(ar, o.m_computedStem);
+        io(ar, o.m_fMute);
+    }
+
+    template<class A> static void io(A& ar, ImoGraceNote& o)
+    {
+        io(ar, static_cast<ImoNote&>(o));
+        io(ar, o.m_alignTime);
+    }
+
+    //auxobjs ---------------------------------------------------------------------------
+    template<class A> static void io(A& ar, ImoSymbolRepetitionMark& o)
+    {
+        io(ar, static_cast<ImoScoreObj&>(o));
+        io(ar, o.m_symbol);
+    }
+
+    template<class A> static void io(A& ar, ImoFermata& o)
+    {
+        io(ar, static_cast<ImoScoreObj&>(o));
+        io(ar, o.m_placement);
+        io(ar, o.m_symbol);
+    }
+
+    template<class A> static void io(A& ar, ImoArticulationSymbol& o)
+    {
+        io(ar, static_cast<ImoArticulation&>(o));
+        io(ar, o.m_fUp);
+        io(ar, o.m_symbol);
+    }
+
+    template<class A> static void io(A& ar, ImoArticulationLine& o)
+    {
+        io(ar, static_cast<ImoArticulation&>(o));
+        io(ar, o.m_lineShape);
+        io(ar, o.m_lineType);
+        io(ar, o.m_dashLength);
+        io(ar, o.m_dashSpace);
+    }
+
+    template<class A> static void io(A& ar, ImoDynamicsMark& o)
+    {
+        io(ar, static_cast<ImoScoreObj&>(o));
+        io(ar, o.m_markType);
+        io(ar, o.m_placement);
+        io(ar, o.m_moved);
+    }
+
+    template<class A> static void io(A& ar, ImoOrnament& o)
+    {
+        io(ar, static_cast<ImoScoreObj&>(o));
+        io(ar, o.m_ornamentType);
+        io(ar, o.m_placement);
+    }
+
+    template<class A> static void io(A& ar, ImoTechnical& o)
+    {
+        io(ar, static_cast<ImoScoreObj&>(o));
+        io(ar, o.m_technicalType);
+        io(ar, o.m_placement);
+    }
+
+    template<class A> static void io(A& ar, ImoFretString& o)
+    {
+        io(ar, static_cast<ImoTechnical&>(o));
+        io(ar, o.m_fret);
+        io(ar, o.m_string);
+    }
+
+    template<class A> static void io(A& ar, ImoFingering& o)
+    {
+        io(ar, static_cast<ImoTechnical&>(o));
+        uint32_t n = uint32_t(o.m_fingerings.size());
+        ar.length(n);
+        if (ar.is_loading())
+        {
+            for (uint32_t i=0; i < n; ++i)
+                o.m_fingerings.emplace_back("");
+        }
+        for (FingerData& data : o.m_fingerings)
+        {
+            if (data.attribs)
+                ar.fail("Fingering attributes can not be saved.");
+            io(ar, data.value);
+            io(ar, data.flags);
+        }
+    }
+
+    template<class A> static void io(A& ar, ImoScoreText& o)
+    {
+        io(ar, static_cast<ImoScoreObj&>(o));
+        io(ar, o.m_text);
+    }
+
+    template<class A> static void io(A& ar, ImoScoreTitle& o)
+    {
+        io(ar, static_cast<ImoScoreText&>(o));
+        io(ar, o.m_hAlign);
+    }
+
+    template<class A> static void io(A& ar, ImoTextRepetitionMark& o)
+    {
+        io(ar, static_cast<ImoScoreText&>(o));
+        io(ar, o.m_repeatType);
+    }
+
+    template<class A> static void io(A& ar, ImoLine& o)
+    {
+        io(ar, static_cast<ImoScoreObj&>(o));
+        io(ar, o.m_style);
+    }
+
+    template<class A> static void io(A& ar, ImoScoreLine& o)
+    {
+        io(ar, static_cast<ImoScoreObj&>(o));
+        io(ar, o.m_startPoint);
+        io(ar, o.m_endPoint);
+        io(ar, o.m_style);
+    }
+
+    template<class A> static void io(A& ar, ImoTextBox& o)
+    {
+        io(ar, static_cast<ImoBlock&>(o));
+        io(ar, o.m_text);
+        io(ar, o.m_line);
+        io(ar, o.m_fHasAnchorLine);
+    }
+
+    template<class A> static void io(A& ar, ImoMetronomeMark& o)
+    {
+        io(ar, static_cast<ImoScoreObj&>(o));
+        io(ar, o.m_markType);
+        io(ar, o.m_ticksPerMinute);
+        io(ar, o.m_leftNoteType);
+        io(ar, o.m_leftDots);
+        io(ar, o.m_rightNoteType);
+        io(ar, o.m_rightDots);
+        io(ar, o.m_fParenthesis);
+    }
+
+    template<class A> static void io(A& ar, ImoPedalMark& o)
+    {
+        io(ar, static_cast<ImoScoreObj&>(o));
+        io(ar, o.m_type);
+        io(ar, o.m_fAbbreviated);
+    }
+
+    template<class A> static void io(A& ar, ImoLyric& o)
+    {
+        io(ar, static_cast<ImoAuxRelObj&>(o));
+        io(ar, o.m_number);
+        io(ar, o.m_placement);
+        io(ar, o.m_numTextItems);
+        io(ar, o.m_fLaughing);
+        io(ar, o.m_fHumming);
+        io(ar, o.m_fEndLine);
+        io(ar, o.m_fEndParagraph);
+        io(ar, o.m_fMelisma);
+        io(ar, o.m_fHyphenation);
+    }
+
+    template<class A> static void io(A& ar, ImoLyricsTextInfo& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_syllableType);
+        io(ar, o.m_text);
+        io(ar, o.m_styleId);
+        io(ar, o.m_elision);
+    }
+
+    //relations -------------------------------------------------------------------------
+    template<class A> static void io(A& ar, ImoRelations& o)
+    {
+        //relations are shared by all participants: each one is saved only once
+        io(ar, static_cast<ImoObj&>(o));
+        uint32_t n = uint32_t(o.m_relations.size());
+        ar.length(n);
+        o.m_relations.resize(n);
+        for (ImoRelObj*& pRO : o.m_relations)
+            ar.relobj(pRO);
+    }
+
+    template<class A> static void io(A& ar, ImoBeam& o)
+    {
+        io(ar, static_cast<ImoRelObj&>(o));
+        io_owned(ar, o.m_pStemsDir);
+    }
+
+    template<class A> static void io(A& ar, ImoBeamData& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_beamType);
+        io(ar, o.m_repeat);
+    }
+
+    template<class A> static void io(A& ar, ImoBezierInfo& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_tPoints);
+    }
+
+    template<class A> static void io(A& ar, ImoChord& o)
+    {
+        io(ar, static_cast<ImoRelObj&>(o));
+        io(ar, o.m_fCrossStaff);
+        io(ar, o.m_stemDirection);
+    }
+
+    template<class A> static void io(A& ar, ImoArpeggio& o)
+    {
+        io(ar, static_cast<ImoRelObj&>(o));
+        io(ar, o.m_type);
+    }
+
+    template<class A> static void io(A& ar, ImoGraceRelObj& o)
+    {
+        io(ar, static_cast<ImoRelObj&>(o));
+        io(ar, o.m_graceType);
+        io(ar, o.m_fSlash);
+        io(ar, o.m_percentage);
+        io(ar, o.m_makeTime);
+    }
+
+    template<class A> static void io(A& ar, ImoSlur& o)
+    {
+        io(ar, static_cast<ImoRelObj&>(o));
+        io(ar, o.m_slurNum);
+        io(ar, o.m_orientation);
+    }
+
+    template<class A> static void io(A& ar, ImoSlurData& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_fStart);
+        io(ar, o.m_slurNum);
+        io(ar, o.m_orientation);
+    }
+
+    template<class A> static void io(A& ar, ImoTie& o)
+    {
+        io(ar, static_cast<ImoRelObj&>(o));
+        io(ar, o.m_tieNum);
+        io(ar, o.m_orientation);
+    }
+
+    template<class A> static void io(A& ar, ImoTieData& o)
+    {
+        io(ar, static_cast<ImoObj&>(o));
+        io(ar, o.m_fStart);
+        io(ar, o.m_tieNum);
+        io(ar, o.m_orientation);
+    }
+
+    template<class A> static void io(A& ar, ImoTuplet& o)
+    {
+        io(ar, static_cast<ImoRelObj&>(o));
+        io(ar, o.m_nActualNum);
+        io(ar, o.m_nNormalNum);
+        io(ar, o.m_nShowBracket);
+        io(ar, o.m_nShowNumber);
+        io(ar, o.m_nPlacement);
+    }
+
+    template<class A> static void io(A& ar, ImoOctaveShift& o)
+    {
+        io(ar, static_cast<ImoRelObj&>(o));
+        io(ar, o.m_steps);
+        io(ar, o.m_octaveShiftNum);
+    }
+
+    template<class A> static void io(A& ar, ImoPedalLine& o)
+    {
+        io(ar, static_cast<ImoRelObj&>(o));
+        io(ar, o.m_fDrawStartCorner);
+        io(ar, o.m_fDrawEndCorner);
+        io(ar, o.m_fDrawContinuationText);
+        io(ar, o.m_fSostenuto);
+    }
+
+    template<class A> static void io(A& ar, ImoVoltaBracket& o)
+    {
+        io(ar, static_cast<ImoRelObj&>(o));
+        io(ar, o.m_fStopJog);
+        io(ar, o.m_voltaNum);
+        io(ar, o.m_voltaText);
+        io(ar, o.m_repetitions);
+        io(ar, o.m_numVoltas);
+    }
+
+    template<class A> static void io(A& ar, ImoWedge& o)
+    {
+        io(ar, static_cast<ImoRelObj&>(o));
+        io(ar, o.m_startSpread);
+        io(ar, o.m_endSpread);
+        io(ar, o.m_fNiente);
+        io(ar, o.m_fCrescendo);
+        io(ar, o.m_wedgeNum);
+        io(ar, o.m_modified);
+    }
+
+    //text and block content ------------------------------------------------------------
+    template<class A> static void io(A& ar, ImoLink& o)
+    {
+        io(ar, static_cast<ImoBoxInline&>(o));
+        io(ar, o.m_url);
+        io(ar, o.m_language);
+    }
+
+    template<class A> static void io(A& ar, ImoDynamic& o)
+    {
+        io(ar, static_cast<ImoContentObj&>(o));
+        io(ar, o.m_classid);
+    }
+
+    template<class A> static void io(A& ar, ImoList& o)
+    {
+        io(ar, static_cast<ImoContentObj&>(o));
+        io(ar, o.m_listType);
+    }
+
+    template<class A> static void io(A& ar, ImoMultiColumn& o)
+    {
+        io(ar, static_cast<ImoContentObj&>(o));
+        io(ar, o.m_widths);
+    }
+
+    template<class A> static void io(A& ar, ImoHeading& o)
+    {
+        io(ar, static_cast<ImoContentObj&>(o));
+        io(ar, o.m_level);
+    }
+
+    template<class A> static void io(A& ar, ImoTable& o)
+    {
+        io(ar, static_cast<ImoContentObj&>(o));
+        io(ar, o.m_colStyles);
+    }
+
+    template<class A> static void io(A& ar, ImoTableCell& o)
+    {
+        io(ar, static_cast<ImoContentObj&>(o));
+        io(ar, o.m_rowspan);
+        io(ar, o.m_colspan);
+    }
+
+    template<class A> static void io(A& ar, ImoTextItem& o)
+    {
+        io(ar, static_cast<ImoContentObj&>(o));
+        io(ar, o.m_text);
+        io(ar, o.m_language);
+    }
+
+    //objects dispatcher ----------------------------------------------------------------
+    template<class T> static T* create(int UNUSED(type)) { return LOMSE_NEW T(); }
+
+    template<class T, class A> static ImoObj* io_object(A& ar, int type, ImoObj* pImo)
+    {
+        T* pObj = pImo ? static_cast<T*>(pImo) : ar.created( create<T>(type) );
+        io(ar, *pObj);
+        return pObj;
+    }
+
+    //Saves or loads the members of object pImo, of the given type. When loading,
+    //pImo is nullptr and the object is created. Returns nullptr for objects that can
+    //not be saved.
+    template<class A> static ImoObj* io_object(A& ar, int type, ImoObj* pImo)
+    {
+        switch (type)
+        {
+            case k_imo_anonymous_block:     return io_object<ImoAnonymousBlock>(ar, type, pImo);
+            case k_imo_arpeggio:            return io_object<ImoArpeggio>(ar, type, pImo);
+            case k_imo_articulation_symbol: return io_object<ImoArticulationSymbol>(ar, type, pImo);
+            case k_imo_articulation_line:   return io_object<ImoArticulationLine>(ar, type, pImo);
+            case k_imo_attachments:         return io_object<ImoAttachments>(ar, type, pImo);
+            case k_imo_barline:             return io_object<ImoBarline>(ar, type, pImo);
+            case k_imo_beam:                return io_object<ImoBeam>(ar, type, pImo);
+            case k_imo_beam_data:           return io_object<ImoBeamData>(ar, type, pImo);
+            case k_imo_bezier_info:         return io_object<ImoBezierInfo>(ar, type, pImo);
+            case k_imo_chord:               return io_object<ImoChord>(ar, type, pImo);
+            case k_imo_clef:                return io_object<ImoClef>(ar, type, pImo);
+            case k_imo_content:             return io_object<ImoContent>(ar, type, pImo);
+            case k_imo_cursor_info:         return io_object<ImoCursorInfo>(ar, type, pImo);
+            case k_imo_direction:           return io_object<ImoDirection>(ar, type, pImo);
+            case k_imo_document:            return io_object<ImoDocument>(ar, type, pImo);
+            case k_imo_dynamic:             return io_object<ImoDynamic>(ar, type, pImo);
+            case k_imo_dynamics_mark:       return io_object<ImoDynamicsMark>(ar, type, pImo);
+            case k_imo_fermata:             return io_object<ImoFermata>(ar, type, pImo);
+            case k_imo_fingering:           return io_object<ImoFingering>(ar, type, pImo);
+            case k_imo_fret_string:         return io_object<ImoFretString>(ar, type, pImo);
+            case k_imo_go_back_fwd:         return io_object<ImoGoBackFwd>(ar, type, pImo);
+            case k_imo_grace_relobj:        return io_object<ImoGraceRelObj>(ar, type, pImo);
+            case k_imo_heading:             return io_object<ImoHeading>(ar, type, pImo);
+            case k_imo_inline_wrapper:      return io_object<ImoInlineWrapper>(ar, type, pImo);
+            case k_imo_instr_group:         return io_object<ImoInstrGroup>(ar, type, pImo);
+            case k_imo_instrument:          return io_object<ImoInstrument>(ar, type, pImo);
+            case k_imo_instruments:         return io_object<ImoInstruments>(ar, type, pImo);
+            case k_imo_instrument_groups:   return io_object<ImoInstrGroups>(ar, type, pImo);
+            case k_imo_key_signature:       return io_object<ImoKeySignature>(ar, type, pImo);
+            case k_imo_line:                return io_object<ImoLine>(ar, type, pImo);
+            case k_imo_list:                return io_object<ImoList>(ar, type, pImo);
+            case k_imo_listitem:            return io_object<ImoListItem>(ar, type, pImo);
+            case k_imo_link:                return io_object<ImoLink>(ar, type, pImo);
+            case k_imo_lyric:               return io_object<ImoLyric>(ar, type, pImo);
+            case k_imo_lyrics_text_info:    return io_object<ImoLyricsTextInfo>(ar, type, pImo);
+            case k_imo_metronome_mark:      return io_object<ImoMetronomeMark>(ar, type, pImo);
+            case k_imo_midi_info:           return io_object<ImoMidiInfo>(ar, type, pImo);
+            case k_imo_multicolumn:         return io_object<ImoMultiColumn>(ar, type, pImo);
+            case k_imo_music_data:          return io_object<ImoMusicData>(ar, type, pImo);
+            case k_imo_note_cue:            return io_object<ImoNote>(ar, type, pImo);
+            case k_imo_note_grace:          return io_object<ImoGraceNote>(ar, type, pImo);
+            case k_imo_note_regular:        return io_object<ImoNote>(ar, type, pImo);
+            case k_imo_octave_shift:        return io_object<ImoOctaveShift>(ar, type, pImo);
+            case k_imo_option:              return io_object<ImoOptionInfo>(ar, type, pImo);
+            case k_imo_options:             return io_object<ImoOptions>(ar, type, pImo);
+            case k_imo_ornament:            return io_object<ImoOrnament>(ar, type, pImo);
+            case k_imo_page_info:           return io_object<ImoPageInfo>(ar, type, pImo);
+            case k_imo_para:                return io_object<ImoParagraph>(ar, type, pImo);
+            case k_imo_param_info:          return io_object<ImoParamInfo>(ar, type, pImo);
+            case k_imo_pedal_mark:          return io_object<ImoPedalMark>(ar, type, pImo);
+            case k_imo_pedal_line:          return io_object<ImoPedalLine>(ar, type, pImo);
+            case k_imo_relations:           return io_object<ImoRelations>(ar, type, pImo);
+            case k_imo_rest:                return io_object<ImoRest>(ar, type, pImo);
+            case k_imo_score:               return io_object<ImoScore>(ar, type, pImo);
+            case k_imo_score_line:          return io_object<ImoScoreLine>(ar, type, pImo);
+            case k_imo_score_text:          return io_object<ImoScoreText>(ar, type, pImo);
+            case k_imo_score_title:         return io_object<ImoScoreTitle>(ar, type, pImo);
+            case k_imo_score_titles:        return io_object<ImoScoreTitles>(ar, type, pImo);
+            case k_imo_slur:                return io_object<ImoSlur>(ar, type, pImo);
+            case k_imo_slur_data:           return io_object<ImoSlurData>(ar, type, pImo);
+            case k_imo_sound_change:        return io_object<ImoSoundChange>(ar, type, pImo);
+            case k_imo_sound_info:          return io_object<ImoSoundInfo>(ar, type, pImo);
+            case k_imo_sounds:              return io_object<ImoSounds>(ar, type, pImo);
+            case k_imo_parameters:          return io_object<ImoParameters>(ar, type, pImo);
+            case k_imo_staff_info:          return io_object<ImoStaffInfo>(ar, type, pImo);
+            case k_imo_style:               return io_object<ImoStyle>(ar, type, pImo);
+            case k_imo_styles:              return io_object<ImoStyles>(ar, type, pImo);
+            case k_imo_symbol_repetition_mark:  return io_object<ImoSymbolRepetitionMark>(ar, type, pImo);
+            case k_imo_system_break:        return io_object<ImoSystemBreak>(ar, type, pImo);
+            case k_imo_system_info:         return io_object<ImoSystemInfo>(ar, type, pImo);
+            case k_imo_table:               return io_object<ImoTable>(ar, type, pImo);
+            case k_imo_table_cell:          return io_object<ImoTableCell>(ar, type, pImo);
+            case k_imo_table_body:          return io_object<ImoTableBody>(ar, type, pImo);
+            case k_imo_table_head:          return io_object<ImoTableHead>(ar, type, pImo);
+            case k_imo_table_row:           return io_object<ImoTableRow>(ar, type, pImo);
+            case k_imo_technical:           return io_object<ImoTechnical>(ar, type, pImo);
+            case k_imo_textblock_info:      return io_object<ImoTextBlockInfo>(ar, type, pImo);
+            case k_imo_text_box:            return io_object<ImoTextBox>(ar, type, pImo);
+            case k_imo_text_item:           return io_object<ImoTextItem>(ar, type, pImo);
+            case k_imo_text_repetition_mark:   return io_object<ImoTextRepetitionMark>(ar, type, pImo);
+            case k_imo_tie:                 return io_object<ImoTie>(ar, type, pImo);
+            case k_imo_tie_data:            return io_object<ImoTieData>(ar, type, pImo);
+            case k_imo_time_signature:      return io_object<ImoTimeSignature>(ar, type, pImo);
+            case k_imo_transpose:           return io_object<ImoTranspose>(ar, type, pImo);
+            case k_imo_tuplet:              return io_object<ImoTuplet>(ar, type, pImo);
+            case k_imo_volta_bracket:       return io_object<ImoVoltaBracket>(ar, type, pImo);
+            case k_imo_wedge:               return io_object<ImoWedge>(ar, type, pImo);
+            default:
+                //controls, images, DTOs and other objects not created by importers
+                return nullptr;
+        }
+    }
+
+    //helpers for deleting a partially loaded model ------------------------------------
+
+    //Removes the references to other objects, as they could be not loaded
+    static void unlink(ImoObj* pImo)
+    {
+        if (pImo->is_relations())
+            static_cast<ImoRelations*>(pImo)->m_relations.clear();
+        else if (pImo->is_auxrelobj())
+        {
+            ImoAuxRelObj* pARO = static_cast<ImoAuxRelObj*>(pImo);
+            pARO->m_prevId = k_no_imoid;
+            pARO->m_nextId = k_no_imoid;
+        }
+        else if (pImo->is_note())
+        {
+            ImoNote* pNote = static_cast<ImoNote*>(pImo);
+            pNote->m_idTieNext = k_no_imoid;
+            pNote->m_idTiePrev = k_no_imoid;
+        }
+    }
+
+    //Relations own the data for their participants
+    static void delete_relobj(ImoRelObj* pRO)
+    {
+        for (auto& item : pRO->m_relatedObjects)
+            delete item.second;
+        pRO->m_relatedObjects.clear();
+        delete pRO;
+    }
+};
+
+//---------------------------------------------------------------------------------------
+template<> ImoNote* ImSerializer::Fields::create<ImoNote>(int type)
+{
+    return LOMSE_NEW ImoNote(type);
+}
+
+
+//=======================================================================================
+// ImSerializer::Writer: archive for saving the model
+//=======================================================================================
+class ImSerializer::Writer
+{
+protected:
+    std::string& m_data;
+    DocModel* m_pDocModel;
+    std::unordered_map<ImoRelObj*, int32_t> m_relobjs;
+    std::vector< std::pair<ImoId, std::string> > m_xmlIds;
+    std::string m_error;
+
+public:
+    Writer(std::string& data, DocModel* pDocModel)
+        : m_data(data)
+        , m_pDocModel(pDocModel)
+    {
+    }
+
+    inline bool is_loading() const { return false; }
+    template<class T> T* created(T* pImo) { return pImo; }
+    inline const std::string& get_error() const { return m_error; }
+
+    template<class T> void pod(T& value)
+    {
+        m_data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void text(std::string& value)
+    {
+        uint32_t size = uint32_t(value.size());
+        pod(size);
+        m_data.append(value);
+    }
+
+    inline void length(uint32_t& n) { pod(n); }
+
+    void fail(const std::string& msg)
+    {
+        if (m_error.empty())
+            m_error = msg;
+    }
+
+    //-----------------------------------------------------------------------------------
+    void header()
+    {
+        m_data.append(k_magic, sizeof(k_magic));
+        uint16_t version = uint16_t(k_version);
+        pod(version);
+        uint16_t mark = k_byte_order_mark;
+        pod(mark);
+    }
+
+    //-----------------------------------------------------------------------------------
+    template<class T> void object(T*& pImo)
+    {
+        write_object(pImo);
+    }
+
+    //-----------------------------------------------------------------------------------
+    void write_object(ImoObj* pImo)
+    {
+        int32_t type = (pImo ? pImo->get_obj_type() : k_null_object);
+        pod(type);
+        if (!pImo)
+            return;
+
+        if (!Fields::io_object(*this, type, pImo))
+        {
+            fail("Object '" + pImo->get_name() + "' can not be saved.");
+            return;
+        }
+
+        ImoId id = pImo->get_id();
+        if (m_pDocModel && id != k_no_imoid)
+        {
+            std::string xmlId = m_pDocModel->get_xml_id_for(id);
+            if (!xmlId.empty())
+                m_xmlIds.emplace_back(id, xmlId);
+        }
+
+        ImoObj* pChild = static_cast<ImoObj*>( pImo->get_first_child() );
+        for (; pChild; pChild = static_cast<ImoObj*>( pChild->get_next_sibling() ))
+            write_object(pChild);
+
+        type = k_end_of_children;
+        pod(type);
+    }
+
+    //-----------------------------------------------------------------------------------
+    void relobj(ImoRelObj*& pRO)
+    {
+        auto it = m_relobjs.find(pRO);
+        if (it != m_relobjs.end())
+        {
+            int32_t i = it->second;
+            pod(i);
+            return;
+        }
+
+        int32_t i = k_new_relobj;
+        pod(i);
+        write_object(pRO);
+        m_relobjs.emplace(pRO, int32_t(m_relobjs.size()));
+    }
+
+    //-----------------------------------------------------------------------------------
+    void attribs(AttrList& attribs)
+    {
+        uint32_t n = uint32_t(attribs.size());
+        pod(n);
+        for (AttrObj* pAttr = attribs.front(); pAttr; pAttr = pAttr->get_next_attrib())
+        {
+            int32_t idx = pAttr->get_attrib_idx();
+            pod(idx);
+            if (AttrInt* p = dynamic_cast<AttrInt*>(pAttr))
+                write_attrib(k_attr_int, p->get_value());
+            else if (AttrBool* p = dynamic_cast<AttrBool*>(pAttr))
+                write_attrib(k_attr_bool, p->get_value());
+            else if (AttrFloat* p = dynamic_cast<AttrFloat*>(pAttr))
+                write_attrib(k_attr_float, p->get_value());
+            else if (AttrDouble* p = dynamic_cast<AttrDouble*>(pAttr))
+                write_attrib(k_attr_double, p->get_value());
+            else if (AttrString* p = dynamic_cast<AttrString*>(pAttr))
+                write_attrib(k_attr_string, p->get_value());
+            else if (AttrColor* p = dynamic_cast<AttrColor*>(pAttr))
+                write_attrib(k_attr_color, p->get_value());
+            else
+                fail("Attribute '" + pAttr->get_name() + "' can not be saved.");
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    void xml_ids()
+    {
+        uint32_t n = uint32_t(m_xmlIds.size());
+        pod(n);
+        for (auto& item : m_xmlIds)
+        {
+            pod(item.first);
+            text(item.second);
+        }
+    }
+
+protected:
+
+    template<class T> void write_attrib(int32_t type, const T& value)
+    {
+        pod(type);
+        T v = value;
+        Fields::io(*this, v);
+    }
+
+};
+
+
+//=======================================================================================
+// ImSerializer::Reader: archive for loading the model
+//=======================================================================================
+class ImSerializer::Reader
+{
+protected:
+    const char* m_data;
+    const char* m_end;
+    DocModel* m_pDocModel;
+    std::vector<ImoRelObj*> m_relobjs;
+    std::vector<ImoObj*> m_created;     //all created objects
+    std::vector<ImoObj*> m_building;    //created objects not yet saved in its owner
+
+public:
+    Reader(const char* data, size_t size, DocModel* pDocModel)
+        : m_data(data)
+        , m_end(data + size)
+        , m_pDocModel(pDocModel)
+    {
+    }
+
+    inline bool is_loading() const { return true; }
+
+    template<class T> T* created(T* pImo)
+    {
+        m_created.push_back(pImo);
+        m_building.push_back(pImo);
+        return pImo;
+    }
+
+    template<class T> void pod(T& value)
+    {
+        check_available(sizeof(T));
+        memcpy(&value, m_data, sizeof(T));
+        m_data += sizeof(T);
+    }
+
+    void text(std::string& value)
+    {
+        uint32_t size;
+        pod(size);
+        check_available(size);
+        value.assign(m_data, size);
+        m_data += size;
+    }
+
+    void length(uint32_t& n)
+    {
+        //all elements take at least one byte. This prevents huge allocations when
+        //the data is corrupted
+        pod(n);
+        check_available(n);
+    }
+
+    void fail(const std::string& msg)
+    {
+        throw std::runtime_error(msg);
+    }
+
+    //-----------------------------------------------------------------------------------
+    void header()
+    {
+        char magic[sizeof(k_magic)];
+        check_available(sizeof(k_magic));
+        memcpy(magic, m_data, sizeof(k_magic));
+        m_data += sizeof(k_magic);
+        uint16_t version;
+        pod(version);
+        uint16_t mark;
+        pod(mark);
+
+        if (memcmp(magic, k_magic, sizeof(k_magic)) != 0)
+            fail("Invalid data. It is not a lomse snapshot.");
+        if (mark != k_byte_order_mark)
+            fail("Invalid snapshot. It was saved in a machine with different byte order.");
+        if (version != k_version)
+            fail("Snapshot version not supported.");
+    }
+
+    //-----------------------------------------------------------------------------------
+    template<class T> void object(T*& pImo)
+    {
+        int32_t type;
+        pod(type);
+        ImoObj* pObj = read_object(type);
+        pImo = dynamic_cast<T*>(pObj);
+        if (pObj && !pImo)
+            fail("Invalid snapshot. Unexpected object type.");
+        if (pObj)
+            m_building.pop_back();      //now owned by pImo holder
+    }
+
+    //-----------------------------------------------------------------------------------
+    ImoObj* read_object(int32_t type)
+    {
+        if (type == k_null_object)
+            return nullptr;
+
+        ImoObj* pImo = Fields::io_object(*this, type, nullptr);
+        if (!pImo)
+            fail("Invalid snapshot. Unknown object type.");
+
+        pImo->set_owner_model(m_pDocModel);
+        if (pImo->get_id() != k_no_imoid)
+            m_pDocModel->assign_id(pImo);
+
+        for (pod(type); type != k_end_of_children; pod(type))
+        {
+            ImoObj* pChild = read_object(type);
+            if (!pChild)
+                fail("Invalid snapshot. Null child.");
+            pImo->append_child(pChild);
+            m_building.pop_back();
+        }
+        return pImo;
+    }
+
+    //-----------------------------------------------------------------------------------
+    void relobj(ImoRelObj*& pRO)
+    {
+        int32_t i;
+        pod(i);
+        if (i == k_new_relobj)
+        {
+            object(pRO);
+            if (!pRO)
+                fail("Invalid snapshot. Null relation.");
+            m_relobjs.push_back(pRO);
+        }
+        else if (i >= 0 && size_t(i) < m_relobjs.size())
+            pRO = m_relobjs[i];
+        else
+            fail("Invalid snapshot. Reference to unknown relation.");
+    }
+
+    //-----------------------------------------------------------------------------------
+    void attribs(AttrList& attribs)
+    {
+        uint32_t n;
+        length(n);
+        for (uint32_t i=0; i < n; ++i)
+        {
+            int32_t idx;
+            pod(idx);
+            int32_t type;
+            pod(type);
+            switch (type)
+            {
+                case k_attr_int:    read_attrib<int>(attribs, idx);          break;
+                case k_attr_bool:   read_attrib<bool>(attribs, idx);         break;
+                case k_attr_float:  read_attrib<float>(attribs, idx);        break;
+                case k_attr_double: read_attrib<double>(attribs, idx);       break;
+                case k_attr_string: read_attrib<std::string>(attribs, idx);  break;
+                case k_attr_color:  read_attrib<Color>(attribs, idx);        break;
+                default:
+                    fail("Invalid snapshot. Unknown attribute type.");
+            }
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    void xml_ids()
+    {
+        uint32_t n;
+        length(n);
+        for (uint32_t i=0; i < n; ++i)
+        {
+            ImoId id;
+            pod(id);
+            std::string xmlId;
+            text(xmlId);
+            m_pDocModel->set_xml_id_for(id, xmlId);
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    void delete_partial_model(ImoDocument* pImoDoc)
+    {
+        //Deletes all objects created when loading fails. References between objects
+        //are removed first, as they could point to objects not loaded. Relations are
+        //shared by their participants and are deleted here. Objects not yet saved in
+        //their owner are deleted with all their children.
+
+        for (ImoObj* pImo : m_created)
+            Fields::unlink(pImo);
+
+        for (ImoRelObj* pRO : m_relobjs)
+            Fields::delete_relobj(pRO);
+
+        for (ImoObj* pImo : m_building)
+        {
+            if (pImo->is_relobj())
+                Fields::delete_relobj(static_cast<ImoRelObj*>(pImo));
+            else
+                delete pImo;
+        }
+        delete pImoDoc;
+
+        m_created.clear();
+        m_building.clear();
+        m_relobjs.clear();
+    }
+
+protected:
+
+    inline void check_available(size_t bytes)
+    {
+        if (size_t(m_end - m_data) < bytes)
+            fail("Invalid snapshot. Unexpected end of data.");
+    }
+
+    template<class T> void read_attrib(AttrList& attribs, int idx)
+    {
+        T value = T();
+        Fields::io(*this, value);
+        attribs.push_back( LOMSE_NEW Attr<T>(idx, value) );
+    }
+
+};
+
+
+//=======================================================================================
+// ImSerializer implementation
+//=======================================================================================
+bool ImSerializer::save(ImoDocument* pImoDoc, std::string& data)
+{
+    m_error.clear();
+    data.clear();
+
+    Writer writer(data, pImoDoc->get_doc_model());
+    writer.header();
+    writer.write_object(pImoDoc);
+    writer.xml_ids();
+
+    if (!writer.get_error().empty())
+    {
+        m_error = writer.get_error();
+        data.clear();
+        return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+ImoDocument* ImSerializer::load(const char* data, size_t size, DocModel* pDocModel)
+{
+    ProfilerScope scope("ImSerializer::load");
+
+    m_error.clear();
+
+    Reader reader(data, size, pDocModel);
+    ImoDocument* pImoDoc = nullptr;
+    try
+    {
+        reader.header();
+        reader.object(pImoDoc);
+        if (!pImoDoc)
+            reader.fail("Invalid snapshot. No document.");
+        reader.xml_ids();
+    }
+    catch (std::exception& e)
+    {
+        m_error = e.what();
+        LOMSE_LOG_ERROR(m_error);
+        reader.delete_partial_model(pImoDoc);
+        pDocModel->reset_id_assigner();
+        return nullptr;
+    }
+    return pImoDoc;
+}
+
+//---------------------------------------------------------------------------------------
+bool ImSerializer::is_snapshot(const char* data, size_t size)
+{
+    return size >= k_header_size && memcmp(data, k_magic, sizeof(k_magic)) == 0;
+}
+
+
+}   //namespace lomse
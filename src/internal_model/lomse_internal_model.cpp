@@ -4899,6 +4899,13 @@ void ImoScore::end_of_changes()
     builder.structurize(this);
 }
 
+//---------------------------------------------------------------------------------------
+void ImoScore::end_of_marked_changes()
+{
+    ModelBuilder builder;
+    builder.structurize_changes(this);
+}
+
 
 //=======================================================================================
 // ImoScoreLine implementation
@@ -14,15 +14,16 @@
 #include "private/lomse_internal_model_p.h"
 #include "lomse_im_note.h"
 #include "lomse_staffobjs_table.h"
-#include "lomse_staffobjs_cursor.h"
 #include "lomse_score_utilities.h"
 #include "lomse_logger.h"
 #include "lomse_im_factory.h"
 #include "lomse_im_measures_table.h"
+#include "lomse_profiler.h"
 
 #include <math.h>       //round
 
 #include <algorithm>
+#include <sstream>
 using namespace std;
 
 namespace lomse
@@ -85,6 +86,8 @@ public:
 //=======================================================================================
 ImoDocument* ModelBuilder::build_model(ImoDocument* pImoDoc)
 {
+    ProfilerScope scope("ModelBuilder::build_model");
+
     if (pImoDoc)
     {
         VisitorForStructurizables v(this);
@@ -122,9 +125,169 @@ void ModelBuilder::structurize(ImoObj* pImo)
     }
 }
 
+//---------------------------------------------------------------------------------------
+void ModelBuilder::structurize_changes(ImoScore* pScore)
+{
+    //Only the modified instruments are processed: their entries are replaced in the
+    //existing ColStaffObjs table and their measures table and pitch are computed
+    //again. When this is not possible, the whole score is structurized.
+    //AWARE: Instruments remain modified until the document dirty flag is cleared
+    //(i.e. when the graphic model is rebuilt), as some edition commands invoke this
+    //method several times and modify objects without marking them as dirty.
+
+    vector<bool> instrs;
+    if (!find_modified_instruments(pScore, &instrs))
+    {
+        structurize(pScore);
+        return;
+    }
+
+    //when no instrument is marked as modified, the changes are unknown (e.g. objects
+    //modified with setters that do not mark them as dirty). Thus, the whole score
+    //is structurized
+    if (find(instrs.begin(), instrs.end(), true) == instrs.end())
+    {
+        structurize(pScore);
+        return;
+    }
+
+    ColStaffObjsBuilder builder;
+    if (!builder.update(pScore, instrs))
+    {
+        structurize(pScore);
+        return;
+    }
+
+    MeasuresTableBuilder measures;
+    measures.build(pScore, &instrs);
+
+    MidiAssigner assigner;
+    assigner.assign_midi_data(pScore);
+
+    PitchAssigner tuner;
+    tuner.assign_pitch(pScore, &instrs);
+
+    PartIdAssigner parts;
+    parts.assign_parts_id(pScore);
+
+    GroupBarlinesFixer fixer;
+    fixer.set_barline_layout_in_instruments(pScore);
+}
+
+//---------------------------------------------------------------------------------------
+bool ModelBuilder::find_modified_instruments(ImoScore* pScore, vector<bool>* pInstrs)
+{
+    //An instrument is modified when it or any of its children is dirty. Returns false
+    //when the whole score must be structurized: the score has never been
+    //structurized, or the score or its instruments list have been modified (e.g.
+    //instruments added, removed or moved).
+
+    ImoInstruments* pColInstr = pScore->get_instruments();
+    if (!pScore->get_staffobjs_table() || pScore->is_dirty() || pColInstr->is_dirty())
+        return false;
+
+    int numInstrs = pScore->get_num_instruments();
+    pInstrs->assign(numInstrs, false);
+    for (int i=0; i < numInstrs; ++i)
+    {
+        ImoInstrument* pInstr = pScore->get_instrument(i);
+        (*pInstrs)[i] = pInstr->is_dirty() || pInstr->are_children_dirty();
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void ModelBuilder::clear_modified_flags(ImoScore* pScore)
+{
+    //Invoked when the document dirty flag is cleared. Only the flags used for
+    //determining the modified instruments are cleared. Flags in other nodes are
+    //not changed.
+
+    pScore->set_dirty(false);
+    ImoInstruments* pColInstr = pScore->get_instruments();
+    pColInstr->set_dirty(false);
+    pColInstr->set_children_dirty(false);
+
+    int numInstrs = pScore->get_num_instruments();
+    for (int i=0; i < numInstrs; ++i)
+    {
+        ImoInstrument* pInstr = pScore->get_instrument(i);
+        pInstr->set_dirty(false);
+        pInstr->set_children_dirty(false);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+bool ModelBuilder::check_structure(ImoScore* pScore, ostream& reporter)
+{
+    string current = dump_structure(pScore);
+    structurize(pScore);
+    string expected = dump_structure(pScore);
+    if (current == expected)
+        return true;
+
+    //report first different line
+    stringstream ssCurrent(current);
+    stringstream ssExpected(expected);
+    string lineCurrent, lineExpected;
+    int numLine = 1;
+    while (getline(ssExpected, lineExpected))
+    {
+        if (!getline(ssCurrent, lineCurrent) || lineCurrent != lineExpected)
+            break;
+        ++numLine;
+    }
+    reporter << "Structure differs at line " << numLine << ". Expected: '"
+             << lineExpected << "', found: '" << lineCurrent << "'" << endl;
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+string ModelBuilder::dump_structure(ImoScore* pScore)
+{
+    //dump of all structures built when structurizing the score
+
+    stringstream s;
+    ColStaffObjs* pTable = pScore->get_staffobjs_table();
+    if (!pTable)
+        return s.str();
+
+    s << "lines=" << pTable->num_lines() << ", min.note=" << pTable->min_note_duration()
+      << ", divisions=" << pTable->get_divisions()
+      << ", noterests=" << pTable->num_half_noterests() << "/"
+      << pTable->num_quarter_noterests() << "/" << pTable->num_eighth_noterests() << "/"
+      << pTable->num_16th_noterests() << endl;
+    s << pTable->dump();
+
+    ColStaffObjsIterator it;
+    for (it = pTable->begin(); it != pTable->end(); ++it)
+    {
+        ImoStaffObj* pSO = (*it)->imo_object();
+        if (pSO->is_note())
+        {
+            ImoNote* pNote = static_cast<ImoNote*>(pSO);
+            s << "note " << pNote->get_id() << ": acc=" << pNote->get_actual_accidentals()
+              << ", notated=" << pNote->get_notated_accidentals()
+              << ", play=" << pNote->get_playback_time()
+              << ", pdur=" << pNote->get_playback_duration() << endl;
+        }
+    }
+
+    int numInstrs = pScore->get_num_instruments();
+    for (int i=0; i < numInstrs; ++i)
+    {
+        ImMeasuresTable* pMeasures = pScore->get_instrument(i)->get_measures_table();
+        if (pMeasures)
+            s << pMeasures->dump();
+    }
+    return s.str();
+}
+
 //---------------------------------------------------------------------------------------
 ImoDocument* ModelBuilder::fix_cloned_model(ImoDocument* pImoDoc)
 {
+    ProfilerScope scope("ModelBuilder::fix_cloned_model");
+
     if (pImoDoc)
     {
         CloneFixerVisitor v(this);
@@ -151,56 +314,65 @@ void ModelBuilder::fix_model(ImoObj* pImo)
 //=======================================================================================
 // PitchAssigner implementation
 //=======================================================================================
-void PitchAssigner::assign_pitch(ImoScore* pScore)
+void PitchAssigner::assign_pitch(ImoScore* pScore, const vector<bool>* pInstrs)
 {
+    ProfilerScope scope("PitchAssigner::assign_pitch");
+
+    //when pInstrs is not nullptr, pitch is only assigned in the instruments marked
+    //in it. The table is traversed directly, as only the staff index is needed and
+    //entries for other instruments can be skipped without accessing the staffobjs.
+
     if (pScore->get_accidentals_model() == ImoScore::k_pitch_and_notation_provided)
         return;
 
-    StaffObjsCursor cursor(pScore);
-
-    int staves = cursor.get_num_staves();
-    m_context.assign(staves, {{0,0,0,0,0,0,0}} );       //alterations, per staff index
+    ColStaffObjs* pColStaffObjs = pScore->get_staffobjs_table();
 
-    int numInstrs = cursor.get_num_instruments();
+    int numInstrs = pScore->get_num_instruments();
     vector<ImoKeySignature*> keys;                      //key, per instrument
     keys.assign(numInstrs, nullptr);
 
     vector<int> numStaves;                              //num. staves, per instrument
+    vector<int> staffIndex;                             //first staff index, per instrument
+    int staves = 0;
     for (int i=0; i< numInstrs; ++i)
     {
+        staffIndex.push_back(staves);
         numStaves.push_back( pScore->get_instrument(i)->get_num_staves() );
+        staves += numStaves.back();
     }
+    m_context.assign(staves, {{0,0,0,0,0,0,0}} );       //alterations, per staff index
 
-    while(!cursor.is_end())
+    ColStaffObjsIterator it;
+    for (it = pColStaffObjs->begin(); it != pColStaffObjs->end(); ++it)
     {
-        ImoStaffObj* pSO = cursor.get_staffobj();
+        int iInstr = (*it)->num_instrument();
+        if (pInstrs && !(*pInstrs)[iInstr])
+            continue;
+
+        ImoStaffObj* pSO = (*it)->imo_object();
         if (pSO->is_note())
         {
             ImoNote* pNote = static_cast<ImoNote*>(pSO);
-            int idx = cursor.staff_index();
+            int idx = staffIndex[iInstr] + (*it)->staff();
             compute_pitch(pNote, idx);
         }
         else if (pSO->is_barline())
         {
-            int iInstr = cursor.num_instrument();
             for (int iStaff=0; iStaff < numStaves[iInstr]; ++iStaff)
             {
-                int idx = cursor.staff_index_for(iInstr, iStaff);
+                int idx = staffIndex[iInstr] + iStaff;
                 reset_accidentals(keys[iInstr], idx);
             }
         }
         else if (pSO->is_key_signature())
         {
-            int iInstr = cursor.num_instrument();
             keys[iInstr] = static_cast<ImoKeySignature*>( pSO );
             for (int iStaff=0; iStaff < numStaves[iInstr]; ++iStaff)
             {
-                int idx = cursor.staff_index_for(iInstr, iStaff);
+                int idx = staffIndex[iInstr] + iStaff;
                 reset_accidentals(keys[iInstr], idx);
             }
         }
-
-        cursor.move_next();
     }
 }
 
@@ -471,6 +643,8 @@ MidiAssigner::~MidiAssigner()
 //---------------------------------------------------------------------------------------
 void MidiAssigner::assign_midi_data(ImoScore* pScore)
 {
+    ProfilerScope scope("MidiAssigner::assign_midi_data");
+
     collect_sounds_info(pScore);
     assign_score_instr_id();
     assign_port_and_channel();
@@ -739,13 +913,26 @@ void GroupBarlinesFixer::set_barlines_layout_for(ImoInstrGroup* pGrp)
 //=======================================================================================
 // MeasuresTableBuilder implementation
 //=======================================================================================
-void MeasuresTableBuilder::build(ImoScore* pScore)
+void MeasuresTableBuilder::build(ImoScore* pScore, const vector<bool>* pInstrs)
 {
+    ProfilerScope scope("MeasuresTableBuilder::build");
+
+    //when pInstrs is not nullptr, only the tables for the instruments marked in it
+    //are built
+
+    //remove old tables. Otherwise, instruments without staffobjs would keep a table
+    //pointing to deleted entries
+    int numInstrs = pScore->get_num_instruments();
+    for (int i=0; i < numInstrs; ++i)
+    {
+        if (!pInstrs || (*pInstrs)[i])
+            pScore->get_instrument(i)->set_measures_table(nullptr);
+    }
+
     ColStaffObjs* pCSO = pScore->get_staffobjs_table();
     if (pCSO->num_entries() == 0)
         return;
 
-    int numInstrs = pScore->get_num_instruments();
     m_tables.assign(numInstrs, nullptr);
     m_curMeasure.assign(numInstrs, nullptr);
 
@@ -754,6 +941,11 @@ void MeasuresTableBuilder::build(ImoScore* pScore)
     {
         ColStaffObjsEntry* pCsoEntry = *it;
         int iInstr = pCsoEntry->num_instrument();
+        if (pInstrs && !(*pInstrs)[iInstr])
+        {
+            ++it;
+            continue;
+        }
         ImoStaffObj* pSO = pCsoEntry->imo_object();
 
         //if first entry for the instrument create measures table and first measure
@@ -15,6 +15,7 @@
 #include "lomse_ldp_exporter.h"
 #include "lomse_time.h"
 #include "lomse_im_factory.h"
+#include "lomse_profiler.h"
 
 
 #include <sstream>
@@ -188,15 +189,21 @@ ColStaffObjs::ColStaffObjs()
     , m_num16th(0)
     , m_pFirst(nullptr)
     , m_pLast(nullptr)
+    , m_pLastInserted(nullptr)
+    , m_fNavIndexValid(false)
 {
 }
 
 //---------------------------------------------------------------------------------------
 ColStaffObjs::~ColStaffObjs()
 {
-    ColStaffObjs::iterator it;
-    for (it=begin(); it != end(); ++it)
-        delete *it;
+    //AWARE: delete entries from the instruments lists, as during an update some
+    //entries could be not linked
+    for (auto& entries : m_instrEntries)
+    {
+        for (auto pEntry : entries)
+            delete pEntry;
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -206,10 +213,93 @@ ColStaffObjsEntry* ColStaffObjs::add_entry(int measure, int instr, int voice, in
     ColStaffObjsEntry* pEntry =
         LOMSE_NEW ColStaffObjsEntry(measure, instr, voice, staff, pImo);
     add_entry_to_list(pEntry);
+    m_index.insert( make_pair(pImo, pEntry) );  //keep first entry when several
+                                                //(key & time, one per staff)
+    if (instr >= int(m_instrEntries.size()))
+        m_instrEntries.resize(instr + 1);
+    m_instrEntries[instr].push_back(pEntry);
     ++m_numEntries;
     return pEntry;
 }
 
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::reset_noterest_counters()
+{
+    m_numHalf = 0;
+    m_numQuarter = 0;
+    m_numEighth = 0;
+    m_num16th = 0;
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::set_first_line(int iInstr, int line)
+{
+    if (iInstr >= int(m_firstLine.size()))
+        m_firstLine.resize(iInstr + 1, 0);
+    m_firstLine[iInstr] = line;
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::unlink_entries_from_instrument(int iInstr)
+{
+    //removes from the list all entries for instruments iInstr and next ones. Entries
+    //are not deleted.
+    //AWARE: the staffobjs for removed entries could be already deleted. Therefore,
+    //they must not be accessed.
+
+    m_fNavIndexValid = false;
+    ColStaffObjsEntry* pEntry = m_pFirst;
+    ColStaffObjsEntry* pLast = nullptr;
+    m_pFirst = nullptr;
+    while (pEntry)
+    {
+        ColStaffObjsEntry* pNext = pEntry->get_next();
+        if (pEntry->num_instrument() < iInstr)
+        {
+            pEntry->set_prev(pLast);
+            if (pLast)
+                pLast->set_next(pEntry);
+            else
+                m_pFirst = pEntry;
+            pLast = pEntry;
+        }
+        pEntry = pNext;
+    }
+    if (pLast)
+        pLast->set_next(nullptr);
+    m_pLast = pLast;
+    m_pLastInserted = nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::delete_entries_for_instrument(int iInstr)
+{
+    //AWARE: entries must be already unlinked. And the staffobjs could be already
+    //deleted. Therefore, they must not be accessed.
+
+    if (iInstr >= int(m_instrEntries.size()))
+        return;
+
+    vector<ColStaffObjsEntry*>& entries = m_instrEntries[iInstr];
+    for (auto pEntry : entries)
+    {
+        m_index.erase(pEntry->imo_object());
+        delete pEntry;
+    }
+    m_numEntries -= int(entries.size());
+    entries.clear();
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::relink_entries_for_instrument(int iInstr)
+{
+    if (iInstr >= int(m_instrEntries.size()))
+        return;
+
+    for (auto pEntry : m_instrEntries[iInstr])
+        add_entry_to_list(pEntry);
+}
+
 //---------------------------------------------------------------------------------------
 void ColStaffObjs::count_noterest(ImoNoteRest* pNR)
 {
@@ -245,18 +335,21 @@ string ColStaffObjs::dump(bool fWithIds)
 //---------------------------------------------------------------------------------------
 void ColStaffObjs::add_entry_to_list(ColStaffObjsEntry* pEntry)
 {
+    m_fNavIndexValid = false;
     if (!m_pFirst)
     {
         //first entry
         m_pFirst = pEntry;
         m_pLast = pEntry;
+        m_pLastInserted = pEntry;
         pEntry->set_prev( nullptr );
         pEntry->set_next( nullptr );
         return;
     }
 
     //insert in list in order
-    ColStaffObjsEntry* pCurrent = m_pLast;
+    ColStaffObjsEntry* pCurrent = find_insertion_search_start(pEntry->time());
+    m_pLastInserted = pEntry;
     while (pCurrent != nullptr)
     {
         if (is_lower_entry(pEntry, pCurrent))
@@ -283,6 +376,27 @@ void ColStaffObjs::add_entry_to_list(ColStaffObjsEntry* pEntry)
     m_pFirst = pEntry;
 }
 
+//---------------------------------------------------------------------------------------
+ColStaffObjsEntry* ColStaffObjs::find_insertion_search_start(TimeUnits time)
+{
+    //The insertion point is searched backwards, and all entries with time greater
+    //than the time of the new entry are skipped (rule R1.1 in is_lower_entry()). As
+    //entries are ordered by time, the search can start at any entry after which all
+    //entries have greater time. The insertion point is usually near the last
+    //inserted entry (i.e. when adding the entries for the second and next
+    //instruments), so the search starts there instead of at the end of the table.
+
+    ColStaffObjsEntry* pStart = m_pLastInserted;
+    if (pStart == nullptr)
+        return m_pLast;
+    if (is_lower_time(time, pStart->time()))
+        return pStart;
+
+    while (pStart->get_next() && !is_lower_time(time, pStart->get_next()->time()))
+        pStart = pStart->get_next();
+    return pStart;
+}
+
 //---------------------------------------------------------------------------------------
 bool ColStaffObjs::is_lower_entry(ColStaffObjsEntry* b, ColStaffObjsEntry* a)
 {
@@ -401,8 +515,25 @@ void ColStaffObjs::delete_entry_for(ImoStaffObj* pSO)
         throw runtime_error("[ColStaffObjs::delete_entry_for] entry not found!");
     }
 
+    m_fNavIndexValid = false;
     ColStaffObjsEntry* pPrev = pEntry->get_prev();
     ColStaffObjsEntry* pNext = pEntry->get_next();
+    //key & time signatures have an entry for each staff. Index next one
+    m_index.erase(pSO);
+    ColStaffObjsEntry* pDup = pNext;
+    while (pDup && is_equal_time(pDup->time(), pEntry->time()))
+    {
+        if (pDup->imo_object() == pSO)
+        {
+            m_index[pSO] = pDup;
+            break;
+        }
+        pDup = pDup->get_next();
+    }
+    if (m_pLastInserted == pEntry)
+        m_pLastInserted = nullptr;
+    vector<ColStaffObjsEntry*>& entries = m_instrEntries[pEntry->num_instrument()];
+    entries.erase( std::find(entries.begin(), entries.end(), pEntry) );
     delete pEntry;
     if (pPrev == nullptr)
     {
@@ -429,15 +560,118 @@ void ColStaffObjs::delete_entry_for(ImoStaffObj* pSO)
 //---------------------------------------------------------------------------------------
 ColStaffObjsEntry* ColStaffObjs::find_entry_for(ImoStaffObj* pSO)
 {
-    ColStaffObjs::iterator it;
-    for (it=begin(); it != end(); ++it)
+    unordered_map<ImoStaffObj*, ColStaffObjsEntry*>::const_iterator it
+        = m_index.find(pSO);
+    return (it != m_index.end() ? it->second : nullptr);
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::build_nav_index()
+{
+    //The navigation index stores the position of each entry and, for each instrument,
+    //the positions of its entries, barlines and time signatures. As entries are
+    //ordered by time, positions and times increase together and binary search can
+    //be used.
+
+    int numInstrs = int(m_instrEntries.size());
+    m_entries.clear();
+    m_entries.reserve(m_numEntries);
+    m_instrPositions.assign(numInstrs, vector<int>());
+    m_barlinePositions.assign(numInstrs, vector<int>());
+    m_timeSignaturePositions.assign(numInstrs, vector<int>());
+
+    for (ColStaffObjsEntry* pEntry = m_pFirst; pEntry; pEntry = pEntry->get_next())
     {
-        if ((*it)->imo_object() == pSO)
-            return *it;
+        int pos = int(m_entries.size());
+        pEntry->m_pos = pos;
+        m_entries.push_back(pEntry);
+
+        int iInstr = pEntry->num_instrument();
+        m_instrPositions[iInstr].push_back(pos);
+        ImoStaffObj* pSO = pEntry->imo_object();
+        if (pSO->is_barline())
+            m_barlinePositions[iInstr].push_back(pos);
+        else if (pSO->is_time_signature())
+            m_timeSignaturePositions[iInstr].push_back(pos);
     }
+    m_fNavIndexValid = true;
+}
+
+//---------------------------------------------------------------------------------------
+ColStaffObjsEntry* ColStaffObjs::find_entry_at_time(int iInstr, TimeUnits time,
+                                                    ColStaffObjsEntry* pStart)
+{
+    if (!m_fNavIndexValid)
+        build_nav_index();
+    if (iInstr < 0 || iInstr >= int(m_instrPositions.size()))
+        return nullptr;
+
+    const vector<int>& positions = m_instrPositions[iInstr];
+    vector<int>::const_iterator it =
+        lower_bound(positions.begin(), positions.end(), time,
+                    [this](int pos, TimeUnits t) {
+                        return is_greater_time(t, m_entries[pos]->time());
+                    });
+    if (pStart)
+        it = max(it, lower_bound(positions.begin(), positions.end(), pStart->m_pos));
+
+    return (it != positions.end() ? m_entries[*it] : nullptr);
+}
+
+//---------------------------------------------------------------------------------------
+ColStaffObjsEntry* ColStaffObjs::find_barline_in_measure(int iInstr, int measure)
+{
+    if (!m_fNavIndexValid)
+        build_nav_index();
+    if (iInstr < 0 || iInstr >= int(m_barlinePositions.size()))
+        return nullptr;
+
+    const vector<int>& positions = m_barlinePositions[iInstr];
+    vector<int>::const_iterator it =
+        lower_bound(positions.begin(), positions.end(), measure,
+                    [this](int pos, int m) { return m_entries[pos]->measure() < m; });
+
+    if (it != positions.end() && m_entries[*it]->measure() == measure)
+        return m_entries[*it];
     return nullptr;
 }
 
+//---------------------------------------------------------------------------------------
+ColStaffObjsEntry* ColStaffObjs::find_prev_barline(int iInstr, ColStaffObjsEntry* pEntry)
+{
+    if (!m_fNavIndexValid)
+        build_nav_index();
+    if (iInstr < 0 || iInstr >= int(m_barlinePositions.size()))
+        return nullptr;
+
+    return find_prev_entry_in(m_barlinePositions[iInstr], pEntry);
+}
+
+//---------------------------------------------------------------------------------------
+ColStaffObjsEntry* ColStaffObjs::find_prev_time_signature(int iInstr,
+                                                          ColStaffObjsEntry* pEntry)
+{
+    if (!m_fNavIndexValid)
+        build_nav_index();
+    if (iInstr < 0 || iInstr >= int(m_timeSignaturePositions.size()))
+        return nullptr;
+
+    return find_prev_entry_in(m_timeSignaturePositions[iInstr], pEntry);
+}
+
+//---------------------------------------------------------------------------------------
+ColStaffObjsEntry* ColStaffObjs::find_prev_entry_in(const vector<int>& positions,
+                                                    ColStaffObjsEntry* pEntry)
+{
+    //last entry in positions that is before pEntry. AWARE: navigation index must be
+    //valid
+
+    int limit = (pEntry ? pEntry->m_pos : int(m_entries.size()));
+    vector<int>::const_iterator it = lower_bound(positions.begin(), positions.end(),
+                                                 limit);
+    return (it != positions.begin() ? m_entries[*(it - 1)] : nullptr);
+}
+
 //---------------------------------------------------------------------------------------
 void ColStaffObjs::sort_table()
 {
@@ -449,10 +683,13 @@ void ColStaffObjs::sort_table()
     // * simple to implement and much better performance than other simple algorithms,
     //   such as the bubble sort
     // * in-place sort (does not require extra memory)
+    //Entries are only re-linked. Therefore, the index staffobj -> entry is not
+    //affected.
 
     ColStaffObjsEntry* pUnsorted = m_pFirst;
     m_pFirst = nullptr;
     m_pLast = nullptr;
+    m_pLastInserted = nullptr;
 
     while (pUnsorted != nullptr)
     {
@@ -472,6 +709,8 @@ void ColStaffObjs::sort_table()
 //=======================================================================================
 ColStaffObjs* ColStaffObjsBuilder::build(ImoScore* pScore)
 {
+    ProfilerScope scope("ColStaffObjsBuilder::build");
+
     ColStaffObjsBuilderEngine* builder = create_builder_engine(pScore);
     ColStaffObjs* pColStaffObjs = builder->do_build();
     pScore->set_staffobjs_table(pColStaffObjs);
@@ -481,6 +720,24 @@ ColStaffObjs* ColStaffObjsBuilder::build(ImoScore* pScore)
     return pColStaffObjs;
 }
 
+//---------------------------------------------------------------------------------------
+bool ColStaffObjsBuilder::update(ImoScore* pScore, const vector<bool>& instruments)
+{
+    //Updates the existing table, re-creating only the entries for the instruments
+    //marked in 'instruments'. Returns false when this is not possible and the table
+    //must be created again.
+
+    ColStaffObjs* pColStaffObjs = pScore->get_staffobjs_table();
+    if (!pColStaffObjs)
+        return false;
+
+    ColStaffObjsBuilderEngine* builder = create_builder_engine(pScore);
+    bool fUpdated = builder->do_update(pColStaffObjs, instruments);
+    delete builder;
+
+    return fUpdated;
+}
+
 //---------------------------------------------------------------------------------------
 ColStaffObjsBuilderEngine* ColStaffObjsBuilder::create_builder_engine(ImoScore* pScore)
 {
@@ -517,13 +774,78 @@ ColStaffObjs* ColStaffObjsBuilderEngine::do_build()
     return m_pColStaffObjs;
 }
 
+//---------------------------------------------------------------------------------------
+bool ColStaffObjsBuilderEngine::do_update(ColStaffObjs* pColStaffObjs,
+                                          const vector<bool>& instruments)
+{
+    //The table order is the result of inserting the entries instrument by instrument,
+    //in creation order. As inserting an entry never changes the order of the
+    //existing ones, the entries for the instruments before the first updated one
+    //are not affected. Therefore, only entries for the first updated instrument and
+    //next ones have to be inserted again.
+    //The table can not be updated when the number of lines used by an updated
+    //instrument changes, as lines for all next instruments would change, or when
+    //grace notes before the first note shift the playback time of all notes.
+
+    int numInstrs = m_pImScore->get_num_instruments();
+    if (pColStaffObjs->num_instruments() != numInstrs
+        || int(instruments.size()) != numInstrs
+        || is_greater_time(pColStaffObjs->anacrusis_extra_time(), 0.0))
+    {
+        return false;
+    }
+
+    int iFirst = 0;
+    while (iFirst < numInstrs && !instruments[iFirst])
+        ++iFirst;
+    if (iFirst == numInstrs)
+        return true;
+
+    m_pColStaffObjs = pColStaffObjs;
+    initializations();
+    m_pColStaffObjs->unlink_entries_from_instrument(iFirst);
+    for (int instr = iFirst; instr < numInstrs; instr++)
+    {
+        if (!instruments[instr])
+        {
+            m_pColStaffObjs->relink_entries_for_instrument(instr);
+            continue;
+        }
+
+        m_pColStaffObjs->delete_entries_for_instrument(instr);
+        m_lines.start_instrument_at_line( m_pColStaffObjs->first_line(instr) );
+        create_entries_for_instrument(instr);
+        prepare_for_next_instrument();
+
+        int nextLine = (instr + 1 < numInstrs ? m_pColStaffObjs->first_line(instr + 1)
+                                              : m_pColStaffObjs->num_lines());
+        if (m_lines.get_number_of_lines() != nextLine)
+            return false;
+    }
+
+    //fix playback time for the new notes and update global info
+    collect_note_rests_info();
+    compute_grace_notes_playback_time();
+    compute_arpeggiated_chords_playback_time();
+    if (is_greater_time(m_gracesAnacrusisTime, 0.0))
+        return false;
+
+    m_pColStaffObjs->set_anacrusis_missing_time(0.0);
+    collect_anacrusis_info();
+    compute_divisions();
+    set_min_note_duration();
+    return true;
+}
+
 //---------------------------------------------------------------------------------------
 void ColStaffObjsBuilderEngine::create_table()
 {
+    m_pColStaffObjs = LOMSE_NEW ColStaffObjs();
     initializations();
     int totalInstruments = m_pImScore->get_num_instruments();
     for (int instr = 0; instr < totalInstruments; instr++)
     {
+        m_pColStaffObjs->set_first_line(instr, m_lines.get_number_of_lines());
         create_entries_for_instrument(instr);
         prepare_for_next_instrument();
     }
@@ -614,6 +936,29 @@ void ColStaffObjsBuilderEngine::collect_note_rest_info(ImoNoteRest* pNR)
     m_pDivComputer->add_note_rest(pNR);
 }
 
+//---------------------------------------------------------------------------------------
+void ColStaffObjsBuilderEngine::collect_note_rests_info()
+{
+    //when updating the table, info from all note/rests must be collected again
+
+    m_pColStaffObjs->reset_noterest_counters();
+    delete m_pDivComputer;
+    m_pDivComputer = LOMSE_NEW DivisionsComputer();
+    m_minNoteDuration = LOMSE_NO_NOTE_DURATION;
+
+    ColStaffObjsIterator it;
+    for (it = m_pColStaffObjs->begin(); it != m_pColStaffObjs->end(); ++it)
+    {
+        ImoStaffObj* pSO = (*it)->imo_object();
+        if (pSO->is_note_rest() && !pSO->is_grace_note())
+        {
+            ImoNoteRest* pNR = static_cast<ImoNoteRest*>(pSO);
+            collect_note_rest_info(pNR);
+            update_min_note_duration(pNR);
+        }
+    }
+}
+
 //---------------------------------------------------------------------------------------
 int ColStaffObjsBuilderEngine::get_line_for(int nVoice, int nStaff)
 {
@@ -974,7 +1319,6 @@ string ColStaffObjsBuilderEngine::dump_divisions_data() const
 //=======================================================================================
 void ColStaffObjsBuilderEngine1x::initializations()
 {
-    m_pColStaffObjs = LOMSE_NEW ColStaffObjs();
 }
 
 //---------------------------------------------------------------------------------------
@@ -1143,6 +1487,13 @@ void ColStaffObjsBuilderEngine1x::prepare_for_next_instrument()
     m_lines.new_instrument();
 }
 
+//---------------------------------------------------------------------------------------
+void ColStaffObjsBuilderEngine1x::update_min_note_duration(ImoNoteRest* pNR)
+{
+    //as in add_entry_for_staffobj()
+    m_minNoteDuration = min(m_minNoteDuration, pNR->get_duration());
+}
+
 
 
 //=======================================================================================
@@ -1151,7 +1502,6 @@ void ColStaffObjsBuilderEngine1x::prepare_for_next_instrument()
 void ColStaffObjsBuilderEngine2x::initializations()
 {
     m_rCurTime.reserve(k_max_voices);
-    m_pColStaffObjs = LOMSE_NEW ColStaffObjs();
     m_curVoice = 0;
     m_prevVoice = 0;
 }
@@ -1339,6 +1689,21 @@ void ColStaffObjsBuilderEngine2x::prepare_for_next_instrument()
     m_curVoice = 0;
 }
 
+//---------------------------------------------------------------------------------------
+void ColStaffObjsBuilderEngine2x::update_min_note_duration(ImoNoteRest* pNR)
+{
+    //as in determine_timepos(): only the last note in a chord has duration
+    if (pNR->is_note())
+    {
+        ImoNote* pNote = static_cast<ImoNote*>(pNR);
+        if (pNote->is_in_chord() && !pNote->is_end_of_chord())
+            return;
+    }
+
+    if (pNR->get_duration() > 0.0)
+        m_minNoteDuration = min(m_minNoteDuration, pNR->get_duration());
+}
+
 
 
 //=======================================================================================
@@ -1399,6 +1764,14 @@ int StaffVoiceLineTable::assign_line_to(int nVoice, int nStaff)
     return line;
 }
 
+//---------------------------------------------------------------------------------------
+void StaffVoiceLineTable::start_instrument_at_line(int line)
+{
+    //prepare for assigning lines to an instrument whose first line is known
+    m_lastDefinedLine = line - 1;
+    new_instrument();
+}
+
 //---------------------------------------------------------------------------------------
 void StaffVoiceLineTable::new_instrument()
 {
@@ -0,0 +1,213 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_batch_renderer.h"
+
+#include "lomse_doorway.h"
+#include "lomse_gm_basic.h"
+#include "lomse_injectors.h"
+#include "lomse_interactor.h"
+#include "lomse_internal_model.h"
+#include "lomse_presenter.h"
+#include "lomse_renderer.h"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#if (LOMSE_ENABLE_THREADS == 1)
+    #include <thread>
+#endif
+
+using namespace std;
+
+namespace lomse
+{
+
+//=======================================================================================
+// BatchWorkQueues: one queue of pending jobs per worker thread
+//=======================================================================================
+class BatchWorkQueues
+{
+protected:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<size_t> jobs;
+    };
+    std::vector< unique_ptr<Queue> > m_queues;
+
+public:
+    BatchWorkQueues(int numQueues, size_t numJobs)
+    {
+        //each queue receives a block of consecutive jobs
+        for (int i=0; i < numQueues; ++i)
+            m_queues.push_back( unique_ptr<Queue>(LOMSE_NEW Queue) );
+
+        for (size_t iJob=0; iJob < numJobs; ++iJob)
+            m_queues[iJob * numQueues / numJobs]->jobs.push_back(iJob);
+    }
+
+    //take next job from the front of its own queue
+    bool pop(int iQueue, size_t* pJob)
+    {
+        Queue& q = *m_queues[iQueue];
+        lock_guard<mutex> lock(q.mutex);
+        if (q.jobs.empty())
+            return false;
+        *pJob = q.jobs.front();
+        q.jobs.pop_front();
+        return true;
+    }
+
+    //take a job from the back of other threads queues
+    bool steal(int iThief, size_t* pJob)
+    {
+        int numQueues = int(m_queues.size());
+        for (int i=1; i < numQueues; ++i)
+        {
+            Queue& q = *m_queues[(iThief + i) % numQueues];
+            lock_guard<mutex> lock(q.mutex);
+            if (!q.jobs.empty())
+            {
+                *pJob = q.jobs.back();
+                q.jobs.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+
+//=======================================================================================
+// BatchRenderer implementation
+//=======================================================================================
+BatchRenderer::BatchRenderer(LomseDoorway& doorway, vector<BatchRenderJob>& jobs)
+    : m_doorway(doorway)
+    , m_jobs(jobs)
+{
+}
+
+//---------------------------------------------------------------------------------------
+void BatchRenderer::render(int numThreads)
+{
+    if (m_jobs.empty())
+        return;
+
+#if (LOMSE_ENABLE_THREADS == 1)
+    if (numThreads <= 0)
+        numThreads = max(1, int(std::thread::hardware_concurrency()));
+#else
+    numThreads = 1;
+#endif
+    numThreads = min(numThreads, int(m_jobs.size()));
+
+    prepare_shared_resources();
+    BatchWorkQueues queues(numThreads, m_jobs.size());
+
+#if (LOMSE_ENABLE_THREADS == 1)
+    //the calling thread is used as worker 0
+    vector<std::thread> threads;
+    for (int i=1; i < numThreads; ++i)
+        threads.push_back( std::thread(&BatchRenderer::worker_main, this,
+                                       std::ref(queues), i) );
+    worker_main(queues, 0);
+    for (std::thread& t : threads)
+        t.join();
+#else
+    worker_main(queues, 0);
+#endif
+}
+
+//---------------------------------------------------------------------------------------
+void BatchRenderer::prepare_shared_resources()
+{
+    //LibraryScope singletons and some tables are created on first use. Create them
+    //now, before starting the threads, as afterwards they are only read.
+
+    LibraryScope* pLibScope = m_doorway.get_library_scope();
+    pLibScope->ldp_factory();
+    pLibScope->get_font_selector();
+    pLibScope->get_glyphs_table();
+    pLibScope->get_events_dispatcher();
+    ImoObj::get_name(k_imo_note_regular);
+    GmoObj::get_name(GmoObj::k_box_document);
+}
+
+//---------------------------------------------------------------------------------------
+void BatchRenderer::worker_main(BatchWorkQueues& queues, int iWorker)
+{
+    size_t iJob;
+    while (queues.pop(iWorker, &iJob) || queues.steal(iWorker, &iJob))
+        render_job(m_jobs[iJob]);
+
+    //worker threads end here. Their FontStorage is no longer needed
+    if (iWorker > 0)
+        m_doorway.get_library_scope()->release_thread_font_storage();
+}
+
+//---------------------------------------------------------------------------------------
+void BatchRenderer::render_job(BatchRenderJob& job)
+{
+    job.ok = false;
+    job.svg.clear();
+    job.bitmap.clear();
+
+    stringstream reporter;
+    Presenter* pPresenter = nullptr;
+    try
+    {
+        if (job.from_file)
+            pPresenter = m_doorway.open_document(job.view_type, job.source, reporter);
+        else
+            pPresenter = m_doorway.new_document(job.view_type, job.source, job.format,
+                                                reporter);
+
+        Interactor* pIntor = pPresenter->get_interactor_raw_ptr(0);
+        if (job.page < 0 || job.page >= pIntor->get_num_pages())
+        {
+            reporter << "Batch render: invalid page number " << job.page << endl;
+        }
+        else if (job.output == k_batch_output_svg)
+        {
+            stringstream svg;
+            pIntor->render_as_svg(svg, job.page);
+            job.svg = svg.str();
+            job.ok = true;
+        }
+        else if (job.width > 0 && job.height > 0)
+        {
+            int bytesPerPixel = Renderer::bytesPerPixel(m_doorway.get_pixel_format());
+            job.bitmap.assign(size_t(bytesPerPixel) * job.width * job.height, 0);
+            pIntor->set_print_buffer(&job.bitmap[0], unsigned(job.width),
+                                     unsigned(job.height));
+            pIntor->set_print_page_size(job.width, job.height);
+            pIntor->print_page(job.page);
+            job.ok = true;
+        }
+        else
+        {
+            reporter << "Batch render: invalid bitmap size " << job.width << "x"
+                     << job.height << endl;
+        }
+    }
+    catch (exception& e)
+    {
+        reporter << "Batch render: " << e.what() << endl;
+        job.ok = false;
+    }
+
+    delete pPresenter;
+    job.errors = reporter.str();
+}
+
+
+}   //namespace lomse
@@ -10,6 +10,7 @@
 #define LOMSE_INTERNAL_API
 #include "lomse_doorway.h"
 
+#include "lomse_batch_renderer.h"
 #include "lomse_injectors.h"
 #include "lomse_presenter.h"
 #include "lomse_import_options.h"
@@ -118,6 +119,13 @@ Presenter* LomseDoorway::open_document(int viewType, LdpReader& reader,
     return builder.open_document(viewType, reader, screenDrawer, printDrawer, reporter);
 }
 
+//---------------------------------------------------------------------------------------
+void LomseDoorway::render_batch(std::vector<BatchRenderJob>& jobs, int numThreads)
+{
+    BatchRenderer renderer(*this, jobs);
+    renderer.render(numThreads);
+}
+
 //---------------------------------------------------------------------------------------
 void LomseDoorway::init_library(int pixel_format, int ppi, bool reverse_y_axis,
                                ostream& reporter)
@@ -22,6 +22,7 @@
 #include "lomse_compressed_mxl_compiler.h"
 #include "lomse_mnx_analyser.h"
 #include "lomse_mnx_compiler.h"
+#include "lomse_binary_compiler.h"
 #include "lomse_model_builder.h"
 #include "private/lomse_document_p.h"
 #include "lomse_font_storage.h"
@@ -45,6 +46,7 @@
     #include "lomse_score_player.h"
 #endif
 
+#include <atomic>
 #include <sstream>
 using namespace std;
 
@@ -52,6 +54,14 @@ namespace lomse
 {
 
 
+//---------------------------------------------------------------------------------------
+//global counter to create unique LibraryScope numbers, and FontStorage used by current
+//thread, for the LibraryScope with number s_threadScopeRef
+static std::atomic<long> s_scopesCounter(0L);
+static thread_local long s_threadScopeRef = 0L;
+static thread_local FontStorage* s_pThreadFontStorage = nullptr;
+
+
 //=======================================================================================
 // LibraryScope implementation
 //=======================================================================================
@@ -60,7 +70,7 @@ LibraryScope::LibraryScope(ostream& reporter, LomseDoorway* pDoorway)
     , m_pDoorway(pDoorway)
     , m_pNullDoorway(nullptr)
     , m_pLdpFactory(nullptr)       //lazzy instantiation. Singleton scope.
-    , m_pFontStorage(nullptr)      //lazzy instantiation. Singleton scope.
+    , m_scopeRef(++s_scopesCounter)
     , m_pFontSelector(nullptr)     //lazzy instantiation. Singleton scope.
     , m_pGlobalMetronome(nullptr)
     , m_pDispatcher(nullptr)
@@ -86,6 +96,7 @@ LibraryScope::LibraryScope(ostream& reporter, LomseDoorway* pDoorway)
     , m_spacingDmin(16.0f)
     , m_spacingSmin(LOMSE_MIN_SPACE)
     , m_renderSpacingOpts(k_render_opt_breaker_optimal)
+    , m_breakerMaxColumns(0)
 {
     if (!m_pDoorway)
     {
@@ -99,7 +110,8 @@ LibraryScope::LibraryScope(ostream& reporter, LomseDoorway* pDoorway)
 LibraryScope::~LibraryScope()
 {
     delete m_pLdpFactory;
-    delete m_pFontStorage;
+    for (auto& item : m_fontStorages)
+        delete item.second;
     delete m_pFontSelector;
     delete m_pNullDoorway;
     delete m_pMusicGlyphs;
@@ -121,9 +133,40 @@ LdpFactory* LibraryScope::ldp_factory()
 //---------------------------------------------------------------------------------------
 FontStorage* LibraryScope::font_storage()
 {
-    if (!m_pFontStorage)
-        m_pFontStorage = LOMSE_NEW FontStorage(this);
-    return m_pFontStorage;
+    //lazzy instantiation. One instance for each thread, as FontStorage keeps the
+    //selected font and the glyph caches. The FontStorage for current thread is
+    //cached, so that the lock is only taken the first time
+
+    if (s_threadScopeRef == m_scopeRef)
+        return s_pThreadFontStorage;
+
+    std::lock_guard<std::mutex> lock(m_fontStoragesMutex);
+    FontStorage*& pStorage = m_fontStorages[std::this_thread::get_id()];
+    if (!pStorage)
+        pStorage = LOMSE_NEW FontStorage(this);
+    s_threadScopeRef = m_scopeRef;
+    s_pThreadFontStorage = pStorage;
+    return pStorage;
+}
+
+//---------------------------------------------------------------------------------------
+void LibraryScope::release_thread_font_storage()
+{
+    //Deletes the FontStorage for current thread. To be invoked by threads that finish
+    //using the library, when no object using the FontStorage remains
+
+    std::lock_guard<std::mutex> lock(m_fontStoragesMutex);
+    auto it = m_fontStorages.find(std::this_thread::get_id());
+    if (it != m_fontStorages.end())
+    {
+        delete it->second;
+        m_fontStorages.erase(it);
+    }
+    if (s_threadScopeRef == m_scopeRef)
+    {
+        s_threadScopeRef = 0L;
+        s_pThreadFontStorage = nullptr;
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -348,6 +391,13 @@ MnxCompiler* Injector::inject_MnxCompiler(LibraryScope& libraryScope,
                                  pDoc );
 }
 
+//---------------------------------------------------------------------------------------
+BinaryCompiler* Injector::inject_BinaryCompiler(LibraryScope& UNUSED(libraryScope),
+                                                Document* pDoc)
+{
+    return LOMSE_NEW BinaryCompiler(inject_ModelBuilder(pDoc->get_scope()), pDoc);
+}
+
 //---------------------------------------------------------------------------------------
 ModelBuilder* Injector::inject_ModelBuilder(DocumentScope& UNUSED(documentScope))
 {
@@ -0,0 +1,274 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#include "lomse_profiler.h"
+
+#include "lomse_build_options.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+using namespace std;
+using namespace std::chrono;
+
+namespace lomse
+{
+
+#if (LOMSE_ENABLE_THREADS == 1)
+    #define LOMSE_THREAD_LOCAL  thread_local
+#else
+    #define LOMSE_THREAD_LOCAL
+#endif
+
+//---------------------------------------------------------------------------------------
+//profiler active in current thread and nesting level of the open scopes
+static LOMSE_THREAD_LOCAL PhaseProfiler* m_pCurProfiler = nullptr;
+static LOMSE_THREAD_LOCAL int m_curDepth = 0;
+
+
+//---------------------------------------------------------------------------------------
+static string escape_json(const string& text)
+{
+    string escaped;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+
+//=======================================================================================
+// PhaseProfiler implementation
+//=======================================================================================
+PhaseProfiler::PhaseProfiler()
+    : m_start( steady_clock::now() )
+{
+}
+
+//---------------------------------------------------------------------------------------
+void PhaseProfiler::clear()
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_phases.clear();
+    m_threads.clear();
+    m_start = steady_clock::now();
+}
+
+//---------------------------------------------------------------------------------------
+void PhaseProfiler::add_phase(const char* name, int depth,
+                              steady_clock::time_point start,
+                              steady_clock::time_point end)
+{
+    lock_guard<mutex> lock(m_mutex);
+
+    ProfilerPhase phase;
+    phase.name = name;
+    phase.thread = get_thread_index();
+    phase.depth = depth;
+    phase.start = double( duration_cast<microseconds>(start - m_start).count() );
+    phase.duration = double( duration_cast<microseconds>(end - start).count() );
+    m_phases.push_back(phase);
+}
+
+//---------------------------------------------------------------------------------------
+int PhaseProfiler::get_thread_index()
+{
+    //AWARE: must be invoked with the mutex locked
+
+    thread::id id = this_thread::get_id();
+    for (size_t i=0; i < m_threads.size(); ++i)
+    {
+        if (m_threads[i] == id)
+            return int(i);
+    }
+    m_threads.push_back(id);
+    return int(m_threads.size()) - 1;
+}
+
+//---------------------------------------------------------------------------------------
+vector<ProfilerPhase> PhaseProfiler::get_phases() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_phases;
+}
+
+//---------------------------------------------------------------------------------------
+double PhaseProfiler::get_total_time(const string& name) const
+{
+    lock_guard<mutex> lock(m_mutex);
+    double total = 0.0;
+    for (const ProfilerPhase& phase : m_phases)
+    {
+        if (phase.name == name)
+            total += phase.duration;
+    }
+    return total / 1000.0;
+}
+
+//---------------------------------------------------------------------------------------
+int PhaseProfiler::get_count(const string& name) const
+{
+    lock_guard<mutex> lock(m_mutex);
+    int count = 0;
+    for (const ProfilerPhase& phase : m_phases)
+    {
+        if (phase.name == name)
+            ++count;
+    }
+    return count;
+}
+
+//---------------------------------------------------------------------------------------
+string PhaseProfiler::to_json() const
+{
+    //One entry per phase name, in order of first use, with the number of times the
+    //phase was executed and the accumulated time. Phases are ordered by start time
+    //and depth, as they are recorded when finished and, therefore, outer phases
+    //are after the nested ones.
+
+    vector<ProfilerPhase> phases = get_phases();
+    stable_sort(phases.begin(), phases.end(),
+                [](const ProfilerPhase& a, const ProfilerPhase& b) {
+                    return a.start < b.start
+                           || (a.start == b.start && a.depth < b.depth);
+                });
+
+    vector<string> names;
+    vector<int> depths;
+    vector<int> counts;
+    vector<double> totals;
+    for (const ProfilerPhase& phase : phases)
+    {
+        size_t i = 0;
+        while (i < names.size() && names[i] != phase.name)
+            ++i;
+        if (i == names.size())
+        {
+            names.push_back(phase.name);
+            depths.push_back(phase.depth);
+            counts.push_back(0);
+            totals.push_back(0.0);
+        }
+        ++counts[i];
+        totals[i] += phase.duration;
+    }
+
+    stringstream ss;
+    ss << fixed << setprecision(3);
+    ss << "{\"phases\":[";
+    for (size_t i=0; i < names.size(); ++i)
+    {
+        if (i > 0)
+            ss << ",";
+        ss << "{\"name\":\"" << escape_json(names[i]) << "\",\"depth\":" << depths[i]
+           << ",\"count\":" << counts[i] << ",\"total_ms\":" << totals[i] / 1000.0
+           << "}";
+    }
+    ss << "]}";
+    return ss.str();
+}
+
+//---------------------------------------------------------------------------------------
+string PhaseProfiler::to_chrome_trace() const
+{
+    //Trace Event Format, as 'complete' events. It can be loaded in chrome://tracing
+    //or in https://ui.perfetto.dev
+
+    vector<ProfilerPhase> phases = get_phases();
+
+    stringstream ss;
+    ss << fixed << setprecision(0);
+    ss << "{\"traceEvents\":[";
+    for (size_t i=0; i < phases.size(); ++i)
+    {
+        const ProfilerPhase& phase = phases[i];
+        if (i > 0)
+            ss << ",";
+        ss << "{\"name\":\"" << escape_json(phase.name) << "\",\"cat\":\"lomse\""
+           << ",\"ph\":\"X\",\"ts\":" << phase.start << ",\"dur\":" << phase.duration
+           << ",\"pid\":1,\"tid\":" << phase.thread << "}";
+    }
+    ss << "],\"displayTimeUnit\":\"ms\"}";
+    return ss.str();
+}
+
+//---------------------------------------------------------------------------------------
+PhaseProfiler* PhaseProfiler::current()
+{
+    return m_pCurProfiler;
+}
+
+//---------------------------------------------------------------------------------------
+void PhaseProfiler::set_current(PhaseProfiler* pProfiler)
+{
+    m_pCurProfiler = pProfiler;
+}
+
+//---------------------------------------------------------------------------------------
+int PhaseProfiler::enter_scope()
+{
+    return m_curDepth++;
+}
+
+//---------------------------------------------------------------------------------------
+void PhaseProfiler::exit_scope()
+{
+    --m_curDepth;
+}
+
+
+//=======================================================================================
+// ProfilerActivation implementation
+//=======================================================================================
+ProfilerActivation::ProfilerActivation(PhaseProfiler* pProfiler)
+    : m_pPrevious( PhaseProfiler::current() )
+    , m_fActivated(pProfiler != nullptr)
+{
+    if (m_fActivated)
+        PhaseProfiler::set_current(pProfiler);
+}
+
+//---------------------------------------------------------------------------------------
+ProfilerActivation::~ProfilerActivation()
+{
+    if (m_fActivated)
+        PhaseProfiler::set_current(m_pPrevious);
+}
+
+
+//=======================================================================================
+// ProfilerScope implementation
+//=======================================================================================
+ProfilerScope::ProfilerScope(const char* name)
+    : m_pProfiler( PhaseProfiler::current() )
+    , m_name(name)
+    , m_depth(0)
+{
+    if (m_pProfiler)
+    {
+        m_depth = PhaseProfiler::enter_scope();
+        m_start = steady_clock::now();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+ProfilerScope::~ProfilerScope()
+{
+    if (m_pProfiler)
+    {
+        m_pProfiler->add_phase(m_name, m_depth, m_start, steady_clock::now());
+        PhaseProfiler::exit_scope();
+    }
+}
+
+
+}   //namespace lomse
@@ -27,6 +27,7 @@
 #include "lomse_box_slice_instr.h"
 #include "lomse_box_system.h"
 #include "lomse_timegrid_table.h"
+#include "lomse_playback_timeline.h"
 #include "lomse_half_page_view.h"
 #include "lomse_renderer.h"
 #include "lomse_svg_drawer.h"
@@ -39,6 +40,10 @@ using namespace std;
 namespace lomse
 {
 
+//margin added to the visible area when culling objects, to ensure that objects whose
+//rendering slightly exceeds its bounds (e.g. strokes, anti-aliasing) are not clipped
+const LUnits k_culling_margin = 100.0f;     //1 mm
+
 
 //=======================================================================================
 // ViewFactory implementation
@@ -368,15 +373,17 @@ bool GraphicView::determine_page_system_and_position_for(ImoId scoreId, TimeUnit
     if (!pGModel)
         return false;    //error
 
-    m_pScrollSystem = pGModel->get_system_for(scoreId, timepos);
-    //LOMSE_LOG_DEBUG(Logger::k_events,
-    //                "scoreId=%d, timepos=%f, system=%s",
-    //                scoreId, timepos, (m_pScrollSystem != nullptr ? "found" : "not found"));
-    if (!m_pScrollSystem)
+    PlaybackTimeline* pTimeline = pGModel->get_playback_timeline(scoreId);
+    PlaybackTimeline::Position pos;
+    if (!pTimeline || !pTimeline->locate(timepos, &pos))
         return false;    //error
 
-    m_iScrollPage = m_pScrollSystem->get_page_number();
-    m_xScrollLeft = m_pScrollSystem->get_x_for_note_rest_at_time(timepos);
+    //LOMSE_LOG_DEBUG(Logger::k_events,
+    //                "scoreId=%d, timepos=%f, system=%d",
+    //                scoreId, timepos, pos.pSystem->get_system_number());
+    m_pScrollSystem = pos.pSystem;
+    m_iScrollPage = pos.iPage;
+    m_xScrollLeft = pos.x;
     m_xScrollRight = m_xScrollLeft + 1000;   //1 cm
 
     //LOMSE_LOG_DEBUG(Logger::k_events, "new scroll pos = %f, %f", m_xScrollLeft, m_xScrollRight);
@@ -689,6 +696,9 @@ void GraphicView::draw_all()
         m_pInteractor->timing_start_measurements();
         draw_graphic_model();
         m_pInteractor->timing_graphic_model_render_end();
+        m_pInteractor->set_render_counters(m_options.num_shapes_drawn,
+                                           m_options.num_shapes_culled,
+                                           m_options.num_boxes_culled);
 
         //render handlers and visual effects
         m_pInteractor->timing_visual_effects_start();
@@ -1577,6 +1587,10 @@ void GraphicView::set_rendering_option(int option, bool value)
             m_options.draw_box_for(GmoObj::k_box_inline);
             break;
 
+        case k_option_disable_viewport_culling:
+            m_fViewportCulling = !value;
+            break;
+
         case k_option_display_voices_in_colours:
             m_options.draw_voices_coloured = value;
             break;
@@ -1617,34 +1631,20 @@ void GraphicView::change_cursor_voice(int voice)
 void GraphicView::generate_paths()
 {
     collect_page_bounds();      //moved out of 'if' block for unit tests
-    if (is_valid_viewport())
-    {
-        int minPage, maxPage;
-
-        determine_visible_pages(&minPage, &maxPage);
-        draw_visible_pages(minPage, maxPage);
-    }
-}
 
-//---------------------------------------------------------------------------------------
-void GraphicView::determine_visible_pages(int* minPage, int* maxPage)
-{
-    list<PageRectangle*> rectangles;
-    screen_rectangle_to_page_rectangles(0, 0, m_viewportSize.width,
-                                        m_viewportSize.height, &rectangles);
+    //lazy layout: layout the pages that are going to be visible
+    while (viewport_needs_more_pages() && m_pInteractor->layout_more_pages())
+        collect_page_bounds();
 
-    if (!rectangles.empty())
-    {
-        *minPage = rectangles.front()->iPage;
-        *maxPage = rectangles.back()->iPage;
-    }
-    else
+    m_options.reset_render_counters();
+    if (is_valid_viewport())
     {
-        *minPage = 0;
-        *maxPage = -1;
+        list<PageRectangle*> visibleAreas;
+        screen_rectangle_to_page_rectangles(0, 0, m_viewportSize.width,
+                                            m_viewportSize.height, &visibleAreas);
+        draw_visible_pages(visibleAreas);
+        delete_rectangles(visibleAreas);
     }
-
-    delete_rectangles(rectangles);
 }
 
 //---------------------------------------------------------------------------------------
@@ -1656,19 +1656,29 @@ void GraphicView::delete_rectangles(list<PageRectangle*>& rectangles)
 }
 
 //---------------------------------------------------------------------------------------
-void GraphicView::draw_visible_pages(int minPage, int maxPage)
+void GraphicView::draw_visible_pages(list<PageRectangle*>& visibleAreas)
 {
-    GraphicModel* pGModel = get_graphic_model();
+    //visibleAreas contains, for each visible page, the visible rectangle, relative to
+    //page origin. Only the objects intersecting it are drawn
 
-    list<URect>::iterator it = m_pageBounds.begin();
-    for (int i=0; i < minPage; i++)
-        ++it;
+    GraphicModel* pGModel = get_graphic_model();
+    m_options.culling_flag = m_fViewportCulling;
 
-    for (int i=minPage; i <= maxPage; i++, ++it)
+    list<PageRectangle*>::iterator it;
+    for (it = visibleAreas.begin(); it != visibleAreas.end(); ++it)
     {
-        UPoint origin = (*it).get_top_left();
-        pGModel->draw_page(i, origin, m_pDrawer, m_options);
+        URect& rect = (*it)->rect;
+        m_options.clip_rect = URect(rect.left() - k_culling_margin,
+                                    rect.top() - k_culling_margin,
+                                    rect.get_width() + 2.0f * k_culling_margin,
+                                    rect.get_height() + 2.0f * k_culling_margin);
+
+        UPoint origin = get_page_bounds((*it)->iPage).get_top_left();
+        pGModel->draw_page((*it)->iPage, origin, m_pDrawer, m_options);
     }
+
+    //other renderizations (printing, svg) must include all objects
+    m_options.culling_flag = false;
 }
 
 //---------------------------------------------------------------------------------------
@@ -1971,6 +1981,23 @@ void VerticalBookView::collect_page_bounds()
     }
 }
 
+//---------------------------------------------------------------------------------------
+bool VerticalBookView::viewport_needs_more_pages()
+{
+    //lazy layout: more pages are needed when the bottom of the last laid out page
+    //is near the viewport, that is, less than one viewport height below it
+
+    GraphicModel* pGModel = get_graphic_model();
+    if (!m_pInteractor || !pGModel || pGModel->is_layout_finished()
+        || m_pageBounds.empty())
+    {
+        return false;
+    }
+
+    UPoint bottom = screen_point_to_model_point(0, 2 * m_viewportSize.height);
+    return m_pageBounds.back().bottom() < bottom.y;
+}
+
 //---------------------------------------------------------------------------------------
 void VerticalBookView::set_viewport_for_page_fit_full(Pixels screenWidth)
 {
@@ -1995,6 +2022,16 @@ void VerticalBookView::get_view_size(Pixels* xWidth, Pixels* yHeight)
             width = max(width, rect.width);
             height += rect.height;
         }
+
+        //lazy layout: assume that pending pages will be as the last one
+        int numPages = pGModel->get_num_pages();
+        int pending = pGModel->get_estimated_num_pages() - numPages;
+        if (pending > 0 && numPages > 0)
+        {
+            URect rect = pGModel->get_page(numPages - 1)->get_bounds();
+            height += pending * (rect.height + 1000.0f);
+        }
+
         LUnits margin = 0.05f * width;      //5% margin, 2.5 at each side
 
         *xWidth = Pixels(m_pDrawer->model_to_device_units(width + margin));
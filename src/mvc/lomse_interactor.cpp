@@ -71,8 +71,16 @@ Interactor::Interactor(LibraryScope& libraryScope, WpDocument wpDoc, View* pView
     , m_fEditionEnabled(false)
     , m_fViewParamsChanged(false)
     , m_fViewUpdatesEnabled(true)
+    , m_fIncrementalLayout(true)
+    , m_fReuseGraphicModel(false)
+    , m_pPrevGraphicModel(nullptr)
+    , m_fLazyLayout(false)
+    , m_pLazyLayouter(nullptr)
     , m_idControlledImo(k_no_imoid)
 {
+    for (int i=0; i < k_counter_max_value; ++i)
+        m_renderCounters[i] = 0;
+
     switch_task(TaskFactory::k_task_only_clicks);
 
     if (SpDocument spDoc = m_wpDoc.lock())
@@ -143,17 +151,33 @@ void Interactor::create_graphic_model()
         if (pView && pDoc)
         {
             LOMSE_LOG_DEBUG(Logger::k_render, "[Interactor::create_graphic_model]");
+            delete_lazy_layouter();
             int constrains = pView->get_layout_constrains();
             LUnits width = pView->get_viewport_width();
-            DocLayouter layouter(pDoc, m_libScope, constrains, width);
+            DocLayouter* pLayouter = LOMSE_NEW DocLayouter(pDoc, m_libScope, constrains,
+                                                           width);
+            pLayouter->set_previous_graphic_model(m_pPrevGraphicModel);
+            if (must_use_lazy_layout(pView, pDoc))
+                pLayouter->enable_lazy_layout(1);
 
             if (pView->is_valid_for_this_view(pDoc))
-                layouter.layout_document();
+                pLayouter->layout_document();
             else
-                layouter.layout_empty_document();
+                pLayouter->layout_empty_document();
+
+            //AWARE: some boxes could have been moved to the new model
+            delete m_pPrevGraphicModel;
+            m_pPrevGraphicModel = nullptr;
 
-            m_pGraphicModel = layouter.get_graphic_model();
+            m_pGraphicModel = pLayouter->get_graphic_model();
             m_pGraphicModel->build_main_boxes_table();
+
+            //keep the layouter while there are pages pending
+            if (pLayouter->is_layout_finished())
+                delete pLayouter;
+            else
+                m_pLazyLayouter = pLayouter;
+
             m_pSelections->graphic_model_changed(m_pGraphicModel);
         }
         spDoc->clear_dirty();
@@ -166,6 +190,65 @@ void Interactor::create_graphic_model()
 //    m_idLastMouseOver = k_no_imoid;
 }
 
+//---------------------------------------------------------------------------------------
+bool Interactor::must_use_lazy_layout(GraphicView* pView, Document* pDoc)
+{
+    //lazy layout is only used when the model will not be edited nor reused
+    return m_fLazyLayout
+           && pView->supports_lazy_layout()
+           && m_pPrevGraphicModel == nullptr
+           && m_operatingMode == k_mode_read_only
+           && pView->is_valid_for_this_view(pDoc);
+}
+
+//---------------------------------------------------------------------------------------
+bool Interactor::layout_more_pages(int numPages)
+{
+    if (!m_pLazyLayouter || !m_pGraphicModel)
+        return false;
+
+    LOMSE_LOG_DEBUG(Logger::k_render, "[Interactor::layout_more_pages]");
+    GraphicModel* pOldModel = m_pGraphicModel;
+    int oldPages = pOldModel->get_num_pages();
+
+    m_pLazyLayouter->layout_more_pages(numPages);
+    GraphicModel* pModel = m_pLazyLayouter->get_graphic_model();
+    if (pModel != pOldModel)
+    {
+        //AWARE: layout restarted (e.g. auto-scaling) and a new model was created
+        detach_graphic_model();
+        delete pOldModel;
+        m_pGraphicModel = pModel;
+        m_pGraphicModel->build_main_boxes_table();
+        m_pSelections->graphic_model_changed(m_pGraphicModel);
+    }
+    else
+        m_pGraphicModel->build_main_boxes_table(oldPages);
+
+    bool fMorePages = !m_pLazyLayouter->is_layout_finished();
+    if (!fMorePages)
+        delete_lazy_layouter();
+    return fMorePages;
+}
+
+//---------------------------------------------------------------------------------------
+void Interactor::layout_pages_up_to(int page)
+{
+    //ensure that pages [0, page] are laid out, if they exist
+    while (m_pLazyLayouter && m_pGraphicModel
+           && m_pGraphicModel->get_num_pages() <= page)
+    {
+        layout_more_pages(page + 1 - m_pGraphicModel->get_num_pages());
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void Interactor::delete_lazy_layouter()
+{
+    delete m_pLazyLayouter;
+    m_pLazyLayouter = nullptr;
+}
+
 //---------------------------------------------------------------------------------------
 bool Interactor::graphic_model_must_be_updated()
 {
@@ -194,7 +277,10 @@ void Interactor::handle_event(SpEventInfo pEvent)
     switch(pEvent->get_event_type())
     {
         case k_doc_modified_event:
-            delete_graphic_model();
+            if (m_fReuseGraphicModel)
+                save_graphic_model_for_reuse();
+            else
+                delete_graphic_model();
             restore_selection();
             force_redraw();
             break;
@@ -229,8 +315,37 @@ void Interactor::handle_event(SpEventInfo pEvent)
 //---------------------------------------------------------------------------------------
 void Interactor::delete_graphic_model()
 {
+    delete_lazy_layouter();
     delete m_pGraphicModel;
     m_pGraphicModel = nullptr;
+    delete m_pPrevGraphicModel;
+    m_pPrevGraphicModel = nullptr;
+    detach_graphic_model();
+    LOMSE_LOG_DEBUG(Logger::k_render, "GModel deleted.");
+}
+
+//---------------------------------------------------------------------------------------
+void Interactor::save_graphic_model_for_reuse()
+{
+    //the current model is not deleted but saved, so that the next layout can take
+    //from it the systems not affected by the last edition command.
+    //AWARE: a partially laid out model can not be reused
+
+    delete_lazy_layouter();
+    delete m_pPrevGraphicModel;
+    if (m_pGraphicModel && !m_pGraphicModel->is_layout_finished())
+    {
+        delete m_pGraphicModel;
+        m_pGraphicModel = nullptr;
+    }
+    m_pPrevGraphicModel = m_pGraphicModel;
+    m_pGraphicModel = nullptr;
+    detach_graphic_model();
+}
+
+//---------------------------------------------------------------------------------------
+void Interactor::detach_graphic_model()
+{
     m_pSelections->graphic_model_changed(nullptr);
 
     GraphicView* pGView = dynamic_cast<GraphicView*>(m_pView);
@@ -239,7 +354,6 @@ void Interactor::delete_graphic_model()
 
 //    m_idLastMouseOver = k_no_imoid;
     set_drag_image(nullptr, k_do_not_get_ownership, UPoint(0.0, 0.0));
-    LOMSE_LOG_DEBUG(Logger::k_render, "GModel deleted.");
 }
 
 ////---------------------------------------------------------------------------------------
@@ -1085,6 +1199,7 @@ void Interactor::get_viewport(Pixels* x, Pixels* y)
 USize Interactor::get_page_size(int page)
 {
     //ensure page is always valid
+    layout_pages_up_to(page);
     if (page < 0 || page > get_num_pages() - 1)
         page = 0;
 
@@ -1573,6 +1688,7 @@ void Interactor::set_print_page_size(Pixels width, Pixels height)
 //---------------------------------------------------------------------------------------
 void Interactor::print_page(int page, VPoint viewport)
 {
+    layout_pages_up_to(page);
     GraphicView* pGView = dynamic_cast<GraphicView*>(m_pView);
     if (pGView)
         pGView->print_page(page, viewport);
@@ -1581,9 +1697,10 @@ void Interactor::print_page(int page, VPoint viewport)
 //---------------------------------------------------------------------------------------
 int Interactor::get_num_pages()
 {
+    //AWARE: while the lazy layout is not finished, this is an estimation
     GraphicModel* pGModel = get_graphic_model();
     if (pGModel)
-        return pGModel->get_num_pages();
+        return pGModel->get_estimated_num_pages();
     else
         return 0;
 }
@@ -1595,6 +1712,7 @@ void Interactor::render_as_svg(std::ostream& svg, int page)
     if (pGView)
     {
         //ensure page is always valid
+        layout_pages_up_to(page);
         if (page < 0 || page > get_num_pages() - 1)
             page = 0;
 
@@ -1929,6 +2047,9 @@ void Interactor::timing_start_measurements()
     for (int i=0; i < k_timing_max_value; ++i)
         m_elapsedTimes[i] = 0.0;
 
+    for (int i=0; i < k_counter_max_value; ++i)
+        m_renderCounters[i] = 0;
+
     m_renderStartTime.init_now();
     m_visualEffectsStartTime = m_renderStartTime;
 }
@@ -1980,6 +2101,14 @@ void Interactor::timing_renderization_end()
     m_repaintStartTime = now;
 }
 
+//---------------------------------------------------------------------------------------
+void Interactor::set_render_counters(int shapesDrawn, int shapesCulled, int boxesCulled)
+{
+    m_renderCounters[k_counter_shapes_drawn] = shapesDrawn;
+    m_renderCounters[k_counter_shapes_culled] = shapesCulled;
+    m_renderCounters[k_counter_boxes_culled] = boxesCulled;
+}
+
 //---------------------------------------------------------------------------------------
 void Interactor::timing_repaint_done()
 {
@@ -2038,6 +2167,10 @@ void Interactor::set_operating_mode(int mode)
 {
     if (mode != m_operatingMode && is_operating_mode_allowed(mode))
     {
+        //edition and playback require the whole document laid out
+        if (mode != k_mode_read_only)
+            finish_layout();
+
         m_operatingMode = mode;
         switch_task(mode == k_mode_edition ? TaskFactory::k_task_selection
                                            : TaskFactory::k_task_only_clicks);
@@ -2131,8 +2264,32 @@ void Interactor::set_drag_image(GmoShape* pShape, bool fGetOwnership, UPoint off
 //---------------------------------------------------------------------------------------
 void Interactor::exec_command(DocCommand* pCmd)
 {
-    m_pExec->execute(m_pCursor, pCmd, m_pSelections);
+    //AWARE: the command is deleted by the executer when it fails or when it is not
+    //reversible. Otherwise, it is saved in the undo stack
+    SpDocument spDoc = m_wpDoc.lock();
+    bool fReusable = m_fIncrementalLayout && m_pGraphicModel && spDoc
+                     && m_pGraphicModel->is_layout_finished()
+                     && !spDoc->is_dirty() && pCmd->is_reversible();
+
+    int result = m_pExec->execute(m_pCursor, pCmd, m_pSelections);
+
+    if (fReusable && result == k_success)
+    {
+        ImoId scoreId;
+        int first, last;
+        if (pCmd->get_dirty_measures(&scoreId, &first, &last))
+        {
+            ScoreStub* pStub = m_pGraphicModel->get_stub_for(scoreId);
+            if (pStub)
+            {
+                pStub->mark_measures_as_dirty(first, last);
+                m_fReuseGraphicModel = true;
+            }
+        }
+    }
+
     update_caret_and_view();
+    m_fReuseGraphicModel = false;
     send_update_UI_event(k_pointed_object_change);
 }
 
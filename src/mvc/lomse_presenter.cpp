@@ -53,6 +53,8 @@ public:
             return Document::k_format_mxl_compressed;
         else if (ext == "mnx")
             return Document::k_format_mnx;
+        else if (ext == "lmb")
+            return Document::k_format_binary;
         else
             return Document::k_format_unknown;
     }
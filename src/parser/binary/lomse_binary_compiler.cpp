@@ -0,0 +1,80 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#include "lomse_binary_compiler.h"
+
+#include "lomse_im_serializer.h"
+#include "lomse_model_builder.h"
+#include "lomse_internal_model.h"
+#include "private/lomse_document_p.h"
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace std;
+
+namespace lomse
+{
+
+//=======================================================================================
+// BinaryCompiler implementation
+//=======================================================================================
+BinaryCompiler::BinaryCompiler(ModelBuilder* mb, Document* pDoc)
+    : Compiler(nullptr, nullptr, mb, pDoc)
+    , m_reporter(pDoc->get_scope().default_reporter())
+    , m_numErrors(0)
+{
+}
+
+//---------------------------------------------------------------------------------------
+BinaryCompiler::~BinaryCompiler()
+{
+}
+
+//---------------------------------------------------------------------------------------
+ImoDocument* BinaryCompiler::compile_file(const std::string& filename)
+{
+    m_fileLocator = filename;
+    ifstream file(filename.c_str(), ios::in | ios::binary);
+    if (!file.good())
+    {
+        m_reporter << "File not found: " << filename << endl;
+        ++m_numErrors;
+        return nullptr;
+    }
+
+    vector<char> buffer( (istreambuf_iterator<char>(file)), istreambuf_iterator<char>() );
+    return compile_buffer(buffer.data(), buffer.size());
+}
+
+//---------------------------------------------------------------------------------------
+ImoDocument* BinaryCompiler::compile_string(const std::string& source)
+{
+    m_fileLocator = "string:";
+    return compile_buffer(source.data(), source.size());
+}
+
+//---------------------------------------------------------------------------------------
+ImoDocument* BinaryCompiler::compile_buffer(const char* data, size_t size)
+{
+    ImSerializer serializer;
+    ImoDocument* pImoDoc = serializer.load(data, size, m_pDoc->get_doc_model());
+    if (!pImoDoc)
+    {
+        m_reporter << serializer.get_error() << endl;
+        ++m_numErrors;
+        return nullptr;
+    }
+
+    return m_pModelBuilder->fix_cloned_model(pImoDoc);
+}
+
+
+}  //namespace lomse
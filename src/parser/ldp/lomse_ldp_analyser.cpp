@@ -25,6 +25,7 @@
 #include "lomse_im_figured_bass.h"
 #include "lomse_ldp_elements.h"
 #include "lomse_linker.h"
+#include "lomse_profiler.h"
 #include "lomse_injectors.h"
 #include "lomse_events.h"
 #include "lomse_im_factory.h"
@@ -6520,6 +6521,7 @@ ImoObj* LdpAnalyser::analyse_tree_and_get_object(LdpTree* tree)
 //---------------------------------------------------------------------------------------
 ImoObj* LdpAnalyser::analyse_tree(LdpTree* tree, const string& locator)
 {
+    ProfilerScope scope("LdpAnalyser::analyse_tree");
     m_fileLocator = locator;
     return analyse_tree_and_get_object(tree);
 }
@@ -13,6 +13,7 @@
 #include <iostream>
 #include "lomse_ldp_factory.h"
 #include "lomse_logger.h"
+#include "lomse_profiler.h"
 
 using namespace std;
 
@@ -34,6 +35,7 @@ LdpParser::LdpParser(ostream& reporter, LdpFactory* pFactory)
     , m_pTk(nullptr)
     , m_state(A0_WaitingForStartOfElement)
     , m_curNode(nullptr)
+    , m_pArena(nullptr)
 {
 }
 
@@ -59,6 +61,11 @@ void LdpParser::clear_all()
     m_numErrors = 0;
     delete m_tree;
     m_tree = nullptr;
+
+    //the elements of previous tree keep the arena alive until deleted
+    if (m_pArena)
+        m_pArena->release();
+    m_pArena = nullptr;
 }
 
 //---------------------------------------------------------------------------------------
@@ -78,6 +85,7 @@ void LdpParser::parse_file(const std::string& filename, bool UNUSED(fErrorMsg))
 //---------------------------------------------------------------------------------------
 void LdpParser::parse_input(LdpReader& reader)
 {
+    ProfilerScope scope("LdpParser::parse");
     do_syntax_analysis(reader);
 }
 
@@ -105,6 +113,9 @@ void LdpParser::do_syntax_analysis(LdpReader& reader)
 
     clear_all();
 
+    //all tree nodes are allocated in an arena
+    m_pArena = LOMSE_NEW LdpArena();
+
     delete m_pTokenizer;
     m_pTokenizer = LOMSE_NEW LdpTokenizer(reader, m_reporter);
     m_pTokenizer->skip_utf_bom();
@@ -203,7 +214,8 @@ void LdpParser::Do_WaitingForName()
             }
 
             //create the node
-            m_curNode = m_pLdpFactory->create(nodename, m_pTk->get_line_number());
+            m_curNode = m_pLdpFactory->create(nodename, m_pTk->get_line_number(),
+                                              m_pArena);
             if (m_curNode->get_type() == k_undefined)
                 m_reporter << "Line " << m_pTk->get_line_number()
                            << ". Unknown tag '" + nodename + "'." << endl;
@@ -237,19 +249,22 @@ void LdpParser::Do_ProcessingParameter()
             else
             {
                 m_curNode->append_child( m_pLdpFactory->new_label(m_pTk->get_value(),
-                                                                  m_pTk->get_line_number()) );
+                                                                  m_pTk->get_line_number(),
+                                                                  m_pArena) );
                 m_state = A3_ProcessingParameter;
             }
             break;
         case tkIntegerNumber:
         case tkRealNumber:
             m_curNode->append_child( m_pLdpFactory->new_number(m_pTk->get_value(),
-                                                               m_pTk->get_line_number()) );
+                                                               m_pTk->get_line_number(),
+                                                               m_pArena) );
             m_state = A3_ProcessingParameter;
             break;
         case tkString:
             m_curNode->append_child( m_pLdpFactory->new_string(m_pTk->get_value(),
-                                                               m_pTk->get_line_number()) );
+                                                               m_pTk->get_line_number(),
+                                                               m_pArena) );
             m_state = A3_ProcessingParameter;
             break;
         case tkStartOfElement:
@@ -292,11 +307,11 @@ void LdpParser::replace_current_tag()
     //    newname = "tied";
 
     //create the replacement node
-    m_curNode = m_pLdpFactory->create(newname, m_pTk->get_line_number());
+    m_curNode = m_pLdpFactory->create(newname, m_pTk->get_line_number(), m_pArena);
 
     //add parameter
-    m_curNode->append_child( m_pLdpFactory->new_label("no",
-                                                      m_pTk->get_line_number()) );
+    m_curNode->append_child( m_pLdpFactory->new_label("no", m_pTk->get_line_number(),
+                                                      m_pArena) );
 
     //close node
     terminate_current_parameter();
@@ -26,6 +26,7 @@
 #include "lomse_im_figured_bass.h"
 #include "lomse_ldp_elements.h"
 #include "lomse_linker.h"
+#include "lomse_profiler.h"
 #include "lomse_injectors.h"
 #include "lomse_events.h"
 #include "lomse_im_factory.h"
@@ -5846,6 +5847,7 @@ ImoObj* LmdAnalyser::analyse_tree_and_get_object(XmlNode* root)
 //---------------------------------------------------------------------------------------
 ImoObj* LmdAnalyser::analyse_tree(XmlNode* tree, const string& locator)
 {
+    ProfilerScope scope("LmdAnalyser::analyse_tree");
     m_fileLocator = locator;
     return analyse_tree_and_get_object(tree);
 }
@@ -9,6 +9,8 @@
 
 #include "lomse_ldp_elements.h"
 
+#include <cstdlib>
+#include <new>
 #include <sstream>
 #include "lomse_internal_model.h"
 
@@ -17,10 +19,110 @@ using namespace std;
 namespace lomse
 {
 
+//=======================================================================================
+// LdpArena implementation
+//=======================================================================================
+
+//size of the blocks requested to the heap
+static const size_t k_arena_block_size = 64 * 1024;
+
+//---------------------------------------------------------------------------------------
+LdpArena::LdpArena()
+    : m_pFree(nullptr)
+    , m_available(0)
+    , m_numRefs(1)
+{
+}
+
+//---------------------------------------------------------------------------------------
+LdpArena::~LdpArena()
+{
+    for (char* pBlock : m_blocks)
+        free(pBlock);
+}
+
+//---------------------------------------------------------------------------------------
+void* LdpArena::allocate(size_t size)
+{
+    const size_t align = alignof(std::max_align_t);
+    size = (size + align - 1) & ~(align - 1);
+    if (size > m_available)
+    {
+        size_t blockSize = max(size, k_arena_block_size);
+        char* pBlock = static_cast<char*>( malloc(blockSize) );
+        if (!pBlock)
+            throw std::bad_alloc();
+        m_blocks.push_back(pBlock);
+        m_pFree = pBlock;
+        m_available = blockSize;
+    }
+    void* p = m_pFree;
+    m_pFree += size;
+    m_available -= size;
+    return p;
+}
+
+//---------------------------------------------------------------------------------------
+void LdpArena::release()
+{
+    if (--m_numRefs == 0)
+        delete this;
+}
+
+
+//=======================================================================================
+// LdpElement implementation
+//=======================================================================================
+
+//Each element is preceded by a header with a pointer to the arena in which it was
+//allocated, or nullptr when allocated in the heap. The header size preserves the
+//alignment of the element.
+static const size_t k_header_size = alignof(std::max_align_t);
+
+static const std::string k_no_name = "";
+
+//---------------------------------------------------------------------------------------
+void* LdpElement::operator new(size_t size)
+{
+    char* p = static_cast<char*>( ::operator new(k_header_size + size) );
+    *reinterpret_cast<LdpArena**>(p) = nullptr;
+    return p + k_header_size;
+}
+
+//---------------------------------------------------------------------------------------
+void* LdpElement::operator new(size_t size, LdpArena* pArena)
+{
+    char* p = static_cast<char*>( pArena->allocate(k_header_size + size) );
+    *reinterpret_cast<LdpArena**>(p) = pArena;
+    pArena->add_ref();
+    return p + k_header_size;
+}
+
+//---------------------------------------------------------------------------------------
+void LdpElement::operator delete(void* p)
+{
+    if (!p)
+        return;
+
+    char* pHeader = static_cast<char*>(p) - k_header_size;
+    LdpArena* pArena = *reinterpret_cast<LdpArena**>(pHeader);
+    if (pArena)
+        pArena->release();
+    else
+        ::operator delete(pHeader);
+}
+
+//---------------------------------------------------------------------------------------
+void LdpElement::operator delete(void* p, LdpArena* UNUSED(pArena))
+{
+    //only invoked when the constructor throws
+    LdpElement::operator delete(p);
+}
+
 //---------------------------------------------------------------------------------------
 LdpElement::LdpElement()
     : m_type(k_undefined)
-    , m_name("")
+    , m_pName(&k_no_name)
     , m_fSimple(false)
     , m_numLine(0)
     , m_id(k_no_imoid)
@@ -90,7 +192,7 @@ std::string LdpElement::to_string()
 	    s << get_ldp_value();
     else
     {
-	    s << "(" << m_name;
+	    s << "(" << *m_pName;
         if (has_children())
         {
             TreeNode<LdpElement>::children_iterator it(this);
@@ -113,7 +215,7 @@ std::string LdpElement::to_string_with_ids()
 	    s << get_ldp_value();
     else
     {
-        s << "(" << m_name << "#" << m_id;
+        s << "(" << *m_pName << "#" << m_id;
         if (has_children())
         {
             TreeNode<LdpElement>::children_iterator it(this);
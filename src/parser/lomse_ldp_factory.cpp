@@ -23,7 +23,8 @@ class LdpFunctor
 public:
 	LdpFunctor() {}
 	virtual ~LdpFunctor() {}
-    virtual LdpElement* operator ()() = 0;
+    virtual LdpElement* operator ()(LdpArena* pArena) = 0;
+    virtual ELdpElement get_type() = 0;
 };
 
 
@@ -31,7 +32,10 @@ template<ELdpElement type>
 class LdpElementFunctor : public LdpFunctor
 {
 public:
-	LdpElement* operator ()() override {  return LdpObject<type>::new_ldp_object(); }
+	LdpElement* operator ()(LdpArena* pArena) override {
+        return LdpObject<type>::new_ldp_object(pArena);
+    }
+    ELdpElement get_type() override { return type; }
 };
 
 
@@ -453,40 +457,55 @@ LdpFactory::LdpFactory()
     m_NameToFunctor["width"] = LOMSE_NEW LdpElementFunctor<k_width>;
     m_NameToFunctor["yes"] = LOMSE_NEW LdpElementFunctor<k_yes>;
 
+    //direct access by type. Types whose name is not registered are created as
+    //undefined elements
+    const NameToFunctorMap::value_type* pUndefined = &(*m_NameToFunctor.find("undefined"));
+    m_TypeToEntry.assign(eElmLast, nullptr);
+	map<ELdpElement, std::string>::const_iterator it;
+    for (it = m_TypeToName.begin(); it != m_TypeToName.end(); ++it)
+    {
+        NameToFunctorMap::const_iterator itF = m_NameToFunctor.find(it->second);
+        m_TypeToEntry[it->first] = (itF != m_NameToFunctor.end() ? &(*itF) : pUndefined);
+    }
 }
 
 LdpFactory::~LdpFactory()
 {
-	map<std::string, LdpFunctor*>::const_iterator it;
+	NameToFunctorMap::const_iterator it;
     for (it = m_NameToFunctor.begin(); it != m_NameToFunctor.end(); ++it)
         delete it->second;
 }
 
-LdpElement* LdpFactory::create(const std::string& name, int numLine) const
+LdpElement* LdpFactory::create(const std::string& name, int numLine,
+                               LdpArena* pArena) const
 {
-	map<std::string, LdpFunctor*>::const_iterator it
-        = m_NameToFunctor.find(name);
+	NameToFunctorMap::const_iterator it = m_NameToFunctor.find(name);
 	if (it != m_NameToFunctor.end())
     {
 		LdpFunctor* f = it->second;
-		LdpElement* element = (*f)();
-		element->set_name(name);
+		LdpElement* element = (*f)(pArena);
+		element->set_name(&it->first);
         element->set_num_line(numLine);
 		return element;
 	}
     else
     {
-        LdpElement* element = create(k_undefined, numLine);
+        LdpElement* element = create(k_undefined, numLine, pArena);
 		//element->set_name(name);
         return element;
     }
 }
 
-LdpElement* LdpFactory::create(ELdpElement type, int numLine) const
+LdpElement* LdpFactory::create(ELdpElement type, int numLine, LdpArena* pArena) const
 {
-	map<ELdpElement, std::string>::const_iterator it = m_TypeToName.find( type );
-	if (it != m_TypeToName.end())
-		return create(it->second, numLine);
+    if (type >= eElmFirst && type < eElmLast && m_TypeToEntry[type])
+    {
+        const NameToFunctorMap::value_type* pEntry = m_TypeToEntry[type];
+		LdpElement* element = (*pEntry->second)(pArena);
+		element->set_name(&pEntry->first);
+        element->set_num_line(numLine);
+		return element;
+    }
 
     std::stringstream err;
     err << "[LdpFactory::create] invoked with unknown type \""
@@ -496,6 +515,12 @@ LdpElement* LdpFactory::create(ELdpElement type, int numLine) const
 	return 0;
 }
 
+ELdpElement LdpFactory::get_type(const std::string& name) const
+{
+	NameToFunctorMap::const_iterator it = m_NameToFunctor.find(name);
+	return (it != m_NameToFunctor.end() ? it->second->get_type() : k_undefined);
+}
+
 const std::string& LdpFactory::get_name(ELdpElement type) const
 {
 	map<ELdpElement, std::string>::const_iterator it = m_TypeToName.find( type );
@@ -12,8 +12,10 @@
 #include "lomse_file_system.h"
 
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 using namespace std;
 
 
@@ -21,86 +23,60 @@ namespace lomse
 {
 
 //=======================================================================================
-// LdpFileReader implementation
+// LdpReader implementation
 //=======================================================================================
-LdpFileReader::LdpFileReader(const std::string& filelocator)
-    : LdpReader()
-    , m_file( FileSystem::open_input_stream(filelocator) )
-    , m_locator(filelocator)
-    , m_numLine(1)
-    , m_repeating_last_char(false)
+void LdpReader::set_buffer(const std::string& source, bool fCountLines)
 {
-}
-//---------------------------------------------------------------------------------------
-LdpFileReader::~LdpFileReader()
-{
-    delete m_file;
+    m_pBuffer = source.data();
+    m_bufferSize = source.size();
+    m_pos = 0;
+    m_fCountLines = fCountLines;
+    m_numLine = (fCountLines ? 1 : 0);
+    m_fRepeatingLastChar = false;
 }
 
-//---------------------------------------------------------------------------------------
-char LdpFileReader::get_next_char()
-{
-    char ch = m_file->get_char();
-    if (!m_repeating_last_char && ch == 0x0a)
-        m_numLine++;
-    m_repeating_last_char = false;
-    return ch;
-}
 
-//---------------------------------------------------------------------------------------
-void LdpFileReader::repeat_last_char()
-{
-    m_repeating_last_char = true;
-    m_file->unget();
-}
-
-//---------------------------------------------------------------------------------------
-bool LdpFileReader::is_ready()
-{
-    return m_file->is_open();
-}
 
-//---------------------------------------------------------------------------------------
-bool LdpFileReader::end_of_data()
+//=======================================================================================
+// LdpFileReader implementation
+//=======================================================================================
+LdpFileReader::LdpFileReader(const std::string& filelocator)
+    : LdpReader()
+    , m_locator(filelocator)
+    , m_fOpen(false)
 {
-    return m_file->eof();
+    //the whole file is read at once, so that the tokenizer can work on a contiguous
+    //buffer instead of reading the stream char by char
+    unique_ptr<InputStream> file( FileSystem::open_input_stream(filelocator) );
+    m_fOpen = file->is_open();
+    if (m_fOpen)
+    {
+        //AWARE: streams can return less bytes than requested before the end (e.g. zip
+        //streams return one decompression buffer) and zip streams do not allow to read
+        //after the end. Therefore, loop until eof() instead of checking the returned size
+        const long chunkSize = 65536;
+        vector<unsigned char> chunk(chunkSize);
+        while (!file->eof())
+        {
+            long numBytes = file->read(&chunk[0], chunkSize);
+            if (numBytes <= 0)
+                break;
+            m_source.append(reinterpret_cast<char*>(&chunk[0]), size_t(numBytes));
+        }
+    }
+    set_buffer(m_source, true);
 }
 
 
 
-
 //=======================================================================================
 // LdpTextReader implementation
 //=======================================================================================
-
 LdpTextReader::LdpTextReader(const std::string& sourceText)
     : LdpReader()
-    , m_stream(sourceText)
-{
-}
-
-//---------------------------------------------------------------------------------------
-char LdpTextReader::get_next_char()
-{
-    return m_stream.get();
-}
-
-//---------------------------------------------------------------------------------------
-void LdpTextReader::repeat_last_char()
-{
-    m_stream.unget();
-}
-
-//---------------------------------------------------------------------------------------
-bool LdpTextReader::is_ready()
-{
-    return true;
-}
-
-//---------------------------------------------------------------------------------------
-bool LdpTextReader::end_of_data()
+    , m_source(sourceText)
 {
-    return m_stream.peek() == EOF;
+    set_buffer(m_source, false);
 }
 
 
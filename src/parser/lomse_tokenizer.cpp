@@ -69,6 +69,7 @@ LdpTokenizer::LdpTokenizer(LdpReader& reader, ostream& reporter)
     , m_expectingValuePart(false)
     , m_expectingNamePart(false)
     , m_pTokenNamePart(nullptr)
+    , m_fBuffered(reader.is_buffered())
 {
 }
 
@@ -88,7 +89,7 @@ void LdpTokenizer::skip_utf_bom()
         curChar = get_next_char();  // 0xbf
     }
     else
-        m_reader.repeat_last_char();
+        repeat_last_char();
 }
 
 //---------------------------------------------------------------------------------------
@@ -138,9 +139,9 @@ LdpToken* LdpTokenizer::read_token()
     // loop until a token is found
     while(true)
     {
-        if (m_reader.end_of_data())
+        if (end_of_data())
         {
-            m_pToken = LOMSE_NEW LdpToken(tkEndOfFile, "", m_reader.get_line_number());
+            m_pToken = LOMSE_NEW LdpToken(tkEndOfFile, "", get_line_number());
             return m_pToken;
         }
 
@@ -182,7 +183,7 @@ LdpToken* LdpTokenizer::parse_new_token()
     };
 
     EAutomataState state = k_Start;
-    stringstream tokendata;
+    string tokendata;
     char curChar = 0;
     int numLine = 0;
 
@@ -192,7 +193,7 @@ LdpToken* LdpTokenizer::parse_new_token()
         {
             case k_Start:
                 curChar = get_next_char();
-                numLine = m_reader.get_line_number();
+                numLine = get_line_number();
                 if (is_letter(curChar)
                     || curChar == chOpenBracket
                     || curChar == chBar
@@ -246,7 +247,7 @@ LdpToken* LdpTokenizer::parse_new_token()
                 break;
 
             case k_ETQ01:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (is_letter(curChar) || is_number(curChar) ||
                     curChar == chUnderscore || curChar == chDot ||
@@ -261,12 +262,12 @@ LdpToken* LdpTokenizer::parse_new_token()
                     // compact notation [ name:value --> (name value) ]
                     // 'name' part is parsed and we've found the ':' sign
                     m_expectingNamePart = true;
-                    m_pTokenNamePart = LOMSE_NEW LdpToken(tkLabel, tokendata.str(), numLine);
+                    m_pTokenNamePart = LOMSE_NEW LdpToken(tkLabel, tokendata, numLine);
                     return LOMSE_NEW LdpToken(tkStartOfElement, chOpenParenthesis, numLine);
                 }
                 else {
-                    m_reader.repeat_last_char();
-                    return LOMSE_NEW LdpToken(tkLabel, tokendata.str(), numLine);
+                    repeat_last_char();
+                    return LOMSE_NEW LdpToken(tkLabel, tokendata, numLine);
                 }
                 break;
 
@@ -292,7 +293,7 @@ LdpToken* LdpTokenizer::parse_new_token()
             case k_STR00:
                 curChar = get_next_char();
                 if (curChar == chQuotes) {
-                    return LOMSE_NEW LdpToken(tkString, tokendata.str(), numLine);
+                    return LOMSE_NEW LdpToken(tkString, tokendata, numLine);
                 } else {
                     if (curChar == nEOF) {
                         state = k_Error;
@@ -303,10 +304,10 @@ LdpToken* LdpTokenizer::parse_new_token()
                 break;
 
             case k_STR01:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chQuotes) {
-                    return LOMSE_NEW LdpToken(tkString, tokendata.str(), numLine);
+                    return LOMSE_NEW LdpToken(tkString, tokendata, numLine);
                 } else {
                     if (curChar == nEOF) {
                         state = k_Error;
@@ -326,7 +327,7 @@ LdpToken* LdpTokenizer::parse_new_token()
                 break;
 
             case k_STR02:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chApostrophe) {
                     state = k_STR03;
@@ -338,14 +339,14 @@ LdpToken* LdpTokenizer::parse_new_token()
             case k_STR03:
                 curChar = get_next_char();
                 if (curChar == chApostrophe) {
-                    return LOMSE_NEW LdpToken(tkString, tokendata.str(), numLine);
+                    return LOMSE_NEW LdpToken(tkString, tokendata, numLine);
                 } else {
                     state = k_STR02;
                 }
                 break;
 
             case k_CMT01:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chSlash)
                     state = k_CMT02;
@@ -356,16 +357,16 @@ LdpToken* LdpTokenizer::parse_new_token()
                 break;
 
             case k_CMT02:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chLF || curChar == nEOF) {
-                    return LOMSE_NEW LdpToken(tkComment, tokendata.str(), numLine);
+                    return LOMSE_NEW LdpToken(tkComment, tokendata, numLine);
                 }
                 //else continue in this state
                 break;
 
             case k_CMT03:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chAsterisk || curChar == nEOF) {
                     state = k_CMT04;
@@ -374,18 +375,18 @@ LdpToken* LdpTokenizer::parse_new_token()
                 break;
 
             case k_CMT04:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chSlash || curChar == nEOF) {
-                    tokendata << curChar;
-                    return LOMSE_NEW LdpToken(tkComment, tokendata.str(), numLine);
+                    tokendata += curChar;
+                    return LOMSE_NEW LdpToken(tkComment, tokendata, numLine);
                 }
                 else
                     state = k_CMT03;
                 break;
 
             case k_NUM01:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (is_number(curChar)) {
                     state = k_NUM01;
@@ -394,19 +395,19 @@ LdpToken* LdpTokenizer::parse_new_token()
                 } else if (is_letter(curChar) || curChar == chUnderscore) {
                     state = k_ETQ01;
                 } else {
-                    m_reader.repeat_last_char();
-                    return LOMSE_NEW LdpToken(tkIntegerNumber, tokendata.str(), numLine);
+                    repeat_last_char();
+                    return LOMSE_NEW LdpToken(tkIntegerNumber, tokendata, numLine);
                 }
                 break;
 
             case k_NUM02:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (is_number(curChar)) {
                     state = k_NUM02;
                 } else {
-                    m_reader.repeat_last_char();
-                    return LOMSE_NEW LdpToken(tkRealNumber, tokendata.str(), numLine);
+                    repeat_last_char();
+                    return LOMSE_NEW LdpToken(tkRealNumber, tokendata, numLine);
                 }
                 break;
 
@@ -415,21 +416,21 @@ LdpToken* LdpTokenizer::parse_new_token()
                 if (curChar == chSpace || curChar == chTab) {
                     state = k_SPC01;
                 } else {
-                    m_reader.repeat_last_char();
+                    repeat_last_char();
                     return LOMSE_NEW LdpToken(tkSpaces, chSpace, numLine);
                 }
                 break;
 
             case k_S01:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chSpace || curChar == chTab) {
-                    return LOMSE_NEW LdpToken(tkLabel, tokendata.str(), numLine);
+                    return LOMSE_NEW LdpToken(tkLabel, tokendata, numLine);
                 }
                 else if (curChar == chCloseParenthesis)
                 {
-                    m_reader.repeat_last_char();
-                    return LOMSE_NEW LdpToken(tkLabel, tokendata.str(), numLine);
+                    repeat_last_char();
+                    return LOMSE_NEW LdpToken(tkLabel, tokendata, numLine);
                 }
                 else if (is_number(curChar)) {
                     state = k_NUM01;
@@ -467,31 +468,46 @@ LdpToken* LdpTokenizer::parse_new_token()
 //---------------------------------------------------------------------------------------
 char LdpTokenizer::get_next_char()
 {
-    char ch = m_reader.get_next_char();
+    //when the reader has all the source in a buffer, chars are taken directly from it
+    char ch = (m_fBuffered ? m_reader.buffer_get_next_char()
+                           : m_reader.get_next_char());
     if (ch == chTab || ch == chCR)
         return ' ';
     else
         return ch;
 }
 
+//---------------------------------------------------------------------------------------
+void LdpTokenizer::repeat_last_char()
+{
+    if (m_fBuffered)
+        m_reader.buffer_repeat_last_char();
+    else
+        m_reader.repeat_last_char();
+}
+
+//---------------------------------------------------------------------------------------
+bool LdpTokenizer::end_of_data()
+{
+    return (m_fBuffered ? m_reader.buffer_end_of_data() : m_reader.end_of_data());
+}
+
 //---------------------------------------------------------------------------------------
 bool LdpTokenizer::is_letter(char ch)
 {
-    static const std::string letters("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz");
-    return (letters.find(ch) != string::npos);
+    return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z');
 }
 
 //---------------------------------------------------------------------------------------
 bool LdpTokenizer::is_number(char ch)
 {
-    static const std::string numbers("0123456789");
-    return (numbers.find(ch) != string::npos);
+    return (ch >= '0' && ch <= '9');
 }
 
 //---------------------------------------------------------------------------------------
 int LdpTokenizer::get_line_number()
 {
-    return m_reader.get_line_number();
+    return (m_fBuffered ? m_reader.buffer_line_number() : m_reader.get_line_number());
 }
 
 
@@ -9,6 +9,9 @@
 
 #include "lomse_xml_parser.h"
 
+#include "lomse_file_system.h"
+#include "lomse_profiler.h"
+
 #include <iostream>
 #include <ostream>
 #include <sstream>
@@ -88,6 +91,10 @@ string XmlNode::value()
 
     if (m_node.type() == pugi::node_element)
     {
+        //when parsing with parse_embed_pcdata, the text is in the element node
+        if (*m_node.value() != 0)
+            return string(m_node.value());
+
         pugi::xml_node child = m_node.first_child();
         return string(child.value());
     }
@@ -110,6 +117,7 @@ XmlParser::XmlParser(ostream& reporter)
     , m_root()
     , m_errorOffset(0)
     , m_fOffsetDataReady(false)
+    , m_fEmbedPcdata(false)
 {
 }
 
@@ -118,6 +126,26 @@ XmlParser::~XmlParser()
 {
 }
 
+//---------------------------------------------------------------------------------------
+void XmlParser::clear()
+{
+    //the document must be released before the mapped file it is using
+    m_doc.reset();
+    m_root = XmlNode();
+    m_pMappedFile.reset();
+    std::vector<unsigned char>().swap(m_buffer);
+}
+
+//---------------------------------------------------------------------------------------
+unsigned int XmlParser::get_parse_options()
+{
+    return pugi::parse_default
+           //| pugi::parse_trim_pcdata
+           //| pugi::parse_wnorm_attribute
+           | pugi::parse_declaration
+           | (m_fEmbedPcdata ? pugi::parse_embed_pcdata : 0);
+}
+
 //---------------------------------------------------------------------------------------
 void XmlParser::parse_text(const std::string& sourceText)
 {
@@ -133,14 +161,26 @@ void XmlParser::parse_cstring(char* sourceText)
 //---------------------------------------------------------------------------------------
 void XmlParser::parse_file(const std::string& filename, bool UNUSED(fErrorMsg))
 {
+    ProfilerScope scope("XmlParser::parse");
     m_fOffsetDataReady = false;
     m_filename = filename;
-    pugi::xml_parse_result result = m_doc.load_file(filename.c_str(),
-                                                    (pugi::parse_default |
-                                                     //pugi::parse_trim_pcdata |
-                                                     //pugi::parse_wnorm_attribute |
-                                                     pugi::parse_declaration)
-                                                   );
+    clear();
+
+    //The file is mapped in memory and parsed in place, instead of being copied into
+    //a buffer owned by pugixml. The mapping is kept until the tree is released.
+    unsigned int options = get_parse_options();
+    pugi::xml_parse_result result;
+    m_pMappedFile.reset( LOMSE_NEW MappedFile(filename) );
+    if (m_pMappedFile->is_open())
+    {
+        result = m_doc.load_buffer_inplace(m_pMappedFile->data(), m_pMappedFile->size(),
+                                           options);
+    }
+    else
+    {
+        m_pMappedFile.reset();
+        result = m_doc.load_file(filename.c_str(), options);
+    }
 
     if (!result)
     {
@@ -155,13 +195,11 @@ void XmlParser::parse_file(const std::string& filename, bool UNUSED(fErrorMsg))
 //---------------------------------------------------------------------------------------
 void XmlParser::parse_char_string(char* str)
 {
+    ProfilerScope scope("XmlParser::parse");
     m_fOffsetDataReady = false;
     m_filename.clear();
-    pugi::xml_parse_result result = m_doc.load_string(str, (pugi::parse_default |
-                                                            //pugi::parse_trim_pcdata |
-                                                            //pugi::parse_wnorm_attribute |
-                                                            pugi::parse_declaration)
-                                                     );
+    clear();
+    pugi::xml_parse_result result = m_doc.load_string(str, get_parse_options());
 
     if (!result)
     {
@@ -175,14 +213,35 @@ void XmlParser::parse_char_string(char* str)
 //---------------------------------------------------------------------------------------
 void XmlParser::parse_buffer(const void* buffer, size_t size)
 {
+    ProfilerScope scope("XmlParser::parse");
     m_fOffsetDataReady = false;
     m_filename.clear();
+    clear();
     pugi::xml_parse_result result = m_doc.load_buffer(buffer, size,
-                                                      (pugi::parse_default |
-                                                       //pugi::parse_trim_pcdata |
-                                                       //pugi::parse_wnorm_attribute |
-                                                       pugi::parse_declaration)
-                                                     );
+                                                      get_parse_options());
+
+    if (!result)
+    {
+        m_errorMsg = string(result.description());
+        m_errorOffset = int(result.offset);
+        m_reporter << "Pos: " << m_errorOffset << ". Error: " << m_errorMsg << endl;
+    }
+    find_root();
+}
+
+//---------------------------------------------------------------------------------------
+void XmlParser::parse_buffer_inplace(std::vector<unsigned char>&& buffer)
+{
+    ProfilerScope scope("XmlParser::parse");
+    //The parser takes ownership of the buffer and parses it in place, instead of
+    //copying it into a buffer owned by pugixml. It is kept until the tree is released.
+    m_fOffsetDataReady = false;
+    m_filename.clear();
+    clear();
+    m_buffer = std::move(buffer);
+    pugi::xml_parse_result result = m_doc.load_buffer_inplace(m_buffer.data(),
+                                                              m_buffer.size(),
+                                                              get_parse_options());
 
     if (!result)
     {
@@ -19,6 +19,7 @@
 #include "lomse_im_figured_bass.h"
 #include "lomse_ldp_elements.h"
 #include "lomse_linker.h"
+#include "lomse_profiler.h"
 #include "lomse_injectors.h"
 #include "lomse_events.h"
 #include "lomse_im_factory.h"
@@ -4828,6 +4829,7 @@ ImoObj* MnxAnalyser::analyse_tree_and_get_object(XmlNode* root)
 //---------------------------------------------------------------------------------------
 ImoObj* MnxAnalyser::analyse_tree(XmlNode* tree, const string& locator)
 {
+    ProfilerScope scope("MnxAnalyser::analyse_tree");
     m_fileLocator = locator;
     return analyse_tree_and_get_object(tree);
 }
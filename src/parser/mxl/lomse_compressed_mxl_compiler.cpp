@@ -42,7 +42,7 @@ ImoDocument* CompressedMxlCompiler::compile_file(const std::string& filename)
 #if (LOMSE_ENABLE_COMPRESSION == 1)
     ZipInputStream zip(filename);
 
-    const std::vector<unsigned char> mxmlBuffer = read_rootfile(zip);
+    std::vector<unsigned char> mxmlBuffer = read_rootfile(zip);
 
     if (mxmlBuffer.empty())
     {
@@ -50,7 +50,8 @@ ImoDocument* CompressedMxlCompiler::compile_file(const std::string& filename)
         return nullptr;
     }
 
-    return m_pMxlCompiler->compile_buffer(static_cast<const void*>(mxmlBuffer.data()), mxmlBuffer.size());
+    //the inflated rootfile is parsed in place and freed with the XML tree
+    return m_pMxlCompiler->compile_buffer( std::move(mxmlBuffer) );
 #else
     throw runtime_error("Could not open compressed file: Lomse was compiled without compression support");
 #endif
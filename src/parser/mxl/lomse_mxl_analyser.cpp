@@ -19,6 +19,7 @@
 #include "lomse_im_figured_bass.h"
 #include "lomse_ldp_elements.h"
 #include "lomse_linker.h"
+#include "lomse_profiler.h"
 #include "lomse_injectors.h"
 #include "lomse_events.h"
 #include "lomse_im_factory.h"
@@ -30,6 +31,8 @@
 #include "lomse_time.h"
 #include "lomse_autobeamer.h"
 #include "lomse_im_attributes.h"
+#include "lomse_id_assigner.h"
+#include "lomse_build_options.h"
 
 
 #include <iostream>
@@ -39,8 +42,16 @@
     #include <locale>
 #endif
 #include <vector>
-#include <algorithm>   // for find
+#include <set>
+#include <algorithm>   // for find, lower_bound
+#include <cstring>     // for strcmp
 #include <regex>
+#include <memory>
+#if (LOMSE_ENABLE_THREADS == 1)
+    #include <atomic>
+    #include <exception>
+    #include <thread>
+#endif
 using namespace std;
 
 #define LOMSE_TRACE_GOBACK  0
@@ -479,6 +490,93 @@ enum EMxlTag
     k_mxl_tag_virtual_instr,
     k_mxl_tag_wedge,
     k_mxl_tag_words,
+
+    k_mxl_tag_max,      //number of tags. Must be the last one
+};
+
+//conversion from xml element name to enum. The table must be sorted by name, as
+//MxlAnalyser::name_to_enum() uses a binary search on it
+struct MxlTagName
+{
+    const char* name;
+    int tag;
+};
+
+static const MxlTagName mxlTagNames[] = {
+    { "accordion-registration",   k_mxl_tag_accordion_registration },
+    { "arpeggiate",               k_mxl_tag_arpeggiate },
+    { "articulations",            k_mxl_tag_articulations },
+    { "attributes",               k_mxl_tag_attributes },
+    { "backup",                   k_mxl_tag_backup },
+    { "barline",                  k_mxl_tag_barline },
+    { "bracket",                  k_mxl_tag_bracket },
+    { "clef",                     k_mxl_tag_clef },
+    { "coda",                     k_mxl_tag_coda },
+    { "damp",                     k_mxl_tag_damp },
+    { "damp-all",                 k_mxl_tag_damp_all },
+    { "dashes",                   k_mxl_tag_dashes },
+    { "defaults",                 k_mxl_tag_defaults },
+    { "direction",                k_mxl_tag_direction },
+    { "direction-type",           k_mxl_tag_direction_type },
+    { "dynamics",                 k_mxl_tag_dynamics },
+    { "ending",                   k_mxl_tag_ending },
+    { "eyeglasses",               k_mxl_tag_eyeglasses },
+    { "fermata",                  k_mxl_tag_fermata },
+    { "fingering",                k_mxl_tag_fingering },
+    { "forward",                  k_mxl_tag_forward },
+    { "fret",                     k_mxl_tag_fret },
+    { "harp-pedals",              k_mxl_tag_harp_pedals },
+    { "image",                    k_mxl_tag_image },
+    { "key",                      k_mxl_tag_key },
+    { "lyric",                    k_mxl_tag_lyric },
+    { "measure",                  k_mxl_tag_measure },
+    { "metronome",                k_mxl_tag_metronome },
+    { "midi-device",              k_mxl_tag_midi_device },
+    { "midi-instrument",          k_mxl_tag_midi_instrument },
+    { "notations",                k_mxl_tag_notations },
+    { "note",                     k_mxl_tag_note },
+    { "octave-shift",             k_mxl_tag_octave_shift },
+    { "ornaments",                k_mxl_tag_ornaments },
+    { "page-layout",              k_mxl_tag_page_layout },
+    { "page-margins",             k_mxl_tag_page_margins },
+    { "part",                     k_mxl_tag_part },
+    { "part-group",               k_mxl_tag_part_group },
+    { "part-list",                k_mxl_tag_part_list },
+    { "part-name",                k_mxl_tag_part_name },
+    { "pedal",                    k_mxl_tag_pedal },
+    { "percussion",               k_mxl_tag_percussion },
+    { "pitch",                    k_mxl_tag_pitch },
+    { "principal-voice",          k_mxl_tag_principal_voice },
+    { "print",                    k_mxl_tag_print },
+    { "rehearsal",                k_mxl_tag_rehearsal },
+    { "rest",                     k_mxl_tag_rest },
+    { "scaling",                  k_mxl_tag_scaling },
+    { "scordatura",               k_mxl_tag_scordatura },
+    { "score-instrument",         k_mxl_tag_score_instrument },
+    { "score-part",               k_mxl_tag_score_part },
+    { "score-partwise",           k_mxl_tag_score_partwise },
+    { "segno",                    k_mxl_tag_segno },
+    { "slur",                     k_mxl_tag_slur },
+    { "sound",                    k_mxl_tag_sound },
+    { "staff-details",            k_mxl_tag_staff_details },
+    { "staff-layout",             k_mxl_tag_staff_layout },
+    { "string",                   k_mxl_tag_string },
+    { "string-mute",              k_mxl_tag_string_mute },
+    { "system-layout",            k_mxl_tag_system_layout },
+    { "system-margins",           k_mxl_tag_system_margins },
+    { "technical",                k_mxl_tag_technical },
+    { "text",                     k_mxl_tag_text },
+    { "tied",                     k_mxl_tag_tied },
+    { "time",                     k_mxl_tag_time },
+    { "time-modification",        k_mxl_tag_time_modification },
+    { "transpose",                k_mxl_tag_transpose },
+    { "tuplet",                   k_mxl_tag_tuplet },
+    { "tuplet-actual",            k_mxl_tag_tuplet_actual },
+    { "tuplet-normal",            k_mxl_tag_tuplet_normal },
+    { "unpitched",                k_mxl_tag_unpitched },
+    { "virtual-instrument",       k_mxl_tag_virtual_instr },
+    { "wedge",                    k_mxl_tag_wedge },
+    { "words",                    k_mxl_tag_words },
 };
 
 
@@ -2386,6 +2484,7 @@ public:
                 if (m_pAnalyser->staff_distance_is_imported(iStaff))
                     pInstr->mark_staff_margin_as_imported(iStaff);
             }
+            m_pAnalyser->first_staff_margin_replaced(pInstr);
         }
 
         // part-symbol?
@@ -2495,6 +2594,8 @@ protected:
             ImoStaffInfo* pOldInfo = pInstr->get_staff(iStaff);
             pInfo->set_tablature( pOldInfo->is_for_tablature() );
             pInstr->replace_staff_info(pInfo);
+            if (iStaff == 0)
+                m_pAnalyser->first_staff_margin_replaced(pInstr);
         }
     }
 };
@@ -5575,6 +5676,8 @@ public:
 
     ImoObj* do_analysis() override
     {
+        ProfilerScope scope("MxlAnalyser::analyse_part");
+
         //attrb: id
         string id = get_optional_string_attribute("id", "");
         if (id.empty())
@@ -6230,7 +6333,7 @@ protected:
 
     void set_symbol(ImoInstrGroup* pGrp)
     {
-        string symbol = m_childToAnalyse.first_child().value();
+        string symbol = m_childToAnalyse.value();
         if (symbol == "brace")
             pGrp->set_symbol(k_group_symbol_brace);
         else if (symbol == "bracket")
@@ -6274,7 +6377,8 @@ protected:
 class PartListMxlAnalyser : public MxlElementAnalyser
 {
 public:
-    PartListMxlAnalyser(MxlAnalyser* pAnalyser, ostream& reporter, LibraryScope& libraryScope)
+    PartListMxlAnalyser(MxlAnalyser* pAnalyser, ostream& reporter, LibraryScope& libraryScope,
+                        ImoObj* UNUSED(pAnchor)=nullptr)
         : MxlElementAnalyser(pAnalyser, reporter, libraryScope) {}
 
     ImoObj* do_analysis() override
@@ -6835,7 +6939,8 @@ public:
 class ScorePartMxlAnalyser : public MxlElementAnalyser
 {
 public:
-    ScorePartMxlAnalyser(MxlAnalyser* pAnalyser, ostream& reporter, LibraryScope& libraryScope)
+    ScorePartMxlAnalyser(MxlAnalyser* pAnalyser, ostream& reporter, LibraryScope& libraryScope,
+                         ImoObj* UNUSED(pAnchor)=nullptr)
         : MxlElementAnalyser(pAnalyser, reporter, libraryScope) {}
 
     ImoObj* do_analysis() override
@@ -6926,7 +7031,8 @@ protected:
 class ScorePartwiseMxlAnalyser : public MxlElementAnalyser
 {
 public:
-    ScorePartwiseMxlAnalyser(MxlAnalyser* pAnalyser, ostream& reporter, LibraryScope& libraryScope)
+    ScorePartwiseMxlAnalyser(MxlAnalyser* pAnalyser, ostream& reporter, LibraryScope& libraryScope,
+                             ImoObj* UNUSED(pAnchor)=nullptr)
         : MxlElementAnalyser(pAnalyser, reporter, libraryScope) {}
 
     ImoObj* do_analysis() override
@@ -7002,7 +7108,12 @@ public:
             remove_score(pImoDoc, pScore);
             return pImoDoc;
         }
+        //independent parts can be analysed concurrently, before adding the
+        //instruments to the score. Remaining parts are analysed one by one
+        bool fConcurrent = analyse_parts_concurrently(pScore);
         add_all_instruments(pScore);
+        if (fConcurrent)
+            m_pAnalyser->add_pending_space_for_lyrics();
 
         // <part>*
         while (more_children_to_analyse())
@@ -7068,6 +7179,34 @@ protected:
         m_pAnalyser->add_all_instruments(pScore);
     }
 
+    bool analyse_parts_concurrently(ImoScore* pScore)
+    {
+        //Collect the consecutive <part> elements that will not produce errors for
+        //its id. The first one that is not valid and the following parts are not
+        //collected, so that errors are reported as when analysing them one by one
+
+        vector<XmlNode> parts;
+        set<string> ids;
+        for (XmlNode node = get_child_to_analyse(); !node.is_null();
+             node = node.next_sibling())
+        {
+            string id = get_node_attribute(&node, "id", "");
+            if (node.name() != "part" || m_pAnalyser->get_instrument(id) == nullptr
+                || !ids.insert(id).second)
+            {
+                break;
+            }
+            parts.push_back(node);
+        }
+
+        if (parts.size() < 2 || !m_pAnalyser->analyse_parts_concurrently(parts, pScore))
+            return false;
+
+        for (size_t i=0; i < parts.size(); ++i)
+            move_to_next_child();
+        return true;
+    }
+
     void check_if_missing_parts()
     {
         m_pAnalyser->check_if_missing_parts();
@@ -9189,91 +9328,41 @@ MxlAnalyser::MxlAnalyser(ostream& reporter, LibraryScope& libraryScope, Document
     , m_measuresCounter(0)
     , m_curVoice(0)
 {
-    //populate the name to enum conversion map
-    m_NameToEnum["accordion-registration"] = k_mxl_tag_accordion_registration;
-    m_NameToEnum["arpeggiate"] = k_mxl_tag_arpeggiate;
-    m_NameToEnum["articulations"] = k_mxl_tag_articulations;
-    m_NameToEnum["attributes"] = k_mxl_tag_attributes;
-    m_NameToEnum["backup"] = k_mxl_tag_backup;
-    m_NameToEnum["barline"] = k_mxl_tag_barline;
-    m_NameToEnum["bracket"] = k_mxl_tag_bracket;
-    m_NameToEnum["clef"] = k_mxl_tag_clef;
-    m_NameToEnum["coda"] = k_mxl_tag_coda;
-    m_NameToEnum["damp"] = k_mxl_tag_damp;
-    m_NameToEnum["damp-all"] = k_mxl_tag_damp_all;
-    m_NameToEnum["dashes"] = k_mxl_tag_dashes;
-    m_NameToEnum["defaults"] = k_mxl_tag_defaults;
-    m_NameToEnum["direction"] = k_mxl_tag_direction;
-    m_NameToEnum["direction-type"] = k_mxl_tag_direction_type;
-    m_NameToEnum["dynamics"] = k_mxl_tag_dynamics;
-    m_NameToEnum["ending"] = k_mxl_tag_ending;
-    m_NameToEnum["eyeglasses"] = k_mxl_tag_eyeglasses;
-    m_NameToEnum["fermata"] = k_mxl_tag_fermata;
-    m_NameToEnum["fingering"] = k_mxl_tag_fingering;
-    m_NameToEnum["forward"] = k_mxl_tag_forward;
-    m_NameToEnum["fret"] = k_mxl_tag_fret;
-    m_NameToEnum["harp-pedals"] = k_mxl_tag_harp_pedals;
-    m_NameToEnum["image"] = k_mxl_tag_image;
-    m_NameToEnum["key"] = k_mxl_tag_key;
-    m_NameToEnum["lyric"] = k_mxl_tag_lyric;
-    m_NameToEnum["measure"] = k_mxl_tag_measure;
-    m_NameToEnum["metronome"] = k_mxl_tag_metronome;
-    m_NameToEnum["midi-device"] = k_mxl_tag_midi_device;
-    m_NameToEnum["midi-instrument"] = k_mxl_tag_midi_instrument;
-    m_NameToEnum["notations"] = k_mxl_tag_notations;
-    m_NameToEnum["note"] = k_mxl_tag_note;
-    m_NameToEnum["octave-shift"] = k_mxl_tag_octave_shift;
-    m_NameToEnum["ornaments"] = k_mxl_tag_ornaments;
-    m_NameToEnum["page-layout"] = k_mxl_tag_page_layout;
-    m_NameToEnum["page-margins"] = k_mxl_tag_page_margins;
-    m_NameToEnum["part"] = k_mxl_tag_part;
-    m_NameToEnum["part-group"] = k_mxl_tag_part_group;
-    m_NameToEnum["part-list"] = k_mxl_tag_part_list;
-    m_NameToEnum["part-name"] = k_mxl_tag_part_name;
-    m_NameToEnum["pedal"] = k_mxl_tag_pedal;
-    m_NameToEnum["percussion"] = k_mxl_tag_percussion;
-    m_NameToEnum["pitch"] = k_mxl_tag_pitch;
-    m_NameToEnum["principal-voice"] = k_mxl_tag_principal_voice;
-    m_NameToEnum["print"] = k_mxl_tag_print;
-    m_NameToEnum["rehearsal"] = k_mxl_tag_rehearsal;
-    m_NameToEnum["rest"] = k_mxl_tag_rest;
-    m_NameToEnum["scaling"] = k_mxl_tag_scaling;
-    m_NameToEnum["scordatura"] = k_mxl_tag_scordatura;
-    m_NameToEnum["score-instrument"] = k_mxl_tag_score_instrument;
-    m_NameToEnum["score-part"] = k_mxl_tag_score_part;
-    m_NameToEnum["score-partwise"] = k_mxl_tag_score_partwise;
-    m_NameToEnum["segno"] = k_mxl_tag_segno;
-    m_NameToEnum["slur"] = k_mxl_tag_slur;
-    m_NameToEnum["sound"] = k_mxl_tag_sound;
-    m_NameToEnum["string-mute"] = k_mxl_tag_string_mute;
-    m_NameToEnum["staff-details"] = k_mxl_tag_staff_details;
-    m_NameToEnum["staff-layout"] = k_mxl_tag_staff_layout;
-    m_NameToEnum["string"] = k_mxl_tag_string;
-    m_NameToEnum["system-layout"] = k_mxl_tag_system_layout;
-    m_NameToEnum["system-margins"] = k_mxl_tag_system_margins;
-    m_NameToEnum["technical"] = k_mxl_tag_technical;
-    m_NameToEnum["text"] = k_mxl_tag_text;
-    m_NameToEnum["tied"] = k_mxl_tag_tied;
-    m_NameToEnum["time"] = k_mxl_tag_time;
-    m_NameToEnum["time-modification"] = k_mxl_tag_time_modification;
-    m_NameToEnum["transpose"] = k_mxl_tag_transpose;
-    m_NameToEnum["tuplet"] = k_mxl_tag_tuplet;
-    m_NameToEnum["tuplet-actual"] = k_mxl_tag_tuplet_actual;
-    m_NameToEnum["tuplet-normal"] = k_mxl_tag_tuplet_normal;
-    m_NameToEnum["unpitched"] = k_mxl_tag_unpitched;
-    m_NameToEnum["virtual-instrument"] = k_mxl_tag_virtual_instr;
-    m_NameToEnum["wedge"] = k_mxl_tag_wedge;
-    m_NameToEnum["words"] = k_mxl_tag_words;
-
+    m_analysers.resize(k_mxl_tag_max);
     m_notes.assign(50, nullptr);
 }
 
+//---------------------------------------------------------------------------------------
+MxlAnalyser::MxlAnalyser(MxlAnalyser* pParent, ostream& reporter)
+    : MxlAnalyser(reporter, pParent->m_libraryScope, pParent->m_pDoc, pParent->m_pParser)
+{
+    //Analyser for a <part> element, when the parts are analysed concurrently. It
+    //receives the information collected by the score analyser before the parts.
+    //The instruments are taken from the score analyser part-list.
+
+    m_pParent = pParent;
+    m_pTree = pParent->m_pTree;
+    m_fileLocator = pParent->m_fileLocator;
+    m_fSkipLayout = pParent->m_fSkipLayout;
+    m_musicxmlVersion = pParent->m_musicxmlVersion;
+    m_pCurScore = pParent->m_pCurScore;
+    m_pImoDoc = pParent->m_pImoDoc;
+    m_soundIdToIdx = pParent->m_soundIdToIdx;
+    m_latestMidiInfo = pParent->m_latestMidiInfo;
+    m_lyricStyle = pParent->m_lyricStyle;
+    m_lyricLang = pParent->m_lyricLang;
+    m_defaultStaffDistance = pParent->m_defaultStaffDistance;
+    m_fDefaultStaffDistanceForAllStaves = pParent->m_fDefaultStaffDistanceForAllStaves;
+
+    create_relation_builders();
+}
+
 //---------------------------------------------------------------------------------------
 MxlAnalyser::~MxlAnalyser()
 {
     delete m_pArpeggioDto;
     delete_relation_builders();
-    m_NameToEnum.clear();
+    delete_analysers();
     m_lyrics.clear();
     m_lyricIndex.clear();
     m_staffDistance.clear();
@@ -9298,7 +9387,7 @@ void MxlAnalyser::delete_relation_builders()
 }
 
 //---------------------------------------------------------------------------------------
-ImoObj* MxlAnalyser::analyse_tree_and_get_object(XmlNode* root)
+void MxlAnalyser::create_relation_builders()
 {
     delete_relation_builders();
     m_pTiesBuilder = LOMSE_NEW MxlTiesBuilder(m_reporter, this);
@@ -9309,8 +9398,15 @@ ImoObj* MxlAnalyser::analyse_tree_and_get_object(XmlNode* root)
     m_pWedgesBuilder = LOMSE_NEW MxlWedgesBuilder(m_reporter, this);
     m_pOctaveShiftBuilder = LOMSE_NEW MxlOctaveShiftBuilder(m_reporter, this);
     m_pPedalBuilder = LOMSE_NEW MxlPedalBuilder(m_reporter, this);
+}
+
+//---------------------------------------------------------------------------------------
+ImoObj* MxlAnalyser::analyse_tree_and_get_object(XmlNode* root)
+{
+    create_relation_builders();
 
     m_pTree = root;
+    m_fSkipLayout = m_libraryScope.get_musicxml_options()->skip_layout();
 //    m_curStaff = 0;
     m_curVoice = 0;
     return analyse_node(root);
@@ -9319,6 +9415,7 @@ ImoObj* MxlAnalyser::analyse_tree_and_get_object(XmlNode* root)
 //---------------------------------------------------------------------------------------
 ImoObj* MxlAnalyser::analyse_tree(XmlNode* tree, const string& locator)
 {
+    ProfilerScope scope("MxlAnalyser::analyse_tree");
     m_fileLocator = locator;
     return analyse_tree_and_get_object(tree);
 }
@@ -9327,21 +9424,74 @@ ImoObj* MxlAnalyser::analyse_tree(XmlNode* tree, const string& locator)
 ImoObj* MxlAnalyser::analyse_node(XmlNode* pNode, ImoObj* pAnchor)
 {
     //m_reporter << "DBG. Analysing node: " << pNode->name() << endl;
-    MxlElementAnalyser* a = new_analyser( pNode->name(), pAnchor );
+    const char* name = pNode->name_cstr();
+    int tag = name_to_enum(name);
+    if (m_fSkipLayout && (tag == k_mxl_tag_page_layout
+                          || tag == k_mxl_tag_system_layout
+                          || tag == k_mxl_tag_staff_layout))
+    {
+        return nullptr;
+    }
+
+    MxlElementAnalyser* a = get_analyser(tag, name, pAnchor);
     ImoObj* pImo = a->analyse_node(pNode);
-    delete a;
+    release_analyser(tag, a);
     return pImo;
 }
 
 //---------------------------------------------------------------------------------------
 bool MxlAnalyser::analyse_node_bool(XmlNode* pNode, ImoObj* pAnchor)
 {
-    MxlElementAnalyser* a = new_analyser( pNode->name(), pAnchor );
+    const char* name = pNode->name_cstr();
+    int tag = name_to_enum(name);
+    MxlElementAnalyser* a = get_analyser(tag, name, pAnchor);
     bool value = a->analyse_node_bool(pNode);
-    delete a;
+    release_analyser(tag, a);
     return value;
 }
 
+//---------------------------------------------------------------------------------------
+MxlElementAnalyser* MxlAnalyser::get_analyser(int tag, const char* name, ImoObj* pAnchor)
+{
+    //Analysers are not deleted after use but saved in a pool, one list per tag, for
+    //reusing them. Analysis is recursive and several analysers for the same tag can
+    //be in use at the same time. Therefore, a new one is created when the list is
+    //empty. A reused analyser is destroyed and constructed again in the same memory,
+    //so that it starts with a clean state.
+
+    if (tag == k_mxl_tag_undefined)
+        return new_analyser(tag, name, pAnchor);
+
+    vector<MxlElementAnalyser*>& pool = m_analysers[tag];
+    if (pool.empty())
+        return new_analyser(tag, name, pAnchor);
+
+    MxlElementAnalyser* a = pool.back();
+    pool.pop_back();
+    a->~MxlElementAnalyser();
+    return new_analyser(tag, name, pAnchor, a);
+}
+
+//---------------------------------------------------------------------------------------
+void MxlAnalyser::release_analyser(int tag, MxlElementAnalyser* a)
+{
+    if (tag == k_mxl_tag_undefined)
+        delete a;
+    else
+        m_analysers[tag].push_back(a);
+}
+
+//---------------------------------------------------------------------------------------
+void MxlAnalyser::delete_analysers()
+{
+    for (vector<MxlElementAnalyser*>& pool : m_analysers)
+    {
+        for (MxlElementAnalyser* a : pool)
+            delete a;
+        pool.clear();
+    }
+}
+
 //---------------------------------------------------------------------------------------
 int MxlAnalyser::get_line_number(XmlNode* node)
 {
@@ -9906,18 +10056,13 @@ void MxlAnalyser::add_marging_space_for_lyrics(ImoNote* pNote, ImoLyric* pLyric)
         int staves = pInstr->get_num_staves();
         if (++iStaff == staves)
         {
-            //add space to top margin of first staff in next instrument
-            //AWARE: All instruments are already created
-            int iInstr = m_pCurScore->get_instr_number_for(pInstr) + 1;
-            if (iInstr < m_pCurScore->get_num_instruments())
-            {
-                pInstr = m_pCurScore->get_instrument(iInstr);
-                pInstr->reserve_space_for_lyrics(0, space);
-            }
+            //add space to top margin of first staff in next instrument. When parts
+            //are analysed concurrently the instruments are not yet in the score and
+            //the next instrument is analysed by other thread: defer it
+            if (m_pParent)
+                m_pendingLyricsSpace.push_back( make_pair(pInstr, space) );
             else
-            {
-                ;   //TODO: Space for last staff in last instrument
-            }
+                reserve_space_for_lyrics_in_next_instrument(pInstr, space);
         }
         else
         {
@@ -9927,6 +10072,179 @@ void MxlAnalyser::add_marging_space_for_lyrics(ImoNote* pNote, ImoLyric* pLyric)
     }
 }
 
+//---------------------------------------------------------------------------------------
+void MxlAnalyser::reserve_space_for_lyrics_in_next_instrument(ImoInstrument* pInstr,
+                                                              LUnits space)
+{
+    //AWARE: All instruments are already created
+    int iInstr = m_pCurScore->get_instr_number_for(pInstr) + 1;
+    if (iInstr < m_pCurScore->get_num_instruments())
+    {
+        pInstr = m_pCurScore->get_instrument(iInstr);
+        pInstr->reserve_space_for_lyrics(0, space);
+    }
+    else
+    {
+        ;   //TODO: Space for last staff in last instrument
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void MxlAnalyser::add_pending_space_for_lyrics()
+{
+    //When parts are analysed one by one, the first staff margin set in next part
+    //replaces the space reserved when analysing previous part. Therefore, the space
+    //is not added when the next instrument margin has been replaced
+
+    for (auto& item : m_pendingLyricsSpace)
+    {
+        int iInstr = m_pCurScore->get_instr_number_for(item.first) + 1;
+        if (iInstr < m_pCurScore->get_num_instruments()
+            && m_marginReplaced.count(m_pCurScore->get_instrument(iInstr)) == 0)
+        {
+            reserve_space_for_lyrics_in_next_instrument(item.first, item.second);
+        }
+    }
+
+    m_pendingLyricsSpace.clear();
+}
+
+#if (LOMSE_ENABLE_THREADS == 1)
+//---------------------------------------------------------------------------------------
+//helper, for analyse_parts_concurrently(): number of nodes in the subtree. Text
+//embedded in element nodes (parsing with embed_pcdata) is counted as a node, so that
+//the result does not depend on the parsing options
+static ImoId count_xml_nodes(XmlNode node)
+{
+    XmlNode child = node.first_child();
+    if (child.is_null())
+        return (node.type() == XmlNode::k_node_element && !node.value().empty() ? 2 : 1);
+
+    ImoId count = 1;
+    for (; !child.is_null(); child = child.next_sibling())
+        count += count_xml_nodes(child);
+    return count;
+}
+#endif
+
+//---------------------------------------------------------------------------------------
+bool MxlAnalyser::analyse_parts_concurrently(vector<XmlNode>& parts, ImoScore* pScore)
+{
+    //Each <part> is analysed by its own MxlAnalyser, that builds the ImoMusicData for
+    //the instrument and uses its own reporter and range of ids. There are no relations
+    //between parts, so the instruments can be built independently. Results are
+    //merged in document order, on the calling thread. Returns false when the
+    //parts have not been analysed (concurrent analysis not enabled or not
+    //enough parts).
+
+#if (LOMSE_ENABLE_THREADS == 1)
+    int numThreads = m_libraryScope.get_musicxml_options()->analysis_threads();
+    if (numThreads <= 0)
+        numThreads = max(1, int(std::thread::hardware_concurrency()));
+    numThreads = min(numThreads, int(parts.size()));
+    if (numThreads < 2)
+        return false;
+
+    //some tables are created on first use. Create them now, before starting the
+    //threads, as afterwards they are only read
+    ImoObj::get_name(k_imo_note_regular);
+    get_line_number(&parts[0]);
+
+    struct PartTask
+    {
+        XmlNode node;
+        stringstream reporter;
+        IdAssigner ids;
+        unique_ptr<MxlAnalyser> analyser;
+        std::exception_ptr error;
+    };
+
+    //each part reserves a range of ids. The number of ImoObjs created for a part is
+    //bounded by a few per XML node, so the range is sized from the nodes count
+    const ImoId k_ids_per_node = 4;
+    const ImoId k_ids_margin = 1000;
+
+    vector< unique_ptr<PartTask> > tasks;
+    vector<IdAssigner*> assigners;
+    vector<ImoId> numIds;
+    for (XmlNode& node : parts)
+    {
+        tasks.push_back( unique_ptr<PartTask>(LOMSE_NEW PartTask) );
+        PartTask* pTask = tasks.back().get();
+        pTask->node = node;
+        pTask->analyser.reset( LOMSE_NEW MxlAnalyser(this, pTask->reporter) );
+        assigners.push_back(&pTask->ids);
+        if (m_dbgIdsPerPart > 0)
+            numIds.push_back(m_dbgIdsPerPart);
+        else
+            numIds.push_back(k_ids_per_node * count_xml_nodes(node) + k_ids_margin);
+    }
+    DocModel* pModel = m_pDoc->get_doc_model();
+    pModel->reserve_thread_ids(assigners, numIds);
+
+    //threads take the next pending part. The calling thread is used as worker 0
+    std::atomic<size_t> nextTask(0);
+    PhaseProfiler* pProfiler = PhaseProfiler::current();
+    auto worker = [&]()
+    {
+        ProfilerActivation profiling(pProfiler);
+        for (size_t i = nextTask++; i < tasks.size(); i = nextTask++)
+        {
+            PartTask* pTask = tasks[i].get();
+            pModel->use_thread_id_assigner(&pTask->ids);
+            try
+            {
+                pTask->analyser->analyse_node(&pTask->node, pScore);
+
+                //report now, instead of when starting next part, items not closed
+                pTask->analyser->clear_pending_relations();
+            }
+            catch (...)
+            {
+                pTask->error = std::current_exception();
+            }
+            pModel->use_thread_id_assigner(nullptr);
+        }
+    };
+
+    vector<std::thread> threads;
+    for (int i=1; i < numThreads; ++i)
+        threads.push_back( std::thread(worker) );
+    worker();
+    for (std::thread& t : threads)
+        t.join();
+
+    //merge results, in document order
+    pModel->merge_thread_ids(assigners);
+    for (unique_ptr<PartTask>& task : tasks)
+    {
+        MxlAnalyser* pAnalyser = task->analyser.get();
+        mark_part_as_added(pAnalyser->m_curPartId);
+        m_curPartId = pAnalyser->m_curPartId;
+        m_measuresCounter = pAnalyser->m_measuresCounter;
+        m_pendingLyricsSpace.insert(m_pendingLyricsSpace.end(),
+                                    pAnalyser->m_pendingLyricsSpace.begin(),
+                                    pAnalyser->m_pendingLyricsSpace.end());
+        m_marginReplaced.insert(pAnalyser->m_marginReplaced.begin(),
+                                pAnalyser->m_marginReplaced.end());
+        task->analyser.reset();
+        m_reporter << task->reporter.str();
+    }
+
+    for (unique_ptr<PartTask>& task : tasks)
+    {
+        if (task->error)
+            std::rethrow_exception(task->error);
+    }
+    return true;
+
+#else
+    (void)parts;
+    (void)pScore;
+    return false;
+#endif
+}
+
 //---------------------------------------------------------------------------------------
 ImoInstrGroup* MxlAnalyser::start_part_group(int number)
 {
@@ -10151,97 +10469,124 @@ bool MxlAnalyser::to_integer(const string& text, int* pResult)
 }
 
 //---------------------------------------------------------------------------------------
-MxlElementAnalyser* MxlAnalyser::new_analyser(const string& name, ImoObj* pAnchor)
-{
-    //Factory method to create analysers
-
-    switch ( name_to_enum(name) )
-    {
-//        case k_mxl_tag_accordion_registration: return LOMSE_NEW AccordionRegistrationMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_arpeggiate:           return LOMSE_NEW ArpeggiateMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_articulations:        return LOMSE_NEW ArticulationsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_attributes:           return LOMSE_NEW AtribbutesMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_backup:               return LOMSE_NEW FwdBackMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_barline:              return LOMSE_NEW BarlineMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_bracket:              return LOMSE_NEW BracketMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_clef:                 return LOMSE_NEW ClefMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_coda:                 return LOMSE_NEW CodaMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_damp:                 return LOMSE_NEW DampMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_damp_all:             return LOMSE_NEW DampAllMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_dashes:               return LOMSE_NEW DashesMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_defaults:             return LOMSE_NEW DefaultsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_direction:            return LOMSE_NEW DirectionMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_direction_type:       return LOMSE_NEW DirectionTypeMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_dynamics:             return LOMSE_NEW DynamicsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_ending:               return LOMSE_NEW EndingMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_eyeglasses:           return LOMSE_NEW EyeglassesMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_fermata:              return LOMSE_NEW FermataMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_fingering:            return LOMSE_NEW FingeringMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_forward:              return LOMSE_NEW FwdBackMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_fret:                 return LOMSE_NEW FretStringMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_harp_pedals:          return LOMSE_NEW HarpPedalsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_image:                return LOMSE_NEW ImageMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_key:                  return LOMSE_NEW KeyMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_lyric:                return LOMSE_NEW LyricMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_measure:              return LOMSE_NEW MeasureMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_metronome:            return LOMSE_NEW MetronomeMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_midi_device:          return LOMSE_NEW MidiDeviceMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_midi_instrument:      return LOMSE_NEW MidiInstrumentMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_notations:            return LOMSE_NEW NotationsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_note:                 return LOMSE_NEW NoteRestMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_octave_shift:         return LOMSE_NEW OctaveShiftMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_ornaments:            return LOMSE_NEW OrnamentsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_page_layout:          return LOMSE_NEW PageLayoutMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_page_margins:         return LOMSE_NEW PageMarginsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_part:                 return LOMSE_NEW PartMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_part_group:           return LOMSE_NEW PartGroupMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_part_list:            return LOMSE_NEW PartListMxlAnalyser(this, m_reporter, m_libraryScope);
-        case k_mxl_tag_part_name:            return LOMSE_NEW PartNameMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_pedal:                return LOMSE_NEW PedalMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_percussion:           return LOMSE_NEW PercussionMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_pitch:                return LOMSE_NEW PitchMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_principal_voice:      return LOMSE_NEW PrincipalVoiceMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_print:                return LOMSE_NEW PrintMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_rehearsal:            return LOMSE_NEW RehearsalMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_rest:                 return LOMSE_NEW RestMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_scaling:              return LOMSE_NEW ScalingMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_scordatura:           return LOMSE_NEW ScordaturaMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_score_instrument:     return LOMSE_NEW ScoreInstrumentMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_score_part:           return LOMSE_NEW ScorePartMxlAnalyser(this, m_reporter, m_libraryScope);
-        case k_mxl_tag_score_partwise:       return LOMSE_NEW ScorePartwiseMxlAnalyser(this, m_reporter, m_libraryScope);
-        case k_mxl_tag_segno:                return LOMSE_NEW SegnoMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_slur:                 return LOMSE_NEW SlurMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_sound:                return LOMSE_NEW SoundMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_string_mute:          return LOMSE_NEW StringMuteMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_staff_details:        return LOMSE_NEW StaffDetailsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_staff_layout:         return LOMSE_NEW StaffLayoutMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_string:               return LOMSE_NEW FretStringMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_system_layout:        return LOMSE_NEW SystemLayoutMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_system_margins:       return LOMSE_NEW SystemMarginsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_technical:            return LOMSE_NEW TecnicalMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_text:                 return LOMSE_NEW TextMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_tied:                 return LOMSE_NEW TiedMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_time:                 return LOMSE_NEW TimeMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_time_modification:    return LOMSE_NEW TimeModificationXmlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_transpose:            return LOMSE_NEW TransposeMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_tuplet:               return LOMSE_NEW TupletMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_tuplet_actual:        return LOMSE_NEW TupletNumbersMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_tuplet_normal:        return LOMSE_NEW TupletNumbersMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_unpitched:            return LOMSE_NEW UnpitchedMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_virtual_instr:        return LOMSE_NEW VirtualInstrumentMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_wedge:                return LOMSE_NEW WedgeMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_words:                return LOMSE_NEW WordsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
+template <class T>
+MxlElementAnalyser* MxlAnalyser::create_analyser(void* pMem, ImoObj* pAnchor)
+{
+    if (pMem)
+        return new (pMem) T(this, m_reporter, m_libraryScope, pAnchor);
+    else
+        return LOMSE_NEW T(this, m_reporter, m_libraryScope, pAnchor);
+}
+
+//---------------------------------------------------------------------------------------
+MxlElementAnalyser* MxlAnalyser::new_analyser(int tag, const char* name, ImoObj* pAnchor,
+                                              void* pMem)
+{
+    //Factory method to create analysers. When pMem is not null, the analyser is
+    //constructed in that memory, that must be the one used by a previous analyser
+    //for the same tag.
+
+    switch (tag)
+    {
+//        case k_mxl_tag_accordion_registration: return create_analyser<AccordionRegistrationMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_arpeggiate:           return create_analyser<ArpeggiateMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_articulations:        return create_analyser<ArticulationsMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_attributes:           return create_analyser<AtribbutesMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_backup:               return create_analyser<FwdBackMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_barline:              return create_analyser<BarlineMxlAnalyser>(pMem, pAnchor);
+//        case k_mxl_tag_bracket:              return create_analyser<BracketMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_clef:                 return create_analyser<ClefMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_coda:                 return create_analyser<CodaMxlAnalyser>(pMem, pAnchor);
+//        case k_mxl_tag_damp:                 return create_analyser<DampMxlAnalyser>(pMem, pAnchor);
+//        case k_mxl_tag_damp_all:             return create_analyser<DampAllMxlAnalyser>(pMem, pAnchor);
+//        case k_mxl_tag_dashes:               return create_analyser<DashesMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_defaults:             return create_analyser<DefaultsMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_direction:            return create_analyser<DirectionMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_direction_type:       return create_analyser<DirectionTypeMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_dynamics:             return create_analyser<DynamicsMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_ending:               return create_analyser<EndingMxlAnalyser>(pMem, pAnchor);
+//        case k_mxl_tag_eyeglasses:           return create_analyser<EyeglassesMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_fermata:              return create_analyser<FermataMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_fingering:            return create_analyser<FingeringMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_forward:              return create_analyser<FwdBackMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_fret:                 return create_analyser<FretStringMxlAnalyser>(pMem, pAnchor);
+//        case k_mxl_tag_harp_pedals:          return create_analyser<HarpPedalsMxlAnalyser>(pMem, pAnchor);
+//        case k_mxl_tag_image:                return create_analyser<ImageMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_key:                  return create_analyser<KeyMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_lyric:                return create_analyser<LyricMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_measure:              return create_analyser<MeasureMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_metronome:            return create_analyser<MetronomeMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_midi_device:          return create_analyser<MidiDeviceMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_midi_instrument:      return create_analyser<MidiInstrumentMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_notations:            return create_analyser<NotationsMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_note:                 return create_analyser<NoteRestMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_octave_shift:         return create_analyser<OctaveShiftMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_ornaments:            return create_analyser<OrnamentsMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_page_layout:          return create_analyser<PageLayoutMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_page_margins:         return create_analyser<PageMarginsMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_part:                 return create_analyser<PartMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_part_group:           return create_analyser<PartGroupMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_part_list:            return create_analyser<PartListMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_part_name:            return create_analyser<PartNameMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_pedal:                return create_analyser<PedalMxlAnalyser>(pMem, pAnchor);
+//        case k_mxl_tag_percussion:           return create_analyser<PercussionMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_pitch:                return create_analyser<PitchMxlAnalyser>(pMem, pAnchor);
+//        case k_mxl_tag_principal_voice:      return create_analyser<PrincipalVoiceMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_print:                return create_analyser<PrintMxlAnalyser>(pMem, pAnchor);
+//        case k_mxl_tag_rehearsal:            return create_analyser<RehearsalMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_rest:                 return create_analyser<RestMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_scaling:              return create_analyser<ScalingMxlAnalyser>(pMem, pAnchor);
+//        case k_mxl_tag_scordatura:           return create_analyser<ScordaturaMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_score_instrument:     return create_analyser<ScoreInstrumentMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_score_part:           return create_analyser<ScorePartMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_score_partwise:       return create_analyser<ScorePartwiseMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_segno:                return create_analyser<SegnoMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_slur:                 return create_analyser<SlurMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_sound:                return create_analyser<SoundMxlAnalyser>(pMem, pAnchor);
+//        case k_mxl_tag_string_mute:          return create_analyser<StringMuteMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_staff_details:        return create_analyser<StaffDetailsMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_staff_layout:         return create_analyser<StaffLayoutMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_string:               return create_analyser<FretStringMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_system_layout:        return create_analyser<SystemLayoutMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_system_margins:       return create_analyser<SystemMarginsMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_technical:            return create_analyser<TecnicalMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_text:                 return create_analyser<TextMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_tied:                 return create_analyser<TiedMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_time:                 return create_analyser<TimeMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_time_modification:    return create_analyser<TimeModificationXmlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_transpose:            return create_analyser<TransposeMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_tuplet:               return create_analyser<TupletMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_tuplet_actual:        return create_analyser<TupletNumbersMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_tuplet_normal:        return create_analyser<TupletNumbersMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_unpitched:            return create_analyser<UnpitchedMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_virtual_instr:        return create_analyser<VirtualInstrumentMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_wedge:                return create_analyser<WedgeMxlAnalyser>(pMem, pAnchor);
+        case k_mxl_tag_words:                return create_analyser<WordsMxlAnalyser>(pMem, pAnchor);
         default:
-            return LOMSE_NEW NullMxlAnalyser(this, m_reporter, m_libraryScope, name);
+            if (pMem)
+                return new (pMem) NullMxlAnalyser(this, m_reporter, m_libraryScope, string(name));
+            else
+                return LOMSE_NEW NullMxlAnalyser(this, m_reporter, m_libraryScope, string(name));
     }
 }
 
 //---------------------------------------------------------------------------------------
 int MxlAnalyser::name_to_enum(const string& name) const
 {
-	map<string, int>::const_iterator it = m_NameToEnum.find(name);
-	if (it != m_NameToEnum.end())
-		return it->second;
+    return name_to_enum(name.c_str());
+}
+
+//---------------------------------------------------------------------------------------
+int MxlAnalyser::name_to_enum(const char* name) const
+{
+    const MxlTagName* pEnd = mxlTagNames + sizeof(mxlTagNames) / sizeof(mxlTagNames[0]);
+    const MxlTagName* it = std::lower_bound(mxlTagNames, pEnd, name,
+        [](const MxlTagName& entry, const char* value) {
+            return strcmp(entry.name, value) < 0;
+        });
+
+    if (it != pEnd && strcmp(it->name, name) == 0)
+        return it->tag;
     else
         return k_mxl_tag_undefined;
 }
@@ -37,6 +37,9 @@ MxlCompiler::MxlCompiler(XmlParser* p, MxlAnalyser* a, ModelBuilder* mb, Documen
     , m_pXmlParser(p)
     , m_pMxlAnalyser(a)
 {
+    //MusicXML files have many elements with only text. Storing the text in the
+    //element node saves a lot of memory
+    m_pXmlParser->embed_pcdata(true);
 }
 
 //---------------------------------------------------------------------------------------
@@ -45,6 +48,7 @@ MxlCompiler::MxlCompiler(LibraryScope& libraryScope, Document* pDoc)
     : Compiler()
 {
     m_pXmlParser = Injector::inject_XmlParser(libraryScope, pDoc->get_scope());
+    m_pXmlParser->embed_pcdata(true);
     m_pMxlAnalyser = Injector::inject_MxlAnalyser(libraryScope, pDoc, m_pXmlParser);
 
     m_pParser = m_pXmlParser;
@@ -70,11 +74,9 @@ ImoDocument* MxlCompiler::compile_file(const std::string& filename)
         InputStream* pFile = FileSystem::open_input_stream(m_fileLocator);
         ZipInputStream* zip  = static_cast<ZipInputStream*>(pFile);
 
-        unsigned char* buffer = zip->get_as_string();
-        m_pXmlParser->parse_cstring( (char *)buffer );
+        m_pXmlParser->parse_buffer_inplace( zip->get_as_vector() );
 
         delete pFile;
-        delete[] buffer;
 #else
 		throw runtime_error("Could not open compressed file: Lomse was compiled without compression support");
 #endif
@@ -105,11 +107,23 @@ ImoDocument* MxlCompiler::compile_buffer(const void* buffer, size_t size)
     return compile_parsed_tree( m_pXmlParser->get_tree_root() );
 }
 
+//---------------------------------------------------------------------------------------
+ImoDocument* MxlCompiler::compile_buffer(std::vector<unsigned char>&& buffer)
+{
+    m_fileLocator = "string:";
+    m_pXmlParser->parse_buffer_inplace( std::move(buffer) );
+    return compile_parsed_tree( m_pXmlParser->get_tree_root() );
+}
+
 //---------------------------------------------------------------------------------------
 ImoDocument* MxlCompiler::compile_parsed_tree(XmlNode* root)
 {
     ImoDocument* pDoc = dynamic_cast<ImoDocument*>(
                             m_pMxlAnalyser->analyse_tree(root, m_fileLocator));
+
+    //the XML tree is no longer needed. Free it before building the model
+    m_pXmlParser->clear();
+
     if (pDoc)
         m_pModelBuilder->build_model(pDoc);
     return pDoc;
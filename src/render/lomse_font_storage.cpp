@@ -29,6 +29,15 @@ using namespace agg;
 namespace lomse
 {
 
+//=======================================================================================
+// font_cache_pool implementation
+//=======================================================================================
+font_cache_pool& font_cache_pool::instance()
+{
+    static font_cache_pool pool;
+    return pool;
+}
+
 //=======================================================================================
 // FontStorage implementation
 //=======================================================================================
@@ -746,8 +746,6 @@ void SvgDrawer::end_composite_notation()
 //---------------------------------------------------------------------------------------
 string SvgDrawer::validate_id(const string& id)
 {
-    static int counter = 0;
-
     if (id.empty())
         return id;
 
@@ -755,7 +753,7 @@ string SvgDrawer::validate_id(const string& id)
     if (search != m_ids.end())
     {
         stringstream newid;
-        newid << id << "-" << counter++;
+        newid << id << "-" << m_idsCounter++;
 
         stringstream ss;
         ss << "Duplicated id found '" << search->first << "'. Replaced by '"
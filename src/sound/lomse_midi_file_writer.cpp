@@ -0,0 +1,325 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#include "lomse_midi_file_writer.h"
+
+#include "lomse_internal_model.h"
+#include "lomse_midi_table.h"
+
+#include <algorithm>    //min(), max()
+#include <fstream>
+#include <unordered_map>
+
+using namespace std;
+
+namespace lomse
+{
+
+//---------------------------------------------------------------------------------------
+//helpers for writing MIDI file data
+static void write_var_length(string& data, unsigned long value)
+{
+    unsigned char buffer[5];
+    int n = 0;
+    buffer[n++] = (unsigned char)(value & 0x7F);
+    while ((value >>= 7) > 0)
+        buffer[n++] = (unsigned char)((value & 0x7F) | 0x80);
+    while (n > 0)
+        data.push_back( char(buffer[--n]) );
+}
+
+//---------------------------------------------------------------------------------------
+static void write_uint32(string& data, unsigned long value)
+{
+    data.push_back( char((value >> 24) & 0xFF) );
+    data.push_back( char((value >> 16) & 0xFF) );
+    data.push_back( char((value >> 8) & 0xFF) );
+    data.push_back( char(value & 0xFF) );
+}
+
+//---------------------------------------------------------------------------------------
+static void write_uint16(string& data, unsigned int value)
+{
+    data.push_back( char((value >> 8) & 0xFF) );
+    data.push_back( char(value & 0xFF) );
+}
+
+
+//=======================================================================================
+// MidiFileWriter implementation
+//=======================================================================================
+MidiFileWriter::MidiFileWriter()
+    : m_bpm(60.0)
+    , m_timeSignatureTime(-1L)
+{
+}
+
+//---------------------------------------------------------------------------------------
+string MidiFileWriter::get_source(ImoScore* pScore)
+{
+    m_error.clear();
+    if (pScore == nullptr)
+    {
+        m_error = "No score to render";
+        return string();
+    }
+
+    SoundEventsTable* pTable = pScore->get_midi_table();
+    if (!render_events(pScore, pTable))
+        return string();
+
+    return assemble_file();
+}
+
+//---------------------------------------------------------------------------------------
+bool MidiFileWriter::save_to_file(ImoScore* pScore, const std::string& filename)
+{
+    string data = get_source(pScore);
+    if (data.empty())
+        return false;
+
+    ofstream file(filename.c_str(), ios::out | ios::binary);
+    if (!file.good())
+    {
+        m_error = "Could not create file '" + filename + "'";
+        return false;
+    }
+    file.write(data.data(), streamsize(data.size()));
+    return file.good();
+}
+
+//---------------------------------------------------------------------------------------
+bool MidiFileWriter::render_events(ImoScore* pScore, SoundEventsTable* pTable)
+{
+    //Traverse the events table in playback order, as ScorePlayer::do_play() does,
+    //but without waiting. Track 0 is for tempo and time signatures and track i+1 is
+    //for instrument i
+
+    vector<SoundEvent*>& events = pTable->get_events();
+    int numInstrs = pScore->get_num_instruments();
+
+    unordered_map<ImoInstrument*, int> instrTrack;
+    for (int iInstr=0; iInstr < numInstrs; ++iInstr)
+        instrTrack[pScore->get_instrument(iInstr)] = iInstr + 1;
+
+    m_tracks.assign(numInstrs + 1, string());
+    m_lastTime.assign(numInstrs + 1, 0L);
+    m_timeSignatureTime = -1L;
+    m_timeSignature.clear();
+    add_tempo(0L, int(60000000.0 / m_bpm + 0.5));
+
+    //jumps can create loops in a malformed score. Limit the number of events
+    size_t maxSteps = 100 * events.size() + 100;
+    size_t numSteps = 0;
+
+    pTable->reset_jumps();
+    long time = 0L;             //time in the MIDI file, in ticks
+    long prevDeltaTime = 0L;    //time in the table for previous event
+    int iProgInstr = 0;
+    int numEvents = int(events.size());
+    int i = 0;
+    while (i < numEvents)
+    {
+        if (++numSteps > maxSteps)
+        {
+            pTable->reset_jumps();
+            m_error = "Endless loop in score repetitions";
+            return false;
+        }
+
+        SoundEvent* pEv = events[i];
+        if (pEv->DeltaTime > prevDeltaTime)
+        {
+            time += pEv->DeltaTime - prevDeltaTime;
+            prevDeltaTime = pEv->DeltaTime;
+        }
+
+        //if it is a jump event, execute the jump if applicable
+        if (pEv->EventType == SoundEvent::k_jump)
+        {
+            bool fExecuted = false;
+            JumpEntry* pJump = pEv->pJump;
+            if (pJump->get_visited() >= pJump->get_times_before())
+            {
+                if (pJump->get_times_valid() == 0
+                    || pJump->get_times_valid() > pJump->get_executed())
+                {
+                    i = pJump->get_event();
+                    prevDeltaTime = events[i]->DeltaTime;
+                    if (pJump->get_times_valid() > pJump->get_executed())
+                        pJump->increment_applied();
+                    fExecuted = true;
+                }
+            }
+
+            pJump->increment_visited();
+
+            if (!fExecuted)
+                ++i;
+
+            continue;
+        }
+
+        if (pEv->EventType == SoundEvent::k_end_of_score)
+            break;
+
+        unsigned char data[3];
+        int channel = pEv->Channel & 0x0F;
+        switch (pEv->EventType)
+        {
+            case SoundEvent::k_prog_instr:
+            {
+                //program events are created in instruments order
+                iProgInstr = min(iProgInstr + 1, numInstrs);
+                data[0] = (unsigned char)(0xC0 | channel);
+                data[1] = (unsigned char)(pEv->Instrument & 0x7F);
+                add_event(iProgInstr, time, data, 2);
+                break;
+            }
+
+            case SoundEvent::k_note_on:
+            case SoundEvent::k_note_off:
+            {
+                int iTrack = 1;
+                unordered_map<ImoInstrument*, int>::iterator it =
+                    instrTrack.find( pEv->pSO->get_instrument() );
+                if (it != instrTrack.end())
+                    iTrack = it->second;
+
+                bool fNoteOn = (pEv->EventType == SoundEvent::k_note_on);
+                data[0] = (unsigned char)((fNoteOn ? 0x90 : 0x80) | channel);
+                data[1] = (unsigned char)( max(0, min(127, pEv->NotePitch)) );
+                data[2] = (unsigned char)( fNoteOn ? max(1, min(127, pEv->Volume)) : 64 );
+                add_event(iTrack, time, data, 3);
+                break;
+            }
+
+            case SoundEvent::k_rhythm_change:
+                add_time_signature(time, pEv->TopNumber, pEv->BeatDuration,
+                                   pEv->NumPulses);
+                break;
+
+            case SoundEvent::k_tempo_change:
+                add_tempo(time, pEv->Tempo);
+                break;
+
+            default:
+                //visual events: nothing to do
+                break;
+        }
+        ++i;
+    }
+    pTable->reset_jumps();
+
+    //all tracks end at the same time
+    for (size_t iTrack=0; iTrack < m_tracks.size(); ++iTrack)
+    {
+        static const unsigned char endOfTrack[] = { 0xFF, 0x2F, 0x00 };
+        add_event(int(iTrack), time, endOfTrack, 3);
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void MidiFileWriter::add_event(int iTrack, long time, const unsigned char* data,
+                               size_t size)
+{
+    string& track = m_tracks[iTrack];
+    write_var_length(track, (unsigned long)(time - m_lastTime[iTrack]));
+    track.append(reinterpret_cast<const char*>(data), size);
+    m_lastTime[iTrack] = time;
+}
+
+//---------------------------------------------------------------------------------------
+void MidiFileWriter::add_tempo(long time, int tempo)
+{
+    //tempo is in microseconds per quarter note
+    unsigned char data[6];
+    data[0] = 0xFF;
+    data[1] = 0x51;
+    data[2] = 0x03;
+    data[3] = (unsigned char)((tempo >> 16) & 0xFF);
+    data[4] = (unsigned char)((tempo >> 8) & 0xFF);
+    data[5] = (unsigned char)(tempo & 0xFF);
+    add_event(0, time, data, 6);
+}
+
+//---------------------------------------------------------------------------------------
+void MidiFileWriter::add_time_signature(long time, int topNumber, int beatDuration,
+                                        int numPulses)
+{
+    if (topNumber <= 0 || beatDuration <= 0 || numPulses <= 0)
+        return;
+
+    //bottom number, as a power of two. beatDuration is the duration of the
+    //bottom number note: 64 for quarter note, 32 for eighth note, etc.
+    int bottomPower = 0;
+    int bottom = int(k_duration_whole) / beatDuration;
+    while (bottom > 1)
+    {
+        bottom >>= 1;
+        ++bottomPower;
+    }
+
+    //MIDI clocks (24 per quarter note) per metronome click
+    int pulseDuration = topNumber * beatDuration / numPulses;
+    int clocks = max(1, min(255, 24 * pulseDuration / int(k_duration_quarter)));
+
+    unsigned char data[7];
+    data[0] = 0xFF;
+    data[1] = 0x58;
+    data[2] = 0x04;
+    data[3] = (unsigned char)(min(255, topNumber));
+    data[4] = (unsigned char)(bottomPower);
+    data[5] = (unsigned char)(clocks);
+    data[6] = 8;        //32nd notes per quarter note
+
+    //the events table has a rhythm change event for each instrument. Write the
+    //time signature only once
+    string event(reinterpret_cast<const char*>(data), 7);
+    if (time == m_timeSignatureTime && event == m_timeSignature)
+        return;
+
+    m_timeSignatureTime = time;
+    m_timeSignature = event;
+    add_event(0, time, data, 7);
+}
+
+//---------------------------------------------------------------------------------------
+string MidiFileWriter::assemble_file()
+{
+    size_t size = 14;
+    for (const string& track : m_tracks)
+        size += 8 + track.size();
+
+    string data;
+    data.reserve(size);
+
+    //header chunk
+    data.append("MThd");
+    write_uint32(data, 6UL);
+    write_uint16(data, 1U);         //format 1
+    write_uint16(data, (unsigned int)(m_tracks.size()));
+    write_uint16(data, (unsigned int)(k_duration_quarter));   //ticks per quarter
+
+    //track chunks
+    for (const string& track : m_tracks)
+    {
+        data.append("MTrk");
+        write_uint32(data, (unsigned long)(track.size()));
+        data.append(track);
+    }
+
+    m_tracks.clear();
+    m_lastTime.clear();
+    return data;
+}
+
+
+}  //namespace lomse
@@ -257,6 +257,7 @@ void SoundEventsTable::process_sound_change(ImoSoundChange* pSound,
             case k_attr_time_only:
                 break;
             case k_attr_tempo:
+                add_tempo_change(cursor, measure, pSound->get_float_attribute(k_attr_tempo));
                 break;
             default:
                 break;
@@ -446,6 +447,18 @@ void SoundEventsTable::add_rythm_change(int measure, ImoTimeSignature* pTS)
                 numBeats, beatDuration, pTS, measure);
 }
 
+//---------------------------------------------------------------------------------------
+void SoundEventsTable::add_tempo_change(StaffObjsCursor& cursor, int measure, float bpm)
+{
+    //bpm is the number of quarter notes per minute
+    if (bpm <= 0.0f)
+        return;
+
+    ImoStaffObj* pSO = cursor.get_staffobj();
+    int tempo = int( 60000000.0 / double(bpm) + 0.5 );
+    store_event(pSO->get_time(), SoundEvent::k_tempo_change, 0, tempo, 0, 0, pSO, measure);
+}
+
 //---------------------------------------------------------------------------------------
 void SoundEventsTable::close_table()
 {
@@ -478,41 +491,44 @@ void SoundEventsTable::create_measures_table()
 }
 
 //---------------------------------------------------------------------------------------
-void SoundEventsTable::sort_by_time()
+//helper for sorting events. A compact copy of the sort key is used, to avoid
+//dereferencing the events pointers in each comparison
+struct SoundEventSortKey
 {
-    // Sort events by time, measure and event type. Uses the bubble sort algorithm
+    long time;
+    int type;
+    int measure;
+    SoundEvent* pEvent;
 
-    int j, k;
-    bool fChanges;
-    int nNumElements = int(m_events.size());
-    SoundEvent* pEvAux;
+    SoundEventSortKey(SoundEvent* pEv)
+        : time(pEv->DeltaTime), type(pEv->EventType), measure(pEv->Measure)
+        , pEvent(pEv)
+    {
+    }
 
-    for (int i = 0; i < nNumElements; i++)
+    bool operator <(const SoundEventSortKey& other) const
     {
-        fChanges = false;
-        j = nNumElements - 1;
+        if (time != other.time)
+            return time < other.time;
+        if (type != other.type)
+            return type < other.type;
+        return measure < other.measure;
+    }
+};
 
-        while ( j != i )
-        {
-            k = j - 1;
-            if ((m_events[j]->DeltaTime < m_events[k]->DeltaTime) ||
-                ((m_events[j]->DeltaTime == m_events[k]->DeltaTime) &&
-                 ((m_events[j]->Measure < m_events[k]->Measure) ||
-                  (m_events[j]->EventType < m_events[k]->EventType))))
-            {
-                //interchange elements
-                pEvAux = m_events[j];
-                m_events[j] = m_events[k];
-                m_events[k] = pEvAux;
-                fChanges = true;
-            }
-            j = k;
-        }
+//---------------------------------------------------------------------------------------
+void SoundEventsTable::sort_by_time()
+{
+    // Sort events by time, event type and measure. Event type has priority over
+    // measure so that, at the same time, sounds are stopped before starting new ones
+    // even when measures are not aligned (multimetric scores). The sort is stable, so
+    // events with the same key keep their creation order
 
-        //If there were no changes in this loop step it implies that the table is ordered;
-        //in this case exit loop to save time
-        if (!fChanges) break;
-    }
+    std::vector<SoundEventSortKey> keys(m_events.begin(), m_events.end());
+    std::stable_sort(keys.begin(), keys.end());
+
+    for (size_t i=0; i < keys.size(); ++i)
+        m_events[i] = keys[i].pEvent;
 }
 
 //---------------------------------------------------------------------------------------
@@ -569,6 +585,9 @@ string SoundEventsTable::dump_events_table()
                 case SoundEvent::k_prog_instr:
                     msg << "PRG INSTR ";
                     break;
+                case SoundEvent::k_tempo_change:
+                    msg << "TEMPO     ";
+                    break;
                 case SoundEvent::k_jump:
                     msg << "JUMP      ";
                     msg << pSE->pJump->dump_entry();
@@ -24,7 +24,8 @@
 #include "lomse_im_note.h"
 
 #include <algorithm>    //max(), min()
-#include <ctime>        //clock()
+#include <atomic>       //atomic_thread_fence()
+#include <cmath>        //sqrt()
 
 
 namespace lomse
@@ -44,6 +45,12 @@ ScorePlayer::ScorePlayer(LibraryScope& libScope, MidiServerBase* pMidi)
     , m_fFinalEventSent(false)
     , m_pScore(nullptr)
     , m_pTable(nullptr)
+    , m_lookahead(0)
+    , m_numWakeUps(0L)
+    , m_sumLateness(0.0)
+    , m_sumSqLateness(0.0)
+    , m_maxLateness(0.0)
+    , m_lastLateness(0.0)
     , m_MtrChannel(9)
     , m_MtrInstr(0)
     , m_MtrTone1(60)
@@ -57,7 +64,7 @@ ScorePlayer::ScorePlayer(LibraryScope& libScope, MidiServerBase* pMidi)
     , m_beatType(0)
     , m_prevGuiBpm(0L)
     , m_nMtrPulseDuration(0L)
-    , m_conversionFactor(1.0f)
+    , m_conversionFactor(1000.0)
     //current TS info
     , m_nCurMeasureDuration(0L)
     , m_nCurNumPulses(0L)
@@ -296,10 +303,138 @@ void ScorePlayer::stop()
     LOMSE_LOG_DEBUG(Logger::k_score_player, "<< Exit");
 }
 
+//---------------------------------------------------------------------------------------
+PlaybackTimingStats ScorePlayer::get_timing_stats()
+{
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+
+    PlaybackTimingStats stats;
+    stats.numEvents = m_numWakeUps;
+    if (m_numWakeUps > 0L)
+    {
+        double n = double(m_numWakeUps);
+        stats.meanLateness = m_sumLateness / n;
+        double variance = m_sumSqLateness / n - stats.meanLateness * stats.meanLateness;
+        stats.jitter = (variance > 0.0 ? sqrt(variance) : 0.0);
+        stats.maxLateness = m_maxLateness;
+        stats.drift = m_lastLateness;
+    }
+    return stats;
+}
+
+//---------------------------------------------------------------------------------------
+void ScorePlayer::reset_timing_stats()
+{
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+
+    m_numWakeUps = 0L;
+    m_sumLateness = 0.0;
+    m_sumSqLateness = 0.0;
+    m_maxLateness = 0.0;
+    m_lastLateness = 0.0;
+}
+
 //---------------------------------------------------------------------------------------
 // Methods to be executed in the thread
 //---------------------------------------------------------------------------------------
 
+void ScorePlayer::wait_until(PlaybackTime deadline, Interactor* pInteractor)
+{
+    //sleep until the time for delivering the events at the absolute deadline, and
+    //account the lateness. As the deadline does not depend on when the previous
+    //wake-up took place, errors do not accumulate. Sound events are delivered
+    //m_lookahead in advance. Visual tracking events pending for a time before the
+    //wake-up time are sent at their real time while waiting
+
+    PlaybackTime wakeUp = deadline - m_lookahead;
+    while (!m_pendingTracking.empty() && m_pendingTracking.front().first <= wakeUp)
+    {
+        std::this_thread::sleep_until(m_pendingTracking.front().first);
+        send_tracking_event(m_pendingTracking.front().second, pInteractor);
+        m_pendingTracking.pop_front();
+    }
+
+    std::this_thread::sleep_until(wakeUp);
+    double lateness = double( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    PlaybackClock::now() - deadline).count() ) / 1000.0;
+    lateness = max(0.0, lateness);
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    ++m_numWakeUps;
+    m_sumLateness += lateness;
+    m_sumSqLateness += lateness * lateness;
+    m_maxLateness = max(m_maxLateness, lateness);
+    m_lastLateness = lateness;
+}
+
+//---------------------------------------------------------------------------------------
+void ScorePlayer::schedule_tracking_event(SpEventVisualTracking pEvent,
+                                          PlaybackTime deadline, Interactor* pInteractor)
+{
+    //visual events can not be delivered in advance. When there is lookahead, the
+    //event is saved for sending it at its deadline
+    if (m_lookahead.count() > 0)
+        m_pendingTracking.push_back( make_pair(deadline, pEvent) );
+    else
+        send_tracking_event(pEvent, pInteractor);
+}
+
+//---------------------------------------------------------------------------------------
+void ScorePlayer::send_pending_tracking_events(Interactor* pInteractor)
+{
+    //at end of playback, send the visual events still pending at their real time.
+    //When playback is stopped they are discarded, as all highlight is going to be
+    //removed
+    while (!m_pendingTracking.empty())
+    {
+        if (!m_fShouldStop && !m_fQuit)
+        {
+            std::this_thread::sleep_until(m_pendingTracking.front().first);
+            send_tracking_event(m_pendingTracking.front().second, pInteractor);
+        }
+        m_pendingTracking.pop_front();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void ScorePlayer::send_tracking_event(SpEventVisualTracking pEvent,
+                                      Interactor* pInteractor)
+{
+    if (m_fPostEvents)
+        m_libScope.post_event(pEvent);
+    else if (pInteractor)
+        pInteractor->handle_event(pEvent);
+}
+
+//---------------------------------------------------------------------------------------
+SpEventVisualTracking ScorePlayer::new_tracking_event(WpInteractor wpInteractor)
+{
+    //Returns an event from the pool, if any is free, or creates a new one.
+    //An event is free when the pool is its only owner, that is, the application
+    //and the events dispatcher have released it. The fence ensures that all
+    //changes made by the last owner in other thread are visible before reusing it.
+
+    static const size_t k_max_pool_size = 16;
+
+    for (SpEventVisualTracking& sp : m_trackingPool)
+    {
+        if (sp.use_count() == 1)
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            sp->reset(wpInteractor, m_pScore->get_id());
+            return sp;
+        }
+    }
+
+    SpEventVisualTracking pEvent(
+            LOMSE_NEW EventVisualTracking(wpInteractor, m_pScore->get_id()) );
+    if (m_trackingPool.size() < k_max_pool_size)
+        m_trackingPool.push_back(pEvent);
+    return pEvent;
+}
+
+//---------------------------------------------------------------------------------------
+
 void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                           long nMM, Interactor* pInteractor)
 {
@@ -344,11 +479,14 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
     //-----------------------------------------------------------------------------------
     //Naming convention for variables:
     //  DeltaTime:  content is Lomse Time Units (TU). One quarter note = 64TU.
-    //  Time: content is absolute time (milliseconds)
+    //  Time: content is absolute time (microseconds)
+    //  deadline: the PlaybackClock time corresponding to curTime. Events are
+    //      scheduled at absolute deadlines, so that delays in one event (e.g. when
+    //      posting visual tracking events) are not propagated to next events.
     //-----------------------------------------------------------------------------------
 
     //declaration of some time related variables.
-    long nEvTime;           //time (millisecs) for next event, metronome or from table
+    long long nEvTime;      //time (microsecs) for next event, metronome or from table
     long nMtrEvDeltaTime;   //time (Time Units) for next metronome click
 
     // get metronome interval duration, in milliseconds
@@ -394,7 +532,10 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
     m_nCurNumPulses = 4;                    //assume 4/4 time signature
     m_nPrevNumPulses = m_nCurNumPulses;
 
-    m_conversionFactor = float(m_nCurMtrIntval) / float(m_nMtrPulseDuration);
+    //AWARE: m_nCurMtrIntval is truncated to milliseconds. Use the tempo for computing
+    //the conversion factor, to avoid accumulating the truncation error
+    long bpm = (nMM == 0 ? m_prevGuiBpm : nMM);
+    m_conversionFactor = 60000000.0 / (double(bpm) * double(m_nMtrPulseDuration));
     LOMSE_LOG_DEBUG(Logger::k_score_player,
                     "initial settings: nCurMeasureDuration=%ld, nCurMtrIntval=%ld, "
                     "conversionFactor=%f, m_nMtrPulseDuration=%ld",
@@ -454,9 +595,9 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
     //Define and initialize time counter (real time, in millisecs). If playback
     //starts not at the beginning but in another measure, advance time counter to that
     //measure
-    long curTime = 0L;
+    long long curTime = 0LL;
 	if (nEvStart > 1)
-		curTime = time_units_to_milliseconds( events[nEvStart]->DeltaTime );
+		curTime = time_units_to_microseconds( events[nEvStart]->DeltaTime );
 
 
     //determine last metronome pulse before first note to play.
@@ -470,12 +611,12 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
 
     nMtrEvDeltaTime = ((events[i]->DeltaTime / m_nMtrPulseDuration) - 1) * m_nMtrPulseDuration;
     nMtrEvDeltaTime -= nMissingTime;
-    curTime = time_units_to_milliseconds( nMtrEvDeltaTime );
+    curTime = time_units_to_microseconds( nMtrEvDeltaTime );
     long nExtraTime = long( m_pTable->get_anacrusis_extra_time() );
 
     LOMSE_LOG_DEBUG(Logger::k_score_player,
                     "At start: nMtrEvDeltaTime=%ld, event=%d, event time=%ld, anacrusis missing time=%f, "
-                    "curTime=%ld, nMissingTime=%ld, nExtraTime=%ld, nDeltaShift=%ld",
+                    "curTime=%lld, nMissingTime=%ld, nExtraTime=%ld, nDeltaShift=%ld",
                     nMtrEvDeltaTime, i, events[i]->DeltaTime, m_pTable->get_anacrusis_missing_time(),
                     curTime, nMissingTime, nExtraTime, nDeltaShift);
 
@@ -490,8 +631,11 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
         wpInteractor = WpInteractor();
 
     //define and prepare highlight event
-    SpEventVisualTracking pEvent(
-            LOMSE_NEW EventVisualTracking(wpInteractor, m_pScore->get_id()) );
+    SpEventVisualTracking pEvent = new_tracking_event(wpInteractor);
+
+    //start the clock
+    reset_timing_stats();
+    PlaybackTime deadline = PlaybackClock::now();
 
     bool fFirstBeatInMeasure = true;    //first beat of a measure
     bool fCountOffPulseActive = false;
@@ -507,20 +651,22 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                         "nMtrEvDeltaTime=%ld",
                         nMtrIntvalOff, nMtrIntvalNextClick, nMtrEvDeltaTime);
         //generate two metronome pulses before starting
-        std::chrono::milliseconds timeToOff( time_units_to_milliseconds(nMtrIntvalOff) );
-        std::chrono::milliseconds timeToNext( time_units_to_milliseconds(nMtrIntvalNextClick) );
+        std::chrono::microseconds timeToOff( time_units_to_microseconds(nMtrIntvalOff) );
+        std::chrono::microseconds timeToNext( time_units_to_microseconds(nMtrIntvalNextClick) );
 
         int numPulses = (nMissingTime != 0 ? 2 : 1);
         for (int j=0 ; j < numPulses; ++j)
         {
-            m_pMidi->note_on(m_MtrChannel, m_MtrTone2, 100);
-            std::this_thread::sleep_for( timeToOff );
-            m_pMidi->note_off(m_MtrChannel, m_MtrTone2, 100);
-            std::this_thread::sleep_for( timeToNext );
+            m_pMidi->note_on_at(deadline, m_MtrChannel, m_MtrTone2, 100);
+            deadline += timeToOff;
+            wait_until(deadline, pInteractor);
+            m_pMidi->note_off_at(deadline, m_MtrChannel, m_MtrTone2, 100);
+            deadline += timeToNext;
+            wait_until(deadline, pInteractor);
         }
 
         //last click
-        m_pMidi->note_on(m_MtrChannel, m_MtrTone2, 100);
+        m_pMidi->note_on_at(deadline, m_MtrChannel, m_MtrTone2, 100);
 
         fSendMtrOff = true;
         nMtrEvDeltaTime += nMtrIntvalOff;
@@ -534,7 +680,7 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
     do
     {
         LOMSE_LOG_DEBUG(Logger::k_score_player,
-                        "new iteration: i=%d, curTime=%ld, nMtrEvDeltaTime=%ld, "
+                        "new iteration: i=%d, curTime=%lld, nMtrEvDeltaTime=%ld, "
                         "events[i]->DeltaTime=%ld",
                         i, curTime, nMtrEvDeltaTime, events[i]->DeltaTime);
 
@@ -542,36 +688,23 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
         if (nMtrEvDeltaTime <= events[i]->DeltaTime)
         {
             //Next event should be a metronome click or the click off event for the previous metronome click
-            nEvTime = time_units_to_milliseconds(nMtrEvDeltaTime);
-            LOMSE_LOG_DEBUG(Logger::k_score_player, "nEvTime updated (MtrDeltaTime) = %ld", nEvTime);
+            nEvTime = time_units_to_microseconds(nMtrEvDeltaTime);
+            LOMSE_LOG_DEBUG(Logger::k_score_player, "nEvTime updated (MtrDeltaTime) = %lld", nEvTime);
             if (curTime < nEvTime)
             {
                 //flush pending events
-                long elapsed = 0L;
                 if (fVisualTracking && pEvent->get_num_items() > 0)
                 {
-                    clock_t t1=clock();
-                    if (m_fPostEvents)
-                        m_libScope.post_event(pEvent);
-                    else if (pInteractor)
-                        pInteractor->handle_event(pEvent);
-                    pEvent = SpEventVisualTracking(
-                                LOMSE_NEW EventVisualTracking(wpInteractor,
-                                                              m_pScore->get_id()) );
-                    clock_t t2=clock();
-                    elapsed = long( ((t2-t1)*1000.0)/double(CLOCKS_PER_SEC));
+                    schedule_tracking_event(pEvent, deadline, pInteractor);
+                    pEvent = new_tracking_event(wpInteractor);
                 }
 
                 //wait for current time
-                long waitT = nEvTime - curTime - elapsed;
-                if (waitT > 0L)
-                {
-                    std::chrono::milliseconds waitTime(waitT);
-                    std::this_thread::sleep_for(waitTime);
-                }
+                deadline += std::chrono::microseconds(nEvTime - curTime);
+                wait_until(deadline, pInteractor);
                 curTime = nEvTime;
-                LOMSE_LOG_DEBUG(Logger::k_score_player, "flush pending events: waitT=%ld, new curTime=%ld",
-                                waitT, curTime);
+                LOMSE_LOG_DEBUG(Logger::k_score_player, "flush pending events: new curTime=%lld",
+                                curTime);
             }
 
             if (fSendMtrOff)
@@ -580,9 +713,9 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                 if (fPlayWithMetronome || fCountOffPulseActive)
                 {
                     if (fFirstBeatInMeasure)
-                        m_pMidi->note_off(m_MtrChannel, m_MtrTone1, 127);
+                        m_pMidi->note_off_at(deadline, m_MtrChannel, m_MtrTone1, 127);
                     else
-                        m_pMidi->note_off(m_MtrChannel, m_MtrTone2, 80);
+                        m_pMidi->note_off_at(deadline, m_MtrChannel, m_MtrTone2, 80);
 
                     fCountOffPulseActive = false;
                 }
@@ -601,9 +734,9 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                 if (fPlayWithMetronome)
                 {
                     if (fFirstBeatInMeasure)
-                        m_pMidi->note_on(m_MtrChannel, m_MtrTone1, 127);
+                        m_pMidi->note_on_at(deadline, m_MtrChannel, m_MtrTone1, 127);
                     else
-                        m_pMidi->note_on(m_MtrChannel, m_MtrTone2, 80);
+                        m_pMidi->note_on_at(deadline, m_MtrChannel, m_MtrTone2, 80);
                 }
 
                 if (fVisualTracking && nMtrEvDeltaTime >= 0L)
@@ -620,42 +753,30 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                                 nMtrEvDeltaTime);
             }
             curTime = nEvTime;
-            LOMSE_LOG_DEBUG(Logger::k_score_player, "Mtr On/Off: new curTime=%ld, new nMtrEvDeltaTime=%ld"
+            LOMSE_LOG_DEBUG(Logger::k_score_player, "Mtr On/Off: new curTime=%lld, new nMtrEvDeltaTime=%ld"
                             ", m_MtrTone1=%d, m_MtrTone2=%d",
                             curTime, nMtrEvDeltaTime, m_MtrTone1, m_MtrTone2);
         }
         else
         {
             //next even comes from the table. Usually it will be a note on/off
-            nEvTime = time_units_to_milliseconds( events[i]->DeltaTime );
-            LOMSE_LOG_DEBUG(Logger::k_score_player, "nEvTime updated (event i) = %ld", nEvTime);
+            nEvTime = time_units_to_microseconds( events[i]->DeltaTime );
+            LOMSE_LOG_DEBUG(Logger::k_score_player, "nEvTime updated (event i) = %lld", nEvTime);
             if (nEvTime > curTime)
             {
                 //flush accumulated events for curTime
-                long elapsed = 0L;
                 if (fVisualTracking && pEvent->get_num_items() > 0)
                 {
                     LOMSE_LOG_DEBUG(Logger::k_events | Logger::k_score_player,
                                     "Flush pending events");
-                    clock_t t1=clock();
-                    if (m_fPostEvents)
-                        m_libScope.post_event(pEvent);
-                    else if (pInteractor)
-                        pInteractor->handle_event(pEvent);
-                    pEvent = SpEventVisualTracking(
-                                LOMSE_NEW EventVisualTracking(wpInteractor,
-                                                              m_pScore->get_id()) );
-                    clock_t t2=clock();
-                    elapsed = long( ((t2-t1)*1000.0)/double(CLOCKS_PER_SEC));
+                    schedule_tracking_event(pEvent, deadline, pInteractor);
+                    pEvent = new_tracking_event(wpInteractor);
                 }
 
                 //wait until new time arrives
-                long waitT = nEvTime - curTime - elapsed;
-                if (waitT > 0L)
-                {
-                    std::chrono::milliseconds waitTime(waitT);
-                    std::this_thread::sleep_for(waitTime);
-                }
+                deadline += std::chrono::microseconds(nEvTime - curTime);
+                wait_until(deadline, pInteractor);
+                curTime = nEvTime;
             }
 
             //if it is a jump event, execute the jump if applicable
@@ -669,7 +790,7 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                         || pJump->get_times_valid() > pJump->get_executed())
                     {
                         i = pJump->get_event();
-                        nEvTime = time_units_to_milliseconds( events[i]->DeltaTime );
+                        nEvTime = time_units_to_microseconds( events[i]->DeltaTime );
                         curTime = nEvTime;
                         nMtrEvDeltaTime = events[i]->DeltaTime;
                         if (pJump->get_times_valid() > pJump->get_executed())
@@ -693,11 +814,11 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                 switch(playMode)
                 {
                     case k_play_rhythm_instrument:
-                        m_pMidi->note_on(events[i]->Channel, k_SOLFA_NOTE,
+                        m_pMidi->note_on_at(deadline, events[i]->Channel, k_SOLFA_NOTE,
                                         events[i]->Volume);
                         break;
                     case k_play_rhythm_percussion:
-                        m_pMidi->note_on(nPercussionChannel, k_SOLFA_NOTE,
+                        m_pMidi->note_on_at(deadline, nPercussionChannel, k_SOLFA_NOTE,
                                         events[i]->Volume);
                         break;
                     case k_play_rhythm_human_voice:
@@ -705,7 +826,7 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                         break;
                     case k_play_normal_instrument:
                     default:
-                        m_pMidi->note_on(events[i]->Channel, events[i]->NotePitch,
+                        m_pMidi->note_on_at(deadline, events[i]->Channel, events[i]->NotePitch,
                                         events[i]->Volume);
                 }
 
@@ -725,17 +846,17 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                 switch(playMode)
                 {
                     case k_play_rhythm_instrument:
-                        m_pMidi->note_off(events[i]->Channel, k_SOLFA_NOTE, 127);
+                        m_pMidi->note_off_at(deadline, events[i]->Channel, k_SOLFA_NOTE, 127);
                         break;
                     case k_play_rhythm_percussion:
-                        m_pMidi->note_off(nPercussionChannel, k_SOLFA_NOTE, 127);
+                        m_pMidi->note_off_at(deadline, nPercussionChannel, k_SOLFA_NOTE, 127);
                         break;
                     case k_play_rhythm_human_voice:
                         //WaveOff
                         break;
                     case k_play_normal_instrument:
                     default:
-                        m_pMidi->note_off(events[i]->Channel, events[i]->NotePitch, 127);
+                        m_pMidi->note_off_at(deadline, events[i]->Channel, events[i]->NotePitch, 127);
                 }
 
                 //generate implicit visual off event
@@ -806,6 +927,10 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                         m_pMidi->voice_change(events[i]->Channel, events[i]->NotePitch);
                 }
             }
+            else if (events[i]->EventType == SoundEvent::k_tempo_change)
+            {
+                //tempo is controlled by the metronome. Ignore
+            }
             else
             {
                 //program error. Unknown event type. Ignore
@@ -815,7 +940,7 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
             curTime = max(curTime, nEvTime);    //to avoid going backwards when no metronome
                                                 //before start and progInstr events
             i++;
-            LOMSE_LOG_DEBUG(Logger::k_score_player, "Increment i: curTime=%ld", curTime);
+            LOMSE_LOG_DEBUG(Logger::k_score_player, "Increment i: curTime=%lld", curTime);
         }
 
         //check if the thread should be paused or stopped
@@ -824,14 +949,23 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
             LOMSE_LOG_DEBUG(Logger::k_score_player, "Going to finish 1");
             break;
         }
-        while(m_fPaused)
+        if (m_fPaused)
         {
-            std::this_thread::sleep_for( std::chrono::milliseconds(200) );
-            if (m_fShouldStop)
+            PlaybackTime pauseStart = PlaybackClock::now();
+            while(m_fPaused)
             {
-                LOMSE_LOG_DEBUG(Logger::k_score_player, "Going to finish 2");
-                break;
+                std::this_thread::sleep_for( std::chrono::milliseconds(200) );
+                if (m_fShouldStop)
+                {
+                    LOMSE_LOG_DEBUG(Logger::k_score_player, "Going to finish 2");
+                    break;
+                }
             }
+            //shift the clock by the paused time
+            PlaybackClock::duration pausedTime = PlaybackClock::now() - pauseStart;
+            deadline += pausedTime;
+            for (auto& pending : m_pendingTracking)
+                pending.first += pausedTime;
         }
 
         //update metronome information, just in case metronome was updated
@@ -841,14 +975,14 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
             if (m_prevGuiBpm != curGuiBpm)
             {
                 float factor = float(m_prevGuiBpm) / float(curGuiBpm);
-                TimeUnits curTU = double(curTime) / double(m_conversionFactor);
-                m_conversionFactor *= factor;
+                TimeUnits curTU = double(curTime) / m_conversionFactor;
+                m_conversionFactor *= double(m_prevGuiBpm) / double(curGuiBpm);
                 m_nPrevMtrIntval = m_nCurMtrIntval;
                 m_nCurMtrIntval = long( float(m_nCurMtrIntval) * factor);
                 m_prevGuiBpm = curGuiBpm;
 
-                curTime = time_units_to_milliseconds(curTU);
-                LOMSE_LOG_DEBUG(Logger::k_score_player, "Mtr updated: new curTime=%ld, new nMtrEvDeltaTime=%ld"
+                curTime = time_units_to_microseconds(curTU);
+                LOMSE_LOG_DEBUG(Logger::k_score_player, "Mtr updated: new curTime=%lld, new nMtrEvDeltaTime=%ld"
                                 ", new m_nCurMtrIntval=%ld, curGuiBpm=%ld",
                                 curTime, nMtrEvDeltaTime, m_nCurMtrIntval, curGuiBpm);
             }
@@ -861,6 +995,8 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
     // 690 without sending last event. It is not important as next event will remove all
     // highlight but should be studied and decided. Can be sent here.
 
+    send_pending_tracking_events(pInteractor);
+
     //ensure that all visual highlight is removed
     if (fVisualTracking && !m_fQuit)
     {
@@ -870,10 +1006,7 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
         pEvent->add_item(EventVisualTracking::k_end_of_visual_tracking, k_no_imoid);
         LOMSE_LOG_DEBUG(Logger::k_events | Logger::k_score_player,
                         "Flush pending events");
-        if (m_fPostEvents)
-            m_libScope.post_event(pEvent);
-        else if (pInteractor)
-            pInteractor->handle_event(pEvent);
+        send_tracking_event(pEvent, pInteractor);
     }
     LOMSE_LOG_DEBUG(Logger::k_score_player, "<< Exit");
 }
@@ -0,0 +1,203 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include <UnitTest++.h>
+#include <sstream>
+#include "lomse_build_options.h"
+
+//classes related to these tests
+#include "lomse_batch_renderer.h"
+#include "lomse_doorway.h"
+#include "lomse_document.h"
+#include "lomse_font_storage.h"
+#include "lomse_injectors.h"
+#include "lomse_interactor.h"
+#include "lomse_presenter.h"
+
+#if (LOMSE_ENABLE_THREADS == 1)
+    #include <thread>
+#endif
+
+using namespace UnitTest;
+using namespace std;
+using namespace lomse;
+
+//---------------------------------------------------------------------------------------
+class BatchRendererTestFixture
+{
+public:
+    std::string m_scores_path;
+
+    BatchRendererTestFixture()     //SetUp fixture
+    {
+        m_scores_path = TESTLIB_SCORES_PATH;
+    }
+
+    ~BatchRendererTestFixture()    //TearDown fixture
+    {
+    }
+
+    string score(int numMeasures, const string& pitch)
+    {
+        stringstream ss;
+        ss << "(score (vers 2.0)(instrument (musicData (clef G)(time 4 4)";
+        for (int i=0; i < numMeasures; ++i)
+            ss << "(n " << pitch << " q)(n " << pitch << " q)(n " << pitch
+               << " h)(barline)";
+        ss << ")))";
+        return ss.str();
+    }
+
+    vector<BatchRenderJob> create_jobs(int output)
+    {
+        static const char* pitches[] = { "c4", "e4", "g4", "b4", "d5" };
+        vector<BatchRenderJob> jobs(10);
+        for (int i=0; i < 10; ++i)
+        {
+            jobs[i].source = score(5 + 4*i, pitches[i % 5]);
+            jobs[i].format = Document::k_format_ldp;
+            jobs[i].output = output;
+            jobs[i].width = 300;
+            jobs[i].height = 400;
+        }
+        return jobs;
+    }
+};
+
+
+SUITE(BatchRendererTest)
+{
+
+    TEST_FIXTURE(BatchRendererTestFixture, batch_renderer_01)
+    {
+        //@01. SVG output is the same than when rendering each document
+        LomseDoorway doorway;
+        doorway.init_library(k_pix_format_rgba32, 96);
+        doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+
+        vector<BatchRenderJob> jobs = create_jobs(k_batch_output_svg);
+        doorway.render_batch(jobs, 3);
+
+        for (BatchRenderJob& job : jobs)
+        {
+            Presenter* pPresenter = doorway.new_document(k_view_vertical_book,
+                                                         job.source, job.format);
+            Interactor* pIntor = pPresenter->get_interactor_raw_ptr(0);
+            stringstream svg;
+            pIntor->render_as_svg(svg, 0);
+            delete pPresenter;
+
+            CHECK( job.ok == true );
+            CHECK( job.errors == "" );
+            CHECK( job.svg == svg.str() );
+        }
+    }
+
+    TEST_FIXTURE(BatchRendererTestFixture, batch_renderer_02)
+    {
+        //@02. result does not depend on the number of threads
+        LomseDoorway doorway;
+        doorway.init_library(k_pix_format_rgba32, 96);
+        doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+
+        vector<BatchRenderJob> jobs1 = create_jobs(k_batch_output_bitmap);
+        doorway.render_batch(jobs1, 1);
+        vector<BatchRenderJob> jobs4 = create_jobs(k_batch_output_bitmap);
+        doorway.render_batch(jobs4, 4);
+
+        for (size_t i=0; i < jobs1.size(); ++i)
+        {
+            CHECK( jobs1[i].ok == true );
+            CHECK( jobs4[i].ok == true );
+            CHECK( jobs1[i].bitmap.size() == 300 * 400 * 4 );
+            CHECK( jobs1[i].bitmap == jobs4[i].bitmap );
+        }
+        CHECK( jobs1[0].bitmap != jobs1[1].bitmap );
+    }
+
+    TEST_FIXTURE(BatchRendererTestFixture, batch_renderer_03)
+    {
+        //@03. errors are reported in the job
+        LomseDoorway doorway;
+        doorway.init_library(k_pix_format_rgba32, 96);
+        doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+
+        vector<BatchRenderJob> jobs = create_jobs(k_batch_output_bitmap);
+        jobs.resize(3);
+        jobs[0].page = 7;
+        jobs[1].width = 0;
+        doorway.render_batch(jobs);
+
+        CHECK( jobs[0].ok == false );
+        CHECK( jobs[0].errors == "Batch render: invalid page number 7\n" );
+        CHECK( jobs[0].bitmap.empty() );
+        CHECK( jobs[1].ok == false );
+        CHECK( jobs[1].errors == "Batch render: invalid bitmap size 0x400\n" );
+        CHECK( jobs[2].ok == true );
+    }
+
+#if (LOMSE_ENABLE_THREADS == 1)
+    TEST_FIXTURE(BatchRendererTestFixture, batch_renderer_04)
+    {
+        //@04. each thread has its own FontStorage
+        LibraryScope libraryScope(cout);
+        FontStorage* pMain = libraryScope.font_storage();
+        FontStorage* pOther = nullptr;
+        std::thread t([&]() { pOther = libraryScope.font_storage(); });
+        t.join();
+
+        CHECK( pMain == libraryScope.font_storage() );
+        CHECK( pOther != nullptr );
+        CHECK( pOther != pMain );
+    }
+
+    TEST_FIXTURE(BatchRendererTestFixture, batch_renderer_05)
+    {
+        //@05. FontStorage for worker threads is deleted when the batch ends
+        LomseDoorway doorway;
+        doorway.init_library(k_pix_format_rgba32, 96);
+        doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        LibraryScope* pLibScope = doorway.get_library_scope();
+        FontStorage* pMain = pLibScope->font_storage();
+
+        vector<BatchRenderJob> jobs = create_jobs(k_batch_output_svg);
+        doorway.render_batch(jobs, 4);
+        CHECK( pLibScope->get_num_font_storages() == 1 );
+        jobs = create_jobs(k_batch_output_svg);
+        doorway.render_batch(jobs, 4);
+        CHECK( pLibScope->get_num_font_storages() == 1 );
+
+        CHECK( pLibScope->font_storage() == pMain );
+        for (BatchRenderJob& job : jobs)
+            CHECK( job.ok == true );
+    }
+
+    TEST_FIXTURE(BatchRendererTestFixture, batch_renderer_06)
+    {
+        //@06. a released FontStorage is created again when needed
+        LibraryScope libraryScope(cout);
+        FontStorage* pNew = nullptr;
+        FontStorage* pCached = nullptr;
+        std::thread t([&]()
+        {
+            libraryScope.font_storage();
+            libraryScope.release_thread_font_storage();
+            pNew = libraryScope.font_storage();
+            pCached = libraryScope.font_storage();
+        });
+        t.join();
+
+        CHECK( pNew != nullptr );
+        CHECK( pCached == pNew );
+        CHECK( libraryScope.get_num_font_storages() == 1 );
+    }
+#endif
+
+}
@@ -0,0 +1,253 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#include <UnitTest++.h>
+#include <sstream>
+#include "lomse_build_options.h"
+
+//classes related to these tests
+#include "lomse_injectors.h"
+#include "lomse_binary_exporter.h"
+#include "lomse_ldp_exporter.h"
+#include "lomse_im_serializer.h"
+#include "lomse_internal_model.h"
+#include "lomse_im_factory.h"
+#include "lomse_staffobjs_table.h"
+#include "private/lomse_document_p.h"
+
+#include <cstdio>
+
+
+using namespace UnitTest;
+using namespace std;
+using namespace lomse;
+
+
+//=======================================================================================
+// test for BinaryExporter and BinaryCompiler
+//=======================================================================================
+
+class BinaryExporterTestFixture
+{
+public:
+    LibraryScope m_libraryScope;
+    std::string m_scores_path;
+
+    BinaryExporterTestFixture()     //SetUp fixture
+        : m_libraryScope(cout)
+    {
+        m_scores_path = TESTLIB_SCORES_PATH;
+        m_libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    }
+
+    ~BinaryExporterTestFixture()    //TearDown fixture
+    {
+    }
+
+    inline const char* test_name()
+    {
+        return UnitTest::CurrentTest::Details()->testName;
+    }
+
+    string model_source(Document& doc)
+    {
+        LdpExporter exporter;
+        exporter.set_add_id(true);
+        return exporter.get_source(doc.get_im_root());
+    }
+
+    string tables_dump(Document& doc)
+    {
+        string dump;
+        ImoObj* pContent = doc.get_im_root()->get_content();
+        for (ImoObj::children_iterator it = pContent->begin(); it != pContent->end(); ++it)
+        {
+            if ((*it)->is_score())
+            {
+                ImoScore* pScore = static_cast<ImoScore*>(*it);
+                dump += pScore->get_staffobjs_table()->dump();
+            }
+        }
+        return dump;
+    }
+
+    bool check_round_trip(const string& file, int format)
+    {
+        stringstream errormsg;
+        Document doc(m_libraryScope, errormsg);
+        doc.from_file(m_scores_path + file, format);
+
+        BinaryExporter exporter;
+        string data = exporter.get_source(doc.get_im_root());
+        if (data.empty())
+        {
+            cout << test_name() << ": " << file << ": " << exporter.get_error() << endl;
+            return false;
+        }
+
+        Document doc2(m_libraryScope, errormsg);
+        int numErrors = doc2.from_string(data, Document::k_format_binary);
+
+        bool fOk = numErrors == 0
+                   && model_source(doc) == model_source(doc2)
+                   && tables_dump(doc) == tables_dump(doc2)
+                   && exporter.get_source(doc2.get_im_root()) == data;
+        if (!fOk)
+            cout << test_name() << ": " << file << ": differences after loading" << endl;
+        return fOk;
+    }
+
+};
+
+//---------------------------------------------------------------------------------------
+SUITE(BinaryExporterTest)
+{
+
+    TEST_FIXTURE(BinaryExporterTestFixture, binary_exporter_01)
+    {
+        //@01. round trip. Same model, tables and snapshot after loading
+
+        CHECK( check_round_trip("01026-beamed-chords.lms", Document::k_format_ldp) );
+        CHECK( check_round_trip("02092-chant.lms", Document::k_format_ldp) );
+        CHECK( check_round_trip("unit-tests/other/04-multimetric.lms",
+                                Document::k_format_ldp) );
+        CHECK( check_round_trip("08011-paragraph.lmd", Document::k_format_lmd) );
+        CHECK( check_round_trip("00047-grace-notes.xml", Document::k_format_mxl) );
+        CHECK( check_round_trip("50051-arpeggios-more-space.xml", Document::k_format_mxl) );
+        CHECK( check_round_trip("unit-tests/other/03-BeetAnGeSample.xml",
+                                Document::k_format_mxl) );
+    }
+
+    TEST_FIXTURE(BinaryExporterTestFixture, binary_exporter_02)
+    {
+        //@02. ids are preserved and new objects receive new ids
+
+        Document doc(m_libraryScope);
+        doc.from_file(m_scores_path + "unit-tests/other/03-BeetAnGeSample.xml",
+                      Document::k_format_mxl);
+        BinaryExporter exporter;
+        string data = exporter.get_source(doc.get_im_root());
+
+        Document doc2(m_libraryScope);
+        doc2.from_string(data, Document::k_format_binary);
+
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        ImoScore* pScore2 = static_cast<ImoScore*>( doc2.get_im_root()->get_content_item(0) );
+        ImoMusicData* pMD = pScore->get_instrument(0)->get_musicdata();
+        ImoMusicData* pMD2 = pScore2->get_instrument(0)->get_musicdata();
+        ImoObj::children_iterator it = pMD->begin();
+        ImoObj::children_iterator it2 = pMD2->begin();
+        for (; it != pMD->end() && it2 != pMD2->end(); ++it, ++it2)
+        {
+            CHECK( (*it)->get_id() == (*it2)->get_id() );
+            CHECK( doc2.get_pointer_to_imo((*it2)->get_id()) == *it2 );
+        }
+        CHECK( it == pMD->end() );
+        CHECK( it2 == pMD2->end() );
+
+        ImoObj* pImo = ImFactory::inject(k_imo_note_regular, &doc2);
+        CHECK( doc2.get_pointer_to_imo(pImo->get_id()) == pImo );
+        CHECK( doc.get_pointer_to_imo(pImo->get_id()) == nullptr );
+        delete pImo;
+    }
+
+    TEST_FIXTURE(BinaryExporterTestFixture, binary_exporter_03)
+    {
+        //@03. save to file and load it
+
+        Document doc(m_libraryScope);
+        doc.from_file(m_scores_path + "01026-beamed-chords.lms");
+        string filename = "lomse-test-binary-exporter.lmb";
+        BinaryExporter exporter;
+
+        CHECK( exporter.save_to_file(doc.get_im_root(), filename) );
+
+        Document doc2(m_libraryScope);
+        CHECK( doc2.from_file(filename, Document::k_format_binary) == 0 );
+        CHECK( model_source(doc) == model_source(doc2) );
+        remove(filename.c_str());
+    }
+
+    TEST_FIXTURE(BinaryExporterTestFixture, binary_exporter_04)
+    {
+        //@04. objects not created by importers can not be saved
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData (clef G)(n c4 q))))");
+        ImoObj* pImage = ImFactory::inject(k_imo_image, &doc);
+        doc.get_im_root()->get_content()->append_child_imo(pImage);
+
+        BinaryExporter exporter;
+
+        CHECK( exporter.get_source(doc.get_im_root()).empty() );
+        CHECK( exporter.get_error() == "Object 'image' can not be saved." );
+    }
+
+    TEST_FIXTURE(BinaryExporterTestFixture, binary_exporter_05)
+    {
+        //@05. invalid data. Error reported and empty document created
+
+        stringstream errormsg;
+        Document doc(m_libraryScope, errormsg);
+        int numErrors = doc.from_string("(score (vers 2.0))", Document::k_format_binary);
+
+        CHECK( numErrors == 1 );
+        CHECK( errormsg.str() == "Invalid data. It is not a lomse snapshot.\n" );
+        CHECK( doc.get_im_root() != nullptr );
+        CHECK( doc.get_im_root()->get_num_content_items() == 0 );
+    }
+
+    TEST_FIXTURE(BinaryExporterTestFixture, binary_exporter_06)
+    {
+        //@06. truncated data. Error reported and empty document created
+
+        Document doc(m_libraryScope);
+        doc.from_file(m_scores_path + "01026-beamed-chords.lms");
+        BinaryExporter exporter;
+        string data = exporter.get_source(doc.get_im_root());
+        CHECK( ImSerializer::is_snapshot(data.data(), data.size()) );
+
+        stringstream errormsg;
+        Document doc2(m_libraryScope, errormsg);
+        int numErrors = doc2.from_string(data.substr(0, data.size() / 2),
+                                         Document::k_format_binary);
+
+        CHECK( numErrors == 1 );
+        CHECK( errormsg.str() == "Invalid snapshot. Unexpected end of data.\n" );
+        CHECK( doc2.get_im_root()->get_num_content_items() == 0 );
+    }
+
+    TEST_FIXTURE(BinaryExporterTestFixture, binary_exporter_07)
+    {
+        //@07. data truncated at any point. The partially loaded model, with ties,
+        //@    slurs and lyrics, is deleted
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData (clef G)"
+            "(n c4 q (tie 1 start)(lyric 1 \"A\" -))(n c4 q (tie 1 stop)(lyric 1 \"ve\"))"
+            "(n e4 e (slur 1 start)(beam 1 +))(n f4 e (slur 1 stop)(beam 1 -))"
+            "(barline) )))");
+        BinaryExporter exporter;
+        string data = exporter.get_source(doc.get_im_root());
+
+        int numFailures = 0;
+        for (size_t size = 0; size < data.size(); size += 7)
+        {
+            stringstream errormsg;
+            Document doc2(m_libraryScope, errormsg);
+            if (doc2.from_string(data.substr(0, size), Document::k_format_binary) != 1
+                || doc2.get_im_root()->get_num_content_items() != 0)
+            {
+                ++numFailures;
+            }
+        }
+        CHECK( numFailures == 0 );
+    }
+
+}
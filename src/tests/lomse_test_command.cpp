@@ -20,6 +20,7 @@
 #include "lomse_im_attributes.h"
 #include "lomse_selections.h"
 #include "lomse_ldp_exporter.h"
+#include "lomse_model_builder.h"
 
 using namespace UnitTest;
 using namespace std;
@@ -1104,6 +1105,50 @@ SUITE(DocCommandTest)
         //cout << pTable->dump() << endl;
      }
 
+    TEST_FIXTURE(DocCommandTestFixture, add_noterest_0404)
+    {
+		//0404. replaced note in second instrument. Duration of next note reduced.
+		//      Structures are updated as when structurizing the whole score
+
+        MyDocument3 doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (musicData (clef G)(time 2 4)(n c4 q v1)(n e4 q v1)(barline)))"
+            "(instrument (musicData (clef F4)(time 2 4)"
+            "(n#300 c3 e v1 p1)(n e3 e v1 p1)(n g3 q v1 p1)(barline)))"
+            ")");
+        doc.my_clear_dirty();
+        DocCursor cursor(&doc);
+        DocCommandExecuter executer(&doc);
+        cursor.point_to(300L);
+
+        DocCommand* pCmd = LOMSE_NEW CmdAddNoteRest("(n d3 e. v1 p1)", k_edit_mode_replace);
+
+        MySelectionSet sel(&doc);
+        executer.execute(&cursor, pCmd, &sel);
+
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+        CHECK( pTable->num_entries() == 11 );
+        ColStaffObjsIterator it = pTable->begin();
+        //              instr, staff, meas. time, line, scr
+        CHECK_ENTRY0(it, 0,    0,      0,   0,     0, "(clef G p1)" );
+        CHECK_ENTRY0(it, 0,    0,      0,   0,     0, "(time 2 4)" );
+        CHECK_ENTRY0(it, 1,    0,      0,   0,     1, "(clef F4 p1)" );
+        CHECK_ENTRY0(it, 1,    0,      0,   0,     1, "(time 2 4)" );
+        CHECK_ENTRY0(it, 0,    0,      0,   0,     0, "(n c4 q v1 p1)" );
+        CHECK_ENTRY0(it, 1,    0,      0,   0,     1, "(n d3 e. v1 p1)" );
+        CHECK_ENTRY0(it, 1,    0,      0,  48,     1, "(n e3 s v1 p1)" );
+        CHECK_ENTRY0(it, 0,    0,      0,  64,     0, "(n e4 q v1 p1)" );
+        CHECK_ENTRY0(it, 1,    0,      0,  64,     1, "(n g3 q v1 p1)" );
+        CHECK_ENTRY0(it, 0,    0,      0, 128,     0, "(barline simple)" );
+        CHECK_ENTRY0(it, 1,    0,      0, 128,     1, "(barline simple)" );
+
+        stringstream errormsg;
+        ModelBuilder builder;
+        CHECK( builder.check_structure(pScore, errormsg) == true );
+//        cout << test_name() << ": " << errormsg.str() << endl;
+     }
+
     TEST_FIXTURE(DocCommandTestFixture, add_noterest_0900)
     {
 		//0900. bug. replace triplet eighth note by eight dotted
@@ -5322,4 +5367,136 @@ SUITE(DocCommandTest)
         CHECK( (*cursor)->to_string() == "(n f4 e v1 p1)" );
     }
 
+
+    TEST_FIXTURE(DocCommandTestFixture, undo_9003)
+    {
+        //9003. undo: model restored from nearest checkpoint
+
+        MyDocument3 doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument#90 (musicData#122 "
+            "(clef G)"
+            ")))");
+        doc.my_clear_dirty();
+        DocCursor cursor(&doc);
+        DocCommandExecuter executer(&doc);
+        executer.set_checkpoint_interval(2);
+        cursor.enter_element();     //points to clef
+        cursor.move_next();         //points to end of score
+        MySelectionSet sel(&doc);
+
+        const string notes[] = { "(n c4 e v1)", "(n d4 e v1)", "(n e4 e v1)",
+                                 "(n f4 e v1)", "(n g4 e v1)" };
+        for (const string& note : notes)
+            executer.execute(&cursor, LOMSE_NEW CmdAddNoteRest(note, k_edit_mode_replace),
+                             &sel);
+        CHECK( executer.num_checkpoints() == 2 );     //after 2 and 4 commands
+
+        executer.undo(&cursor, &sel);       //from checkpoint 4
+        executer.undo(&cursor, &sel);       //from checkpoint 2
+        executer.undo(&cursor, &sel);       //from checkpoint 2
+
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+//        cout << test_name() << ". after:" << endl << pScore->to_string(true) << endl;
+        CHECK( pScore->get_staffobjs_table()->num_entries() == 3 );
+        CHECK( *cursor == nullptr );
+        cursor.move_prev();
+        CHECK( (*cursor)->is_note() == true );
+        CHECK( (*cursor)->to_string() == "(n d4 e v1 p1)" );
+
+        //redo keeps checkpoints. New commands discard those for redo history
+        executer.redo(&cursor, &sel);
+        CHECK( executer.num_checkpoints() == 2 );
+        executer.execute(&cursor, LOMSE_NEW CmdAddNoteRest("(n a4 e v1)",
+                                                           k_edit_mode_replace), &sel);
+        CHECK( executer.num_checkpoints() == 2 );     //after 2 and 4 (new) commands
+        executer.undo(&cursor, &sel);
+
+        pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        CHECK( pScore->get_staffobjs_table()->num_entries() == 4 );
+        CHECK( *cursor == nullptr );
+        cursor.move_prev();
+        CHECK( (*cursor)->is_note() == true );
+        CHECK( (*cursor)->to_string() == "(n e4 e v1 p1)" );
+    }
+
+    TEST_FIXTURE(DocCommandTestFixture, undo_9004)
+    {
+        //9004. checkpoints: memory limit is respected and most recent one is kept
+
+        MyDocument3 doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument#90 (musicData#122 "
+            "(clef G)"
+            ")))");
+        doc.my_clear_dirty();
+        DocCursor cursor(&doc);
+        DocCommandExecuter executer(&doc);
+        executer.set_checkpoint_interval(1);
+        cursor.enter_element();     //points to clef
+        cursor.move_next();         //points to end of score
+        MySelectionSet sel(&doc);
+
+        for (int i=0; i < 8; ++i)
+            executer.execute(&cursor, LOMSE_NEW CmdAddNoteRest("(n c4 e v1)",
+                                                               k_edit_mode_replace), &sel);
+        CHECK( executer.num_checkpoints() == 8 );
+        size_t size = executer.checkpoints_size();
+
+        executer.set_checkpoints_memory_limit(size / 2);
+        CHECK( executer.checkpoints_size() <= size / 2 );
+        CHECK( executer.num_checkpoints() > 0 );
+        CHECK( executer.num_checkpoints() < 8 );
+
+        executer.undo(&cursor, &sel);
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        CHECK( pScore->get_staffobjs_table()->num_entries() == 8 );
+
+        executer.set_checkpoint_interval(0);
+        CHECK( executer.num_checkpoints() == 0 );
+        CHECK( executer.checkpoints_size() == 0 );
+        executer.undo(&cursor, &sel);
+        pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        CHECK( pScore->get_staffobjs_table()->num_entries() == 7 );
+    }
+
+    TEST_FIXTURE(DocCommandTestFixture, undo_9005)
+    {
+        //9005. checkpoints: replayed commands assign the same ids, even when the
+        //      newest object was deleted before the checkpoint
+
+        MyDocument3 doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument#90 (musicData#122 "
+            "(clef G)"
+            ")))");
+        doc.my_clear_dirty();
+        DocCursor cursor(&doc);
+        DocCommandExecuter executer(&doc);
+        executer.set_checkpoint_interval(2);
+        cursor.enter_element();     //points to clef
+        cursor.move_next();         //points to end of score
+        MySelectionSet sel(&doc);
+
+        executer.execute(&cursor, LOMSE_NEW CmdAddNoteRest("(n c4 e v1)",
+                                                           k_edit_mode_replace), &sel);
+        cursor.move_prev();         //points to c4
+        executer.execute(&cursor, LOMSE_NEW CmdDeleteStaffObj(), &sel);
+        CHECK( executer.num_checkpoints() == 1 );     //after deleting c4
+
+        executer.execute(&cursor, LOMSE_NEW CmdAddNoteRest("(n d4 e v1)",
+                                                           k_edit_mode_replace), &sel);
+        cursor.move_prev();         //points to d4
+        ImoId idNote = (*cursor)->get_id();
+        executer.execute(&cursor, LOMSE_NEW CmdDeleteStaffObj(), &sel);
+
+        executer.undo(&cursor, &sel);       //from checkpoint 2
+        CHECK( *cursor != nullptr );
+        CHECK( *cursor && (*cursor)->get_id() == idNote );
+        CHECK( doc.get_pointer_to_imo(idNote) != nullptr );
+        CHECK( *cursor && (*cursor)->to_string() == "(n d4 e v1 p1)" );
+
+        executer.redo(&cursor, &sel);
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        CHECK( pScore->get_staffobjs_table()->num_entries() == 1 );
+        CHECK( doc.get_pointer_to_imo(idNote) == nullptr );
+    }
+
 }
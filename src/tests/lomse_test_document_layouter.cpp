@@ -13,6 +13,7 @@
 
 //classes related to these tests
 #include "lomse_document_layouter.h"
+#include "lomse_score_layouter.h"
 #include "lomse_injectors.h"
 #include "private/lomse_document_p.h"
 #include "lomse_graphical_model.h"
@@ -65,6 +66,40 @@ public:
     ~DocLayouterTestFixture()
     {
     }
+
+    string long_score(int numInstruments, int numMeasures)
+    {
+        stringstream ss;
+        ss << "(score (vers 2.0)";
+        for (int iInstr=0; iInstr < numInstruments; ++iInstr)
+        {
+            ss << "(instrument (musicData (clef G)(key C)(time 4 4)";
+            for (int i=0; i < numMeasures; ++i)
+                ss << "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline)";
+            ss << "))";
+        }
+        ss << ")";
+        return ss.str();
+    }
+
+    string dump_gmodel(GraphicModel* pGModel)
+    {
+        stringstream ss;
+        for (int i=0; i < pGModel->get_num_pages(); ++i)
+            pGModel->dump_page(i, ss);
+        return ss.str();
+    }
+
+    int count_reused_columns(ScoreLayouter* pScoreLyt)
+    {
+        int numReused = 0;
+        for (int iCol=0; iCol < pScoreLyt->get_num_columns(); ++iCol)
+        {
+            if (pScoreLyt->is_reused_column(iCol))
+                ++numReused;
+        }
+        return numReused;
+    }
 };
 
 //---------------------------------------------------------------------------------------
@@ -499,5 +534,157 @@ SUITE(DocLayouterTest)
         delete pGModel;
     }
 
+    TEST_FIXTURE(DocLayouterTestFixture, DocLayouter_incremental_layout_01)
+    {
+        //@01. incremental layout. Columns in reused systems are neither engraved nor
+        //@    spaced. Result equal to a full layout
+
+        Document doc(m_libraryScope);
+        doc.from_string(long_score(2, 200), Document::k_format_ldp);
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        DocLayouter dl1(&doc, m_libraryScope);
+        dl1.layout_document();
+        GraphicModel* pGModel1 = dl1.get_graphic_model();
+        string expected = dump_gmodel(pGModel1);
+
+        pGModel1->get_stub_for(pScore->get_id())->mark_measures_as_dirty(120, 120);
+        DocLayouter dl2(&doc, m_libraryScope);
+        dl2.set_previous_graphic_model(pGModel1);
+        dl2.layout_document();
+        GraphicModel* pGModel2 = dl2.get_graphic_model();
+
+        ScoreLayouter* pScoreLyt = dl2.get_score_layouter();
+        CHECK( pScoreLyt != nullptr );
+        int numReused = count_reused_columns(pScoreLyt);
+        CHECK( numReused > pScoreLyt->get_num_columns() / 2 );
+        CHECK( numReused < pScoreLyt->get_num_columns() );
+        CHECK( dump_gmodel(pGModel2) == expected );
+
+        delete pGModel1;
+        delete pGModel2;
+    }
+
+    TEST_FIXTURE(DocLayouterTestFixture, DocLayouter_incremental_layout_02)
+    {
+        //@02. incremental layout. When a system with reused columns can not be
+        //@    reused, the score is laid out again without the previous model
+
+        Document doc(m_libraryScope);
+        doc.from_string(long_score(2, 200), Document::k_format_ldp);
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        DocLayouter dl1(&doc, m_libraryScope);
+        dl1.layout_document();
+        GraphicModel* pGModel1 = dl1.get_graphic_model();
+        string expected = dump_gmodel(pGModel1);
+
+        //force a different free space above the last systems
+        ScoreStub* pStub = pGModel1->get_stub_for(pScore->get_id());
+        pStub->mark_measures_as_dirty(0, 0);
+        vector<ScoreStub::SystemLayoutInfo>& systems = pStub->get_systems_info();
+        for (size_t i=systems.size() / 2; i < systems.size(); ++i)
+            systems[i].prevFreeSpace += 1000.0f;
+
+        DocLayouter dl2(&doc, m_libraryScope);
+        dl2.set_previous_graphic_model(pGModel1);
+        dl2.layout_document();
+        GraphicModel* pGModel2 = dl2.get_graphic_model();
+
+        ScoreLayouter* pScoreLyt = dl2.get_score_layouter();
+        CHECK( pScoreLyt != nullptr );
+        CHECK( count_reused_columns(pScoreLyt) == 0 );
+        CHECK( dump_gmodel(pGModel2) == expected );
+
+        delete pGModel1;
+        delete pGModel2;
+    }
+
+    TEST_FIXTURE(DocLayouterTestFixture, DocLayouter_lazy_layout_01)
+    {
+        //@01. lazy layout. Only first page is laid out. Pages estimated
+
+        Document doc(m_libraryScope);
+        doc.from_string(long_score(4, 200), Document::k_format_ldp);
+        DocLayouter* pDL = LOMSE_NEW DocLayouter(&doc, m_libraryScope);
+        pDL->enable_lazy_layout(1);
+        pDL->layout_document();
+        GraphicModel* pGModel = pDL->get_graphic_model();
+
+        CHECK( pDL->is_layout_finished() == false );
+        CHECK( pGModel->is_layout_finished() == false );
+        CHECK( pGModel->get_num_pages() == 1 );
+        CHECK( pGModel->get_estimated_num_pages() > 1 );
+
+        delete pDL;
+        delete pGModel;
+    }
+
+    TEST_FIXTURE(DocLayouterTestFixture, DocLayouter_lazy_layout_02)
+    {
+        //@02. lazy layout. More pages on demand, until finished
+
+        Document doc(m_libraryScope);
+        doc.from_string(long_score(4, 200), Document::k_format_ldp);
+        DocLayouter dl(&doc, m_libraryScope);
+        dl.enable_lazy_layout(1);
+        dl.layout_document();
+        GraphicModel* pGModel = dl.get_graphic_model();
+
+        CHECK( dl.layout_more_pages(2) == true );
+        CHECK( pGModel->get_num_pages() == 3 );
+
+        CHECK( dl.layout_more_pages(0) == false );
+        CHECK( dl.is_layout_finished() == true );
+        CHECK( pGModel->is_layout_finished() == true );
+        CHECK( pGModel->get_num_pages() > 3 );
+        CHECK( pGModel->get_estimated_num_pages() == pGModel->get_num_pages() );
+        CHECK( dl.layout_more_pages(1) == false );
+
+        delete pGModel;
+    }
+
+    TEST_FIXTURE(DocLayouterTestFixture, DocLayouter_lazy_layout_03)
+    {
+        //@03. lazy layout. Same pages and systems than when not lazy
+
+        Document doc(m_libraryScope);
+        doc.from_string(long_score(4, 200), Document::k_format_ldp);
+        DocLayouter dl1(&doc, m_libraryScope);
+        dl1.layout_document();
+        GraphicModel* pGModel1 = dl1.get_graphic_model();
+
+        DocLayouter dl2(&doc, m_libraryScope);
+        dl2.enable_lazy_layout(1);
+        dl2.layout_document();
+        while (dl2.layout_more_pages(1));
+        GraphicModel* pGModel2 = dl2.get_graphic_model();
+
+        CHECK( pGModel1->get_num_pages() == pGModel2->get_num_pages() );
+        CHECK( pGModel1->get_page(0)->get_child_box(0)->get_child_box(0)->get_num_boxes()
+               == pGModel2->get_page(0)->get_child_box(0)->get_child_box(0)->get_num_boxes() );
+
+        delete pGModel1;
+        delete pGModel2;
+    }
+
+    TEST_FIXTURE(DocLayouterTestFixture, DocLayouter_lazy_layout_04)
+    {
+        //@04. lazy layout. Short document finished at once
+
+        Document doc(m_libraryScope);
+        doc.from_string("(lenmusdoc (vers 0.0) (content (score (vers 1.6) "
+            "(instrument (musicData (clef G)(key e)(n c4 q)(r q)(barline simple))))))" );
+        DocLayouter dl(&doc, m_libraryScope);
+        dl.enable_lazy_layout(1);
+        dl.layout_document();
+        GraphicModel* pGModel = dl.get_graphic_model();
+
+        CHECK( dl.is_layout_finished() == true );
+        CHECK( pGModel->is_layout_finished() == true );
+        CHECK( pGModel->get_num_pages() == 1 );
+        CHECK( dl.layout_more_pages(1) == false );
+
+        delete pGModel;
+    }
+
 
 };
@@ -157,4 +157,39 @@ SUITE(LdpElementsTest)
         delete pNum;
     }
 
+    TEST_FIXTURE(LdpElementsTestFixture, FactoryReturnsType)
+    {
+        CHECK( m_pLdpFactory->get_type("n") == k_note );
+        CHECK( m_pLdpFactory->get_type("dyn") == k_dynamics_mark );
+        CHECK( m_pLdpFactory->get_type("invalid") == k_undefined );
+    }
+
+    TEST_FIXTURE(LdpElementsTestFixture, ElementNamesAreShared)
+    {
+        LdpElement* clef1 = m_pLdpFactory->create("clef");
+        LdpElement* clef2 = m_pLdpFactory->create(k_clef);
+        CHECK( &clef1->get_name() == &clef2->get_name() );
+        delete clef1;
+        delete clef2;
+    }
+
+    TEST_FIXTURE(LdpElementsTestFixture, CanCreateElementsInArena)
+    {
+        LdpArena* pArena = LOMSE_NEW LdpArena();
+        LdpElement* note = m_pLdpFactory->create("n", 7, pArena);
+        note->append_child( m_pLdpFactory->new_value(k_pitch, "c4", 7, pArena) );
+        note->append_child( m_pLdpFactory->new_label("q") );     //in heap
+        for (int i=0; i < 1000; ++i)
+            note->append_child( m_pLdpFactory->new_number("1", 8, pArena) );
+        pArena->release();
+
+        CHECK( note->get_type() == k_note );
+        CHECK( note->get_name() == "n" );
+        CHECK( note->get_line_number() == 7 );
+        CHECK( note->get_num_parameters() == 1002 );
+        CHECK( note->get_parameter(1)->to_string() == "c4" );
+        CHECK( note->get_parameter(2)->to_string() == "q" );
+        delete note;    //arena is deleted with its last element
+    }
+
 }
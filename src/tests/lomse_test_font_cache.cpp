@@ -0,0 +1,137 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#include <UnitTest++.h>
+#include <sstream>
+#include "lomse_build_options.h"
+
+//classes related to these tests
+#include "lomse_font_cache_manager.h"
+#include "lomse_calligrapher.h"
+#include "lomse_injectors.h"
+
+#if (LOMSE_ENABLE_THREADS == 1)
+    #include <thread>
+#endif
+
+using namespace UnitTest;
+using namespace std;
+using namespace lomse;
+
+//---------------------------------------------------------------------------------------
+class FontCacheTestFixture
+{
+public:
+    LibraryScope m_libraryScope;
+
+    FontCacheTestFixture()     //SetUp fixture
+        : m_libraryScope(cout)
+    {
+        m_libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    }
+
+    ~FontCacheTestFixture()    //TearDown fixture
+    {
+    }
+
+    LUnits measure(LibraryScope& libraryScope, const string& text)
+    {
+        TextMeter meter(libraryScope);
+        meter.select_font("en", "", "Liberation serif", 12.0);
+        return meter.measure_width(text);
+    }
+};
+
+
+SUITE(FontCacheTest)
+{
+
+    TEST_FIXTURE(FontCacheTestFixture, font_cache_pool_01)
+    {
+        //@01. least recently used font is removed
+        font_cache_pool pool(2);
+        std::shared_ptr<font_cache> a = pool.font("a");
+        std::shared_ptr<font_cache> b = pool.font("b");
+        CHECK( pool.font("a") == a );
+        pool.font("c");
+
+        CHECK( pool.num_fonts() == 2 );
+        CHECK( pool.evictions() == 1 );
+        CHECK( pool.font("a") == a );
+        CHECK( pool.font("b") != b );
+        CHECK( b->font_is("b") );       //still valid while in use
+    }
+
+    TEST_FIXTURE(FontCacheTestFixture, font_cache_pool_02)
+    {
+        //@02. glyphs are shared by all FontStorage objects
+        font_cache_pool& pool = font_cache_pool::instance();
+        pool.clear();
+        pool.reset_counters();
+
+        LUnits width = measure(m_libraryScope, "Hello world");
+        CHECK( pool.misses() > 0 );
+        unsigned long long misses = pool.misses();
+
+        LibraryScope otherScope(cout);
+        otherScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        CHECK( otherScope.font_storage() != m_libraryScope.font_storage() );
+
+        CHECK( measure(otherScope, "Hello world") == width );
+        CHECK( pool.misses() == misses );
+        CHECK( pool.hits() >= 11 );
+    }
+
+#if (LOMSE_ENABLE_THREADS == 1)
+    TEST_FIXTURE(FontCacheTestFixture, font_cache_pool_03)
+    {
+        //@03. the cache can be used concurrently
+        font_cache_pool::instance().clear();
+        string text = "The quick brown fox jumps over the lazy dog";
+        LUnits width = measure(m_libraryScope, text);
+        font_cache_pool::instance().clear();
+
+        LUnits widths[4];
+        vector<std::thread> threads;
+        for (int i=0; i < 4; ++i)
+        {
+            threads.push_back( std::thread([&, i]() {
+                widths[i] = measure(m_libraryScope, text);
+            }) );
+        }
+        for (std::thread& t : threads)
+            t.join();
+
+        for (int i=0; i < 4; ++i)
+            CHECK( widths[i] == width );
+    }
+#endif
+
+    TEST_FIXTURE(FontCacheTestFixture, font_cache_pool_04)
+    {
+        //@04. statistics include the lookups of deleted FontStorage objects
+        font_cache_pool& pool = font_cache_pool::instance();
+        measure(m_libraryScope, "Hello world");
+        pool.reset_counters();
+        CHECK( pool.hits() == 0 );
+        CHECK( pool.misses() == 0 );
+
+        {
+            LibraryScope otherScope(cout);
+            otherScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+            measure(otherScope, "Hello world");
+        }
+        unsigned long long hits = pool.hits();
+        CHECK( hits >= 11 );
+
+        measure(m_libraryScope, "Hello world");
+        CHECK( pool.hits() >= hits + 11 );
+    }
+
+}
@@ -29,6 +29,10 @@
 #include "lomse_model_builder.h"
 #include "lomse_im_factory.h"
 #include "lomse_timegrid_table.h"
+#include "lomse_playback_timeline.h"
+#include "lomse_presenter.h"
+#include "lomse_selections.h"
+#include "lomse_shapes.h"
 
 using namespace UnitTest;
 using namespace std;
@@ -101,6 +105,16 @@ public:
     {
         return UnitTest::CurrentTest::Details()->testName;
     }
+
+    std::string many_measures_score(int numMeasures)
+    {
+        stringstream ss;
+        ss << "(score (vers 2.0)(instrument (musicData (clef G)(time 4 4)";
+        for (int i=0; i < numMeasures; ++i)
+            ss << "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)";
+        ss << ")))";
+        return ss.str();
+    }
 };
 
 SUITE(GraphicModelTest)
@@ -387,6 +401,116 @@ SUITE(GraphicModelTest)
         delete pIntor;
     }
 
+    // shapes grid (spatial index) --------------------------------------------------------
+
+    TEST_FIXTURE(GraphicModelTestFixture, shapes_grid_01)
+    {
+        //@01. Hit testing with the index gives the same results than scanning the list
+
+        LomseDoorway doorway;
+        doorway.init_library(k_pix_format_rgb24, 82);
+        LibraryScope libraryScope(cout, &doorway);
+        libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        Presenter* pPresenter = doorway.open_document(k_view_vertical_book,
+            m_scores_path + "50041-octave_shift.xml");
+        Interactor* pIntor = pPresenter->get_interactor_raw_ptr(0);
+        GraphicModel* pGM = pIntor->get_graphic_model();
+        GmoBoxDocPage* pPage = pGM->get_page(0);
+
+        CHECK( pPage->is_shapes_grid_valid() == true );
+
+        std::list<GmoShape*>& shapes = pPage->get_all_shapes();
+        int numErrors = 0;
+        for (LUnits y=0.0f; y < pPage->get_height(); y += 37.0f)
+        {
+            for (LUnits x=0.0f; x < pPage->get_width(); x += 41.0f)
+            {
+                GmoShape* pExpected = nullptr;
+                std::list<GmoShape*>::reverse_iterator it;
+                for (it = shapes.rbegin(); it != shapes.rend(); ++it)
+                {
+                    if ((*it)->hit_test(x, y))
+                    {
+                        pExpected = *it;
+                        break;
+                    }
+                }
+                if (pGM->find_shape_at(0, x, y) != pExpected)
+                    ++numErrors;
+            }
+        }
+        CHECK( numErrors == 0 );
+
+        delete pPresenter;
+    }
+
+    TEST_FIXTURE(GraphicModelTestFixture, shapes_grid_02)
+    {
+        //@02. Rectangle selection with the index selects all contained shapes
+
+        LomseDoorway doorway;
+        doorway.init_library(k_pix_format_rgb24, 82);
+        LibraryScope libraryScope(cout, &doorway);
+        libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        Presenter* pPresenter = doorway.open_document(k_view_vertical_book,
+            m_scores_path + "50041-octave_shift.xml");
+        Interactor* pIntor = pPresenter->get_interactor_raw_ptr(0);
+        GraphicModel* pGM = pIntor->get_graphic_model();
+        GmoBoxDocPage* pPage = pGM->get_page(0);
+
+        URect selRect(1500.0f, 2000.0f, 8000.0f, 5000.0f);
+        SelectionSet selection(nullptr);
+        pPage->select_objects_in_rectangle(&selection, selRect);
+
+        list<GmoObj*>& selected = selection.get_all_gmo_objects();
+        int numExpected = 0;
+        std::list<GmoShape*>& shapes = pPage->get_all_shapes();
+        std::list<GmoShape*>::iterator it;
+        for (it = shapes.begin(); it != shapes.end(); ++it)
+        {
+            if (selRect.contains((*it)->get_bounds()))
+            {
+                ++numExpected;
+                CHECK( std::find(selected.begin(), selected.end(), *it) != selected.end() );
+            }
+        }
+        CHECK( numExpected > 0 );
+        CHECK( int(selected.size()) == numExpected );
+
+        delete pPresenter;
+    }
+
+    TEST_FIXTURE(GraphicModelTestFixture, shapes_grid_03)
+    {
+        //@03. Adding shapes invalidates the index and it is rebuilt when needed
+
+        MyDoorway doorway;
+        LibraryScope libraryScope(cout, &doorway);
+        libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        SpDocument spDoc( new Document(libraryScope) );
+        spDoc->from_string("(lenmusdoc (vers 0.0) (content (score (vers 2.0) "
+            "(instrument (musicData (clef G)(key e)(n c4 q)(r q)(barline simple))))))" );
+        VerticalBookView* pView = static_cast<VerticalBookView*>(
+            Injector::inject_View(libraryScope, k_view_vertical_book) );
+        Interactor* pIntor = Injector::inject_Interactor(libraryScope, WpDocument(spDoc), pView, nullptr);
+        GraphicModel* pModel = pIntor->get_graphic_model();
+        GmoBoxDocPage* pPage = pModel->get_page(0);
+
+        GmoBox* pBDPC = pPage->get_child_box(0);        //DocPageContent
+        GmoShape* pShape = LOMSE_NEW GmoShapeInvisible(nullptr, 0, UPoint(-500.0f, -500.0f),
+                                                       USize(100.0f, 100.0f));
+        pBDPC->add_shape(pShape, GmoShape::k_layer_top);
+        CHECK( pPage->is_shapes_grid_valid() == true );
+
+        pPage->add_to_tables(pShape);
+        CHECK( pPage->is_shapes_grid_valid() == false );
+
+        CHECK( pPage->find_shape_at(-450.0f, -450.0f) == pShape );
+        CHECK( pPage->is_shapes_grid_valid() == true );
+
+        delete pIntor;
+    }
+
     // map imo -> gmo -------------------------------------------------------------------
 
     TEST_FIXTURE(GraphicModelTestFixture, NoterestAddedToShapesMap)
@@ -1121,6 +1245,100 @@ SUITE(GraphicModelTest)
         delete pIntor;
     }
 
+    //@ PlaybackTimeline ----------------------------------------------------------------
+
+    TEST_FIXTURE(GraphicModelTestFixture, playback_timeline_001)
+    {
+        //@001. Timeline contains all systems, in order
+
+        MyDoorway doorway;
+        LibraryScope libraryScope(cout, &doorway);
+        libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        SpDocument spDoc( new Document(libraryScope) );
+        spDoc->from_string( many_measures_score(40) );
+        VerticalBookView* pView = static_cast<VerticalBookView*>(
+            Injector::inject_View(libraryScope, k_view_vertical_book) );
+        Interactor* pIntor = Injector::inject_Interactor(libraryScope, WpDocument(spDoc), pView, nullptr);
+        GraphicModel* pGModel = pIntor->get_graphic_model();
+        ImoId scoreId = spDoc->get_im_root()->get_content_item(0)->get_id();
+        PlaybackTimeline* pTimeline = pGModel->get_playback_timeline(scoreId);
+
+        int numSystems = pGModel->get_num_systems(scoreId);
+        CHECK( numSystems > 1 );
+        CHECK( pTimeline->get_num_systems() == numSystems );
+        for (int i=0; i < pTimeline->get_num_systems(); ++i)
+        {
+            PlaybackTimeline::SystemEntry& system = pTimeline->get_system_entry(i);
+            GmoBoxSystem* pBSys = pGModel->get_system_box(i, scoreId);
+            CHECK( system.pSystem == pBSys );
+            CHECK( system.iEnd - system.iFirst == pBSys->get_time_grid_table()->get_size() );
+            CHECK( pTimeline->get_system_for(system.startTime + 32.0) == pBSys );
+        }
+
+        delete pIntor;
+    }
+
+    TEST_FIXTURE(GraphicModelTestFixture, playback_timeline_002)
+    {
+        //@002. Locate. At system end, next system is preferred. Interpolated position
+
+        MyDoorway doorway;
+        LibraryScope libraryScope(cout, &doorway);
+        libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        SpDocument spDoc( new Document(libraryScope) );
+        spDoc->from_string( many_measures_score(40) );
+        VerticalBookView* pView = static_cast<VerticalBookView*>(
+            Injector::inject_View(libraryScope, k_view_vertical_book) );
+        Interactor* pIntor = Injector::inject_Interactor(libraryScope, WpDocument(spDoc), pView, nullptr);
+        GraphicModel* pGModel = pIntor->get_graphic_model();
+        ImoId scoreId = spDoc->get_im_root()->get_content_item(0)->get_id();
+        PlaybackTimeline* pTimeline = pGModel->get_playback_timeline(scoreId);
+        GmoBoxSystem* pBSys = pGModel->get_system_box(1, scoreId);
+
+        TimeUnits timepos = pTimeline->get_system_entry(0).endTime;
+        PlaybackTimeline::Position pos;
+        CHECK( pTimeline->locate(timepos, &pos) == true );
+        CHECK( pos.pSystem == pBSys );
+        CHECK( pos.iPage == pBSys->get_page_number() );
+        CHECK( pos.yTop == pBSys->get_top() );
+        CHECK( pos.yBottom == pBSys->get_bottom() );
+        CHECK( is_equal_pos(pos.x, pBSys->get_x_for_note_rest_at_time(timepos)) );
+
+        timepos += 32.0;    //between two notes
+        CHECK( pTimeline->locate(timepos, &pos) == true );
+        CHECK( pos.pSystem == pBSys );
+        CHECK( is_equal_pos(pos.x, pBSys->get_x_for_note_rest_at_time(timepos)) );
+        CHECK( pos.x > pBSys->get_x_for_note_rest_at_time(timepos - 32.0) );
+        CHECK( pos.x < pBSys->get_x_for_note_rest_at_time(timepos + 32.0) );
+
+        delete pIntor;
+    }
+
+    TEST_FIXTURE(GraphicModelTestFixture, playback_timeline_003)
+    {
+        //@003. Timepos after score end is not found
+
+        MyDoorway doorway;
+        LibraryScope libraryScope(cout, &doorway);
+        libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        SpDocument spDoc( new Document(libraryScope) );
+        spDoc->from_string( many_measures_score(4) );
+        VerticalBookView* pView = static_cast<VerticalBookView*>(
+            Injector::inject_View(libraryScope, k_view_vertical_book) );
+        Interactor* pIntor = Injector::inject_Interactor(libraryScope, WpDocument(spDoc), pView, nullptr);
+        GraphicModel* pGModel = pIntor->get_graphic_model();
+        ImoId scoreId = spDoc->get_im_root()->get_content_item(0)->get_id();
+        PlaybackTimeline* pTimeline = pGModel->get_playback_timeline(scoreId);
+
+        PlaybackTimeline::Position pos;
+        CHECK( pTimeline->locate(5000.0, &pos) == false );
+        CHECK( pGModel->get_system_for(scoreId, 5000.0) == nullptr );
+        CHECK( pGModel->get_system_for(scoreId, 0.0) == pGModel->get_system_box(0, scoreId) );
+
+        delete pIntor;
+    }
+
+
     TEST_FIXTURE(GraphicModelTestFixture, gm_api_001)
     {
         //@001. Get num. systems and system box
@@ -21,6 +21,9 @@
 #include "lomse_tasks.h"
 #include "lomse_graphical_model.h"
 #include "lomse_shapes.h"
+#include "lomse_command.h"
+#include "lomse_document_cursor.h"
+#include "lomse_staffobjs_table.h"
 
 using namespace UnitTest;
 using namespace std;
@@ -169,6 +172,22 @@ public:
         return UnitTest::CurrentTest::Details()->testName;
     }
 
+    //-----------------------------------------------------------------------------------
+    string long_score(int numInstruments, int numMeasures)
+    {
+        stringstream ss;
+        ss << "(score (vers 2.0)";
+        for (int iInstr=0; iInstr < numInstruments; ++iInstr)
+        {
+            ss << "(instrument (musicData (clef G)(key C)(time 4 4)";
+            for (int i=0; i < numMeasures; ++i)
+                ss << "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline)";
+            ss << "))";
+        }
+        ss << ")";
+        return ss.str();
+    }
+
     //-----------------------------------------------------------------------------------
     bool check_click_data(ClickPointData& data, int iInstr, int iStaff, int iMeasure,
                           TimeUnits location, const string& pImoName, const char* name)
@@ -196,6 +215,86 @@ public:
         return fTestOk;
     }
 
+    //-----------------------------------------------------------------------------------
+    string score_with_measures(int numMeasures)
+    {
+        stringstream ss;
+        ss << "(score (vers 2.0)(instrument (musicData (clef G)(key C)(time 4 4)";
+        for (int i=0; i < numMeasures; ++i)
+            ss << "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)";
+        ss << "))";
+        return ss.str();
+    }
+
+    //-----------------------------------------------------------------------------------
+    ImoId find_first_note_in_measure(Document* pDoc, int iMeasure)
+    {
+        ImoScore* pScore = static_cast<ImoScore*>( pDoc->get_im_root()->get_content_item(0) );
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+        ColStaffObjs::iterator it;
+        for (it = pTable->begin(); it != pTable->end(); ++it)
+        {
+            if ((*it)->measure() == iMeasure && (*it)->imo_object()->is_note())
+                return (*it)->element_id();
+        }
+        return k_no_imoid;
+    }
+
+    //-----------------------------------------------------------------------------------
+    void collect_systems(GraphicModel* pGM, vector<GmoBox*>& systems)
+    {
+        systems.clear();
+        for (int i=0; i < pGM->get_num_pages(); ++i)
+        {
+            GmoBox* pBDPC = pGM->get_page(i)->get_child_box(0);     //DocPageContent
+            for (GmoBox* pBSP : pBDPC->get_child_boxes())           //ScorePage
+            {
+                for (GmoBox* pBSys : pBSP->get_child_boxes())       //System
+                {
+                    if (pBSys->is_box_system())
+                        systems.push_back(pBSys);
+                }
+            }
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    int count_shapes(GmoBox* pBox)
+    {
+        int numShapes = pBox->get_num_shapes();
+        for (GmoBox* pChild : pBox->get_child_boxes())
+            numShapes += count_shapes(pChild);
+        return numShapes;
+    }
+
+    //-----------------------------------------------------------------------------------
+    bool check_same_systems(vector<URect>& incremental, vector<GmoBox*>& full)
+    {
+        bool fTestOk = (incremental.size() == full.size());
+        for (size_t i=0; fTestOk && i < full.size(); ++i)
+        {
+            URect bounds = full[i]->get_bounds();
+            fTestOk = is_equal_pos(incremental[i].left(), bounds.left())
+                      && is_equal_pos(incremental[i].top(), bounds.top())
+                      && is_equal_pos(incremental[i].width, bounds.width)
+                      && is_equal_pos(incremental[i].height, bounds.height);
+            if (!fTestOk)
+            {
+                cout << test_name() << ": system " << i << " is different. Incremental: "
+                     << incremental[i].left() << ", " << incremental[i].top() << ", "
+                     << incremental[i].width << ", " << incremental[i].height
+                     << ". Full: " << bounds.left() << ", " << bounds.top() << ", "
+                     << bounds.width << ", " << bounds.height << endl;
+            }
+        }
+        if (incremental.size() != full.size())
+        {
+            cout << test_name() << ": num.systems. Incremental: " << incremental.size()
+                 << ", full: " << full.size() << endl;
+        }
+        return fTestOk;
+    }
+
     //-----------------------------------------------------------------------------------
     void dump_gmodel(Interactor* pIntor)
     {
@@ -229,6 +328,65 @@ SUITE(InteractorTest)
         CHECK( pIntor->get_graphic_model() != nullptr );
     }
 
+    //-- lazy layout --------------------------------------------------------------------
+
+    TEST_FIXTURE(InteractorTestFixture, Interactor_lazy_layout_01)
+    {
+        //@01. only first page laid out. Pages estimated. All laid out when requested
+
+        SpDocument spDoc( new Document(m_libraryScope) );
+        spDoc->from_string(long_score(4, 200), Document::k_format_ldp);
+        View* pView = Injector::inject_View(m_libraryScope, k_view_vertical_book);
+        SpInteractor pIntor(Injector::inject_Interactor(m_libraryScope, WpDocument(spDoc), pView, nullptr));
+        pView->set_interactor(pIntor.get());
+        pIntor->enable_lazy_layout(true);
+
+        GraphicModel* pModel = pIntor->get_graphic_model();
+        CHECK( pModel->get_num_pages() == 1 );
+        CHECK( pModel->is_layout_finished() == false );
+        CHECK( pIntor->get_num_pages() > 1 );
+
+        pIntor->finish_layout();
+        CHECK( pIntor->get_graphic_model() == pModel );
+        CHECK( pModel->is_layout_finished() == true );
+        CHECK( pModel->get_num_pages() > 1 );
+        CHECK( pIntor->get_num_pages() == pModel->get_num_pages() );
+        CHECK( pIntor->layout_more_pages() == false );
+    }
+
+    TEST_FIXTURE(InteractorTestFixture, Interactor_lazy_layout_02)
+    {
+        //@02. requested pages are laid out
+
+        SpDocument spDoc( new Document(m_libraryScope) );
+        spDoc->from_string(long_score(4, 200), Document::k_format_ldp);
+        View* pView = Injector::inject_View(m_libraryScope, k_view_vertical_book);
+        SpInteractor pIntor(Injector::inject_Interactor(m_libraryScope, WpDocument(spDoc), pView, nullptr));
+        pView->set_interactor(pIntor.get());
+        pIntor->enable_lazy_layout(true);
+
+        GraphicModel* pModel = pIntor->get_graphic_model();
+        USize size = pIntor->get_page_size(2);
+        CHECK( pModel->get_num_pages() == 3 );
+        CHECK( size.width == pModel->get_page(2)->get_width() );
+    }
+
+    TEST_FIXTURE(InteractorTestFixture, Interactor_lazy_layout_03)
+    {
+        //@03. not used in views not supporting it
+
+        SpDocument spDoc( new Document(m_libraryScope) );
+        spDoc->from_string(long_score(4, 200), Document::k_format_ldp);
+        View* pView = Injector::inject_View(m_libraryScope, k_view_horizontal_book);
+        SpInteractor pIntor(Injector::inject_Interactor(m_libraryScope, WpDocument(spDoc), pView, nullptr));
+        pView->set_interactor(pIntor.get());
+        pIntor->enable_lazy_layout(true);
+
+        GraphicModel* pModel = pIntor->get_graphic_model();
+        CHECK( pModel->is_layout_finished() == true );
+        CHECK( pModel->get_num_pages() > 1 );
+    }
+
     //-- selecting objects --------------------------------------------------------------
 
     TEST_FIXTURE(InteractorTestFixture, Interactor_SelectObject)
@@ -1192,6 +1350,165 @@ SUITE(InteractorTest)
     }
 
 
+    //-- incremental layout after edition commands --------------------------------------
+
+    TEST_FIXTURE(InteractorTestFixture, incremental_layout_001)
+    {
+        //@001. Replace note. Systems before the modified one are reused and the
+        //      result is the same than a full layout
+        LomseDoorway doorway;
+        doorway.init_library(k_pix_format_rgb24, 82);
+        doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        Presenter* pPresenter = doorway.new_document(k_view_vertical_book,
+            score_with_measures(60), Document::k_format_ldp);
+        Interactor* pIntor = pPresenter->get_interactor_raw_ptr(0);
+        Document* pDoc = pPresenter->get_document_raw_ptr();
+        vector<GmoBox*> before;
+        collect_systems(pIntor->get_graphic_model(), before);
+
+        pIntor->get_cursor()->reset_and_point_to( find_first_note_in_measure(pDoc, 40) );
+        pIntor->exec_command( LOMSE_NEW CmdAddNoteRest("(n d4 q)", k_edit_mode_replace) );
+
+        vector<GmoBox*> after;
+        collect_systems(pIntor->get_graphic_model(), after);
+        vector<URect> incremental;
+        for (GmoBox* pBox : after)
+            incremental.push_back(pBox->get_bounds());
+
+        CHECK( before.size() > 3 );
+        CHECK( after.size() == before.size() );
+        CHECK( after.size() > 0 && after[0] == before[0] );
+
+        pIntor->on_document_updated();
+        vector<GmoBox*> full;
+        collect_systems(pIntor->get_graphic_model(), full);
+
+        CHECK( check_same_systems(incremental, full) );
+        delete pPresenter;
+    }
+
+    TEST_FIXTURE(InteractorTestFixture, incremental_layout_002)
+    {
+        //@002. Delete note. Systems are split again and the result is the same than
+        //      a full layout
+        LomseDoorway doorway;
+        doorway.init_library(k_pix_format_rgb24, 82);
+        doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        Presenter* pPresenter = doorway.new_document(k_view_vertical_book,
+            score_with_measures(60), Document::k_format_ldp);
+        Interactor* pIntor = pPresenter->get_interactor_raw_ptr(0);
+        Document* pDoc = pPresenter->get_document_raw_ptr();
+        pIntor->get_graphic_model();
+
+        for (int i=0; i < 3; ++i)
+        {
+            pIntor->get_cursor()->reset_and_point_to(
+                                            find_first_note_in_measure(pDoc, 20 + i) );
+            pIntor->exec_command( LOMSE_NEW CmdDeleteStaffObj() );
+        }
+
+        vector<GmoBox*> after;
+        collect_systems(pIntor->get_graphic_model(), after);
+        vector<URect> incremental;
+        for (GmoBox* pBox : after)
+            incremental.push_back(pBox->get_bounds());
+
+        pIntor->on_document_updated();
+        vector<GmoBox*> full;
+        collect_systems(pIntor->get_graphic_model(), full);
+
+        CHECK( check_same_systems(incremental, full) );
+        delete pPresenter;
+    }
+
+    TEST_FIXTURE(InteractorTestFixture, incremental_layout_004)
+    {
+        //@004. Delete selection with notes in several measures and a slur attached
+        //      to notes in a previous system. The result is the same than a full
+        //      layout
+        LomseDoorway doorway;
+        doorway.init_library(k_pix_format_rgb24, 82);
+        doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        stringstream ss;
+        ss << "(score (vers 2.0)(instrument (musicData (clef G)(key C)(time 4 4)";
+        for (int i=0; i < 60; ++i)
+        {
+            if (i == 5)
+                ss << "(n c4 q (slur 1 start))(n e4 q)(n g4 q)(n c5 q (slur 1 stop))";
+            else
+                ss << "(n c4 q)(n e4 q)(n g4 q)(n c5 q)";
+            ss << "(barline simple)";
+        }
+        ss << "))";
+        Presenter* pPresenter = doorway.new_document(k_view_vertical_book, ss.str(),
+                                                     Document::k_format_ldp);
+        Interactor* pIntor = pPresenter->get_interactor_raw_ptr(0);
+        Document* pDoc = pPresenter->get_document_raw_ptr();
+        pIntor->get_graphic_model();
+
+        ImoStaffObj* pNote = static_cast<ImoStaffObj*>(
+                        pDoc->get_pointer_to_imo( find_first_note_in_measure(pDoc, 5) ));
+        ImoRelObj* pSlur = pNote->find_relation(k_imo_slur);
+        CHECK( pSlur != nullptr );
+
+        pIntor->select_object( find_first_note_in_measure(pDoc, 20) );
+        pIntor->select_object( find_first_note_in_measure(pDoc, 30), false );
+        pIntor->get_selection_set()->add( pSlur->get_id() );   //slur has no main shape
+        pIntor->get_cursor()->reset_and_point_to( find_first_note_in_measure(pDoc, 20) );
+        pIntor->exec_command( LOMSE_NEW CmdDeleteSelection() );
+        CHECK( pNote->find_relation(k_imo_slur) == nullptr );
+
+        vector<GmoBox*> after;
+        collect_systems(pIntor->get_graphic_model(), after);
+        vector<URect> incremental;
+        vector<int> incrementalShapes;
+        for (GmoBox* pBox : after)
+        {
+            incremental.push_back(pBox->get_bounds());
+            incrementalShapes.push_back(count_shapes(pBox));
+        }
+
+        pIntor->on_document_updated();
+        vector<GmoBox*> full;
+        collect_systems(pIntor->get_graphic_model(), full);
+        vector<int> fullShapes;
+        for (GmoBox* pBox : full)
+            fullShapes.push_back(count_shapes(pBox));
+
+        CHECK( check_same_systems(incremental, full) );
+        CHECK( incrementalShapes == fullShapes );
+        delete pPresenter;
+    }
+
+    TEST_FIXTURE(InteractorTestFixture, incremental_layout_003)
+    {
+        //@003. Incremental layout disabled. All systems are engraved again
+        LomseDoorway doorway;
+        doorway.init_library(k_pix_format_rgb24, 82);
+        doorway.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        Presenter* pPresenter = doorway.new_document(k_view_vertical_book,
+            score_with_measures(60), Document::k_format_ldp);
+        Interactor* pIntor = pPresenter->get_interactor_raw_ptr(0);
+        Document* pDoc = pPresenter->get_document_raw_ptr();
+        pIntor->enable_incremental_layout(false);
+        GraphicModel* pGM = pIntor->get_graphic_model();
+        vector<GmoBox*> before;
+        collect_systems(pGM, before);
+        URect bounds = before[0]->get_bounds();
+        before[0]->set_height(bounds.height + 1000.0f);  //mark the old box
+
+        pIntor->get_cursor()->reset_and_point_to( find_first_note_in_measure(pDoc, 40) );
+        pIntor->exec_command( LOMSE_NEW CmdAddNoteRest("(n d4 q)", k_edit_mode_replace) );
+
+        vector<GmoBox*> after;
+        collect_systems(pIntor->get_graphic_model(), after);
+
+        CHECK( after.size() == before.size() );
+        CHECK( after.size() > 0 && is_equal_pos(after[0]->get_height(), bounds.height) );
+        delete pPresenter;
+    }
+
+
 
 
 
@@ -0,0 +1,291 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#include <UnitTest++.h>
+#include <sstream>
+#include "lomse_build_options.h"
+
+//classes related to these tests
+#include "lomse_injectors.h"
+#include "lomse_midi_file_writer.h"
+#include "lomse_midi_table.h"
+#include "lomse_internal_model.h"
+#include "private/lomse_document_p.h"
+
+#include <vector>
+
+
+using namespace UnitTest;
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+//helper: a decoded event from a MIDI file track
+struct MyMidiFileEvent
+{
+    long time;
+    int status;
+    int data1;
+    int data2;
+    int tempo;      //for tempo meta events
+};
+
+//=======================================================================================
+// test for MidiFileWriter
+//=======================================================================================
+
+class MidiFileWriterTestFixture
+{
+public:
+    LibraryScope m_libraryScope;
+    std::string m_scores_path;
+
+    MidiFileWriterTestFixture()     //SetUp fixture
+        : m_libraryScope(cout)
+    {
+        m_scores_path = TESTLIB_SCORES_PATH;
+        m_libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    }
+
+    ~MidiFileWriterTestFixture()    //TearDown fixture
+    {
+    }
+
+    inline const char* test_name()
+    {
+        return UnitTest::CurrentTest::Details()->testName;
+    }
+
+    string mxl_score(const string& measures)
+    {
+        return "<score-partwise version='3.0'><part-list>"
+               "<score-part id='P1'><part-name>Music</part-name></score-part>"
+               "</part-list><part id='P1'>" + measures + "</part></score-partwise>";
+    }
+
+    unsigned long read_uint(const string& data, size_t pos, int bytes)
+    {
+        unsigned long value = 0;
+        for (int i=0; i < bytes; ++i)
+            value = (value << 8) | (unsigned char)(data[pos + i]);
+        return value;
+    }
+
+    //returns the events in track iTrack. Only channel messages and tempo meta events
+    vector<MyMidiFileEvent> read_track(const string& data, int iTrack)
+    {
+        vector<MyMidiFileEvent> events;
+        size_t pos = 14;
+        for (int i=0; i < iTrack; ++i)
+            pos += 8 + read_uint(data, pos + 4, 4);
+
+        size_t end = pos + 8 + read_uint(data, pos + 4, 4);
+        pos += 8;
+        long time = 0L;
+        while (pos < end)
+        {
+            unsigned long delta = 0;
+            unsigned char byte;
+            do
+            {
+                byte = (unsigned char)(data[pos++]);
+                delta = (delta << 7) | (byte & 0x7F);
+            } while (byte & 0x80);
+            time += long(delta);
+
+            MyMidiFileEvent ev = { time, (unsigned char)(data[pos]), 0, 0, 0 };
+            if (ev.status == 0xFF)
+            {
+                int type = (unsigned char)(data[pos + 1]);
+                int size = (unsigned char)(data[pos + 2]);
+                if (type == 0x51)
+                {
+                    ev.tempo = int(read_uint(data, pos + 3, 3));
+                    events.push_back(ev);
+                }
+                pos += 3 + size;
+            }
+            else if ((ev.status & 0xF0) == 0xC0)
+            {
+                ev.data1 = (unsigned char)(data[pos + 1]);
+                events.push_back(ev);
+                pos += 2;
+            }
+            else
+            {
+                ev.data1 = (unsigned char)(data[pos + 1]);
+                ev.data2 = (unsigned char)(data[pos + 2]);
+                events.push_back(ev);
+                pos += 3;
+            }
+        }
+        return events;
+    }
+
+    int count_notes_on(const vector<MyMidiFileEvent>& events)
+    {
+        int count = 0;
+        for (const MyMidiFileEvent& ev : events)
+            count += ((ev.status & 0xF0) == 0x90 ? 1 : 0);
+        return count;
+    }
+};
+
+
+SUITE(MidiFileWriterTest)
+{
+
+    TEST_FIXTURE(MidiFileWriterTestFixture, midi_file_writer_01)
+    {
+        //@01. header: format 1, one track for tempo and one for each instrument
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData (clef G)(n c4 q)))"
+                        "(instrument (musicData (clef F4)(n c3 q))))");
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        MidiFileWriter writer;
+        string data = writer.get_source(pScore);
+
+        CHECK( data.size() > 14 );
+        CHECK( data.substr(0, 4) == "MThd" );
+        CHECK( read_uint(data, 4, 4) == 6 );
+        CHECK( read_uint(data, 8, 2) == 1 );        //format 1
+        CHECK( read_uint(data, 10, 2) == 3 );       //num tracks
+        CHECK( read_uint(data, 12, 2) == 64 );      //ticks per quarter note
+        CHECK( data.substr(14, 4) == "MTrk" );
+    }
+
+    TEST_FIXTURE(MidiFileWriterTestFixture, midi_file_writer_02)
+    {
+        //@02. program, note on and note off events
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData (clef G)(n c4 q)(n e4 h))))");
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        MidiFileWriter writer;
+        vector<MyMidiFileEvent> events = read_track(writer.get_source(pScore), 1);
+
+        CHECK( events.size() == 5 );
+        CHECK( (events[0].status & 0xF0) == 0xC0 );
+        CHECK( events[1].time == 0L );
+        CHECK( (events[1].status & 0xF0) == 0x90 );
+        CHECK( events[1].data1 == 60 );
+        CHECK( events[2].time == 64L );
+        CHECK( (events[2].status & 0xF0) == 0x80 );
+        CHECK( events[2].data1 == 60 );
+        CHECK( events[3].time == 64L );
+        CHECK( events[3].data1 == 64 );
+        CHECK( events[4].time == 192L );
+        CHECK( (events[4].status & 0xF0) == 0x80 );
+    }
+
+    TEST_FIXTURE(MidiFileWriterTestFixture, midi_file_writer_03)
+    {
+        //@03. repetitions are played
+        //  |    |:    |    :|     |     |
+        //  1    2     3     4     5
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData "
+            "(clef G)(n c4 q)(n e4 q)(barline startRepetition)"
+            "(n c4 q)(n e4 q)(barline)"
+            "(n c4 q)(n e4 q)(barline endRepetition)"
+            "(n c4 q)(n e4 q)(barline)(n c4 q)(n e4 q)(barline) )))" );
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        MidiFileWriter writer;
+        vector<MyMidiFileEvent> events = read_track(writer.get_source(pScore), 1);
+
+        CHECK( count_notes_on(events) == 14 );
+        CHECK( events.back().time == 14L * 64L );
+
+        //the jumps are ready for playback
+        CHECK( pScore->get_midi_table()->get_jump(0)->get_executed() == 0 );
+    }
+
+    TEST_FIXTURE(MidiFileWriterTestFixture, midi_file_writer_04)
+    {
+        //@04. tempo changes
+
+        Document doc(m_libraryScope);
+        doc.from_string(mxl_score(
+            "<measure number='1'><attributes><divisions>1</divisions>"
+                "<time><beats>2</beats><beat-type>4</beat-type></time></attributes>"
+                "<note><pitch><step>C</step><octave>4</octave></pitch>"
+                    "<duration>2</duration><type>half</type></note></measure>"
+            "<measure number='2'><sound tempo='120'/>"
+                "<note><pitch><step>D</step><octave>4</octave></pitch>"
+                    "<duration>2</duration><type>half</type></note></measure>"),
+            Document::k_format_mxl);
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        MidiFileWriter writer;
+        writer.set_tempo(80.0);
+        vector<MyMidiFileEvent> events = read_track(writer.get_source(pScore), 0);
+
+        CHECK( events.size() == 2 );
+        CHECK( events[0].time == 0L );
+        CHECK( events[0].tempo == 750000 );
+        CHECK( events[1].time == 128L );
+        CHECK( events[1].tempo == 500000 );
+    }
+
+    TEST_FIXTURE(MidiFileWriterTestFixture, midi_file_writer_05)
+    {
+        //@05. transposed instruments sound at transposed pitch
+
+        Document doc(m_libraryScope);
+        doc.from_string(mxl_score(
+            "<measure number='1'><attributes><divisions>1</divisions>"
+                "<transpose><chromatic>-2</chromatic></transpose></attributes>"
+                "<note><pitch><step>C</step><octave>4</octave></pitch>"
+                    "<duration>1</duration><type>quarter</type></note></measure>"),
+            Document::k_format_mxl);
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        MidiFileWriter writer;
+        vector<MyMidiFileEvent> events = read_track(writer.get_source(pScore), 1);
+
+        CHECK( count_notes_on(events) == 1 );
+        CHECK( events.size() == 3 && events[1].data1 == 58 );
+    }
+
+    TEST_FIXTURE(MidiFileWriterTestFixture, midi_file_writer_06)
+    {
+        //@06. time signatures are saved in first track, only once for all instruments
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (musicData (clef G)(time 6 8)"
+                "(n c4 e)(n d4 e)(n e4 e)(n f4 e)(n g4 e)(n a4 e)))"
+            "(instrument (musicData (clef F4)(time 6 8)"
+                "(n c3 e)(n d3 e)(n e3 e)(n f3 e)(n g3 e)(n a3 e))))");
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        MidiFileWriter writer;
+        string data = writer.get_source(pScore);
+
+        //6/8, two pulses of dotted quarter (36 MIDI clocks)
+        string ts("\xFF\x58\x04\x06\x03\x24\x08", 7);
+        size_t pos = data.find(ts);
+        CHECK( pos != string::npos );
+        CHECK( pos != string::npos && data.find(ts, pos + 1) == string::npos );
+    }
+
+    TEST_FIXTURE(MidiFileWriterTestFixture, midi_file_writer_07)
+    {
+        //@07. error when the file can not be created
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData (clef G)(n c4 q))))");
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        MidiFileWriter writer;
+
+        CHECK( writer.save_to_file(pScore, "/non-existent-folder/score.mid") == false );
+        CHECK( writer.get_error() == "Could not create file '/non-existent-folder/score.mid'" );
+    }
+
+}
@@ -482,6 +482,35 @@ SUITE(MidiTableTest)
         CHECK( (*it)->DeltaTime == 64.0f );
     }
 
+    TEST_FIXTURE(MidiTableTestFixture, EventsSorted_multimetric)
+    {
+        //@201. Multimetric score: measures not aligned. Events at the same time are
+        //      ordered by event type, so that sounds are stopped before starting new ones
+
+        load_ldp_score_for_test("other/04-multimetric.lms");
+
+        std::vector<SoundEvent*>& events = m_pTable->get_events();
+        CHECK( events.size() > 2 );
+        bool fSorted = true;
+        bool fMeasuresNotAligned = false;
+        for (size_t i=1; i < events.size(); ++i)
+        {
+            SoundEvent* pPrev = events[i-1];
+            SoundEvent* pEv = events[i];
+            if (pEv->DeltaTime < pPrev->DeltaTime
+                || (pEv->DeltaTime == pPrev->DeltaTime
+                    && pEv->EventType < pPrev->EventType))
+            {
+                fSorted = false;
+            }
+            if (pEv->DeltaTime == pPrev->DeltaTime && pEv->Measure < pPrev->Measure)
+                fMeasuresNotAligned = true;
+        }
+        CHECK( fSorted == true );
+        CHECK( fMeasuresNotAligned == true );
+        CHECK( events.back()->EventType == SoundEvent::k_end_of_score );
+    }
+
 
     //@ Measures table ------------------------------------------------------------------
 
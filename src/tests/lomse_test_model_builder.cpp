@@ -31,6 +31,17 @@ using namespace std;
 using namespace lomse;
 
 
+//---------------------------------------------------------------------------------------
+// ModelBuilderTestDocument:  Helper class to use Document protected members
+class ModelBuilderTestDocument : public Document
+{
+public:
+    ModelBuilderTestDocument(LibraryScope& libraryScope) : Document(libraryScope) {}
+   ~ModelBuilderTestDocument() override {}
+
+    void my_clear_dirty() { clear_dirty(); }
+};
+
 //---------------------------------------------------------------------------------------
 class ModelBuilderTestFixture
 {
@@ -48,6 +59,33 @@ public:
     ~ModelBuilderTestFixture()    //TearDown fixture
     {
     }
+
+    ImoScore* load_three_instruments_score(ModelBuilderTestDocument& doc)
+    {
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (musicData (clef G)(time 2 4)(n c4 q)(n e4 q)(barline)"
+                "(n g4 h)(barline)))"
+            "(instrument (staves 2)(musicData (clef G p1)(clef F4 p2)(time 2 4)"
+                "(n c4 q p1)(n a3 q p1)(goBack h)(n c3 h p2)(barline)"
+                "(n +f4 q p1)(n f4 q p1)(goBack h)(n c3 h p2)(barline)))"
+            "(instrument (musicData (clef G)(time 2 4)(n c5 h)(barline)"
+                "(n d5 h)(barline)))"
+            ")", Document::k_format_ldp);
+        doc.my_clear_dirty();
+        return static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+    }
+
+    ImoNote* get_note(ImoScore* pScore, int iInstr, int iNote)
+    {
+        ImoMusicData* pMD = pScore->get_instrument(iInstr)->get_musicdata();
+        ImoObj::children_iterator it;
+        for (it = pMD->begin(); it != pMD->end(); ++it)
+        {
+            if ((*it)->is_note() && iNote-- == 0)
+                return static_cast<ImoNote*>(*it);
+        }
+        return nullptr;
+    }
 };
 
 SUITE(ModelBuilderTest)
@@ -73,6 +111,131 @@ SUITE(ModelBuilderTest)
         if (pRoot && !pRoot->is_document()) delete pRoot;
     }
 
+    TEST_FIXTURE(ModelBuilderTestFixture, model_builder_01)
+    {
+        //@01. structurize_changes. When no instrument is modified, changes are unknown
+        //@     and the whole score is structurized
+
+        ModelBuilderTestDocument doc(m_libraryScope);
+        ImoScore* pScore = load_three_instruments_score(doc);
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+
+        ImoNote* pNote = get_note(pScore, 1, 0);     //c4 q
+        pNote->set_note_type_and_dots(k_eighth, 0);     //not marked as dirty
+        pScore->end_of_marked_changes();
+
+        pTable = pScore->get_staffobjs_table();
+        CHECK( (*pTable->find(get_note(pScore, 1, 1)))->time() == 32.0 );
+        stringstream errormsg;
+        ModelBuilder builder;
+        CHECK( builder.check_structure(pScore, errormsg) == true );
+//        cout << test_name() << ": " << errormsg.str() << endl;
+    }
+
+    TEST_FIXTURE(ModelBuilderTestFixture, model_builder_02)
+    {
+        //@02. structurize_changes. Modified instrument in the middle. Table updated
+
+        ModelBuilderTestDocument doc(m_libraryScope);
+        ImoScore* pScore = load_three_instruments_score(doc);
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+
+        ImoNote* pNote = get_note(pScore, 1, 0);     //c4 q
+        pNote->set_note_type_and_dots(k_eighth, 0);
+        pNote->set_dirty(true);
+        pScore->end_of_marked_changes();
+
+        CHECK( pScore->get_staffobjs_table() == pTable );
+        CHECK( (*pTable->find(get_note(pScore, 1, 1)))->time() == 32.0 );
+        stringstream errormsg;
+        ModelBuilder builder;
+        CHECK( builder.check_structure(pScore, errormsg) == true );
+//        cout << test_name() << ": " << errormsg.str() << endl;
+    }
+
+    TEST_FIXTURE(ModelBuilderTestFixture, model_builder_03)
+    {
+        //@03. structurize_changes. Instruments remain modified until the document
+        //@    dirty flag is cleared
+
+        ModelBuilderTestDocument doc(m_libraryScope);
+        ImoScore* pScore = load_three_instruments_score(doc);
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+
+        ImoNote* pNote = get_note(pScore, 0, 0);     //c4 q
+        pNote->set_dirty(true);
+        pScore->end_of_marked_changes();
+        pNote->set_note_type_and_dots(k_eighth, 0);     //not marked as dirty
+        pScore->end_of_marked_changes();
+
+        CHECK( pScore->get_staffobjs_table() == pTable );
+        CHECK( (*pTable->find(get_note(pScore, 0, 1)))->time() == 32.0 );
+        stringstream errormsg;
+        ModelBuilder builder;
+        CHECK( builder.check_structure(pScore, errormsg) == true );
+//        cout << test_name() << ": " << errormsg.str() << endl;
+    }
+
+    TEST_FIXTURE(ModelBuilderTestFixture, model_builder_04)
+    {
+        //@04. structurize_changes. Score modified. Table created again
+
+        ModelBuilderTestDocument doc(m_libraryScope);
+        ImoScore* pScore = load_three_instruments_score(doc);
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+
+        pScore->set_dirty(true);
+        pScore->end_of_marked_changes();
+
+        CHECK( pScore->get_staffobjs_table() != pTable );
+        stringstream errormsg;
+        ModelBuilder builder;
+        CHECK( builder.check_structure(pScore, errormsg) == true );
+//        cout << test_name() << ": " << errormsg.str() << endl;
+    }
+
+    TEST_FIXTURE(ModelBuilderTestFixture, model_builder_05)
+    {
+        //@05. structurize_changes. Instrument without staffobjs: no measures table
+
+        ModelBuilderTestDocument doc(m_libraryScope);
+        ImoScore* pScore = load_three_instruments_score(doc);
+        ImoInstrument* pInstr = pScore->get_instrument(2);
+        CHECK( pInstr->get_measures_table() != nullptr );
+
+        ImoMusicData* pMD = pInstr->get_musicdata();
+        while (pMD->get_num_children() > 0)
+            pInstr->delete_staffobj( static_cast<ImoStaffObj*>(pMD->get_first_child()) );
+        pScore->end_of_marked_changes();
+
+        CHECK( pInstr->get_measures_table() == nullptr );
+        stringstream errormsg;
+        ModelBuilder builder;
+        CHECK( builder.check_structure(pScore, errormsg) == true );
+//        cout << test_name() << ": " << errormsg.str() << endl;
+    }
+
+    TEST_FIXTURE(ModelBuilderTestFixture, model_builder_06)
+    {
+        //@06. end_of_changes. Changes not marked are processed, even when other
+        //@    instruments are marked as modified
+
+        ModelBuilderTestDocument doc(m_libraryScope);
+        ImoScore* pScore = load_three_instruments_score(doc);
+
+        ImoNote* pNote = get_note(pScore, 0, 0);     //c4 q
+        pNote->set_note_type_and_dots(k_eighth, 0);     //not marked as dirty
+        get_note(pScore, 1, 0)->set_dirty(true);
+        pScore->end_of_changes();
+
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+        CHECK( (*pTable->find(get_note(pScore, 0, 1)))->time() == 32.0 );
+        stringstream errormsg;
+        ModelBuilder builder;
+        CHECK( builder.check_structure(pScore, errormsg) == true );
+//        cout << test_name() << ": " << errormsg.str() << endl;
+    }
+
 }
 
 
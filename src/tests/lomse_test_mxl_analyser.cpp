@@ -26,9 +26,12 @@
 #include "lomse_import_options.h"
 #include "lomse_im_attributes.h"
 #include "lomse_staffobjs_table.h"
+#include "lomse_ldp_exporter.h"
+#include "lomse_model_builder.h"
 
 #include <regex>
 #include <cstdarg>
+#include <set>
 
 using namespace UnitTest;
 using namespace std;
@@ -78,6 +81,7 @@ SUITE(MusicXmlOptionsTest)
 
         CHECK( opt->fix_beams() == true );
         CHECK( opt->use_default_clefs() == true );
+        CHECK( opt->skip_layout() == false );
     }
 
     TEST_FIXTURE(MusicXmlOptionsTestFixture, MusicXmlOptions_2)
@@ -114,6 +118,29 @@ SUITE(MusicXmlOptionsTest)
         CHECK( newopt->use_default_clefs() == false );
     }
 
+    TEST_FIXTURE(MusicXmlOptionsTestFixture, MusicXmlOptions_5)
+    {
+        //@05. skip layout
+        MusicXmlOptions* opt = m_libraryScope.get_musicxml_options();
+        opt->skip_layout(true);
+
+        MusicXmlOptions* newopt = m_libraryScope.get_musicxml_options();
+        CHECK( newopt->skip_layout() == true );
+        CHECK( newopt->fix_beams() == true );
+    }
+
+    TEST_FIXTURE(MusicXmlOptionsTestFixture, MusicXmlOptions_6)
+    {
+        //@06. threads for analysing parts
+        MusicXmlOptions* opt = m_libraryScope.get_musicxml_options();
+        CHECK( opt->analysis_threads() == 1 );
+        opt->analysis_threads(4);
+
+        MusicXmlOptions* newopt = m_libraryScope.get_musicxml_options();
+        CHECK( newopt->analysis_threads() == 4 );
+        CHECK( newopt->skip_layout() == false );
+    }
+
 };
 
 
@@ -142,6 +169,13 @@ public:
     long my_get_timepos_for_voice(int voice) { return m_timeKeeper.get_timepos_for_voice(voice); }
     size_t my_get_num_voices() { return my_get_voice_times().size(); }
 
+    MxlElementAnalyser* my_get_analyser(const char* name) {
+        return get_analyser(name_to_enum(name), name, nullptr);
+    }
+    void my_release_analyser(const char* name, MxlElementAnalyser* a) {
+        release_analyser(name_to_enum(name), a);
+    }
+
 };
 
 //---------------------------------------------------------------------------------------
@@ -168,6 +202,80 @@ public:
     {
     }
 
+    //-----------------------------------------------------------------------------------
+    string import_with_threads(const string& source, int numThreads, string* pErrors,
+                               vector<LUnits>* pMargins=nullptr)
+    {
+        //returns the LDP source, without ids, for the first score in the document.
+        //Beams ids and ties and slurs numbers are also removed
+
+        m_libraryScope.get_musicxml_options()->analysis_threads(numThreads);
+        stringstream errormsg;
+        Document doc(m_libraryScope, errormsg);
+        if (source.compare(0, 1, "<") == 0)
+            doc.from_string(source, Document::k_format_mxl);
+        else
+            doc.from_file(m_scores_path + source, Document::k_format_mxl);
+        *pErrors = errormsg.str();
+
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        if (pMargins)
+        {
+            for (int i=0; i < pScore->get_num_instruments(); ++i)
+                pMargins->push_back(pScore->get_instrument(i)->get_staff(0)->get_staff_margin());
+        }
+        LdpExporter exporter;
+        exporter.set_add_id(false);
+        return regex_replace(exporter.get_source(pScore), regex("\\((beam|tie|slur) [0-9]+"),
+                             "($1");
+    }
+
+    string import_with_parser(const string& file, bool fEmbedPcdata, string* pErrors)
+    {
+        //returns the LDP source, without ids, for the first score in the document,
+        //parsing the file with or without embedding pcdata in the element nodes
+
+        stringstream errormsg;
+        Document doc(m_libraryScope, errormsg);
+        XmlParser parser(errormsg);
+        parser.embed_pcdata(fEmbedPcdata);
+        parser.parse_file(m_scores_path + file);
+        MyMxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
+        ImoDocument* pImoDoc = dynamic_cast<ImoDocument*>(
+                                    a.analyse_tree(parser.get_tree_root(), file) );
+        *pErrors = errormsg.str();
+        if (!pImoDoc)
+            return "";
+
+        ModelBuilder builder;
+        builder.build_model(pImoDoc);
+        ImoScore* pScore = static_cast<ImoScore*>( pImoDoc->get_content_item(0) );
+        LdpExporter exporter;
+        exporter.set_add_id(false);
+        string source = exporter.get_source(pScore);
+        delete pImoDoc;
+        return source;
+    }
+
+    bool check_unique_ids(Document& doc, ImoObj* pImo, set<ImoId>& ids)
+    {
+        //all ids in the subtree are unique and point to its object
+
+        ImoId id = pImo->get_id();
+        if (id != k_no_imoid
+            && (!ids.insert(id).second || doc.get_pointer_to_imo(id) != pImo))
+        {
+            return false;
+        }
+
+        for (ImoObj::children_iterator it = pImo->begin(); it != pImo->end(); ++it)
+        {
+            if (!check_unique_ids(doc, *it, ids))
+                return false;
+        }
+        return true;
+    }
+
     static void wrapper_lomse_request(void* pThis, Request* pRequest)
     {
         static_cast<MxlAnalyserTestFixture*>(pThis)->on_lomse_request(pRequest);
@@ -2506,6 +2614,54 @@ SUITE(MxlAnalyserTest)
         delete pRoot;
     }
 
+    TEST_FIXTURE(MxlAnalyserTestFixture, MxlAnalyser_defaults_10)
+    {
+        //@10. defaults: page-layout ignored when option skip_layout is set
+
+        stringstream errormsg;
+        Document doc(m_libraryScope);
+        XmlParser parser(errormsg);
+        stringstream expected;
+        parser.parse_text(
+            "<score-partwise version='3.0'>"
+            "<defaults>"
+                "<page-layout>"
+                  "<page-height>1760</page-height>"
+                  "<page-width>1360</page-width>"
+                  "<page-margins type='both'>"
+                    "<left-margin>80</left-margin>"
+                    "<right-margin>100</right-margin>"
+                    "<top-margin>60</top-margin>"
+                    "<bottom-margin>120</bottom-margin>"
+                  "</page-margins>"
+                "</page-layout>"
+            "</defaults>"
+            "<part-list><score-part id='P1'><part-name/></score-part>"
+            "</part-list><part id='P1'>"
+            "<measure number='1'>"
+            "<attributes>"
+                "<staves>2</staves>"
+            "</attributes>"
+            "</measure>"
+            "</part></score-partwise>"
+        );
+        m_libraryScope.get_musicxml_options()->skip_layout(true);
+        MyMxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
+        XmlNode* tree = parser.get_tree_root();
+        ImoObj* pRoot = a.analyse_tree(tree, "string:");
+
+        CHECK( check_errormsg(errormsg, expected) );
+
+        ImoDocument* pDoc = dynamic_cast<ImoDocument*>( pRoot );
+        CHECK( pDoc );
+        ImoPageInfo* pInfo = pDoc->get_page_info();
+        CHECK( is_equal_float(pInfo->get_left_margin_odd(), 1500.0f) );
+        CHECK( is_equal_float(pInfo->get_top_margin_odd(), 2000.0f) );
+        CHECK( !is_equal_float(pInfo->get_page_width(), 24480.0f) );
+
+        delete pRoot;
+    }
+
 
     //@ direction -------------------------------------------------------------
 
@@ -9689,5 +9845,298 @@ SUITE(MxlAnalyserTest)
         delete pRoot;
     }
 
+    TEST_FIXTURE(MxlAnalyserTestFixture, mxl_analyser_90020)
+    {
+        //@90020 all MusicXML tags have a different enum value. Unknown ones are undefined
+        stringstream errormsg;
+        Document doc(m_libraryScope);
+        XmlParser parser;
+        MxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
+
+        static const char* tags[] = {
+            "accordion-registration", "arpeggiate", "articulations", "attributes",
+            "backup", "barline", "bracket", "clef", "coda", "damp", "damp-all",
+            "dashes", "defaults", "direction", "direction-type", "dynamics", "ending",
+            "eyeglasses", "fermata", "fingering", "forward", "fret", "harp-pedals",
+            "image", "key", "lyric", "measure", "metronome", "midi-device",
+            "midi-instrument", "notations", "note", "octave-shift", "ornaments",
+            "page-layout", "page-margins", "part", "part-group", "part-list",
+            "part-name", "pedal", "percussion", "pitch", "principal-voice", "print",
+            "rehearsal", "rest", "scaling", "scordatura", "score-instrument",
+            "score-part", "score-partwise", "segno", "slur", "sound", "staff-details",
+            "staff-layout", "string", "string-mute", "system-layout", "system-margins",
+            "technical", "text", "tied", "time", "time-modification", "transpose",
+            "tuplet", "tuplet-actual", "tuplet-normal", "unpitched",
+            "virtual-instrument", "wedge", "words"
+        };
+        set<int> values;
+        for (const char* tag : tags)
+        {
+            int value = a.name_to_enum(tag);
+            CHECK( value >= 0 );
+            values.insert(value);
+        }
+        CHECK( values.size() == sizeof(tags) / sizeof(tags[0]) );
+
+        CHECK( a.name_to_enum("") == -1 );
+        CHECK( a.name_to_enum("aaa") == -1 );
+        CHECK( a.name_to_enum("part-") == -1 );
+        CHECK( a.name_to_enum("zzz") == -1 );
+        CHECK( a.name_to_enum(string("note")) == a.name_to_enum("note") );
+    }
+
+    TEST_FIXTURE(MxlAnalyserTestFixture, mxl_analyser_90021)
+    {
+        //@90021 reused element analysers start with a clean state
+        stringstream errormsg;
+        Document doc(m_libraryScope);
+        XmlParser parser;
+        stringstream expected;
+        parser.parse_text(
+            "<score-partwise version='3.0'><part-list>"
+            "<score-part id='P1'><part-name>Music</part-name></score-part>"
+            "</part-list><part id='P1'>"
+            "<measure number='1'>"
+            "<attributes>"
+                "<divisions>1</divisions><staves>2</staves>"
+                "<clef number='1'><sign>G</sign><line>2</line>"
+                    "<clef-octave-change>-1</clef-octave-change></clef>"
+                "<clef number='2'><sign>G</sign><line>2</line></clef>"
+            "</attributes>"
+            "<note><pitch><step>C</step><octave>4</octave></pitch><duration>4</duration><type>whole</type></note>"
+            "</measure>"
+            "</part></score-partwise>"
+        );
+        MyMxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
+        XmlNode* tree = parser.get_tree_root();
+        ImoObj* pRoot =  a.analyse_tree(tree, "string:");
+
+        CHECK( check_errormsg(errormsg, expected) );
+        ImoDocument* pDoc = dynamic_cast<ImoDocument*>( pRoot );
+        CHECK( pDoc != nullptr );
+        if (pDoc)
+        {
+            ImoScore* pScore = dynamic_cast<ImoScore*>( pDoc->get_content_item(0) );
+            ImoInstrument* pInstr = pScore->get_instrument(0);
+            ImoMusicData* pMD = pInstr->get_musicdata();
+            ImoObj::children_iterator it = pMD->begin();
+            ImoClef* pClef = dynamic_cast<ImoClef*>( *it );
+            CHECK( pClef && pClef->get_clef_type() == k_clef_G2_8 );
+            ++it;
+            pClef = dynamic_cast<ImoClef*>( *it );
+            CHECK( pClef && pClef->get_clef_type() == k_clef_G2 );
+            CHECK( pClef && pClef->get_staff() == 1 );
+        }
+
+        delete pRoot;
+    }
+
+    TEST_FIXTURE(MxlAnalyserTestFixture, mxl_analyser_90022)
+    {
+        //@90022 analysers for tags without analyser are also reused
+        stringstream errormsg;
+        Document doc(m_libraryScope);
+        XmlParser parser;
+        MyMxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
+
+        MxlElementAnalyser* pA1 = a.my_get_analyser("rehearsal");
+        a.my_release_analyser("rehearsal", pA1);
+        MxlElementAnalyser* pA2 = a.my_get_analyser("rehearsal");
+        MxlElementAnalyser* pA3 = a.my_get_analyser("rehearsal");
+
+        CHECK( pA2 == pA1 );
+        CHECK( pA3 != pA1 );
+        a.my_release_analyser("rehearsal", pA2);
+        a.my_release_analyser("rehearsal", pA3);
+    }
+
+    TEST_FIXTURE(MxlAnalyserTestFixture, mxl_analyser_90023)
+    {
+        //@90023 the same model is created when the text of elements is embedded in
+        //@      the element nodes instead of in pcdata child nodes
+
+        const char* files[] = {
+            "unit-tests/other/03-BeetAnGeSample.xml",
+            "unit-tests/repeats/09-repeat-barlines-three-volta-long-several-times.xml",
+            "unit-tests/repeats/54-repeat-dal-segno-al-fine.xml",
+            "unit-tests/xml-export/001-divisions.xml",
+            "unit-tests/transpose/002-transpose-octave-change.xml",
+            "00623-clef-change-lyrics.xml",
+            "50011-ornaments.xml",
+            "50021-articulations.xml",
+            "50060-fingering.xml",
+            "50106-repeat-barlines-simple-volta.xml",
+            "50410-key-signatures-14-fifths.xml",
+            "50430-pedal-marks.musicxml",
+            "50500-tablature-sample.xml",
+        };
+        for (const char* file : files)
+        {
+            string errors1, errors2;
+            string source1 = import_with_parser(file, false, &errors1);
+            string source2 = import_with_parser(file, true, &errors2);
+            CHECK( source1.size() > 100 );
+            CHECK( source1 == source2 );
+            CHECK( errors1 == errors2 );
+        }
+    }
+
+
+    //@ concurrent analysis of parts ----------------------------------------------------
+
+    TEST_FIXTURE(MxlAnalyserTestFixture, MxlAnalyser_parts_01)
+    {
+        //@01. parts analysed concurrently: same model and errors, space for lyrics
+
+        string errors1, errors2;
+        vector<LUnits> margins1, margins2;
+        string file = "unit-tests/other/03-BeetAnGeSample.xml";
+        string source1 = import_with_threads(file, 1, &errors1, &margins1);
+        string source2 = import_with_threads(file, 2, &errors2, &margins2);
+
+        CHECK( source1.size() > 1000 );
+        CHECK( source1 == source2 );
+        CHECK( errors1 == errors2 );
+        CHECK( margins1.size() == 2 );
+        CHECK( margins1 == margins2 );
+    }
+
+    TEST_FIXTURE(MxlAnalyserTestFixture, MxlAnalyser_parts_02)
+    {
+        //@02. parts analysed concurrently: errors reported in document order
+
+        string xml =
+            "<score-partwise version='3.0'><part-list>"
+            "<score-part id='P1'><part-name/></score-part>"
+            "<score-part id='P2'><part-name/></score-part>"
+            "<score-part id='P3'><part-name/></score-part>"
+            "</part-list>"
+            "<part id='P1'><measure number='1'>"
+                "<note><pitch><step>C</step><octave>4</octave></pitch>"
+                "<duration>4</duration><type>whole</type>"
+                "<notations><slur type='start' number='1'/></notations></note>"
+            "</measure></part>"
+            "<part id='P2'><measure number='1'>"
+                "<note><pitch><step>E</step><octave>4</octave></pitch>"
+                "<duration>4</duration><type>whole</type></note>"
+                "<note><pitch><step>F</step><octave>4</octave></pitch>"
+                "<duration>4</duration><type>eighth</type><beam number='1'>end</beam></note>"
+            "</measure></part>"
+            "<part id='P2'><measure number='1'/></part>"
+            "<part id='P3'><measure number='1'>"
+                "<note><rest/><duration>4</duration><type>whole</type></note>"
+            "</measure></part>"
+            "</score-partwise>";
+
+        string errors1, errors4;
+        string source1 = import_with_threads(xml, 1, &errors1);
+        string source4 = import_with_threads(xml, 4, &errors4);
+
+        CHECK( errors1.find("Duplicated <part>") != string::npos );
+        CHECK( errors1 == errors4 );
+        CHECK( source1 == source4 );
+    }
+
+#if (LOMSE_ENABLE_THREADS == 1)
+    TEST_FIXTURE(MxlAnalyserTestFixture, MxlAnalyser_parts_03)
+    {
+        //@03. parts analysed concurrently: ids are valid and do not depend on the
+        //@    number of threads
+
+        string file = m_scores_path + "unit-tests/transpose/002-transpose-octave-change.xml";
+        m_libraryScope.get_musicxml_options()->analysis_threads(2);
+        Document doc2(m_libraryScope);
+        doc2.from_file(file, Document::k_format_mxl);
+        m_libraryScope.get_musicxml_options()->analysis_threads(3);
+        Document doc3(m_libraryScope);
+        doc3.from_file(file, Document::k_format_mxl);
+
+        ImoScore* pScore2 = static_cast<ImoScore*>( doc2.get_im_root()->get_content_item(0) );
+        ImoScore* pScore3 = static_cast<ImoScore*>( doc3.get_im_root()->get_content_item(0) );
+        CHECK( pScore2->get_num_instruments() == 4 );
+        for (int i=0; i < pScore2->get_num_instruments(); ++i)
+        {
+            ImoMusicData* pMD2 = pScore2->get_instrument(i)->get_musicdata();
+            ImoMusicData* pMD3 = pScore3->get_instrument(i)->get_musicdata();
+            ImoObj::children_iterator it2 = pMD2->begin();
+            ImoObj::children_iterator it3 = pMD3->begin();
+            for (; it2 != pMD2->end() && it3 != pMD3->end(); ++it2, ++it3)
+            {
+                CHECK( (*it2)->get_id() == (*it3)->get_id() );
+                CHECK( doc2.get_pointer_to_imo((*it2)->get_id()) == *it2 );
+            }
+            CHECK( it2 == pMD2->end() );
+            CHECK( it3 == pMD3->end() );
+        }
+
+        //objects created later receive new ids
+        ImoObj* pImo = ImFactory::inject(k_imo_note_regular, &doc2);
+        CHECK( doc2.get_pointer_to_imo(pImo->get_id()) == pImo );
+        delete pImo;
+    }
+
+    TEST_FIXTURE(MxlAnalyserTestFixture, MxlAnalyser_parts_04)
+    {
+        //@04. parts analysed concurrently: ids ranges are sized from the parts, not
+        //@    spread over all available ids
+
+        string file = m_scores_path + "unit-tests/transpose/002-transpose-octave-change.xml";
+        m_libraryScope.get_musicxml_options()->analysis_threads(1);
+        Document doc1(m_libraryScope);
+        doc1.from_file(file, Document::k_format_mxl);
+        m_libraryScope.get_musicxml_options()->analysis_threads(2);
+        Document doc2(m_libraryScope);
+        doc2.from_file(file, Document::k_format_mxl);
+
+        ImoObj* pImo1 = ImFactory::inject(k_imo_note_regular, &doc1);
+        ImoObj* pImo2 = ImFactory::inject(k_imo_note_regular, &doc2);
+        CHECK( pImo2->get_id() > pImo1->get_id() );
+        CHECK( pImo2->get_id() < 10000 );
+        delete pImo1;
+        delete pImo2;
+    }
+
+    TEST_FIXTURE(MxlAnalyserTestFixture, MxlAnalyser_parts_05)
+    {
+        //@05. parts analysed concurrently: when a part uses more ids than reserved,
+        //@    its excess ids are renumbered. Ids are not duplicated
+
+        string file = "unit-tests/transpose/002-transpose-octave-change.xml";
+        string errors1;
+        string source1 = import_with_threads(file, 1, &errors1);
+
+        m_libraryScope.get_musicxml_options()->analysis_threads(2);
+        stringstream errormsg;
+        Document doc(m_libraryScope, errormsg);
+        XmlParser parser(errormsg);
+        parser.parse_file(m_scores_path + file);
+        MyMxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
+        a.dbg_ids_per_part(2);
+        ImoDocument* pImoDoc = dynamic_cast<ImoDocument*>(
+                                    a.analyse_tree(parser.get_tree_root(), file) );
+        CHECK( pImoDoc != nullptr );
+        if (!pImoDoc)
+            return;
+
+        set<ImoId> ids;
+        CHECK( check_unique_ids(doc, pImoDoc, ids) );
+        CHECK( ids.size() > 40 );
+        ImoObj* pImo = ImFactory::inject(k_imo_note_regular, &doc);
+        CHECK( pImo->get_id() > *ids.rbegin() );
+        delete pImo;
+
+        ModelBuilder builder;
+        builder.build_model(pImoDoc);
+        ImoScore* pScore = static_cast<ImoScore*>( pImoDoc->get_content_item(0) );
+        LdpExporter exporter;
+        exporter.set_add_id(false);
+        string source2 = regex_replace(exporter.get_source(pScore),
+                                       regex("\\((beam|tie|slur) [0-9]+"), "($1");
+        CHECK( source1 == source2 );
+        CHECK( errors1 == errormsg.str() );
+        delete pImoDoc;
+    }
+#endif
+
 }
 
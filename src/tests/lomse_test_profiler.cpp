@@ -0,0 +1,213 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Copyright (c) 2010-present, Lomse Developers
+//
+// Licensed under the MIT license.
+//
+// See LICENSE and NOTICE.md files in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#include <UnitTest++.h>
+#include <sstream>
+#include "lomse_build_options.h"
+
+//classes related to these tests
+#include "lomse_injectors.h"
+#include "lomse_profiler.h"
+#include "lomse_document_layouter.h"
+#include "lomse_graphical_model.h"
+#include "lomse_import_options.h"
+#include "private/lomse_document_p.h"
+
+
+using namespace UnitTest;
+using namespace std;
+using namespace lomse;
+
+
+//=======================================================================================
+// test for PhaseProfiler
+//=======================================================================================
+
+class PhaseProfilerTestFixture
+{
+public:
+    LibraryScope m_libraryScope;
+    std::string m_scores_path;
+
+    PhaseProfilerTestFixture()     //SetUp fixture
+        : m_libraryScope(cout)
+    {
+        m_scores_path = TESTLIB_SCORES_PATH;
+        m_libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    }
+
+    ~PhaseProfilerTestFixture()    //TearDown fixture
+    {
+    }
+
+    const ProfilerPhase* find_phase(const vector<ProfilerPhase>& phases,
+                                    const string& name)
+    {
+        for (const ProfilerPhase& phase : phases)
+        {
+            if (phase.name == name)
+                return &phase;
+        }
+        return nullptr;
+    }
+
+};
+
+//---------------------------------------------------------------------------------------
+SUITE(PhaseProfilerTest)
+{
+
+    TEST_FIXTURE(PhaseProfilerTestFixture, profiler_01)
+    {
+        //@01. nothing recorded when the profiler is not active
+
+        PhaseProfiler profiler;
+        {
+            ProfilerScope scope("phase");
+        }
+
+        CHECK( PhaseProfiler::current() == nullptr );
+        CHECK( profiler.get_phases().size() == 0 );
+    }
+
+    TEST_FIXTURE(PhaseProfilerTestFixture, profiler_02)
+    {
+        //@02. nested scopes. Depth and count recorded. Previous profiler restored
+
+        PhaseProfiler profiler;
+        {
+            ProfilerActivation profiling(&profiler);
+            CHECK( PhaseProfiler::current() == &profiler );
+            ProfilerScope scope("outer");
+            for (int i=0; i < 3; ++i)
+            {
+                ProfilerScope scope2("inner");
+            }
+        }
+        CHECK( PhaseProfiler::current() == nullptr );
+
+        vector<ProfilerPhase> phases = profiler.get_phases();
+        CHECK( phases.size() == 4 );
+        CHECK( profiler.get_count("inner") == 3 );
+        CHECK( profiler.get_count("outer") == 1 );
+        const ProfilerPhase* pOuter = find_phase(phases, "outer");
+        const ProfilerPhase* pInner = find_phase(phases, "inner");
+        CHECK( pOuter && pOuter->depth == 0 );
+        CHECK( pInner && pInner->depth == 1 );
+        CHECK( pInner && pInner->thread == 0 );
+        CHECK( profiler.get_total_time("outer") >= profiler.get_total_time("inner") );
+
+        profiler.clear();
+        CHECK( profiler.get_phases().size() == 0 );
+    }
+
+    TEST_FIXTURE(PhaseProfilerTestFixture, profiler_03)
+    {
+        //@03. activation with nullptr keeps current profiler
+
+        PhaseProfiler profiler;
+        ProfilerActivation profiling(&profiler);
+        {
+            ProfilerActivation none(nullptr);
+            ProfilerScope scope("phase");
+        }
+
+        CHECK( profiler.get_count("phase") == 1 );
+    }
+
+    TEST_FIXTURE(PhaseProfilerTestFixture, profiler_04)
+    {
+        //@04. export. JSON summary and Chrome trace
+
+        PhaseProfiler profiler;
+        {
+            ProfilerActivation profiling(&profiler);
+            ProfilerScope scope("outer");
+            {
+                ProfilerScope scope2("in \"quotes\"");
+            }
+        }
+
+        string json = profiler.to_json();
+        string trace = profiler.to_chrome_trace();
+//        cout << json << endl << trace << endl;
+
+        CHECK( json.find("{\"phases\":[{\"name\":\"outer\",\"depth\":0,\"count\":1,") == 0 );
+        CHECK( json.find("{\"name\":\"in \\\"quotes\\\"\",\"depth\":1,\"count\":1,")
+               != string::npos );
+        CHECK( trace.find("{\"traceEvents\":[{\"name\":\"in \\\"quotes\\\"\"") == 0 );
+        CHECK( trace.find("\"ph\":\"X\"") != string::npos );
+        CHECK( trace.find("\"pid\":1,\"tid\":0}") != string::npos );
+    }
+
+    TEST_FIXTURE(PhaseProfilerTestFixture, profiler_05)
+    {
+        //@05. document. Phases for opening the document are recorded
+
+        PhaseProfiler profiler;
+        Document doc(m_libraryScope);
+        doc.set_profiler(&profiler);
+        doc.from_file(m_scores_path + "01026-beamed-chords.lms");
+
+        CHECK( PhaseProfiler::current() == nullptr );
+        vector<ProfilerPhase> phases = profiler.get_phases();
+        const ProfilerPhase* pOpen = find_phase(phases, "Document::from_file");
+        CHECK( pOpen && pOpen->depth == 0 );
+        CHECK( profiler.get_count("LdpParser::parse") == 2 );   //score + wrapper doc
+        CHECK( profiler.get_count("LdpAnalyser::analyse_tree") == 1 );
+        CHECK( profiler.get_count("ModelBuilder::build_model") == 1 );
+        CHECK( profiler.get_count("ColStaffObjsBuilder::build") == 1 );
+        CHECK( profiler.get_count("MeasuresTableBuilder::build") == 1 );
+        CHECK( profiler.get_count("MidiAssigner::assign_midi_data") == 1 );
+        CHECK( profiler.get_count("PitchAssigner::assign_pitch") == 1 );
+        const ProfilerPhase* pBuilder = find_phase(phases, "ColStaffObjsBuilder::build");
+        CHECK( pBuilder && pBuilder->depth == 2 );
+    }
+
+    TEST_FIXTURE(PhaseProfilerTestFixture, profiler_06)
+    {
+        //@06. document. Phases for the layout are recorded
+
+        PhaseProfiler profiler;
+        Document doc(m_libraryScope);
+        doc.from_file(m_scores_path + "01026-beamed-chords.lms");
+        doc.set_profiler(&profiler);
+        DocLayouter layouter(&doc, m_libraryScope);
+        layouter.layout_document();
+        delete layouter.get_graphic_model();
+
+        CHECK( profiler.get_count("Document::from_file") == 0 );
+        CHECK( profiler.get_count("DocLayouter::layout_document") == 1 );
+        CHECK( profiler.get_count("ScoreLayouter::prepare_to_start_layout") == 1 );
+        CHECK( profiler.get_count("ColumnsBuilder::create_columns") == 1 );
+        CHECK( profiler.get_count("ScoreLayouter::decide_line_breaks") == 1 );
+        CHECK( profiler.get_count("SystemLayouter::engrave_system") >= 1 );
+        CHECK( profiler.get_count("SystemLayouter::engrave_system_details")
+               == profiler.get_count("SystemLayouter::engrave_system") );
+    }
+
+#if (LOMSE_ENABLE_THREADS == 1)
+    TEST_FIXTURE(PhaseProfilerTestFixture, profiler_07)
+    {
+        //@07. MusicXML parts analysed concurrently. Phases recorded in all threads
+
+        m_libraryScope.get_musicxml_options()->analysis_threads(2);
+        PhaseProfiler profiler;
+        Document doc(m_libraryScope);
+        doc.set_profiler(&profiler);
+        doc.from_file(m_scores_path + "unit-tests/transpose/002-transpose-octave-change.xml",
+                      Document::k_format_mxl);
+
+        CHECK( profiler.get_count("XmlParser::parse") == 1 );
+        CHECK( profiler.get_count("MxlAnalyser::analyse_tree") == 1 );
+        CHECK( profiler.get_count("MxlAnalyser::analyse_part") == 4 );
+    }
+#endif
+
+}
@@ -172,4 +172,37 @@ SUITE(LdpFileReaderTest)
         CHECK( reader.get_locator() == loc);
     }
 
+    TEST_FIXTURE(LdpFileReaderTestFixture, FileReaderCountsLines)
+    {
+        LdpFileReader reader(m_scores_path + "00011-empty-fill-page.lms");
+        CHECK( reader.get_line_number() == 1 );
+        while (reader.get_next_char() != '\n');
+        CHECK( reader.get_line_number() == 2 );
+        reader.repeat_last_char();
+        reader.get_next_char();
+        CHECK( reader.get_line_number() == 2 );
+    }
+
+    TEST_FIXTURE(LdpFileReaderTestFixture, FileReaderReadsZipEntryMultipleOfChunk)
+    {
+        //zip entry of exactly 64KB: no read after end of entry
+        LdpFileReader reader(m_scores_path +
+                             "10015-ldp-64k-entry.zip#zip:score-65536-bytes.lms");
+        CHECK( reader.is_ready() );
+        CHECK( reader.get_next_char() == '(' );
+        int numChars = 1;
+        while (!reader.end_of_data())
+        {
+            reader.get_next_char();
+            ++numChars;
+        }
+        CHECK( numChars == 65536 );
+    }
+
+    TEST_FIXTURE(LdpFileReaderTestFixture, FileReaderReadsEmptyZipEntry)
+    {
+        LdpFileReader reader(m_scores_path + "10015-ldp-64k-entry.zip#zip:empty.lms");
+        CHECK( reader.end_of_data() == true );
+    }
+
 }
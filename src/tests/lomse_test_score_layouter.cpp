@@ -918,6 +918,49 @@ SUITE(ScoreLayouterTest)
 //        scoreLyt.my_delete_all();
 //    }
 
+
+    //@3xx. LinesBreakerOptimal
+
+    TEST_FIXTURE(ScoreLayouterTestFixture, ScoreLayouter_300)
+    {
+        //@300. Bounded lookahead: systems do not have more columns than allowed
+
+        stringstream src;
+        src << "(score (vers 2.0)(instrument (musicData (clef G)(time 2 4)";
+        for (int i=0; i < 40; ++i)
+            src << "(n c4 q)(n e4 q)(barline)";
+        src << ")))";
+        Document doc(m_libraryScope);
+        doc.from_string(src.str());
+        GraphicModel gmodel( doc.get_im_root() );
+        ImoScore* pImoScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        m_libraryScope.set_lines_breaker_max_columns(3);
+        MyScoreLayouter scoreLyt(pImoScore, &gmodel, m_libraryScope);
+        scoreLyt.prepare_to_start_layout();
+        GmoBoxScorePage pageBox(pImoScore);
+        pageBox.set_origin(1500.0f, 2000.0f);
+        pageBox.set_width(19000.0f);
+        pageBox.set_height(25700.0f);
+        scoreLyt.my_page_initializations(&pageBox);
+        scoreLyt.my_move_cursor_to_top_left_corner();
+        scoreLyt.my_decide_line_breaks();
+
+        std::vector<int>& breaks = scoreLyt.my_get_line_breaks();
+        int numCols = scoreLyt.get_num_columns();
+        CHECK( numCols == 40 );
+        CHECK( breaks.size() >= 14 );
+        bool fOk = (breaks.size() > 0 && breaks[0] == 0);
+        for (size_t i=1; fOk && i <= breaks.size(); ++i)
+        {
+            int iEnd = (i == breaks.size() ? numCols : breaks[i]);
+            fOk = (iEnd > breaks[i-1] && iEnd - breaks[i-1] <= 3);
+        }
+        CHECK( fOk );
+
+        m_libraryScope.set_lines_breaker_max_columns(0);
+        scoreLyt.my_delete_all();
+    }
+
 };
 
 
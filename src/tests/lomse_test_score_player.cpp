@@ -27,6 +27,7 @@
 #include "lomse_player_gui.h"
 
 #include <list>
+#include <set>
 
 
 using namespace UnitTest;
@@ -34,8 +35,9 @@ using namespace std;
 using namespace lomse;
 
 //---------------------------------------------------------------------------------------
-//Helper, to save Highlight events
+//Helper, to save Highlight events and the time at which they are received
 std::list<SpEventInfo> m_notifications;
+std::vector<PlaybackTime> m_notificationTimes;
 
 //---------------------------------------------------------------------------------------
 //Helper, as mock class and for accessing protected members
@@ -52,6 +54,7 @@ public:
     }
     virtual ~MyScorePlayer() {
         m_notifications.clear();
+        m_notificationTimes.clear();
     }
 
     //std::vector<SoundEvent*>& my_get_events() { return m_events; }
@@ -75,6 +78,7 @@ public:
     static void my_callback(void* UNUSED(pThis), SpEventInfo event)
     {
         m_notifications.push_back(event);
+        m_notificationTimes.push_back(PlaybackClock::now());
     }
 
     //access to protected members
@@ -179,6 +183,30 @@ public:
     std::list<int>& my_get_events() { return m_events; }
 };
 
+//---------------------------------------------------------------------------------------
+//Helper, mock class for a midi server that schedules events
+class MyTimedMidiServer : public MidiServerBase
+{
+protected:
+    std::vector<PlaybackTime> m_timestamps;     //requested time for each note on
+    std::vector<PlaybackTime> m_invoked;        //real time when invoked
+
+public:
+    MyTimedMidiServer() : MidiServerBase() {}
+    virtual ~MyTimedMidiServer() {}
+
+    //overrides
+    void note_on_at(PlaybackTime when, int UNUSED(channel), int UNUSED(pitch),
+                    int UNUSED(volume)) override
+    {
+        m_timestamps.push_back(when);
+        m_invoked.push_back(PlaybackClock::now());
+    }
+
+    std::vector<PlaybackTime>& my_get_timestamps() { return m_timestamps; }
+    std::vector<PlaybackTime>& my_get_invoked() { return m_invoked; }
+};
+
 //---------------------------------------------------------------------------------------
 class MyEventHandlerCPP2 : public EventHandler
 {
@@ -476,6 +504,172 @@ SUITE(ScorePlayerTest)
         CHECK( handler.my_last_event_type() == k_end_of_playback_event );
     }
 
+    TEST_FIXTURE(ScorePlayerTestFixture, TimingStats)
+    {
+        SpDocument spDoc( new Document(m_libraryScope) );
+        spDoc->from_string("(lenmusdoc (vers 0.0) (content (score (vers 2.0) "
+            "(instrument (musicData (clef G)(n c4 q)(n d4 q)(n e4 q)(n f4 q) )) )))" );
+        ImoScore* pScore = static_cast<ImoScore*>( spDoc->get_im_root()->get_content_item(0) );
+        MyTimedMidiServer midi;
+        MyScorePlayer2 player(m_libraryScope, &midi);
+        PlayerNoGui playGui;
+        player.load_score(pScore, &playGui);
+        player.play(k_no_visual_tracking, 480L, nullptr);
+        player.my_wait_for_termination();
+
+        PlaybackTimingStats stats = player.get_timing_stats();
+        CHECK( stats.numEvents > 0L );
+        CHECK( stats.maxLateness >= stats.meanLateness );
+        CHECK( stats.jitter >= 0.0 );
+        CHECK( stats.drift <= stats.maxLateness );
+    }
+
+    TEST_FIXTURE(ScorePlayerTestFixture, TimestampsAreDriftFree)
+    {
+        //at 240 BPM a quarter note lasts 250 ms. Timestamps must be exact, without
+        //accumulated rounding or scheduling errors
+        SpDocument spDoc( new Document(m_libraryScope) );
+        spDoc->from_string("(lenmusdoc (vers 0.0) (content (score (vers 2.0) "
+            "(instrument (musicData (clef G)(n c4 q)(n d4 q)(n e4 q)(n f4 q) )) )))" );
+        ImoScore* pScore = static_cast<ImoScore*>( spDoc->get_im_root()->get_content_item(0) );
+        MyTimedMidiServer midi;
+        MyScorePlayer2 player(m_libraryScope, &midi);
+        PlayerNoGui playGui;
+        player.load_score(pScore, &playGui);
+        player.play(k_no_visual_tracking, 240L, nullptr);
+        player.my_wait_for_termination();
+
+        std::vector<PlaybackTime>& timestamps = midi.my_get_timestamps();
+        CHECK( timestamps.size() == 4 );
+        for (size_t i=1; i < timestamps.size(); ++i)
+        {
+            std::chrono::microseconds interval =
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    timestamps[i] - timestamps[0] );
+            CHECK( interval.count() == long(i) * 250000L );
+        }
+    }
+
+    TEST_FIXTURE(ScorePlayerTestFixture, LookaheadDeliversInAdvance)
+    {
+        SpDocument spDoc( new Document(m_libraryScope) );
+        spDoc->from_string("(lenmusdoc (vers 0.0) (content (score (vers 2.0) "
+            "(instrument (musicData (clef G)(n c4 q)(n d4 q)(n e4 q) )) )))" );
+        ImoScore* pScore = static_cast<ImoScore*>( spDoc->get_im_root()->get_content_item(0) );
+        MyTimedMidiServer midi;
+        MyScorePlayer2 player(m_libraryScope, &midi);
+        PlayerNoGui playGui;
+        player.load_score(pScore, &playGui);
+        player.set_lookahead(100000L);
+        player.play(k_no_visual_tracking, 240L, nullptr);
+        player.my_wait_for_termination();
+
+        CHECK( player.get_lookahead() == 100000L );
+        std::vector<PlaybackTime>& timestamps = midi.my_get_timestamps();
+        std::vector<PlaybackTime>& invoked = midi.my_get_invoked();
+        CHECK( timestamps.size() == 3 );
+        //all notes but the first one are delivered before their time
+        for (size_t i=1; i < timestamps.size(); ++i)
+        {
+            CHECK( invoked[i] < timestamps[i] );
+        }
+    }
+
+    TEST_FIXTURE(ScorePlayerTestFixture, LookaheadWithVisualTracking)
+    {
+        //visual tracking events are sent at their real time, without reducing the
+        //time in advance for sound events, nor accounting it as lateness.
+        //At 240 BPM notes are 250 ms apart, less than the lookahead
+        LomseDoorway* pLomse = m_libraryScope.platform_interface();
+        pLomse->set_notify_callback(nullptr, MyScorePlayer::my_callback);
+        SpDocument spDoc( new Document(m_libraryScope) );
+        spDoc->from_string("(lenmusdoc (vers 0.0) (content (score (vers 2.0) "
+            "(instrument (musicData (clef G)(n c4 q)(n d4 q)(n e4 q)(n f4 q) )) )))" );
+        ImoScore* pScore = static_cast<ImoScore*>( spDoc->get_im_root()->get_content_item(0) );
+        MyTimedMidiServer midi;
+        MyScorePlayer player(m_libraryScope, &midi);
+        PlayerNoGui playGui;
+        player.load_score(pScore, &playGui);
+        player.set_lookahead(400000L);
+        int nEvMax = player.my_get_table()->num_events() - 1;
+        SpInteractor inter( LOMSE_NEW Interactor(m_libraryScope, WpDocument(spDoc), nullptr, nullptr) );
+        player.my_do_play(0, nEvMax, k_play_normal_instrument, k_do_visual_tracking,
+                          k_no_countoff, 240L, inter.get());
+        player.my_wait_for_termination();
+
+        //notes after the lookahead time are delivered with the full lookahead
+        std::vector<PlaybackTime>& timestamps = midi.my_get_timestamps();
+        std::vector<PlaybackTime>& invoked = midi.my_get_invoked();
+        CHECK( timestamps.size() == 4 );
+        for (size_t i=2; i < timestamps.size(); ++i)
+        {
+            std::chrono::microseconds advance =
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    timestamps[i] - invoked[i] );
+            CHECK( advance.count() > 300000L );
+        }
+
+        //highlight for each note is not sent before the note sounds
+        size_t iNote = 0;
+        std::list<SpEventInfo>::iterator itN = m_notifications.begin();
+        for (size_t i=0; itN != m_notifications.end(); ++itN, ++i)
+        {
+            if ((*itN)->get_event_type() != k_tracking_event)
+                continue;
+            SpEventVisualTracking pEv( static_pointer_cast<EventVisualTracking>(*itN) );
+            for (auto& item : pEv->get_items())
+            {
+                if (item.first == EventVisualTracking::k_highlight_on
+                    && iNote < timestamps.size())
+                {
+                    CHECK( m_notificationTimes[i] >= timestamps[iNote] );
+                    ++iNote;
+                }
+            }
+        }
+        CHECK( iNote == 4 );
+
+        PlaybackTimingStats stats = player.get_timing_stats();
+        CHECK( stats.numEvents > 0L );
+        CHECK( stats.meanLateness < 50000.0 );
+    }
+
+    TEST_FIXTURE(ScorePlayerTestFixture, TrackingEventsKeptAreNotReused)
+    {
+        //visual tracking events are reused only when the application releases them
+        LomseDoorway* pLomse = m_libraryScope.platform_interface();
+        pLomse->set_notify_callback(nullptr, MyScorePlayer::my_callback);
+        SpDocument spDoc( new Document(m_libraryScope) );
+        spDoc->from_string("(lenmusdoc (vers 0.0) (content (score (vers 2.0) "
+            "(instrument (musicData (clef G)(n c4 e)(n d4 e)(n e4 e)(n f4 e)"
+            "(n g4 e)(n a4 e) )) )))" );
+        ImoScore* pScore = static_cast<ImoScore*>( spDoc->get_im_root()->get_content_item(0) );
+        MyMidiServer midi;
+        MyScorePlayer player(m_libraryScope, &midi);
+        PlayerNoGui playGui;
+        player.load_score(pScore, &playGui);
+        int nEvMax = player.my_get_table()->num_events() - 1;
+        SpInteractor inter( LOMSE_NEW Interactor(m_libraryScope, WpDocument(spDoc), nullptr, nullptr) );
+        player.my_do_play(0, nEvMax, k_play_normal_instrument, k_do_visual_tracking,
+                          k_no_countoff, 480L, inter.get());
+        player.my_wait_for_termination();
+
+        //all tracking events are different objects and keep their items
+        std::set<EventInfo*> received;
+        int numHighlightOn = 0;
+        for (SpEventInfo& pEvent : m_notifications)
+        {
+            if (pEvent->get_event_type() != k_tracking_event)
+                continue;
+            CHECK( received.insert(pEvent.get()).second == true );
+            SpEventVisualTracking pEv( static_pointer_cast<EventVisualTracking>(pEvent) );
+            CHECK( pEv->get_num_items() > 0 );
+            for (auto& item : pEv->get_items())
+                numHighlightOn += (item.first == EventVisualTracking::k_highlight_on ? 1 : 0);
+        }
+        CHECK( numHighlightOn == 6 );
+    }
+
 }
 
 #endif  //LOMSE_ENABLE_THREADS == 1
@@ -3359,6 +3359,180 @@ SUITE(ColStaffObjsBuilderTest)
         if (pRoot && !pRoot->is_document()) delete pRoot;
     }
 
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, find_entry_01)
+    {
+        //@01. find() returns the entry for each staffobj
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (musicData (clef G)(n c4 q)(n e4 q)(barline)(n g4 h)))"
+            "(instrument (musicData (clef F4)(n c3 h)(barline)(n e3 q)(r q))))");
+        ImoScore* pScore = dynamic_cast<ImoScore*>( doc.get_content_item(0) );
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+
+        CHECK( pTable->num_entries() == 10 );
+        ColStaffObjsIterator it;
+        for (it = pTable->begin(); it != pTable->end(); ++it)
+        {
+            CHECK( *(pTable->find((*it)->imo_object())) == *it );
+        }
+
+        Document doc2(m_libraryScope);
+        doc2.from_string("(score (vers 2.0)(instrument (musicData (n c4 q))))");
+        ImoScore* pScore2 = dynamic_cast<ImoScore*>( doc2.get_content_item(0) );
+        ImoStaffObj* pOther = pScore2->get_staffobjs_table()->front()->imo_object();
+        CHECK( pTable->find(pOther) == pTable->end() );
+    }
+
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, find_entry_02)
+    {
+        //@02. deleted entries are not found
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (musicData (clef G)(n c4 q)(n e4 q)(barline))))");
+        ImoScore* pScore = dynamic_cast<ImoScore*>( doc.get_content_item(0) );
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+        ColStaffObjsIterator it = pTable->begin();
+        ++it;
+        ImoStaffObj* pNote1 = (*it)->imo_object();
+        ++it;
+        ImoStaffObj* pNote2 = (*it)->imo_object();
+
+        pTable->delete_entry_for(pNote1);
+
+        CHECK( pTable->num_entries() == 3 );
+        CHECK( pTable->find(pNote1) == pTable->end() );
+        CHECK( (*pTable->find(pNote2))->imo_object() == pNote2 );
+    }
+
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, find_entry_03)
+    {
+        //@03. key & time signatures: first entry is found. Next one after deleting
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (staves 2)(musicData "
+            "(clef G p1)(clef F4 p2)(key D)(time 2 4)(n c4 q p1))))");
+        ImoScore* pScore = dynamic_cast<ImoScore*>( doc.get_content_item(0) );
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+        ColStaffObjsIterator it = pTable->begin();
+        ++it;
+        ++it;
+        ImoStaffObj* pKey = (*it)->imo_object();
+        CHECK( pKey->is_key_signature() );
+        CHECK( (*pTable->find(pKey))->staff() == 0 );
+
+        pTable->delete_entry_for(pKey);
+
+        CHECK( pTable->find(pKey) != pTable->end() );
+        CHECK( (*pTable->find(pKey))->staff() == 1 );
+    }
+
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, find_entry_04)
+    {
+        //@04. second instrument entries inserted in order, starting search at
+        //     last inserted entry
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (musicData (clef G)(n c4 q)(n e4 q)(barline)(n g4 h)(barline)))"
+            "(instrument (musicData (clef F4)(n c3 h)(barline)(n e3 q)(r q)(barline))))");
+        ImoScore* pScore = dynamic_cast<ImoScore*>( doc.get_content_item(0) );
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+
+//        cout << test_name() << endl << pTable->dump();
+        CHECK( pTable->num_entries() == 12 );
+        ColStaffObjsIterator it = pTable->begin();
+        //              instr, staff, meas. time, line, scr
+        CHECK_ENTRY0(it, 0,    0,      0,    0,     0, "(clef G p1)" );
+        CHECK_ENTRY0(it, 1,    0,      0,    0,     1, "(clef F4 p1)" );
+        CHECK_ENTRY0(it, 0,    0,      0,    0,     0, "(n c4 q v1 p1)" );
+        CHECK_ENTRY0(it, 1,    0,      0,    0,     1, "(n c3 h v1 p1)" );
+        CHECK_ENTRY0(it, 0,    0,      0,   64,     0, "(n e4 q v1 p1)" );
+        CHECK_ENTRY0(it, 0,    0,      0,  128,     0, "(barline simple)" );
+        CHECK_ENTRY0(it, 1,    0,      0,  128,     1, "(barline simple)" );
+        CHECK_ENTRY0(it, 0,    0,      1,  128,     0, "(n g4 h v1 p1)" );
+        CHECK_ENTRY0(it, 1,    0,      1,  128,     1, "(n e3 q v1 p1)" );
+        CHECK_ENTRY0(it, 1,    0,      1,  192,     1, "(r q v1 p1)" );
+        CHECK_ENTRY0(it, 0,    0,      1,  256,     0, "(barline simple)" );
+        CHECK_ENTRY0(it, 1,    0,      1,  256,     1, "(barline simple)" );
+    }
+
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, nav_index_01)
+    {
+        //@01. find_entry_at_time() returns first entry for the instrument with time
+        //     not lower than requested time, and not before start entry
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (musicData (clef G)(n c4 q)(n e4 q)(barline)(n g4 h)(barline)))"
+            "(instrument (musicData (clef F4)(n c3 h)(barline)(n e3 q)(r q)(barline))))");
+        ImoScore* pScore = dynamic_cast<ImoScore*>( doc.get_content_item(0) );
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+
+        ColStaffObjsEntry* pEntry = pTable->find_entry_at_time(0, 0.0);
+        CHECK( pEntry && pEntry->imo_object()->is_clef() );
+        pEntry = pTable->find_entry_at_time(1, 100.0);
+        CHECK( pEntry && pEntry->imo_object()->is_barline() );
+        CHECK( pEntry && pEntry->num_instrument() == 1 );
+        pEntry = pTable->find_entry_at_time(1, 150.0);
+        CHECK( pEntry && pEntry->time() == 192.0 );
+        CHECK( pTable->find_entry_at_time(0, 300.0) == nullptr );
+        CHECK( pTable->find_entry_at_time(2, 0.0) == nullptr );
+
+        ColStaffObjsEntry* pStart = pTable->find_entry_at_time(0, 64.0);    //e4
+        pEntry = pTable->find_entry_at_time(0, 0.0, pStart);
+        CHECK( pEntry == pStart );
+    }
+
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, nav_index_02)
+    {
+        //@02. find_barline_in_measure(), find_prev_barline() and
+        //     find_prev_time_signature()
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (musicData (clef G)(time 2 4)(n c4 q)(n e4 q)(barline)"
+            "(time 3 8)(n g4 q.)(barline)(n a4 q.)(barline))))");
+        ImoScore* pScore = dynamic_cast<ImoScore*>( doc.get_content_item(0) );
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+
+        ColStaffObjsEntry* pBarline = pTable->find_barline_in_measure(0, 1);
+        CHECK( pBarline && pBarline->imo_object()->is_barline() );
+        CHECK( pBarline && pBarline->measure() == 1 );
+        CHECK( pBarline && pBarline->time() == 224.0 );
+        CHECK( pTable->find_barline_in_measure(0, 3) == nullptr );
+
+        CHECK( pTable->find_prev_barline(0, pBarline) == pTable->find_barline_in_measure(0, 0) );
+        CHECK( pTable->find_prev_barline(0, nullptr) == pTable->find_barline_in_measure(0, 2) );
+        CHECK( pTable->find_prev_barline(0, pTable->front()) == nullptr );
+
+        ColStaffObjsEntry* pTS = pTable->find_prev_time_signature(0, pBarline);
+        CHECK( pTS && pTS->imo_object()->is_time_signature() );
+        CHECK( pTS && pTS->time() == 128.0 );
+    }
+
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, nav_index_03)
+    {
+        //@03. navigation index is updated when the table is modified
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (musicData (clef G)(n c4 q)(n e4 q)(barline)(n g4 h)(barline))))");
+        ImoScore* pScore = dynamic_cast<ImoScore*>( doc.get_content_item(0) );
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+        ColStaffObjsEntry* pBarline = pTable->find_barline_in_measure(0, 0);
+        ImoStaffObj* pSO = pBarline->imo_object();
+
+        pTable->delete_entry_for(pSO);
+
+        pBarline = pTable->find_barline_in_measure(0, 0);
+        CHECK( pBarline == nullptr );
+        CHECK( pTable->find_prev_barline(0, nullptr)->measure() == 1 );
+        ColStaffObjsEntry* pEntry = pTable->find_entry_at_time(0, 100.0);
+        CHECK( pEntry && pEntry->imo_object()->is_note() );
+    }
+
     TEST_FIXTURE(ColStaffObjsBuilderTestFixture, ColStaffObjsTimeInSequenceWhenDecimals)
     {
         Document doc(m_libraryScope);
@@ -275,4 +275,22 @@ SUITE(LdpTokenizerTest)
         CHECK( token->get_value() == "-45.70" );
     }
 
+    TEST_FIXTURE(LdpTokenizerTestFixture, Tokenizer_line_numbers_from_file)
+    {
+        LdpFileReader reader(m_scores_path + "00011-empty-fill-page.lms");
+        LdpTokenizer tokenizer(reader, cout);
+        LdpToken* token = tokenizer.read_token();
+        CHECK( token->get_type() == tkStartOfElement );
+        CHECK( token->get_line_number() == 1 );
+        token = tokenizer.read_token();
+        CHECK( token->get_value() == "score" );
+        CHECK( token->get_line_number() == 1 );
+        token = tokenizer.read_token();
+        CHECK( token->get_type() == tkStartOfElement );
+        CHECK( token->get_line_number() == 2 );
+        token = tokenizer.read_token();
+        CHECK( token->get_value() == "vers" );
+        CHECK( token->get_line_number() == 2 );
+    }
+
 };
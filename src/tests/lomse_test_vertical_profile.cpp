@@ -36,22 +36,12 @@ public:
 
     inline size_t my_x_min_size(int idxStaff) { return m_xMin[idxStaff]->size(); }
     inline size_t my_x_max_size(int idxStaff) { return m_xMax[idxStaff]->size(); }
-    inline list<VProfilePoint>* my_xMin(int idxStaff) { return m_xMin[idxStaff]; }
-    inline list<VProfilePoint>* my_xMax(int idxStaff) { return m_xMax[idxStaff]; }
-    VProfilePoint my_xMin(int idxStaff, int i)
-    {
-        list<VProfilePoint>::iterator it = m_xMin[idxStaff]->begin();
-        std::advance(it, i);
-        return *it;
-    }
-    inline VProfilePoint my_xMax(int idxStaff, int i)
-    {
-        list<VProfilePoint>::iterator it = m_xMax[idxStaff]->begin();
-        std::advance(it, i);
-        return *it;
-    }
+    inline PointsRow* my_xMin(int idxStaff) { return m_xMin[idxStaff]; }
+    inline PointsRow* my_xMax(int idxStaff) { return m_xMax[idxStaff]; }
+    inline VProfilePoint my_xMin(int idxStaff, int i) { return m_xMin[idxStaff]->at(i); }
+    inline VProfilePoint my_xMax(int idxStaff, int i) { return m_xMax[idxStaff]->at(i); }
 
-    string dump_points(list<VProfilePoint>* pPoints, int idxStaff)
+    string dump_points(PointsRow* pPoints, int idxStaff)
     {
         stringstream msg;
         msg << "size = " << pPoints->size() << endl;
@@ -589,6 +579,61 @@ SUITE(VerticalProfileTest)
         CHECK( vp.get_max_limit(0) == 5000.0f );
     }
 
+    TEST_FIXTURE(VerticalProfileTestFixture, vertical_profile_040)
+    {
+        //@040 update(): wide shape covering several shapes. Intermediate points removed
+        LUnits xStart = 1500.0f;
+        LUnits xEnd = 19500.0f;
+        MyVerticalProfile vp(xStart, xEnd, 1);
+        vp.initialize(0, 3000.0f, 3400.0f);
+
+        GmoShapeRectangle shape1(nullptr);
+        shape1.set_origin(3000.0f, 2000.0f);
+        shape1.set_height(500.0f);
+        shape1.set_width(1000.0f);
+        vp.update(&shape1, 0);
+
+        GmoShapeRectangle shape2(nullptr);
+        shape2.set_origin(5000.0f, 2000.0f);
+        shape2.set_height(500.0f);
+        shape2.set_width(1000.0f);
+        vp.update(&shape2, 0);
+
+        GmoShapeRectangle shape3(nullptr);
+        shape3.set_origin(7000.0f, 2000.0f);
+        shape3.set_height(500.0f);
+        shape3.set_width(1000.0f);
+        vp.update(&shape3, 0);
+        CHECK( vp.my_x_min_size(0) == 8 );
+        CHECK( vp.my_x_max_size(0) == 8 );
+
+        GmoShapeRectangle shape4(nullptr);
+        shape4.set_origin(2000.0f, 1000.0f);
+        shape4.set_height(2000.0f);
+        shape4.set_width(8000.0f);
+        vp.update(&shape4, 0);
+
+//        cout << test_name() << ".  Dump of xMin:" << endl;
+//        cout << vp.dump_points(vp.my_xMin(0), 0) << endl;
+        CHECK( vp.my_x_min_size(0) == 4 );
+        CHECK( vp.my_xMin(0, 0) == VProfilePoint(1500.0f, LOMSE_PAPER_UPPER_LIMIT, nullptr) );
+        CHECK( vp.my_xMin(0, 1) == VProfilePoint(2000.0f, 1000.0f, &shape4) );
+        CHECK( vp.my_xMin(0, 2) == VProfilePoint(10000.0f, LOMSE_PAPER_UPPER_LIMIT, nullptr) );
+        CHECK( vp.my_xMin(0, 3) == VProfilePoint(19500.0f, LOMSE_PAPER_UPPER_LIMIT, nullptr) );
+
+//        cout << test_name() << ".  Dump of xMax:" << endl;
+//        cout << vp.dump_points(vp.my_xMax(0), 0) << endl;
+        CHECK( vp.my_x_max_size(0) == 4 );
+        CHECK( vp.my_xMax(0, 0) == VProfilePoint(1500.0f, LOMSE_PAPER_LOWER_LIMIT, nullptr) );
+        CHECK( vp.my_xMax(0, 1) == VProfilePoint(2000.0f, 3000.0f, &shape4) );
+        CHECK( vp.my_xMax(0, 2) == VProfilePoint(10000.0f, LOMSE_PAPER_LOWER_LIMIT, nullptr) );
+        CHECK( vp.my_xMax(0, 3) == VProfilePoint(19500.0f, LOMSE_PAPER_LOWER_LIMIT, nullptr) );
+
+        std::pair<LUnits, GmoShape*> maxData = vp.get_max_for(3000.0f, 9000.0f, 0);
+        CHECK( maxData.first == 3000.0f );
+        CHECK( maxData.second == &shape4 );
+    }
+
     TEST_FIXTURE(VerticalProfileTestFixture, vertical_profile_100)
     {
         //@100 get_max_for()
@@ -551,6 +551,64 @@ SUITE(GraphicViewTest)
         rectangles.clear();
     }
 
+    //-- viewport culling ---------------------------------------------------------------
+
+    TEST_FIXTURE(GraphicViewTestFixture, viewport_culling_01)
+    {
+        //@01. only shapes in the visible area are drawn. Counters are reported
+
+        MyDoorway platform;
+        LibraryScope libraryScope(cout, &platform);
+        SpDocument spDoc( new Document(libraryScope) );
+        spDoc->from_string("(lenmusdoc (vers 0.0) (content (score (vers 1.6) "
+            "(instrument (musicData (clef G)(key e)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)"
+            "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple))))))" );
+        VerticalBookView* pView = (VerticalBookView*)Injector::inject_View(libraryScope, k_view_vertical_book);
+        Interactor* pIntor = Injector::inject_Interactor(libraryScope, spDoc, pView, nullptr);
+        pView->set_interactor(pIntor);
+        unsigned char buf[57600];
+        pView->set_rendering_buffer(buf, 120, 120);
+        pView->redraw_bitmap();
+
+        int* pCounters = pIntor->get_render_counters();
+        int numDrawn = *(pCounters + Interactor::k_counter_shapes_drawn);
+        int numCulled = *(pCounters + Interactor::k_counter_shapes_culled)
+                        + *(pCounters + Interactor::k_counter_boxes_culled);
+        CHECK( numDrawn > 0 );
+        CHECK( numCulled > 0 );
+
+        //@02. when culling is disabled, all shapes in the visible pages are drawn
+
+        pView->set_rendering_option(k_option_disable_viewport_culling, true);
+        pView->redraw_bitmap();
+
+        CHECK( *(pCounters + Interactor::k_counter_shapes_drawn) > numDrawn );
+        CHECK( *(pCounters + Interactor::k_counter_shapes_culled) == 0 );
+        CHECK( *(pCounters + Interactor::k_counter_boxes_culled) == 0 );
+
+        delete pIntor;
+    }
+
     //TEST_FIXTURE(GraphicViewTestFixture, EditView_UpdateWindow)
     //{
     //    MyDoorway platform;
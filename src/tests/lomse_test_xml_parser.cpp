@@ -156,6 +156,53 @@ SUITE(XmlParserTest)
 
     }
 
+    TEST_FIXTURE(XmlParserTestFixture, xml_parser_07)
+    {
+        //@07. Read content from file. Parser can be reused for other files
+
+        XmlParser parser;
+        parser.parse_file(m_scores_path + "08011-paragraph.lmd");
+        parser.parse_file(m_scores_path + "unit-tests/docmodel/"
+                          "14a-StaffDetails-LineChanges.xml");
+        XmlNode* root = parser.get_tree_root();
+
+        CHECK( root->name() == "score-partwise" );
+        CHECK( parser.get_encoding() == "UTF-8" );
+    }
+
+    TEST_FIXTURE(XmlParserTestFixture, xml_parser_08)
+    {
+        //@08. Embedded pcdata. Node value is the same
+
+        XmlParser parser;
+        parser.embed_pcdata(true);
+        parser.parse_text("<score><vers>1.7</vers><empty/></score>");
+        XmlNode* root = parser.get_tree_root();
+        CHECK( root->name() == "score" );
+        XmlNode vers = root->first_child();
+        CHECK( vers.name() == "vers" );
+        CHECK( vers.value() == "1.7" );
+        CHECK( vers.next_sibling().value() == "" );
+    }
+
+    TEST_FIXTURE(XmlParserTestFixture, xml_parser_09)
+    {
+        //@09. Parse buffer in place. Parser takes ownership of the buffer
+
+        string source("<score><vers>1.7</vers></score>");
+        std::vector<unsigned char> buffer(source.begin(), source.end());
+        buffer.push_back('\0');
+
+        XmlParser parser;
+        parser.embed_pcdata(true);
+        parser.parse_buffer_inplace( std::move(buffer) );
+        XmlNode* root = parser.get_tree_root();
+
+        CHECK( buffer.empty() );
+        CHECK( root->name() == "score" );
+        CHECK( root->first_child().value() == "1.7" );
+    }
+
     TEST_FIXTURE(XmlParserTestFixture, xml_parser_901)
     {
         //@901. File not found